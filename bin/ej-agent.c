@@ -24,6 +24,10 @@
 #include "ejudge/base64.h"
 #include "ejudge/ej_lzma.h"
 #include "ejudge/random.h"
+#include "ejudge/sha256.h"
+#include "ejudge/misctext.h"
+#include "ejudge/spool_queue.h"
+#include "ejudge/agent_frame.h"
 
 #include <stdlib.h>
 #include "ejudge/cJSON.h"
@@ -145,6 +149,7 @@ struct AppState
     struct FDInfo *signal_fdi;
     struct FDInfo *timer_fdi;
     struct FDInfo *inotify_fdi;
+    struct FDInfo *queue_fdi;
 
     struct FDCallback *ready_cbs;
     int ready_cba;
@@ -155,6 +160,9 @@ struct AppState
     int queryu;
     struct dyntrie_node *queryi;
 
+    // SHA-256 of the mirrored files: path -> struct MirrorHash
+    struct dyntrie_node *mirror_hashes;
+
     int cntsa;
     int cntsu;
     struct ContestInfo *cntss;
@@ -185,6 +193,7 @@ struct AppState
     unsigned char *spool_dir;
     unsigned char *queue_dir;
     unsigned char *queue_packet_dir;
+    struct spool_queue *queue;  /* index of queue_dir */
     unsigned char *queue_out_dir;
     unsigned char *data_dir;
     unsigned char *heartbeat_dir;
@@ -192,6 +201,14 @@ struct AppState
     unsigned char *heartbeat_in_dir;
 
     int verbose_mode;
+
+    int binary_framing;         /* the client accepts binary frames */
+    // the files of the current request
+    const unsigned char *in_payload;
+    size_t in_payload_size;
+    // the files of the reply being built
+    struct agent_frame_payload out_payload;
+    int out_frame;
 };
 
 static void
@@ -205,6 +222,21 @@ app_state_init(struct AppState *as)
     as->spool_wd = -1;
 }
 
+struct MirrorHash
+{
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+    unsigned char sha256[32];
+};
+
+static void
+mirror_hash_free(void *cntx, void *value)
+{
+    free(value);
+}
+
 static void
 app_state_destroy(struct AppState *as)
 {
@@ -218,6 +250,8 @@ app_state_destroy(struct AppState *as)
     }
     free(as->querys);
     dyntrie_free(&as->queryi, NULL, NULL);
+    dyntrie_free(&as->mirror_hashes, mirror_hash_free, NULL);
+    spool_queue_free(as->queue);
 }
 
 static struct FDInfo *
@@ -531,6 +565,45 @@ static const struct FDInfoOps inotify_ops =
     .op_read = inotify_read_func,
 };
 
+static void
+queue_read_func(struct AppState *as, struct FDInfo *fdi)
+{
+    if (spool_queue_update(as->queue) < 0) {
+        err("%s: queue_read_func: spool queue update failed", as->inst_id);
+    }
+}
+
+static const struct FDInfoOps queue_ops =
+{
+    .op_read = queue_read_func,
+};
+
+static int
+app_state_scan_queue(
+        struct AppState *as,
+        unsigned char *pkt_name,
+        size_t pkt_size,
+        int random_mode)
+{
+    if (as->queue) {
+        return spool_queue_get(as->queue, pkt_name, pkt_size, random_mode);
+    }
+    return scan_dir(as->queue_dir, pkt_name, pkt_size, random_mode);
+}
+
+static int
+app_state_open_queue(struct AppState *as)
+{
+    if (!as->queue_dir || !as->queue_dir[0]) return 0;
+    if (!(as->queue = spool_queue_create(as->queue_dir))) {
+        err("%s: failed to create queue index for '%s'", as->inst_id, as->queue_dir);
+        return -1;
+    }
+    as->queue_fdi = fdinfo_create(as, spool_queue_fd(as->queue), &queue_ops);
+    app_state_arm_for_read(as, as->queue_fdi);
+    return 0;
+}
+
 static void
 pipe_read_func(struct AppState *as, struct FDInfo *fdi)
 {
@@ -577,22 +650,55 @@ done:
 }
 
 static int
-separator_2nl_ready_func(struct AppState *as, struct FDInfo *fdi)
+frame_ready_func(struct AppState *as, struct FDInfo *fdi)
 {
-    if (fdi->rd_size < 2) return 0;
     int s = 0;
-    for (int i = 1; i < fdi->rd_size; ++i) {
-        if (fdi->rd_data[i] == '\n' && fdi->rd_data[i - 1] == '\n') {
-            fdinfo_add_rchunk(fdi, &fdi->rd_data[s], i - s + 1);
-            s = i + 1;
+    while (s < fdi->rd_size) {
+        ssize_t len = agent_frame_scan(fdi->rd_data + s, fdi->rd_size - s);
+        if (len < 0) {
+            err("%s: broken input stream", as->inst_id);
+            as->term_flag = 1;
+            break;
         }
+        if (!len) break;
+        fdinfo_add_rchunk(fdi, &fdi->rd_data[s], len);
+        s += len;
     }
     if (!s) return 0;
     fdi->rd_size -= s;
-    memcpy(fdi->rd_data, fdi->rd_data + s, fdi->rd_size);
+    memmove(fdi->rd_data, fdi->rd_data + s, fdi->rd_size);
     return 1;
 }
 
+static void
+app_state_write_reply(struct AppState *as, cJSON *reply)
+{
+    char *jstr = cJSON_PrintUnformatted(reply);
+    size_t jlen = strlen(jstr);
+    if (as->verbose_mode) {
+        info("%s: json: %s%s", as->inst_id, jstr, as->out_frame?" (binary)":"");
+    }
+    if (as->out_frame) {
+        unsigned char *out = NULL;
+        size_t out_size = 0;
+        if (agent_frame_encode(jstr, jlen, &as->out_payload, &out, &out_size) >= 0) {
+            fdinfo_add_write_data_2(as->stdout_fdi, out, out_size);
+            free(jstr); jstr = NULL;
+        }
+        // on failure the reply is sent without the files, the client reports an error
+        agent_frame_payload_free(&as->out_payload);
+        as->out_frame = 0;
+    }
+    if (jstr) {
+        jstr = realloc(jstr, jlen + 3);
+        jstr[jlen++] = '\n';
+        jstr[jlen++] = '\n';
+        jstr[jlen] = 0;
+        fdinfo_add_write_data_2(as->stdout_fdi, jstr, jlen);
+    }
+    app_state_arm_for_write(as, as->stdout_fdi);
+}
+
 static void
 handle_stdin_rchunk(
         struct AppState *as,
@@ -600,9 +706,10 @@ handle_stdin_rchunk(
         const unsigned char *data,
         int size)
 {
-    char *jstr = NULL;
-    int jlen;
     cJSON *root = NULL;
+    char *json = NULL;
+    unsigned char *payload = NULL;
+    size_t payload_size = 0;
     cJSON *reply = cJSON_CreateObject();
     int ok = 0;
 
@@ -613,6 +720,21 @@ handle_stdin_rchunk(
     cJSON_AddNumberToObject(reply, "tt", (double) as->current_time_ms);
     cJSON_AddNumberToObject(reply, "ss", (double) ++as->serial);
 
+    if (agent_frame_is_binary(data, size)) {
+        if (agent_frame_decode(data, size, &json, &payload, &payload_size) < 0) {
+            cJSON_AddStringToObject(reply, "message", "invalid frame");
+            err("%s: invalid binary frame on stdin", as->inst_id);
+            goto done;
+        }
+        if (as->verbose_mode) {
+            info("%s: in: %s (binary)", as->inst_id, json);
+        }
+        data = (const unsigned char *) json;
+        size = strlen(json);
+        as->in_payload = payload;
+        as->in_payload_size = payload_size;
+    }
+
     if (strlen(data) != size) {
         cJSON_AddStringToObject(reply, "message", "binary data");
         err("%s: binary data on stdin", as->inst_id);
@@ -654,22 +776,14 @@ handle_stdin_rchunk(
 
 done:
     cJSON_AddBoolToObject(reply, "ok", ok);
-    jstr = cJSON_PrintUnformatted(reply);
-    jlen = strlen(jstr);
-    if (as->verbose_mode) {
-        info("%s: json: %s", as->inst_id, jstr);
-    }
-    jstr = realloc(jstr, jlen + 3);
-    jstr[jlen++] = '\n';
-    jstr[jlen++] = '\n';
-    jstr[jlen] = 0;
-    fdinfo_add_write_data_2(as->stdout_fdi, jstr, jlen);
-    jstr = NULL;
-    app_state_arm_for_write(as, as->stdout_fdi);
+    app_state_write_reply(as, reply);
 
+    as->in_payload = NULL;
+    as->in_payload_size = 0;
     if (root) cJSON_Delete(root);
     if (reply) cJSON_Delete(reply);
-    free(jstr);
+    free(json);
+    free(payload);
 }
 
 static void
@@ -681,7 +795,7 @@ handle_stdin_read_func(struct AppState *as, struct FDInfo *fdi)
     }
 
     for (int i = 0; i < fdi->rchunku; ++i) {
-        {
+        if (!agent_frame_is_binary(fdi->rchunks[i].data, fdi->rchunks[i].size)) {
             unsigned char *data = fdi->rchunks[i].data;
             int size = fdi->rchunks[i].size;
             while (size > 0 && isspace(data[size - 1])) {
@@ -689,9 +803,9 @@ handle_stdin_read_func(struct AppState *as, struct FDInfo *fdi)
             }
             data[size] = 0;
             fdi->rchunks[i].size = size;
-        }
-        if (as->verbose_mode) {
-            info("%s: in: %s", as->inst_id, fdi->rchunks[i].data);
+            if (as->verbose_mode) {
+                info("%s: in: %s", as->inst_id, fdi->rchunks[i].data);
+            }
         }
         handle_stdin_rchunk(as, fdi, fdi->rchunks[i].data, fdi->rchunks[i].size);
     }
@@ -701,7 +815,7 @@ handle_stdin_read_func(struct AppState *as, struct FDInfo *fdi)
 static const struct FDInfoOps stdin_ops =
 {
     .op_read = pipe_read_func,
-    .is_in_ready = separator_2nl_ready_func,
+    .is_in_ready = frame_ready_func,
     .handle_read = handle_stdin_read_func,
 };
 
@@ -916,16 +1030,19 @@ safe_read_packet(
         char **p_data,
         size_t *p_size);
 static void
-add_file_to_object(
+add_file_to_reply(
+        struct AppState *as,
         cJSON *j,
         const char *data,
         size_t size);
+static void
+app_state_write_reply(struct AppState *as, cJSON *reply);
 
 static void
 check_spool_state(struct AppState *as)
 {
     unsigned char pkt_name[PATH_MAX];
-    int r = scan_dir(as->queue_dir, pkt_name, sizeof(pkt_name), as->wait_random_mode);
+    int r = app_state_scan_queue(as, pkt_name, sizeof(pkt_name), as->wait_random_mode);
     if (r <= 0) return;
 
     char *data = NULL;
@@ -949,25 +1066,14 @@ check_spool_state(struct AppState *as)
     if (data != NULL) {
         cJSON_AddStringToObject(reply, "q", "file-result");
         cJSON_AddTrueToObject(reply, "found");
-        add_file_to_object(reply, data, size);
+        add_file_to_reply(as, reply, data, size);
         free(data); data = NULL;
     } else {
         cJSON_AddStringToObject(reply, "q", "poll-result");
     }
     cJSON_AddStringToObject(reply, "pkt-name", pkt_name);
     cJSON_AddTrueToObject(reply, "ok");
-    char *jstr = cJSON_PrintUnformatted(reply);
-    size_t jlen = strlen(jstr);
-    if (as->verbose_mode) {
-        info("%s: json: %s", as->inst_id, jstr);
-    }
-    jstr = realloc(jstr, jlen + 3);
-    jstr[jlen++] = '\n';
-    jstr[jlen++] = '\n';
-    jstr[jlen] = 0;
-    fdinfo_add_write_data_2(as->stdout_fdi, jstr, jlen);
-    jstr = NULL;
-    app_state_arm_for_write(as, as->stdout_fdi);
+    app_state_write_reply(as, reply);
 
     info("%s: wake-up on directory: %d, %d, %s", as->inst_id, as->serial, as->wait_serial, pkt_name);
 
@@ -1066,6 +1172,10 @@ set_query_func(
         free(as->queue_id);
         as->queue_id = xstrdup(jn->valuestring);
     }
+    cJSON *jf = cJSON_GetObjectItem(query, "framing");
+    if (jf && jf->type == cJSON_String && !strcmp(jf->valuestring, "binary")) {
+        as->binary_framing = 1;
+    }
     cJSON *jm = cJSON_GetObjectItem(query, "mode");
     if (jm && jm->type == cJSON_String) {
         if (!strcmp(jm->valuestring, "compile")) {
@@ -1085,6 +1195,11 @@ set_query_func(
     } else if (as->mode == PREPARE_RUN) {
         cJSON_AddStringToObject(reply, "mode", "run");
     }
+    if (as->binary_framing) {
+        cJSON_AddStringToObject(reply, "framing", "binary");
+    }
+    cJSON_AddTrueToObject(reply, "put-results");
+    cJSON_AddTrueToObject(reply, "put-data");
     cJSON_AddStringToObject(reply, "q", "get");
     return 1;
 }
@@ -1169,6 +1284,21 @@ add_file_to_object(cJSON *j, const char *data, size_t size)
     }
 }
 
+static void
+add_file_to_reply(
+        struct AppState *as,
+        cJSON *j,
+        const char *data,
+        size_t size)
+{
+    if (as->binary_framing) {
+        agent_frame_add_file(&as->out_payload, j, (const unsigned char *) data, size);
+        as->out_frame = 1;
+    } else {
+        add_file_to_object(j, data, size);
+    }
+}
+
 static int
 safe_read_packet(
         struct AppState *as,
@@ -1276,7 +1406,7 @@ poll_func(
         enable_file = 1;
     }
     while (1) {
-        int r = scan_dir(as->queue_dir, pkt_name, sizeof(pkt_name), random_mode);
+        int r = app_state_scan_queue(as, pkt_name, sizeof(pkt_name), random_mode);
         if (r < 0) {
             cJSON_AddStringToObject(reply, "message", "scan_dir failed");
             err("%s: scan_dir failed: %s", as->inst_id, strerror(-r));
@@ -1303,7 +1433,7 @@ poll_func(
             cJSON_AddStringToObject(reply, "pkt-name", pkt_name);
             cJSON_AddStringToObject(reply, "q", "file-result");
             cJSON_AddTrueToObject(reply, "found");
-            add_file_to_object(reply, data, size);
+            add_file_to_reply(as, reply, data, size);
             free(data);
             return 1;
         }
@@ -1339,7 +1469,7 @@ get_packet_func(
     }
     cJSON_AddStringToObject(reply, "q", "file-result");
     cJSON_AddTrueToObject(reply, "found");
-    add_file_to_object(reply, pkt_ptr, pkt_len);
+    add_file_to_reply(as, reply, pkt_ptr, pkt_len);
     free(pkt_ptr);
     return 1;
 }
@@ -1378,7 +1508,7 @@ get_data_func(
     }
     cJSON_AddStringToObject(reply, "q", "file-result");
     cJSON_AddTrueToObject(reply, "found");
-    add_file_to_object(reply, pkt_ptr, pkt_len);
+    add_file_to_reply(as, reply, pkt_ptr, pkt_len);
     free(pkt_ptr);
     return 1;
 }
@@ -1407,6 +1537,9 @@ extract_file(
         *p_pkt_len = 0;
         return 1;
     }
+    if (agent_frame_has_file(j)) {
+        return agent_frame_get_file(as->in_payload, as->in_payload_size, j, p_pkt_ptr, p_pkt_len);
+    }
     cJSON *jb64 = cJSON_GetObjectItem(j, "b64");
     if (!jb64 || jb64->type != cJSON_True) {
         err("%s: invalid json: no encoding", as->inst_id);
@@ -1731,7 +1864,7 @@ wait_func(
 
     while (1) {
         unsigned char pkt_name[PATH_MAX];
-        int r = scan_dir(as->queue_dir, pkt_name, sizeof(pkt_name), random_mode);
+        int r = app_state_scan_queue(as, pkt_name, sizeof(pkt_name), random_mode);
         if (r < 0) {
             cJSON_AddStringToObject(reply, "message", "scan_dir failed");
             err("%s: scan_dir failed: %s", as->inst_id, strerror(-r));
@@ -1755,7 +1888,7 @@ wait_func(
             cJSON_AddStringToObject(reply, "q", "file-result");
             cJSON_AddStringToObject(reply, "pkt-name", pkt_name);
             cJSON_AddTrueToObject(reply, "found");
-            add_file_to_object(reply, data, size);
+            add_file_to_reply(as, reply, data, size);
             free(data);
             return 1;
         }
@@ -1809,7 +1942,11 @@ add_ignored_func(
     }
     const unsigned char *pkt_name = jp->valuestring;
 
-    scan_dir_add_ignored(as->queue_dir, pkt_name);
+    if (as->queue) {
+        spool_queue_add_ignored(as->queue, pkt_name);
+    } else {
+        scan_dir_add_ignored(as->queue_dir, pkt_name);
+    }
     cJSON_AddStringToObject(reply, "q", "result");
     return 1;
 }
@@ -1849,6 +1986,50 @@ done:
     return result;
 }
 
+static int
+put_data_func(
+        struct AppState *as,
+        const struct QueryCallback *cb,
+        cJSON *query,
+        cJSON *reply)
+{
+    /*
+{ "q" : "put-data", "pkt_name" : "N", "suffix" : "X", <file> }
+     */
+    int result = 0;
+    char *data = NULL;
+    size_t size = 0;
+    cJSON *jp = cJSON_GetObjectItem(query, "pkt_name");
+    if (!jp || jp->type != cJSON_String) {
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        err("%s: put_data: missing pkt_name", as->inst_id);
+        goto done;
+    }
+    const unsigned char *pkt_name = jp->valuestring;
+    const unsigned char *suffix = NULL;
+    cJSON *js = cJSON_GetObjectItem(query, "suffix");
+    if (js && js->type == cJSON_String) {
+        suffix = js->valuestring;
+    }
+
+    if (extract_file(as, query, &data, &size) < 0) {
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        goto done;
+    }
+
+    // the data file is put back before its packet, nobody reads it meanwhile
+    if (generic_write_file(data, size, 0, as->data_dir, pkt_name, suffix) < 0) {
+        cJSON_AddStringToObject(reply, "message", "filesystem error");
+        goto done;
+    }
+    result = 1;
+
+done:
+    cJSON_AddStringToObject(reply, "q", "result");
+    free(data);
+    return result;
+}
+
 static int
 put_heartbeat_func(
         struct AppState *as,
@@ -2026,6 +2207,114 @@ done:
     return result;
 }
 
+static int
+put_results_func(
+        struct AppState *as,
+        const struct QueryCallback *cb,
+        cJSON *query,
+        cJSON *reply)
+{
+    /*
+{ "q" : "put-results", "server" : "S", "contest" : C, "run_name" : "N", "files" : [ { "dir" : "report" | "output", "suffix" : "X", <file> }, ... ], "reply" : { <file> } }
+     */
+    int result = 0;
+    char *data = NULL;
+    size_t size = 0;
+    unsigned char **written = NULL;
+    int written_count = 0;
+
+    cJSON *jserver = cJSON_GetObjectItem(query, "server");
+    if (!jserver || jserver->type != cJSON_String || !jserver->valuestring) {
+        err("%s: invalid json: no server", as->inst_id);
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        goto done;
+    }
+    const unsigned char *server = jserver->valuestring;
+    cJSON *jcid = cJSON_GetObjectItem(query, "contest");
+    if (!jcid || jcid->type != cJSON_Number || jcid->valuedouble <= 0) {
+        err("%s: invalid json: invalid contest_id", as->inst_id);
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        goto done;
+    }
+    int contest_id = jcid->valuedouble;
+    cJSON *jrun = cJSON_GetObjectItem(query, "run_name");
+    if (!jrun || jrun->type != cJSON_String || !jrun->valuestring) {
+        err("%s: invalid json: no run_name", as->inst_id);
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        goto done;
+    }
+    const unsigned char *run_name = jrun->valuestring;
+    cJSON *jfs = cJSON_GetObjectItem(query, "files");
+    cJSON *jr = cJSON_GetObjectItem(query, "reply");
+    if (!jfs || jfs->type != cJSON_Array || !jr || jr->type != cJSON_Object) {
+        err("%s: invalid json: no files or reply", as->inst_id);
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        goto done;
+    }
+
+    struct ContestInfo *ci = create_contest_dirs(as, server, contest_id);
+    if (!ci) {
+        err("%s: directory creation failed", as->inst_id);
+        cJSON_AddStringToObject(reply, "message", "filesystem error");
+        goto done;
+    }
+
+    // the files are removed, if the reply packet cannot be written
+    int file_count = cJSON_GetArraySize(jfs);
+    XCALLOC(written, file_count + 1);
+    for (int i = 0; i < file_count; ++i) {
+        cJSON *jf = cJSON_GetArrayItem(jfs, i);
+        const unsigned char *dir = ci->report_dir;
+        const unsigned char *suffix = "";
+        cJSON *jd = cJSON_GetObjectItem(jf, "dir");
+        if (jd && jd->type == cJSON_String && !strcmp(jd->valuestring, "output")) {
+            dir = ci->output_dir;
+        }
+        cJSON *jsuffix = cJSON_GetObjectItem(jf, "suffix");
+        if (jsuffix && jsuffix->type == cJSON_String) {
+            suffix = jsuffix->valuestring;
+        }
+        if (extract_file(as, jf, &data, &size) < 0) {
+            cJSON_AddStringToObject(reply, "message", "invalid json");
+            goto fail;
+        }
+        if (generic_write_file(data, size, 0, dir, run_name, suffix) < 0) {
+            cJSON_AddStringToObject(reply, "message", "filesystem error");
+            goto fail;
+        }
+        free(data); data = NULL;
+        unsigned char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s%s", dir, run_name, suffix);
+        written[written_count++] = xstrdup(path);
+    }
+
+    if (extract_file(as, jr, &data, &size) < 0) {
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        goto fail;
+    }
+    if (generic_write_file(data, size, SAFE, ci->status_dir, run_name, 0) < 0) {
+        cJSON_AddStringToObject(reply, "message", "filesystem error");
+        goto fail;
+    }
+
+    cJSON_AddStringToObject(reply, "q", "result");
+    result = 1;
+
+done:
+    for (int i = 0; i < written_count; ++i) {
+        xfree(written[i]);
+    }
+    xfree(written);
+    free(data);
+    return result;
+
+fail:
+    for (int i = 0; i < written_count; ++i) {
+        unlink(written[i]);
+    }
+    goto done;
+}
+
 static int
 mirror_func(
         struct AppState *as,
@@ -2126,7 +2415,7 @@ mirror_func(
     cJSON_AddNumberToObject(reply, "uid", stb.st_uid);
     cJSON_AddNumberToObject(reply, "gid", stb.st_gid);
     if (stb.st_size <= 0) {
-        add_file_to_object(reply, NULL, 0);
+        add_file_to_reply(as, reply, NULL, 0);
         cJSON_AddStringToObject(reply, "q", "file-result");
         cJSON_AddTrueToObject(reply, "found");
         result = 1;
@@ -2143,7 +2432,7 @@ mirror_func(
     close(fd); fd = -1;
     cJSON_AddStringToObject(reply, "q", "file-result");
     cJSON_AddTrueToObject(reply, "found");
-    add_file_to_object(reply, pkt_ptr, pkt_size);
+    add_file_to_reply(as, reply, pkt_ptr, pkt_size);
     result = 1;
 
 done:;
@@ -2152,6 +2441,212 @@ done:;
     return result;
 }
 
+enum { MIRROR_MAX_FILES = 100000 };
+enum { MIRROR_MAX_FILE_SIZE = 1073741824 };
+enum { MIRROR_MAX_FETCH_SIZE = 268435456 };
+
+/*
+ * opens a regular file to be mirrored,
+ * returns the file descriptor or -1, the file is mapped, if p_ptr != NULL
+ */
+static int
+mirror_open(
+        struct AppState *as,
+        const unsigned char *path,
+        struct stat *pstb,
+        unsigned char **p_ptr)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, pstb) < 0) {
+        err("%s: mirror: fstat '%s' failed: %s ", as->inst_id, path,
+            strerror(errno));
+        goto fail;
+    }
+    if (!S_ISREG(pstb->st_mode)) {
+        err("%s: mirror: '%s' not a regular file", as->inst_id, path);
+        goto fail;
+    }
+    if (pstb->st_size > MIRROR_MAX_FILE_SIZE) {
+        err("%s: mirror: '%s' file is too big: %lld", as->inst_id, path,
+            (long long) pstb->st_size);
+        goto fail;
+    }
+    if (p_ptr && pstb->st_size > 0) {
+        *p_ptr = mmap(NULL, pstb->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (*p_ptr == MAP_FAILED) {
+            err("%s: mirror: mmap '%s' failed: %s ", as->inst_id, path,
+                strerror(errno));
+            goto fail;
+        }
+    }
+    return fd;
+
+fail:;
+    close(fd);
+    return -1;
+}
+
+/* returns the SHA-256 of the file, recalculating it only if the file changed */
+static const unsigned char *
+mirror_get_hash(
+        struct AppState *as,
+        const unsigned char *path,
+        int fd,
+        const struct stat *pstb)
+{
+    struct MirrorHash *mh = dyntrie_get(&as->mirror_hashes, path);
+    if (mh && mh->dev == pstb->st_dev && mh->ino == pstb->st_ino
+        && mh->size == pstb->st_size
+        && mh->mtime.tv_sec == pstb->st_mtim.tv_sec
+        && mh->mtime.tv_nsec == pstb->st_mtim.tv_nsec) {
+        return mh->sha256;
+    }
+
+    SHA256_CTX ctx;
+    sha256_init(&ctx);
+    if (pstb->st_size > 0) {
+        unsigned char *ptr = mmap(NULL, pstb->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            err("%s: mirror: mmap '%s' failed: %s ", as->inst_id, path,
+                strerror(errno));
+            return NULL;
+        }
+        sha256_update(&ctx, ptr, pstb->st_size);
+        munmap(ptr, pstb->st_size);
+    }
+
+    if (!mh) {
+        mh = xcalloc(1, sizeof(*mh));
+        dyntrie_insert(&as->mirror_hashes, path, mh, 1, NULL);
+    }
+    mh->dev = pstb->st_dev;
+    mh->ino = pstb->st_ino;
+    mh->size = pstb->st_size;
+    mh->mtime = pstb->st_mtim;
+    sha256_final(&ctx, mh->sha256);
+    return mh->sha256;
+}
+
+static cJSON *
+mirror_get_paths(
+        struct AppState *as,
+        cJSON *query,
+        cJSON *reply)
+{
+    cJSON *jps = cJSON_GetObjectItem(query, "paths");
+    if (!jps || jps->type != cJSON_Array) {
+        cJSON_AddStringToObject(reply, "message", "invalid json");
+        err("%s: mirror: missing paths", as->inst_id);
+        return NULL;
+    }
+    int count = cJSON_GetArraySize(jps);
+    if (count > MIRROR_MAX_FILES) {
+        cJSON_AddStringToObject(reply, "message", "too many files");
+        err("%s: mirror: too many files: %d", as->inst_id, count);
+        return NULL;
+    }
+    for (int i = 0; i < count; ++i) {
+        cJSON *jp = cJSON_GetArrayItem(jps, i);
+        if (!jp || jp->type != cJSON_String || !jp->valuestring) {
+            cJSON_AddStringToObject(reply, "message", "invalid json");
+            err("%s: mirror: invalid path", as->inst_id);
+            return NULL;
+        }
+    }
+    return jps;
+}
+
+static int
+mirror_stat_func(
+        struct AppState *as,
+        const struct QueryCallback *cb,
+        cJSON *query,
+        cJSON *reply)
+{
+    unsigned char perm_buf[64];
+
+    /*
+      query: { "paths" : [ PATH... ] }
+      reply: { "files" : [ { "found", "size", "mtime", "mode", "sha256" }... ] }
+     */
+
+    cJSON *jps = mirror_get_paths(as, query, reply);
+    if (!jps) return 0;
+
+    cJSON *jfs = cJSON_CreateArray();
+    int count = cJSON_GetArraySize(jps);
+    for (int i = 0; i < count; ++i) {
+        const unsigned char *path = cJSON_GetArrayItem(jps, i)->valuestring;
+        cJSON *jf = cJSON_CreateObject();
+        cJSON_AddItemToArray(jfs, jf);
+        struct stat stb;
+        int fd = mirror_open(as, path, &stb, NULL);
+        if (fd < 0) continue;
+        const unsigned char *sha256 = mirror_get_hash(as, path, fd, &stb);
+        close(fd);
+        if (!sha256) continue;
+        cJSON_AddTrueToObject(jf, "found");
+        cJSON_AddNumberToObject(jf, "size", stb.st_size);
+        cJSON_AddNumberToObject(jf, "mtime", stb.st_mtime);
+        snprintf(perm_buf, sizeof(perm_buf), "%04o", stb.st_mode & 07777);
+        cJSON_AddStringToObject(jf, "mode", perm_buf);
+        cJSON_AddStringToObject(jf, "sha256", unparse_sha256(sha256));
+    }
+    cJSON_AddItemToObject(reply, "files", jfs);
+    cJSON_AddStringToObject(reply, "q", "mirror-stat-result");
+    return 1;
+}
+
+static int
+mirror_fetch_func(
+        struct AppState *as,
+        const struct QueryCallback *cb,
+        cJSON *query,
+        cJSON *reply)
+{
+    long long total_size = 0;
+
+    /*
+      query: { "paths" : [ PATH... ] }
+      reply: { "files" : [ { "found", "size", DATA... }... ] }
+     */
+
+    cJSON *jps = mirror_get_paths(as, query, reply);
+    if (!jps) return 0;
+
+    cJSON *jfs = cJSON_CreateArray();
+    int count = cJSON_GetArraySize(jps);
+    for (int i = 0; i < count; ++i) {
+        const unsigned char *path = cJSON_GetArrayItem(jps, i)->valuestring;
+        cJSON *jf = cJSON_CreateObject();
+        cJSON_AddItemToArray(jfs, jf);
+        struct stat stb;
+        unsigned char *ptr = MAP_FAILED;
+        int fd = mirror_open(as, path, &stb, &ptr);
+        if (fd < 0) continue;
+        close(fd);
+        if (total_size + stb.st_size > MIRROR_MAX_FETCH_SIZE) {
+            // the rest is to be requested separately
+            if (ptr != MAP_FAILED) munmap(ptr, stb.st_size);
+            continue;
+        }
+        total_size += stb.st_size;
+        cJSON_AddTrueToObject(jf, "found");
+        if (ptr == MAP_FAILED) {
+            add_file_to_reply(as, jf, NULL, 0);
+        } else {
+            add_file_to_reply(as, jf, ptr, stb.st_size);
+            munmap(ptr, stb.st_size);
+        }
+    }
+    cJSON_AddItemToObject(reply, "files", jfs);
+    cJSON_AddStringToObject(reply, "q", "mirror-fetch-result");
+    return 1;
+}
+
 static int
 cancel_func(
         struct AppState *as,
@@ -2293,6 +2788,9 @@ main(int argc, char *argv[])
     if (app_state_configure_directories(&app) < 0) {
         die("failed to create spool directories");
     }
+    if (app_state_open_queue(&app) < 0) {
+        die("failed to open queue");
+    }
 
     app_state_add_query_callback(&app, "ping", NULL, ping_query_func);
     app_state_add_query_callback(&app, "set", NULL, set_query_func);
@@ -2304,10 +2802,14 @@ main(int argc, char *argv[])
     app_state_add_query_callback(&app, "wait", NULL, wait_func);
     app_state_add_query_callback(&app, "add-ignored", NULL, add_ignored_func);
     app_state_add_query_callback(&app, "put-packet", NULL, put_packet_func);
+    app_state_add_query_callback(&app, "put-data", NULL, put_data_func);
     app_state_add_query_callback(&app, "put-heartbeat", NULL, put_heartbeat_func);
     app_state_add_query_callback(&app, "delete-heartbeat", NULL, delete_heartbeat_func);
     app_state_add_query_callback(&app, "put-archive", NULL, put_archive_func);
+    app_state_add_query_callback(&app, "put-results", NULL, put_results_func);
     app_state_add_query_callback(&app, "mirror", NULL, mirror_func);
+    app_state_add_query_callback(&app, "mirror-stat", NULL, mirror_stat_func);
+    app_state_add_query_callback(&app, "mirror-fetch", NULL, mirror_fetch_func);
     app_state_add_query_callback(&app, "cancel", NULL, cancel_func);
 
     if (log_file && *log_file) {
@@ -41,6 +41,10 @@
 #include "ejudge/ej_process.h"
 #include "ejudge/agent_client.h"
 #include "ejudge/version.h"
+#include "ejudge/spool_queue.h"
+#include "ejudge/sha256.h"
+#include "ejudge/test_gen_cache.h"
+#include "ejudge/exe_store.h"
 
 #include "ejudge/meta_generic.h"
 #include "ejudge/meta/compile_packet_meta.h"
@@ -68,11 +72,15 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <sys/inotify.h>
+#include <sys/wait.h>
 #include <sys/epoll.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <poll.h>
 
 enum { MAX_LOG_SIZE = 1024 * 1024, MAX_EXE_SIZE = 128 * 1024 * 1024 };
 
@@ -89,7 +97,6 @@ static int slave_mode;
 static unsigned char *compile_server_id;
 static __attribute__((unused)) unsigned char compile_server_spool_dir[PATH_MAX];
 static unsigned char compile_server_queue_dir[PATH_MAX];
-static unsigned char compile_server_queue_dir_dir[PATH_MAX];
 static unsigned char compile_server_src_dir[PATH_MAX];
 static unsigned char heartbeat_dir[PATH_MAX];
 static unsigned char *agent_name;
@@ -109,6 +116,11 @@ static unsigned char pending_down_flag; // bool
 static unsigned char pending_reboot_flag; // bool
 static unsigned char *heartbeat_instance_id;
 static unsigned char *local_cache = NULL;
+static long long compile_cache_size = 0;
+static int supervisor_slots = 0;
+static int style_pipeline_mode = -1;
+static int prefetch_mode = 0;
+static unsigned char compile_cache_dir[PATH_MAX];
 
 struct testinfo_subst_handler_compile
 {
@@ -144,20 +156,17 @@ testinfo_subst_handler_substitute(struct testinfo_subst_handler *bp, const unsig
 #define VALID_SIZE(z) ((z) > 0 && (z) == (size_t) (z))
 
 static int
-invoke_style_checker(
+start_style_checker(
         FILE *log_f,
-        const struct serve_state *cs,
         const struct section_language_data *lang,
         const struct compile_request_packet *req,
         const unsigned char *input_file,
         const unsigned char *working_dir,
         const unsigned char *log_path,
-        const testinfo_t *tinf)
+        const testinfo_t *tinf,
+        tpTask *p_tsk)
 {
-  tpTask tsk = 0;
-  int retval = RUN_CHECK_FAILED;
-
-  tsk = task_New();
+  tpTask tsk = task_New();
   task_AddArg(tsk, req->style_checker);
   task_AddArg(tsk, input_file);
   task_SetPathAsArg0(tsk);
@@ -186,8 +195,22 @@ invoke_style_checker(
   if (task_Start(tsk) < 0) {
     err("Failed to start style checker process");
     fprintf(log_f, "\nFailed to start style checker %s\n", req->style_checker);
-    goto cleanup;
+    task_Delete(tsk);
+    return -1;
   }
+  *p_tsk = tsk;
+  return 0;
+}
+
+/* waits for the style checker and deletes the task */
+static int
+finish_style_checker(
+        FILE *log_f,
+        const struct compile_request_packet *req,
+        tpTask tsk)
+{
+  int retval = RUN_CHECK_FAILED;
+
   task_Wait(tsk);
   if (task_IsTimeout(tsk)) {
     err("Style checker process is timed out");
@@ -231,6 +254,110 @@ cleanup:
   return retval;
 }
 
+static int
+invoke_style_checker(
+        FILE *log_f,
+        const struct serve_state *cs,
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const unsigned char *input_file,
+        const unsigned char *working_dir,
+        const unsigned char *log_path,
+        const testinfo_t *tinf)
+{
+  tpTask tsk = NULL;
+
+  if (start_style_checker(log_f, lang, req, input_file, working_dir, log_path, tinf, &tsk) < 0) {
+    return RUN_CHECK_FAILED;
+  }
+  return finish_style_checker(log_f, req, tsk);
+}
+
+/*
+ * In the pipeline mode the style checker is started on a copy of
+ * the source together with the compiler. The output of the style
+ * checker is collected separately and is appended to the log after
+ * the compiler output, so the log looks like the log of the sequential
+ * mode. If the style check fails, the compilation is cancelled.
+ */
+struct style_pipeline
+{
+  const struct compile_request_packet *req;
+  tpTask tsk;
+  int status;                   // -1, if not finished yet
+  FILE *msg_f;
+  char *msg_s;
+  size_t msg_z;
+  unsigned char dir[PATH_MAX];
+  unsigned char log_path[PATH_MAX];
+};
+
+// the pipeline of the current compilation, if any
+static struct style_pipeline *style_pipeline;
+
+static int
+start_style_pipeline(
+        struct style_pipeline *sp,
+        FILE *log_f,
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const unsigned char *working_dir,
+        const unsigned char *src_name)
+{
+  unsigned char src_path[PATH_MAX];
+  unsigned long long u64 = random_u64();
+
+  memset(sp, 0, sizeof(*sp));
+  sp->req = req;
+  sp->status = -1;
+  snprintf(sp->dir, sizeof(sp->dir), "%s/%llx.sc", working_dir, u64);
+  snprintf(sp->log_path, sizeof(sp->log_path), "%s/%llx.sclog", working_dir, u64);
+  snprintf(src_path, sizeof(src_path), "%s/%s", working_dir, src_name);
+  if (make_dir(sp->dir, 0) < 0) {
+    err("cannot create '%s': %s", sp->dir, os_ErrorMsg());
+    return -1;
+  }
+  if (generic_copy_file(0, NULL, src_path, "", 0, sp->dir, src_name, "") < 0) {
+    remove_directory_recursively(sp->dir, 0);
+    return -1;
+  }
+  sp->msg_f = open_memstream(&sp->msg_s, &sp->msg_z);
+  if (start_style_checker(sp->msg_f, lang, req, src_name, sp->dir, sp->log_path, NULL, &sp->tsk) < 0) {
+    sp->status = RUN_CHECK_FAILED;
+  }
+  return 0;
+}
+
+static int
+wait_style_pipeline(struct style_pipeline *sp)
+{
+  if (sp->status < 0) {
+    sp->status = finish_style_checker(sp->msg_f, sp->req, sp->tsk);
+    sp->tsk = NULL;
+  }
+  return sp->status;
+}
+
+static int
+finish_style_pipeline(struct style_pipeline *sp, FILE *log_f)
+{
+  char *text = NULL;
+  size_t size = 0;
+
+  int status = wait_style_pipeline(sp);
+  if (generic_read_file(&text, 0, &size, 0, NULL, sp->log_path, "") >= 0) {
+    fwrite(text, 1, size, log_f);
+    xfree(text);
+  }
+  fclose(sp->msg_f); sp->msg_f = NULL;
+  fwrite(sp->msg_s, 1, sp->msg_z, log_f);
+  fflush(log_f);
+  xfree(sp->msg_s); sp->msg_s = NULL;
+  unlink(sp->log_path);
+  remove_directory_recursively(sp->dir, 0);
+  return status;
+}
+
 // non-recursive
 static int
 copy_all_files(
@@ -439,70 +566,33 @@ done:
 }
 
 static int
-invoke_compiler(
-        FILE *log_f,
-        const struct serve_state *cs,
-        const struct section_language_data *lang,
-        const struct compile_request_packet *req,
-        const unsigned char *input_file,
-        const unsigned char *output_file,
-        const unsigned char *working_dir,
-        const unsigned char *log_path,
-        const testinfo_t *tinf,
-        int *p_prepended_size)
+hash_file(SHA256_CTX *ctx, const unsigned char *path)
 {
-  const struct section_global_data *global = serve_state.global;
-  tpTask tsk = 0;
-
-  if (req->extra_src_dir && req->extra_src_dir[0]) {
-    int r = copy_all_files(log_f, req->extra_src_dir, working_dir);
+  unsigned char buf[65536];
+  int fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0);
+  if (fd < 0) return -1;
+  while (1) {
+    ssize_t r = read(fd, buf, sizeof(buf));
     if (r < 0) {
-      err("failed to copy extra_src_dir from %s to %s",
-          req->extra_src_dir, working_dir);
-      fprintf(log_f, "\nfailed to copy extra_src_dir %s to working_dir %s\n",
-              req->extra_src_dir, working_dir);
-      return RUN_CHECK_FAILED;
+      close(fd);
+      return -1;
     }
+    if (!r) break;
+    sha256_update(ctx, buf, r);
   }
+  close(fd);
+  sha256_update(ctx, (const unsigned char *) "\1", 1);
+  return 0;
+}
+
+static void
+setup_compiler_limits(
+        tpTask tsk,
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req)
+{
+  const struct section_global_data *global = serve_state.global;
 
-  tsk = task_New();
-  if (req->vcs_mode) {
-    unsigned char helper_path[PATH_MAX];
-    snprintf(helper_path, sizeof(helper_path),
-             "%s/ej-vcs-compile", EJUDGE_SERVER_BIN_PATH);
-    task_AddArg(tsk, helper_path);
-    task_AddArg(tsk, input_file);
-    task_AddArg(tsk, output_file);
-    task_AddArg(tsk, lang->short_name);
-    if (req->vcs_compile_cmd && req->vcs_compile_cmd[0]) {
-      task_AddArg(tsk, req->vcs_compile_cmd);
-    }
-  } else if (lang->enable_custom > 0 && req->compile_cmd && req->compile_cmd[0]) {
-    unsigned char cmd_name[PATH_MAX];
-    os_rGetLastname(req->compile_cmd, cmd_name, sizeof(cmd_name));
-    if (generic_copy_file(0, NULL, req->compile_cmd, NULL, 0, working_dir, cmd_name, NULL) < 0) {
-      err("failed to copy custom compiler '%s'", req->compile_cmd);
-      fprintf(log_f, "\nFailed to copy custom compiler '%s'\n", req->compile_cmd);
-      task_Delete(tsk);
-      return RUN_CHECK_FAILED;
-    }
-    unsigned char cmd_path[PATH_MAX];
-    if (snprintf(cmd_path, sizeof(cmd_path), "%s/%s", working_dir, cmd_name) >= (int) sizeof(cmd_path)) {
-      abort();
-    }
-    make_executable(cmd_path);
-    if (snprintf(cmd_path, sizeof(cmd_path), "./%s", cmd_name) >= (int) sizeof(cmd_path)) {
-      abort();
-    }
-    task_AddArg(tsk, cmd_path);
-    task_AddArg(tsk, input_file);
-    task_AddArg(tsk, output_file);
-  } else {
-    task_AddArg(tsk, lang->cmd);
-    task_AddArg(tsk, input_file);
-    task_AddArg(tsk, output_file);
-  }
-  task_SetPathAsArg0(tsk);
   task_EnableProcessGroup(tsk);
   if (VALID_SIZE(req->max_vm_size)) {
     task_SetVMSize(tsk, req->max_vm_size);
@@ -542,45 +632,23 @@ invoke_compiler(
     }
     task_SetLanguageName(tsk, lang->short_name);
   }
+}
 
-  if (req->env_num > 0) {
-    for (int i = 0; i < req->env_num; i++)
-      task_PutEnv(tsk, req->env_vars[i]);
-  }
-  if (tinf && tinf->compiler_env.u > 0) {
-    for (int i = 0; i < tinf->compiler_env.u; ++i)
-      task_PutEnv(tsk, tinf->compiler_env.v[i]);
-  }
-  if (req->vcs_mode) {
-    task_PutEnv(tsk, "EJUDGE_VCS_MODE=1");
-  }
-  task_SetWorkingDir(tsk, working_dir);
-  task_SetRedir(tsk, 0, TSR_FILE, "/dev/null", TSK_READ);
-  if (tinf && tinf->compiler_must_fail > 0) {
-    task_SetRedir(tsk, 1, TSR_FILE, "/dev/null", TSK_WRITE, 0777);
-  } else {
-    task_SetRedir(tsk, 1, TSR_FILE, log_path, TSK_APPEND, 0777);
-  }
-  task_SetRedir(tsk, 2, TSR_FILE, log_path, TSK_APPEND, 0777);
-  if (lang->compile_real_time_limit > 0) {
-    task_SetMaxRealTime(tsk, lang->compile_real_time_limit);
-  }
-  task_EnableAllSignals(tsk);
-
-  task_PrintArgs(tsk);
-
-  if (task_Start(tsk) < 0) {
-    err("failed to start compiler '%s'", lang->cmd);
-    fprintf(log_f, "\nFailed to start compiler '%s'\n", lang->cmd);
-    task_Delete(tsk);
-    return RUN_CHECK_FAILED;
-  }
-
-  task_Wait(tsk);
-
-  if (task_IsTimeout(tsk)) {
+static int
+make_compiler_result(
+        FILE *log_f,
+        const struct compile_request_packet *req,
+        const unsigned char *input_file,
+        const unsigned char *output_file,
+        const unsigned char *working_dir,
+        int timed_out,
+        int failed,
+        int *p_prepended_size,
+        int *p_timed_out)
+{
+  if (timed_out) {
     err("Compilation process timed out");
-    task_Delete(tsk);
+    if (p_timed_out) *p_timed_out = 1;
     if (req->not_ok_is_cf > 0) {
       fprintf(log_f, "\nCompilation process timed out\n");
       fprintf(log_f, "Check failed on non-OK result mode enabled\n");
@@ -589,9 +657,8 @@ invoke_compiler(
       fprintf(log_f, "\nCompilation process timed out\n");
       return RUN_COMPILE_ERR;
     }
-  } else if (task_IsAbnormal(tsk)) {
+  } else if (failed) {
     info("Compilation failed");
-    task_Delete(tsk);
     if (req->not_ok_is_cf > 0) {
       fprintf(log_f, "\nCompilation failed\n");
       fprintf(log_f, "Check failed on non-OK result mode enabled\n");
@@ -601,7 +668,6 @@ invoke_compiler(
     }
   } else {
     info("Compilation sucessful");
-    task_Delete(tsk);
     if (req->preserve_numbers && p_prepended_size) {
       *p_prepended_size = detect_prepended_size(working_dir, input_file, output_file);
     }
@@ -609,54 +675,1063 @@ invoke_compiler(
   }
 }
 
-static void
-save_heartbeat_file(const unsigned char *data, size_t size)
+/*
+ * The precompiled headers are kept in <compile_dir>/pch/<key>, the key
+ * is the SHA-256 of the compilation script, the language configuration
+ * file (it has the compiler version), the compiler environment and
+ * the header names. The compilation script gets the directory in
+ * EJUDGE_PCH_DIR and puts it first in the include path. GCC looks for
+ * <header>.gch before <header> and silently ignores an unusable .gch,
+ * so the diagnostics for the contestant do not change. The script is
+ * invoked with EJUDGE_PCH_BUILD set and the arguments <header> <output>
+ * to build a precompiled header. A failed build is retried after
+ * PCH_FAILED_RETRY seconds, the entries not used for PCH_UNUSED_AGE
+ * seconds are removed. In the container mode the compiler runs as
+ * another user, so the directories are world-readable.
+ */
+#define COMPILE_PCH_KEY_VERSION "ejudge-compile-pch 2"
+
+enum { PCH_FAILED_RETRY = 3600 };
+enum { PCH_UNUSED_AGE = 7 * 24 * 3600 };
+enum { PCH_TRIM_INTERVAL = 3600 };
+
+static unsigned char compile_pch_dir[PATH_MAX];
+
+static int
+make_pch_key(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const testinfo_t *tinf,
+        unsigned char *key)
 {
-  unsigned char path[PATH_MAX];
-  unsigned char dpath[PATH_MAX];
-  __attribute__((unused)) int r;
-  r = snprintf(path, sizeof(path), "%s/in/%s", heartbeat_dir, heartbeat_file_name);
-  r = snprintf(dpath, sizeof(dpath), "%s/dir/%s", heartbeat_dir, heartbeat_file_name);
-  int fd = -1;
-  void *mem = MAP_FAILED;
+  const struct section_global_data *global = serve_state.global;
+  SHA256_CTX ctx;
 
-  fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_NOFOLLOW | O_NONBLOCK | O_NOCTTY, 0666);
-  if (fd < 0) {
-    err("open '%s' failed: %s", path, os_ErrorMsg());
-    goto done;
-  }
-  if (ftruncate(fd, size) < 0) {
-    err("ftruncate '%s', %lld failed: %s", path, (long long) size, os_ErrorMsg());
-    goto done;
+  sha256_init(&ctx);
+  sha256_update(&ctx, (const unsigned char *) COMPILE_PCH_KEY_VERSION,
+                sizeof(COMPILE_PCH_KEY_VERSION));
+  if (hash_file(&ctx, lang->cmd) < 0) return -1;
+  if (global->lang_config_dir && global->lang_config_dir[0]) {
+    unsigned char cmd_name[PATH_MAX];
+    unsigned char cfg_path[PATH_MAX];
+    os_rGetLastname(lang->cmd, cmd_name, sizeof(cmd_name));
+    snprintf(cfg_path, sizeof(cfg_path), "%s/%s.cfg", global->lang_config_dir, cmd_name);
+    hash_file(&ctx, cfg_path);
+  }
+  sha256_update(&ctx, lang->compile_pch_headers, strlen(lang->compile_pch_headers) + 1);
+  sha256_update(&ctx, (const unsigned char *) &ejudge_config->enable_compile_container,
+                sizeof(ejudge_config->enable_compile_container));
+  for (int i = 0; i < req->env_num; ++i) {
+    sha256_update(&ctx, req->env_vars[i], strlen(req->env_vars[i]) + 1);
+  }
+  sha256_update(&ctx, (const unsigned char *) "\1", 1);
+  if (tinf) {
+    for (int i = 0; i < tinf->compiler_env.u; ++i) {
+      sha256_update(&ctx, tinf->compiler_env.v[i], strlen(tinf->compiler_env.v[i]) + 1);
+    }
   }
-  mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-  if (mem == MAP_FAILED) {
-    err("mmap failed: %s", os_ErrorMsg());
-    goto done;
+  sha256_final(&ctx, key);
+  return 0;
+}
+
+static int
+is_valid_pch_header(const unsigned char *s)
+{
+  if (!*s || *s == '/' || strstr(s, "..")) return 0;
+  for (; *s; ++s) {
+    if (!isalnum(*s) && *s != '_' && *s != '-' && *s != '+' && *s != '.' && *s != '/') return 0;
   }
-  close(fd); fd = -1;
+  return 1;
+}
 
-  memcpy(mem, data, size);
-  munmap(mem, size); mem = MAP_FAILED;
+static int
+build_pch_header(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const testinfo_t *tinf,
+        const unsigned char *dir,
+        const unsigned char *header)
+{
+  unsigned char out_path[PATH_MAX];
+  unsigned char out_dir[PATH_MAX];
+  unsigned char log_path[PATH_MAX];
+  tpTask tsk = NULL;
+  int retval = -1;
 
-  if (rename(path, dpath) < 0) {
-    err("rename '%s'->'%s' failed: %s", path, dpath, os_ErrorMsg());
-    goto done;
+  snprintf(out_path, sizeof(out_path), "%s/%s.gch", dir, header);
+  os_rDirName(out_path, out_dir, sizeof(out_dir));
+  if (os_MakeDirPath(out_dir, 0755) < 0) {
+    err("cannot create '%s'", out_dir);
+    return -1;
   }
-  path[0] = 0;
+  snprintf(log_path, sizeof(log_path), "%s/log", dir);
 
-  r = snprintf(path, sizeof(path), "%s/dir/%s@S", heartbeat_dir, heartbeat_file_name);
-  if (access(path, F_OK) >= 0) {
-    pending_stop_flag = 1;
-    r = unlink(path);
+  tsk = task_New();
+  task_AddArg(tsk, lang->cmd);
+  task_AddArg(tsk, header);
+  task_AddArg(tsk, out_path);
+  task_SetPathAsArg0(tsk);
+  setup_compiler_limits(tsk, lang, req);
+  for (int i = 0; i < req->env_num; i++)
+    task_PutEnv(tsk, req->env_vars[i]);
+  if (tinf) {
+    for (int i = 0; i < tinf->compiler_env.u; ++i)
+      task_PutEnv(tsk, tinf->compiler_env.v[i]);
   }
-  r = snprintf(path, sizeof(path), "%s/dir/%s@D", heartbeat_dir, heartbeat_file_name);
-  if (access(path, F_OK) >= 0) {
-    pending_down_flag = 1;
-    r = unlink(path);
+  task_SetEnv(tsk, "EJUDGE_PCH_BUILD", "1");
+  task_SetWorkingDir(tsk, dir);
+  task_SetRedir(tsk, 0, TSR_FILE, "/dev/null", TSK_READ);
+  task_SetRedir(tsk, 1, TSR_FILE, log_path, TSK_APPEND, 0777);
+  task_SetRedir(tsk, 2, TSR_FILE, log_path, TSK_APPEND, 0777);
+  if (lang->compile_real_time_limit > 0) {
+    task_SetMaxRealTime(tsk, lang->compile_real_time_limit);
   }
-  r = snprintf(path, sizeof(path), "%s/dir/%s@R", heartbeat_dir, heartbeat_file_name);
-  if (access(path, F_OK) >= 0) {
+  task_EnableAllSignals(tsk);
+  task_PrintArgs(tsk);
+  if (task_Start(tsk) < 0) {
+    err("failed to start '%s'", lang->cmd);
+    goto cleanup;
+  }
+  task_Wait(tsk);
+  if (task_IsTimeout(tsk) || task_IsAbnormal(tsk)) {
+    err("failed to precompile '%s' for language %s, see %s", header, lang->short_name, log_path);
+    goto cleanup;
+  }
+  retval = 0;
+
+cleanup:
+  task_Delete(tsk);
+  return retval;
+}
+
+/* makes the directory tree readable by the compiler in the container */
+static void
+make_pch_tree_readable(const unsigned char *dir)
+{
+  unsigned char path[PATH_MAX];
+  struct stat stb;
+  DIR *d;
+  struct dirent *dd;
+
+  if (chmod(dir, 0755) < 0) {
+    err("chmod '%s' failed: %s", dir, os_ErrorMsg());
+  }
+  if (!(d = opendir(dir))) return;
+  while ((dd = readdir(d))) {
+    if (!strcmp(dd->d_name, ".") || !strcmp(dd->d_name, "..")) continue;
+    snprintf(path, sizeof(path), "%s/%s", dir, dd->d_name);
+    if (lstat(path, &stb) < 0) continue;
+    if (S_ISDIR(stb.st_mode)) {
+      make_pch_tree_readable(path);
+    } else if (S_ISREG(stb.st_mode)) {
+      if (chmod(path, 0644) < 0) {
+        err("chmod '%s' failed: %s", path, os_ErrorMsg());
+      }
+    }
+  }
+  closedir(d);
+}
+
+/*
+ * builds the precompiled headers into a temporary directory and renames
+ * it into place, the result of a failed build is stored as well, so
+ * the build is not repeated for every compilation
+ */
+static void
+build_pch_entry(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const testinfo_t *tinf,
+        const unsigned char *entry_dir)
+{
+  unsigned char tmp_dir[PATH_MAX];
+  unsigned char path[PATH_MAX];
+  struct stat stb;
+  char *headers = NULL, *saveptr = NULL, *h;
+  int failed = 0;
+
+  if (os_MakeDirPath(compile_pch_dir, 0755) < 0) {
+    err("cannot create '%s'", compile_pch_dir);
+    return;
+  }
+  // might be created with the restrictive mode by the older version
+  if (chmod(compile_pch_dir, 0755) < 0) {
+    err("chmod '%s' failed: %s", compile_pch_dir, os_ErrorMsg());
+  }
+  snprintf(tmp_dir, sizeof(tmp_dir), "%s/.tmp.%d", compile_pch_dir, (int) getpid());
+  if (lstat(tmp_dir, &stb) >= 0) {
+    remove_directory_recursively(tmp_dir, 0);
+  }
+  if (mkdir(tmp_dir, 0755) < 0) {
+    err("mkdir '%s' failed: %s", tmp_dir, os_ErrorMsg());
+    return;
+  }
+
+  info("building precompiled headers '%s' for language %s", lang->compile_pch_headers, lang->short_name);
+  headers = xstrdup(lang->compile_pch_headers);
+  for (h = strtok_r(headers, " \t", &saveptr); h; h = strtok_r(NULL, " \t", &saveptr)) {
+    if (!is_valid_pch_header(h)) {
+      err("invalid header name '%s' in compile_pch_headers", h);
+      failed = 1;
+      break;
+    }
+    if (build_pch_header(lang, req, tinf, tmp_dir, h) < 0) {
+      failed = 1;
+      break;
+    }
+  }
+  xfree(headers);
+
+  if (failed) {
+    snprintf(path, sizeof(path), "%s/failed", tmp_dir);
+    generic_write_file("", 0, 0, NULL, path, "");
+  } else {
+    snprintf(path, sizeof(path), "%s/log", tmp_dir);
+    unlink(path);
+  }
+  // the modes set by mkdir and the compiler are subject to umask
+  make_pch_tree_readable(tmp_dir);
+  if (rename(tmp_dir, entry_dir) < 0) {
+    // the same headers might be built concurrently
+    remove_directory_recursively(tmp_dir, 0);
+  }
+}
+
+/* removes the entries and the temporary directories not used for long */
+static void
+trim_pch_dir(void)
+{
+  unsigned char path[PATH_MAX];
+  struct stat stb;
+  DIR *d;
+  struct dirent *dd;
+  time_t now = time(NULL);
+
+  snprintf(path, sizeof(path), "%s/.trim", compile_pch_dir);
+  if (stat(path, &stb) >= 0 && stb.st_mtime + PCH_TRIM_INTERVAL > now) return;
+  // only one process scans the directory at a time
+  if (generic_write_file("", 0, 0, NULL, path, "") < 0) return;
+
+  if (!(d = opendir(compile_pch_dir))) return;
+  while ((dd = readdir(d))) {
+    if (!strcmp(dd->d_name, ".") || !strcmp(dd->d_name, "..") || !strcmp(dd->d_name, ".trim")) continue;
+    snprintf(path, sizeof(path), "%s/%s", compile_pch_dir, dd->d_name);
+    if (lstat(path, &stb) < 0 || !S_ISDIR(stb.st_mode)) continue;
+    // the entry directory time is updated when the entry is used
+    if (stb.st_mtime + PCH_UNUSED_AGE < now) {
+      remove_directory_recursively(path, 0);
+    }
+  }
+  closedir(d);
+}
+
+/*
+ * returns 1 and the directory with the precompiled headers,
+ * if they are enabled for the language and could be built
+ */
+static int
+prepare_pch_dir(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const testinfo_t *tinf,
+        unsigned char *pch_dir,
+        size_t pch_dir_size)
+{
+  unsigned char key[32];
+  unsigned char entry_dir[PATH_MAX];
+  unsigned char path[PATH_MAX];
+  struct stat stb;
+
+  if (!compile_pch_dir[0]) return 0;
+  if (!lang->compile_pch_headers || !lang->compile_pch_headers[0]) return 0;
+  if (make_pch_key(lang, req, tinf, key) < 0) return 0;
+  snprintf(entry_dir, sizeof(entry_dir), "%s/%s", compile_pch_dir, unparse_sha256(key));
+  snprintf(path, sizeof(path), "%s/failed", entry_dir);
+  if (stat(path, &stb) >= 0 && stb.st_mtime + PCH_FAILED_RETRY < time(NULL)) {
+    // the failure might be temporary, so the build is retried
+    remove_directory_recursively(entry_dir, 0);
+  }
+  if (stat(entry_dir, &stb) < 0) {
+    build_pch_entry(lang, req, tinf, entry_dir);
+    trim_pch_dir();
+    if (stat(entry_dir, &stb) < 0) return 0;
+  }
+  if (!S_ISDIR(stb.st_mode)) return 0;
+  if (access(path, F_OK) >= 0) return 0;
+  if (stb.st_mtime + PCH_TRIM_INTERVAL < time(NULL)) {
+    // keeps the entry from being trimmed
+    utimes(entry_dir, NULL);
+  }
+  if (snprintf(pch_dir, pch_dir_size, "%s", entry_dir) >= pch_dir_size) return 0;
+  return 1;
+}
+
+/*
+ * The compiler daemons keep the compiler (JVM, .NET runtime) warm
+ * between the compilations. A daemon is started with the same memory
+ * limits as the compilation script, but without the CPU and real time
+ * limits of the compilation container, each job is limited by
+ * ej-compile instead. Its stdin and stdout are connected to
+ * a unix socket. A job is a sequence of lines ending with an empty line:
+ *   dir <working directory>
+ *   src <source file>
+ *   exe <executable file>
+ *   log <file to append the compiler messages to>
+ *   env <NAME=VALUE>      (zero or more lines)
+ * The daemon replies with a line with the exit code of the compilation,
+ * 0 means success. The daemon exits on EOF.
+ */
+enum { COMPILE_DAEMON_DEFAULT_MAX_JOBS = 100 };
+
+struct compile_daemon
+{
+  tpTask tsk;
+  int fd;
+  int job_count;
+  unsigned char *working_dir;
+};
+
+// indexed by the language id
+static struct compile_daemon *compile_daemons;
+static int compile_daemons_size;
+// the supervisor worker processes are short-lived
+static int compile_daemons_disabled;
+
+static void
+stop_compile_daemon(struct compile_daemon *d)
+{
+  if (d->fd >= 0) close(d->fd);
+  if (d->tsk) {
+    task_KillProcessGroup(d->tsk);
+    task_Wait(d->tsk);
+    task_Delete(d->tsk);
+  }
+  xfree(d->working_dir);
+  memset(d, 0, sizeof(*d));
+  d->fd = -1;
+}
+
+static void
+stop_all_compile_daemons(void)
+{
+  for (int i = 0; i < compile_daemons_size; ++i) {
+    if (compile_daemons[i].tsk) {
+      stop_compile_daemon(&compile_daemons[i]);
+    }
+  }
+}
+
+static int
+can_use_compile_daemon(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const testinfo_t *tinf)
+{
+  if (compile_daemons_disabled) return 0;
+  if (!lang->compile_daemon_cmd || !lang->compile_daemon_cmd[0]) return 0;
+  if (req->vcs_mode) return 0;
+  if (lang->enable_custom > 0 && req->compile_cmd && req->compile_cmd[0]) return 0;
+  if (tinf && tinf->compiler_must_fail > 0) return 0;
+  // the daemon is started with the limits of the language
+  if (VALID_SIZE(req->max_vm_size) || VALID_SIZE(req->max_stack_size)
+      || VALID_SIZE(req->max_file_size) || VALID_SIZE(req->max_rss_size)) {
+    return 0;
+  }
+  if (req->container_options && req->container_options[0]) return 0;
+  return 1;
+}
+
+static long long
+get_process_rss(int pid)
+{
+  unsigned char path[PATH_MAX];
+  char buf[1024];
+  long long rss = -1;
+
+  snprintf(path, sizeof(path), "/proc/%d/status", pid);
+  FILE *f = fopen(path, "r");
+  if (!f) return -1;
+  while (fgets(buf, sizeof(buf), f)) {
+    if (!strncmp(buf, "VmRSS:", 6)) {
+      rss = strtoll(buf + 6, NULL, 10) * 1024;
+      break;
+    }
+  }
+  fclose(f);
+  return rss;
+}
+
+static int
+get_process_ppid(int pid)
+{
+  unsigned char path[PATH_MAX];
+  char buf[1024];
+  int ppid = -1;
+
+  snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+  FILE *f = fopen(path, "r");
+  if (!f) return -1;
+  if (fgets(buf, sizeof(buf), f)) {
+    // the command name may contain spaces and parentheses
+    char *p = strrchr(buf, ')');
+    if (p && sscanf(p + 1, " %*c %d", &ppid) != 1) ppid = -1;
+  }
+  fclose(f);
+  return ppid;
+}
+
+/*
+ * the total RSS of the descendants of 'pid', and of 'pid' itself,
+ * unless 'skip_root' is set: in the container mode the task process
+ * is ej-suid-container, and the daemon runs as its descendant
+ */
+static long long
+get_process_tree_rss(int pid, int skip_root)
+{
+  DIR *d;
+  struct dirent *dd;
+  int *pids = NULL, *ppids = NULL;
+  unsigned char *marks = NULL;
+  int a = 0, u = 0;
+  long long total = 0;
+
+  if (!(d = opendir("/proc"))) return -1;
+  while ((dd = readdir(d))) {
+    char *eptr = NULL;
+    errno = 0;
+    long v = strtol(dd->d_name, &eptr, 10);
+    if (errno || *eptr || v <= 0 || v > INT_MAX) continue;
+    int ppid = get_process_ppid(v);
+    if (ppid < 0) continue;
+    if (u == a) {
+      if (!(a *= 2)) a = 256;
+      XREALLOC(pids, a);
+      XREALLOC(ppids, a);
+    }
+    pids[u] = v;
+    ppids[u] = ppid;
+    ++u;
+  }
+  closedir(d);
+
+  // the tree is collected in several passes, as /proc is not ordered by parent
+  XCALLOC(marks, u + 1);
+  int changed = 1;
+  while (changed) {
+    changed = 0;
+    for (int i = 0; i < u; ++i) {
+      if (marks[i]) continue;
+      int in_tree = (pids[i] == pid);
+      for (int j = 0; !in_tree && j < u; ++j) {
+        in_tree = marks[j] && pids[j] == ppids[i];
+      }
+      if (in_tree) {
+        marks[i] = 1;
+        changed = 1;
+      }
+    }
+  }
+  for (int i = 0; i < u; ++i) {
+    if (!marks[i] || (skip_root && pids[i] == pid)) continue;
+    long long rss = get_process_rss(pids[i]);
+    if (rss > 0) total += rss;
+  }
+
+  xfree(marks);
+  xfree(ppids);
+  xfree(pids);
+  return total;
+}
+
+static struct compile_daemon *
+start_compile_daemon(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const unsigned char *working_dir)
+{
+  struct compile_daemon *d;
+  int sfd[2] = { -1, -1 };
+
+  if (lang->id >= compile_daemons_size) {
+    int new_size = compile_daemons_size;
+    if (!new_size) new_size = 16;
+    while (lang->id >= new_size) new_size *= 2;
+    XREALLOC(compile_daemons, new_size);
+    memset(&compile_daemons[compile_daemons_size], 0,
+           (new_size - compile_daemons_size) * sizeof(compile_daemons[0]));
+    for (int i = compile_daemons_size; i < new_size; ++i) {
+      compile_daemons[i].fd = -1;
+    }
+    compile_daemons_size = new_size;
+  }
+  d = &compile_daemons[lang->id];
+  if (d->tsk) {
+    if (!strcmp(d->working_dir, working_dir)) return d;
+    stop_compile_daemon(d);
+  }
+
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sfd) < 0) {
+    err("socketpair failed: %s", os_ErrorMsg());
+    return NULL;
+  }
+
+  tpTask tsk = task_New();
+  task_AddArg(tsk, lang->compile_daemon_cmd);
+  task_SetPathAsArg0(tsk);
+  setup_compiler_limits(tsk, lang, req);
+  if (ejudge_config->enable_compile_container) {
+    // the compilation time limits would kill the long-living daemon
+    task_AppendContainerOptions(tsk, "mamb");
+  }
+  task_SetWorkingDir(tsk, working_dir);
+  task_SetRedir(tsk, 0, TSR_DUP, sfd[1]);
+  task_SetRedir(tsk, 1, TSR_DUP, sfd[1]);
+  task_EnableAllSignals(tsk);
+  task_PrintArgs(tsk);
+  if (task_Start(tsk) < 0) {
+    err("failed to start compiler daemon '%s'", lang->compile_daemon_cmd);
+    task_Delete(tsk);
+    close(sfd[0]);
+    close(sfd[1]);
+    return NULL;
+  }
+  close(sfd[1]);
+
+  info("compiler daemon '%s' started, pid %d", lang->compile_daemon_cmd, task_GetPid(tsk));
+  d->tsk = tsk;
+  d->fd = sfd[0];
+  d->job_count = 0;
+  d->working_dir = xstrdup(working_dir);
+  return d;
+}
+
+/*
+ * returns -1, if the daemon is unavailable, and the compilation
+ * script should be used
+ */
+static int
+run_compile_daemon(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const testinfo_t *tinf,
+        const unsigned char *input_file,
+        const unsigned char *output_file,
+        const unsigned char *working_dir,
+        const unsigned char *log_path,
+        int *p_exit_code,
+        int *p_timed_out)
+{
+  char *job_s = NULL;
+  size_t job_z = 0;
+  FILE *job_f = NULL;
+  struct compile_daemon *d = NULL;
+  char reply[64];
+  int reply_len = 0;
+
+  // the protocol is line-based
+  if (strchr(working_dir, '\n') || strchr(input_file, '\n')
+      || strchr(output_file, '\n') || strchr(log_path, '\n')) {
+    return -1;
+  }
+  for (int i = 0; i < req->env_num; ++i) {
+    if (strchr(req->env_vars[i], '\n')) return -1;
+  }
+  if (tinf) {
+    for (int i = 0; i < tinf->compiler_env.u; ++i) {
+      if (strchr(tinf->compiler_env.v[i], '\n')) return -1;
+    }
+  }
+
+  if (!(d = start_compile_daemon(lang, req, working_dir))) return -1;
+
+  job_f = open_memstream(&job_s, &job_z);
+  fprintf(job_f, "dir %s\nsrc %s\nexe %s\nlog %s\n", working_dir, input_file, output_file, log_path);
+  for (int i = 0; i < req->env_num; ++i) {
+    fprintf(job_f, "env %s\n", req->env_vars[i]);
+  }
+  if (tinf) {
+    for (int i = 0; i < tinf->compiler_env.u; ++i) {
+      fprintf(job_f, "env %s\n", tinf->compiler_env.v[i]);
+    }
+  }
+  fprintf(job_f, "\n");
+  fclose(job_f); job_f = NULL;
+
+  for (size_t off = 0; off < job_z; ) {
+    ssize_t w = send(d->fd, job_s + off, job_z - off, MSG_NOSIGNAL);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      err("compiler daemon '%s': write failed: %s", lang->compile_daemon_cmd, os_ErrorMsg());
+      goto fail;
+    }
+    off += w;
+  }
+  xfree(job_s); job_s = NULL;
+
+  long long deadline_ms = 0;
+  if (lang->compile_real_time_limit > 0) {
+    deadline_ms = get_current_time_ms() + lang->compile_real_time_limit * 1000LL;
+  }
+  while (1) {
+    int timeout_ms = -1;
+    if (deadline_ms > 0) {
+      long long now_ms = get_current_time_ms();
+      if (now_ms >= deadline_ms) {
+        // the daemon may hang on the same job, so it is restarted
+        err("compiler daemon '%s': job timed out", lang->compile_daemon_cmd);
+        stop_compile_daemon(d);
+        *p_timed_out = 1;
+        return 0;
+      }
+      timeout_ms = deadline_ms - now_ms;
+    }
+    struct pollfd pfd = { .fd = d->fd, .events = POLLIN };
+    int r = poll(&pfd, 1, timeout_ms);
+    if (r < 0) {
+      if (errno == EINTR) continue;
+      err("compiler daemon '%s': poll failed: %s", lang->compile_daemon_cmd, os_ErrorMsg());
+      goto fail;
+    }
+    if (!r) continue;
+    ssize_t rr = read(d->fd, reply + reply_len, sizeof(reply) - 1 - reply_len);
+    if (rr < 0) {
+      if (errno == EINTR) continue;
+      err("compiler daemon '%s': read failed: %s", lang->compile_daemon_cmd, os_ErrorMsg());
+      goto fail;
+    }
+    if (!rr) {
+      err("compiler daemon '%s': unexpected EOF", lang->compile_daemon_cmd);
+      goto fail;
+    }
+    reply_len += rr;
+    reply[reply_len] = 0;
+    if (strchr(reply, '\n')) break;
+    if (reply_len >= (int) sizeof(reply) - 1) {
+      err("compiler daemon '%s': invalid reply", lang->compile_daemon_cmd);
+      goto fail;
+    }
+  }
+
+  char *eptr = NULL;
+  errno = 0;
+  long exit_code = strtol(reply, &eptr, 10);
+  if (errno || eptr == reply || *eptr != '\n') {
+    err("compiler daemon '%s': invalid reply", lang->compile_daemon_cmd);
+    goto fail;
+  }
+  *p_exit_code = exit_code;
+
+  ++d->job_count;
+  int max_jobs = lang->compile_daemon_max_jobs;
+  if (max_jobs <= 0) max_jobs = COMPILE_DAEMON_DEFAULT_MAX_JOBS;
+  if (d->job_count >= max_jobs) {
+    info("compiler daemon '%s': %d jobs done, restarting", lang->compile_daemon_cmd, d->job_count);
+    stop_compile_daemon(d);
+  } else if (lang->compile_daemon_max_rss > 0) {
+    long long rss = get_process_tree_rss(task_GetPid(d->tsk),
+                                         ejudge_config->enable_compile_container);
+    if (rss > (long long) lang->compile_daemon_max_rss) {
+      info("compiler daemon '%s': RSS %lld exceeds the limit, restarting", lang->compile_daemon_cmd, rss);
+      stop_compile_daemon(d);
+    }
+  }
+  return 0;
+
+fail:
+  xfree(job_s);
+  stop_compile_daemon(d);
+  return -1;
+}
+
+static int
+invoke_compiler(
+        FILE *log_f,
+        const struct serve_state *cs,
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const unsigned char *input_file,
+        const unsigned char *output_file,
+        const unsigned char *working_dir,
+        const unsigned char *log_path,
+        const testinfo_t *tinf,
+        int *p_prepended_size,
+        int *p_timed_out)
+{
+  tpTask tsk = 0;
+  unsigned char pch_dir[PATH_MAX];
+
+  if (req->extra_src_dir && req->extra_src_dir[0]) {
+    int r = copy_all_files(log_f, req->extra_src_dir, working_dir);
+    if (r < 0) {
+      err("failed to copy extra_src_dir from %s to %s",
+          req->extra_src_dir, working_dir);
+      fprintf(log_f, "\nfailed to copy extra_src_dir %s to working_dir %s\n",
+              req->extra_src_dir, working_dir);
+      return RUN_CHECK_FAILED;
+    }
+  }
+
+  if (can_use_compile_daemon(lang, req, tinf)) {
+    int exit_code = 0, timed_out = 0;
+    if (run_compile_daemon(lang, req, tinf, input_file, output_file, working_dir,
+                           log_path, &exit_code, &timed_out) >= 0) {
+      return make_compiler_result(log_f, req, input_file, output_file, working_dir,
+                                  timed_out, exit_code != 0, p_prepended_size, p_timed_out);
+    }
+    // fall back to the compilation script
+  }
+
+  tsk = task_New();
+  if (req->vcs_mode) {
+    unsigned char helper_path[PATH_MAX];
+    snprintf(helper_path, sizeof(helper_path),
+             "%s/ej-vcs-compile", EJUDGE_SERVER_BIN_PATH);
+    task_AddArg(tsk, helper_path);
+    task_AddArg(tsk, input_file);
+    task_AddArg(tsk, output_file);
+    task_AddArg(tsk, lang->short_name);
+    if (req->vcs_compile_cmd && req->vcs_compile_cmd[0]) {
+      task_AddArg(tsk, req->vcs_compile_cmd);
+    }
+  } else if (lang->enable_custom > 0 && req->compile_cmd && req->compile_cmd[0]) {
+    unsigned char cmd_name[PATH_MAX];
+    os_rGetLastname(req->compile_cmd, cmd_name, sizeof(cmd_name));
+    if (generic_copy_file(0, NULL, req->compile_cmd, NULL, 0, working_dir, cmd_name, NULL) < 0) {
+      err("failed to copy custom compiler '%s'", req->compile_cmd);
+      fprintf(log_f, "\nFailed to copy custom compiler '%s'\n", req->compile_cmd);
+      task_Delete(tsk);
+      return RUN_CHECK_FAILED;
+    }
+    unsigned char cmd_path[PATH_MAX];
+    if (snprintf(cmd_path, sizeof(cmd_path), "%s/%s", working_dir, cmd_name) >= (int) sizeof(cmd_path)) {
+      abort();
+    }
+    make_executable(cmd_path);
+    if (snprintf(cmd_path, sizeof(cmd_path), "./%s", cmd_name) >= (int) sizeof(cmd_path)) {
+      abort();
+    }
+    task_AddArg(tsk, cmd_path);
+    task_AddArg(tsk, input_file);
+    task_AddArg(tsk, output_file);
+  } else {
+    task_AddArg(tsk, lang->cmd);
+    task_AddArg(tsk, input_file);
+    task_AddArg(tsk, output_file);
+    if (prepare_pch_dir(lang, req, tinf, pch_dir, sizeof(pch_dir))) {
+      task_SetEnv(tsk, "EJUDGE_PCH_DIR", pch_dir);
+    }
+  }
+  task_SetPathAsArg0(tsk);
+  setup_compiler_limits(tsk, lang, req);
+
+  if (req->env_num > 0) {
+    for (int i = 0; i < req->env_num; i++)
+      task_PutEnv(tsk, req->env_vars[i]);
+  }
+  if (tinf && tinf->compiler_env.u > 0) {
+    for (int i = 0; i < tinf->compiler_env.u; ++i)
+      task_PutEnv(tsk, tinf->compiler_env.v[i]);
+  }
+  if (req->vcs_mode) {
+    task_PutEnv(tsk, "EJUDGE_VCS_MODE=1");
+  }
+  task_SetWorkingDir(tsk, working_dir);
+  task_SetRedir(tsk, 0, TSR_FILE, "/dev/null", TSK_READ);
+  if (tinf && tinf->compiler_must_fail > 0) {
+    task_SetRedir(tsk, 1, TSR_FILE, "/dev/null", TSK_WRITE, 0777);
+  } else {
+    task_SetRedir(tsk, 1, TSR_FILE, log_path, TSK_APPEND, 0777);
+  }
+  task_SetRedir(tsk, 2, TSR_FILE, log_path, TSK_APPEND, 0777);
+  if (lang->compile_real_time_limit > 0) {
+    task_SetMaxRealTime(tsk, lang->compile_real_time_limit);
+  }
+  task_EnableAllSignals(tsk);
+
+  task_PrintArgs(tsk);
+
+  if (task_Start(tsk) < 0) {
+    err("failed to start compiler '%s'", lang->cmd);
+    fprintf(log_f, "\nFailed to start compiler '%s'\n", lang->cmd);
+    task_Delete(tsk);
+    return RUN_CHECK_FAILED;
+  }
+
+  if (style_pipeline) {
+    // the compilation is not needed, if the style check fails
+    int r = wait_style_pipeline(style_pipeline);
+    if (r != RUN_OK) {
+      info("style check failed, compilation is cancelled");
+      task_KillProcessGroup(tsk);
+      task_Wait(tsk);
+      task_Delete(tsk);
+      return r;
+    }
+  }
+  task_Wait(tsk);
+
+  int timed_out = task_IsTimeout(tsk);
+  int failed = task_IsAbnormal(tsk);
+  task_Delete(tsk);
+  return make_compiler_result(log_f, req, input_file, output_file, working_dir,
+                              timed_out, failed, p_prepended_size, p_timed_out);
+}
+
+#define COMPILE_CACHE_KEY_VERSION "ejudge-compile-cache 1"
+
+/*
+ * the compilation result depends on the source, the compilation script,
+ * the language configuration file (it has the compiler path and version),
+ * the compiler environment and the limits
+ */
+static int
+make_compile_cache_key(
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const unsigned char *src_path,
+        unsigned char *key)
+{
+  const struct section_global_data *global = serve_state.global;
+  SHA256_CTX ctx;
+  unsigned char buf[1024];
+  int len;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, (const unsigned char *) COMPILE_CACHE_KEY_VERSION,
+                sizeof(COMPILE_CACHE_KEY_VERSION));
+  if (hash_file(&ctx, src_path) < 0) return -1;
+  if (!lang->cmd || hash_file(&ctx, lang->cmd) < 0) return -1;
+  if (global->lang_config_dir && global->lang_config_dir[0]) {
+    unsigned char cmd_name[PATH_MAX];
+    unsigned char cfg_path[PATH_MAX];
+    os_rGetLastname(lang->cmd, cmd_name, sizeof(cmd_name));
+    snprintf(cfg_path, sizeof(cfg_path), "%s/%s.cfg", global->lang_config_dir, cmd_name);
+    // the configuration file is optional
+    hash_file(&ctx, cfg_path);
+  }
+  sha256_update(&ctx, (const unsigned char *) "\2", 1);
+
+  len = snprintf(buf, sizeof(buf),
+                 "%s\1%s\1%s\1%d\1%d\1%lld %lld %lld %lld\1%lld %lld %lld %lld\1%lld %lld %lld %lld\1",
+                 lang->short_name, lang->src_sfx, lang->exe_sfx,
+                 req->preserve_numbers, ejudge_config->enable_compile_container,
+                 (long long) req->max_vm_size, (long long) req->max_stack_size,
+                 (long long) req->max_file_size, (long long) req->max_rss_size,
+                 (long long) lang->max_vm_size, (long long) lang->max_stack_size,
+                 (long long) lang->max_file_size, (long long) lang->max_rss_size,
+                 (long long) global->compile_max_vm_size,
+                 (long long) global->compile_max_stack_size,
+                 (long long) global->compile_max_file_size,
+                 (long long) global->compile_max_rss_size);
+  sha256_update(&ctx, buf, len);
+  if (req->container_options) {
+    sha256_update(&ctx, req->container_options, strlen(req->container_options));
+  }
+  sha256_update(&ctx, (const unsigned char *) "\1", 1);
+  for (int i = 0; i < req->env_num; ++i) {
+    sha256_update(&ctx, req->env_vars[i], strlen(req->env_vars[i]) + 1);
+  }
+  sha256_final(&ctx, key);
+  return 0;
+}
+
+/*
+ * the cache entry has the files: 'status' with the status and the
+ * prepended size, 'log' with the compiler output, and 'exe'
+ */
+static int
+use_cached_compile_result(
+        FILE *log_f,
+        const unsigned char *entry_dir,
+        const unsigned char *working_dir,
+        const unsigned char *output_file,
+        int *p_prepended_size)
+{
+  unsigned char path[PATH_MAX];
+  unsigned char exe_path[PATH_MAX];
+  char *text = NULL;
+  size_t size = 0;
+  int status = -1, prepended_size = 0;
+
+  snprintf(path, sizeof(path), "%s/status", entry_dir);
+  if (generic_read_file(&text, 0, &size, 0, NULL, path, "") < 0) return -1;
+  if (sscanf(text, "%d%d", &status, &prepended_size) != 2
+      || (status != RUN_OK && status != RUN_COMPILE_ERR)) {
+    xfree(text);
+    return -1;
+  }
+  xfree(text); text = NULL; size = 0;
+
+  if (status == RUN_OK) {
+    snprintf(path, sizeof(path), "%s/exe", entry_dir);
+    snprintf(exe_path, sizeof(exe_path), "%s/%s", working_dir, output_file);
+    if (rename(path, exe_path) < 0) {
+      err("rename %s -> %s failed: %s", path, exe_path, os_ErrorMsg());
+      return -1;
+    }
+    make_executable(exe_path);
+  }
+
+  snprintf(path, sizeof(path), "%s/log", entry_dir);
+  if (generic_read_file(&text, 0, &size, 0, NULL, path, "") >= 0) {
+    fwrite(text, 1, size, log_f);
+    fflush(log_f);
+    xfree(text);
+  }
+
+  if (p_prepended_size) *p_prepended_size = prepended_size;
+  return status;
+}
+
+static void
+store_compile_result(
+        const unsigned char *key,
+        const unsigned char *entry_dir,
+        int status,
+        int prepended_size,
+        const unsigned char *log_path,
+        long long log_start,
+        const unsigned char *exe_path)
+{
+  unsigned char path[PATH_MAX];
+  unsigned char buf[64];
+  char *text = NULL;
+  size_t size = 0;
+
+  if (make_dir(entry_dir, 0700) < 0) return;
+
+  snprintf(buf, sizeof(buf), "%d %d\n", status, prepended_size);
+  snprintf(path, sizeof(path), "%s/status", entry_dir);
+  if (generic_write_file(buf, strlen(buf), 0, NULL, path, "") < 0) goto cleanup;
+
+  if (generic_read_file(&text, 0, &size, 0, NULL, log_path, "") < 0) goto cleanup;
+  if (log_start > (long long) size) log_start = size;
+  snprintf(path, sizeof(path), "%s/log", entry_dir);
+  if (generic_write_file(text + log_start, size - log_start, 0, NULL, path, "") < 0) goto cleanup;
+
+  if (status == RUN_OK) {
+    snprintf(path, sizeof(path), "%s/exe", entry_dir);
+    if (fast_copy_file(exe_path, path) < 0) goto cleanup;
+  }
+
+  test_gen_cache_store(compile_cache_dir, key, entry_dir, compile_cache_size);
+
+cleanup:
+  xfree(text);
+  remove_directory_recursively(entry_dir, 0);
+}
+
+/*
+ * invokes the compiler, unless the result of the same compilation
+ * is already in the compile cache
+ */
+static int
+invoke_compiler_cached(
+        FILE *log_f,
+        const struct serve_state *cs,
+        const struct section_language_data *lang,
+        const struct compile_request_packet *req,
+        const unsigned char *input_file,
+        const unsigned char *output_file,
+        const unsigned char *working_dir,
+        const unsigned char *log_path,
+        int *p_prepended_size)
+{
+  unsigned char key[32];
+  unsigned char src_path[PATH_MAX];
+  unsigned char exe_path[PATH_MAX];
+  unsigned char entry_dir[PATH_MAX];
+  struct stat stb;
+  long long log_start = 0;
+  int timed_out = 0;
+  int r;
+
+  // the custom compilers and the extra files are not taken into account
+  if (compile_cache_size <= 0 || req->vcs_mode > 0
+      || (req->extra_src_dir && req->extra_src_dir[0])
+      || (lang->enable_custom > 0 && req->compile_cmd && req->compile_cmd[0])) {
+    return invoke_compiler(log_f, cs, lang, req, input_file, output_file, working_dir, log_path, NULL, p_prepended_size, NULL);
+  }
+  snprintf(src_path, sizeof(src_path), "%s/%s", working_dir, input_file);
+  if (make_compile_cache_key(lang, req, src_path, key) < 0) {
+    return invoke_compiler(log_f, cs, lang, req, input_file, output_file, working_dir, log_path, NULL, p_prepended_size, NULL);
+  }
+
+  snprintf(entry_dir, sizeof(entry_dir), "%s/%llx.cache", working_dir, random_u64());
+  if (make_dir(entry_dir, 0700) >= 0) {
+    r = -1;
+    if (test_gen_cache_lookup(compile_cache_dir, key, entry_dir) > 0) {
+      r = use_cached_compile_result(log_f, entry_dir, working_dir, output_file, p_prepended_size);
+    }
+    remove_directory_recursively(entry_dir, 0);
+    if (r >= 0) {
+      info("compilation result for run %d is found in the cache", req->run_id);
+      return r;
+    }
+  }
+
+  fflush(log_f);
+  if (stat(log_path, &stb) >= 0) log_start = stb.st_size;
+  r = invoke_compiler(log_f, cs, lang, req, input_file, output_file, working_dir, log_path, NULL, p_prepended_size, &timed_out);
+  // a timeout depends on the load of the host
+  if ((r == RUN_OK || r == RUN_COMPILE_ERR) && !timed_out) {
+    fflush(log_f);
+    snprintf(exe_path, sizeof(exe_path), "%s/%s", working_dir, output_file);
+    store_compile_result(key, entry_dir, r,
+                         p_prepended_size ? *p_prepended_size : 0,
+                         log_path, log_start, exe_path);
+  }
+  return r;
+}
+
+static void
+save_heartbeat_file(const unsigned char *data, size_t size)
+{
+  unsigned char path[PATH_MAX];
+  unsigned char dpath[PATH_MAX];
+  __attribute__((unused)) int r;
+  r = snprintf(path, sizeof(path), "%s/in/%s", heartbeat_dir, heartbeat_file_name);
+  r = snprintf(dpath, sizeof(dpath), "%s/dir/%s", heartbeat_dir, heartbeat_file_name);
+  int fd = -1;
+  void *mem = MAP_FAILED;
+
+  fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_NOFOLLOW | O_NONBLOCK | O_NOCTTY, 0666);
+  if (fd < 0) {
+    err("open '%s' failed: %s", path, os_ErrorMsg());
+    goto done;
+  }
+  if (ftruncate(fd, size) < 0) {
+    err("ftruncate '%s', %lld failed: %s", path, (long long) size, os_ErrorMsg());
+    goto done;
+  }
+  mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mem == MAP_FAILED) {
+    err("mmap failed: %s", os_ErrorMsg());
+    goto done;
+  }
+  close(fd); fd = -1;
+
+  memcpy(mem, data, size);
+  munmap(mem, size); mem = MAP_FAILED;
+
+  if (rename(path, dpath) < 0) {
+    err("rename '%s'->'%s' failed: %s", path, dpath, os_ErrorMsg());
+    goto done;
+  }
+  path[0] = 0;
+
+  r = snprintf(path, sizeof(path), "%s/dir/%s@S", heartbeat_dir, heartbeat_file_name);
+  if (access(path, F_OK) >= 0) {
+    pending_stop_flag = 1;
+    r = unlink(path);
+  }
+  r = snprintf(path, sizeof(path), "%s/dir/%s@D", heartbeat_dir, heartbeat_file_name);
+  if (access(path, F_OK) >= 0) {
+    pending_down_flag = 1;
+    r = unlink(path);
+  }
+  r = snprintf(path, sizeof(path), "%s/dir/%s@R", heartbeat_dir, heartbeat_file_name);
+  if (access(path, F_OK) >= 0) {
     pending_reboot_flag = 1;
     r = unlink(path);
   }
@@ -904,10 +1979,23 @@ handle_packet(
     */
 
     if (req->style_check_only <= 0) {
-      int r = invoke_compiler(log_f, cs, lang, req, src_work_name, exe_work_name, working_dir, log_work_path, NULL, &prepended_size);
+      struct style_pipeline sp;
+      int use_pipeline = 0;
+      if (style_pipeline_mode > 0 && req->vcs_mode <= 0 && req->style_checker && req->style_checker[0]
+          && start_style_pipeline(&sp, log_f, lang, req, working_dir, src_work_name) >= 0) {
+        use_pipeline = 1;
+        style_pipeline = &sp;
+      }
+      int r = invoke_compiler_cached(log_f, cs, lang, req, src_work_name, exe_work_name, working_dir, log_work_path, &prepended_size);
+      style_pipeline = NULL;
+      if (use_pipeline) {
+        int sc = finish_style_pipeline(&sp, log_f);
+        if (sc != RUN_OK && r != RUN_CHECK_FAILED) r = sc;
+      }
       rpl->status = r;
       if (r != RUN_OK) goto cleanup;
       rpl->prepended_size = prepended_size;
+      if (use_pipeline) goto cleanup;
     }
 
     if (req->vcs_mode <= 0 && req->style_checker && req->style_checker[0]) {
@@ -1145,7 +2233,7 @@ handle_packet(
     if (cur_status == RUN_OK) {
       fprintf(log_f, "=== compilation for test %d ===\n", serial);
       fflush(log_f);
-      cur_status = invoke_compiler(log_f, cs, lang, req, test_src_name, test_exe_name, working_dir, log_work_path, tinf, &prepended_size);
+      cur_status = invoke_compiler(log_f, cs, lang, req, test_src_name, test_exe_name, working_dir, log_work_path, tinf, &prepended_size, NULL);
       // valid statuses: RUN_OK, RUN_COMPILE_ERR, RUN_CHECK_FAILED
       if (cur_status == RUN_CHECK_FAILED) {
         status = RUN_CHECK_FAILED;
@@ -1194,7 +2282,7 @@ handle_packet(
                 fprintf(log_f, "failed to write full source file '%s'\n", test_src_path);
                 status = RUN_CHECK_FAILED;
               } else {
-                cur_status = invoke_compiler(log_f, cs, lang, req, test_src_name, test_exe_name, working_dir, log_work_path, tinf, &prepended_size);
+                cur_status = invoke_compiler(log_f, cs, lang, req, test_src_name, test_exe_name, working_dir, log_work_path, tinf, &prepended_size, NULL);
 
                 if (cur_status == RUN_CHECK_FAILED) {
                   status = RUN_CHECK_FAILED;
@@ -1328,139 +2416,559 @@ do_write_string(
     unlink(path);
     return -1;
   }
-  return 0;
-}
+  return 0;
+}
+
+static int
+do_copy_regular_file(
+        const unsigned char *dst_path,
+        const unsigned char *src_path)
+{
+  int src_fd = -1;
+  int retval = -1;
+  size_t src_size = 0;
+  unsigned char *src_ptr = MAP_FAILED;
+  int dst_fd = -1;
+  int need_unlink = 0;
+  unsigned char *dst_ptr = MAP_FAILED;
+
+  src_fd = open(src_path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0);
+  if (src_fd < 0) {
+    err("%s: open '%s' failed: %s", __FUNCTION__, src_path, os_ErrorMsg());
+    goto done;
+  }
+  struct stat stb;
+  if (fstat(src_fd, &stb) < 0) {
+    err("%s: fstat failed: %s", __FUNCTION__, os_ErrorMsg());
+    goto done;
+  }
+  if (!S_ISREG(stb.st_mode)) {
+    err("%s: '%s' is not regular", __FUNCTION__, src_path);
+    goto done;
+  }
+  if (stb.st_size < 0 || stb.st_size > 128 * 1024 * 1024) {
+    err("%s: '%s' is too big", __FUNCTION__, src_path);
+    goto done;
+  }
+  src_size = stb.st_size;
+
+  dst_fd = open(dst_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, stb.st_mode & 0777);
+  if (dst_fd < 0) {
+    err("%s: open '%s' failed: %s", __FUNCTION__, dst_path, os_ErrorMsg());
+    goto done;
+  }
+  need_unlink = 1;
+  if (fstat(dst_fd, &stb) < 0) {
+    err("%s: fstat failed: %s", __FUNCTION__, os_ErrorMsg());
+    goto done;
+  }
+  if (!S_ISREG(stb.st_mode)) {
+    err("%s: '%s' is not regular", __FUNCTION__, dst_path);
+    goto done;
+  }
+
+  if (src_size > 0) {
+    src_ptr = mmap(NULL, src_size, PROT_READ, MAP_PRIVATE, src_fd, 0);
+    if (src_ptr == MAP_FAILED) {
+      err("%s: mmap of '%s' failed: %s", __FUNCTION__, src_path, os_ErrorMsg());
+      goto done;
+    }
+
+    if (posix_fallocate(dst_fd, 0, src_size) < 0) {
+      err("%s: fallocate failed: %s", __FUNCTION__, os_ErrorMsg());
+      goto done;
+    }
+    dst_ptr = mmap(NULL, src_size, PROT_READ | PROT_WRITE, MAP_SHARED, dst_fd, 0);
+    if (dst_ptr == MAP_FAILED) {
+      err("%s: mmap of '%s' failed: %s", __FUNCTION__, dst_path, os_ErrorMsg());
+      goto done;
+    }
+    memcpy(dst_ptr, src_ptr, src_size);
+  }
+
+  retval = 0;
+  need_unlink = 0;
+
+done:;
+  if (dst_ptr != MAP_FAILED) munmap(dst_ptr, src_size);
+  if (src_ptr != MAP_FAILED) munmap(src_ptr, src_size);
+  if (need_unlink) unlink(dst_path);
+  if (dst_fd >= 0) close(dst_fd);
+  if (src_fd >= 0) close(src_fd);
+  return retval;
+}
+
+static int
+copy_to_local_cache(
+        const struct compile_request_packet *req,
+        const unsigned char *exe_work_path,
+        const unsigned char *exe_sfx)
+{
+  unsigned char uuid_buf[64];
+  unsigned char cached_path[PATH_MAX];
+  int r;
+
+  r = snprintf(cached_path, sizeof(cached_path), "%s/%s%s",
+               local_cache,
+               ej_uuid_unparse_r(uuid_buf, sizeof(uuid_buf),
+                                 &req->judge_uuid, ""),
+               exe_sfx);
+  if (r >= (int)sizeof(cached_path)) {
+    err("%s: cached_path is too long", __FUNCTION__);
+    return -1;
+  }
+
+  struct stat stb;
+  if (stat(exe_work_path, &stb) < 0) {
+    err("%s: stat failed for '%s': %s", __FUNCTION__, exe_work_path, os_ErrorMsg());
+    return -1;
+  }
+  if (!S_ISREG(stb.st_mode)) {
+    err("%s: '%s' not regular", __FUNCTION__, exe_work_path);
+    return -1;
+  }
+
+  if (rename(exe_work_path, cached_path) >= 0) {
+    if (do_write_string(exe_work_path, 777, stub_program) < 0) {
+      err("%s: writing of stub file failed", __FUNCTION__);
+      unlink(cached_path);
+      return -1;
+    }
+    return 0;
+  }
+  if (errno != EXDEV) {
+    err("%s: rename failed: %s", __FUNCTION__, os_ErrorMsg());
+    return -1;
+  }
+  if (do_copy_regular_file(cached_path, exe_work_path) < 0) {
+    return -1;
+  }
+  if (do_write_string(exe_work_path, 777, stub_program) < 0) {
+    err("%s: writing of stub file failed", __FUNCTION__);
+    unlink(cached_path);
+    return -1;
+  }
+  return 0;
+}
+
+static void
+handle_request(
+        struct compile_request_packet *req,
+        const unsigned char *pkt_name,
+        const unsigned char *full_working_dir,
+        struct Future **p_src_future)
+{
+  const struct section_global_data *global = serve_state.global;
+  int override_exe = 0;
+  int exe_copied = 0;
+  int r;
+
+  struct compile_reply_packet rpl;
+  memset(&rpl, 0, sizeof(rpl));
+  rpl.judge_id = req->judge_id;
+  rpl.judge_uuid = req->judge_uuid;
+  rpl.contest_id = req->contest_id;
+  rpl.run_id = req->run_id;
+  rpl.submit_id = req->submit_id;
+  rpl.ts1 = req->ts1;
+  rpl.ts1_us = req->ts1_us;
+  rpl.use_uuid = req->use_uuid;
+  rpl.uuid = req->uuid;
+  get_current_time(&rpl.ts2, &rpl.ts2_us);
+  rpl.run_block_len = req->run_block_len;
+  rpl.run_block = req->run_block; /* !!! shares memory with req */
+
+  last_handled_request_ms = rpl.ts2 * 1000LL + rpl.ts2_us / 1000;
+
+  unsigned char contest_server_reply_dir[PATH_MAX];
+  contest_server_reply_dir[0] = 0;
+  const unsigned char *contest_server_id = NULL;
+  unsigned char contest_reply_dir[PATH_MAX];
+
+#if defined EJUDGE_COMPILE_SPOOL_DIR
+  {
+    if (req->contest_server_id && *req->contest_server_id) {
+      contest_server_id = req->contest_server_id;
+    }
+    if (!contest_server_id) {
+      contest_server_id = compile_server_id;
+    }
+    if (!contest_server_id || !*contest_server_id) {
+      contest_server_id = "localhost";
+    }
+    if (snprintf(contest_server_reply_dir, sizeof(contest_server_reply_dir), "%s/%s", EJUDGE_COMPILE_SPOOL_DIR, contest_server_id) >= sizeof(contest_server_reply_dir)) {
+      rpl.run_block = NULL;
+      compile_request_packet_free(req);
+      return;
+    }
+    if (make_dir(contest_server_reply_dir, 0777) < 0) {
+      rpl.run_block = NULL;
+      compile_request_packet_free(req);
+      return;
+    }
+  }
+  strcpy(contest_reply_dir, contest_server_reply_dir);
+#else
+  if (snprintf(contest_server_reply_dir, sizeof(contest_server_reply_dir), "%s", global->compile_dir) >= sizeof(contest_server_reply_dir)) {
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    return;
+  }
+
+  snprintf(contest_reply_dir, sizeof(contest_reply_dir), "%s/%06d", contest_server_reply_dir, rpl.contest_id);
+  if (make_dir(contest_reply_dir, 0777) < 0) {
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    return;
+  }
+#endif
+
+  unsigned char status_dir[PATH_MAX];
+  snprintf(status_dir, sizeof(status_dir), "%s/status", contest_reply_dir);
+  if (make_all_dir(status_dir, 0777) < 0) {
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    return;
+  }
+
+  unsigned char run_name[PATH_MAX];
+  if (req->use_uuid > 0) {
+    if (ej_uuid_is_nonempty(req->judge_uuid)) {
+      snprintf(run_name, sizeof(run_name), "%s", ej_uuid_unparse(&req->judge_uuid, NULL));
+    } else {
+      snprintf(run_name, sizeof(run_name), "%s", ej_uuid_unparse(&req->uuid, NULL));
+    }
+  } else {
+    snprintf(run_name, sizeof(run_name), "%06d", rpl.run_id);
+  }
+
+  unsigned char report_dir[PATH_MAX];
+  snprintf(report_dir, sizeof(report_dir), "%s/report", contest_reply_dir);
+  if (make_dir(report_dir, 0777) < 0) {
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    return;
+  }
+
+  unsigned char log_path[PATH_MAX];
+  snprintf(log_path, sizeof(log_path), "%s/%s.txt", report_dir, run_name);
+  unlink(log_path);
+
+  unsigned char exe_work_name[PATH_MAX];
+  exe_work_name[0] = 0;
+
+  unsigned char log_work_name[PATH_MAX];
+  snprintf(log_work_name, sizeof(log_work_name), "log_%06d.txt", req->run_id);
+  unsigned char log_work_path[PATH_MAX];
+  snprintf(log_work_path, sizeof(log_work_path), "%s/%s", full_working_dir, log_work_name);
+  unlink(log_work_path);
+  FILE *log_f = fopen(log_work_path, "a");
+  if (!log_f) {
+    err("cannot open log file '%s': %s", log_work_path, strerror(errno));
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    return;
+  }
+
+  const struct section_language_data *lang = NULL;
+  if (req->lang_id) {
+    if (req->lang_id <= 0 || req->lang_id > serve_state.max_lang || !(lang = serve_state.langs[req->lang_id])) {
+      fprintf(log_f, "invalid language id %d passed from ej-contest\n", req->lang_id);
+    }
+  }
+
+  unsigned char exe_path[PATH_MAX];
+  const unsigned char *exe_sfx = "";
+  if (lang /*&& lang->exe_sfx*/) exe_sfx = lang->exe_sfx;
+  snprintf(exe_path, sizeof(exe_path), "%s/%s%s", report_dir, run_name, exe_sfx);
+  unlink(exe_path);
+
+  unsigned char src_path[PATH_MAX];
+  const unsigned char *src_sfx = "";
+  if (req->src_sfx) src_sfx = req->src_sfx;
+  snprintf(src_path, sizeof(src_path), "%s/%s%s", compile_server_src_dir, pkt_name, src_sfx);
+
+  char *src_buf = NULL;
+  size_t src_len = 0;
+  if (agent) {
+    if (p_src_future && *p_src_future) {
+      // downloaded while the previous request was compiled
+      r = agent->ops->get_data_async_complete(agent, p_src_future, &src_buf, &src_len);
+    } else {
+      r = agent->ops->get_data(agent, pkt_name, src_sfx, &src_buf, &src_len);
+    }
+    if (r < 0) {
+      err("agent get_data failed");
+      fclose(log_f); log_f = NULL;
+      rpl.run_block = NULL;
+      compile_request_packet_free(req);
+      return;
+    }
+    if (!r || !src_buf) {
+      fclose(log_f); log_f = NULL;
+      rpl.run_block = NULL;
+      compile_request_packet_free(req);
+      return;
+    }
+  }
+
+  override_exe = 0;
+  exe_copied = 0;
+  handle_packet(log_f, &serve_state, pkt_name, req, &rpl,
+                lang,
+                contest_server_id,
+                run_name,
+                src_path,
+                src_buf,
+                src_len,
+                exe_sfx,
+                exe_path,
+                full_working_dir,
+                log_work_path,
+                exe_work_name,
+                &override_exe,
+                &exe_copied);
+
+  free(src_buf); src_buf = NULL; src_len = 0;
+
+  get_current_time(&rpl.ts3, &rpl.ts3_us);
+  long long current_time_ms = rpl.ts3 * 1000LL + rpl.ts3_us / 1000;
+  accumulated_ms += (current_time_ms - last_handled_request_ms);
+  ++request_count;
+
+  if (rpl.status == RUN_OK && !override_exe && !exe_copied) {
+    if (!exe_work_name[0]) {
+      err("the resulting executable name is empty");
+      fprintf(log_f, "\ncompiler output file is empty\n");
+      rpl.status = RUN_CHECK_FAILED;
+    } else {
+      unsigned char exe_work_path[PATH_MAX];
+      snprintf(exe_work_path, sizeof(exe_work_path), "%s/%s", full_working_dir, exe_work_name);
+      struct stat stb;
+
+      if (lstat(exe_work_path, &stb) < 0) {
+        err("the resulting executable '%s' does not exist", exe_work_path);
+        fprintf(log_f, "\ncompiler output file '%s' does not exist\n", exe_work_path);
+        rpl.status = RUN_COMPILE_ERR;
+      } else {
+        if (!S_ISREG(stb.st_mode)) {
+          err("the resulting executable '%s' is not a regular file", exe_work_path);
+          fprintf(log_f, "\ncompiler output file '%s' is not a regular file\n", exe_work_path);
+          rpl.status = RUN_CHECK_FAILED;
+        } else if (stb.st_size > MAX_EXE_SIZE) {
+          err("the resulting executable '%s' is too large (size = %lld)", exe_work_path, (long long) stb.st_size);
+          fprintf(log_f, "\ncompiler output file '%s' is too large\n (size = %lld)", exe_work_path, (long long) stb.st_size);
+          rpl.status = RUN_COMPILE_ERR;
+        } else {
+          if (agent) {
+            if (req->enable_remote_cache > 0 && local_cache && *local_cache
+                && ej_uuid_is_nonempty(req->judge_uuid)) {
+              if (copy_to_local_cache(req, exe_work_path, exe_sfx) >= 0) {
+                rpl.cached_on_remote = 1;
+              }
+            }
+            if (agent->ops->put_output_2(agent,
+                                         contest_server_id,
+                                         rpl.contest_id,
+                                         run_name,
+                                         exe_sfx,
+                                         exe_work_path) < 0) {
+              err("put_output failed");
+              fprintf(log_f, "\nput_output failed\n");
+              rpl.status = RUN_CHECK_FAILED;
+            }
+          } else if (req->accept_exe_sha256 > 0 && exe_store_dir()
+                     && exe_store_put(exe_store_dir(), exe_work_path, rpl.exe_sha256) >= 0
+                     && exe_store_get(exe_store_dir(), rpl.exe_sha256, exe_path) >= 0) {
+            // serve and ej-super-run will link the stored file as well
+            rpl.has_exe_sha256 = 1;
+          } else if (rename(exe_work_path, exe_path) >= 0) {
+            // good!
+          } else if (errno != EXDEV) {
+            int e = errno;
+            err("rename %s -> %s failed: %s", exe_work_path, exe_path, strerror(e));
+            fprintf(log_f, "\nrename %s -> %s failed: %s\n", exe_work_path, exe_path, strerror(e));
+            rpl.status = RUN_CHECK_FAILED;
+          } else {
+            if (generic_copy_file(0, NULL, exe_work_path, "", 0, NULL, exe_path, "") < 0) {
+              fprintf(log_f, "\ncopy %s -> %s failed\n", exe_work_path, exe_path);
+              rpl.status = RUN_CHECK_FAILED;
+            }
+          }
+        }
+      }
+    }
+  }
 
-static int
-do_copy_regular_file(
-        const unsigned char *dst_path,
-        const unsigned char *src_path)
-{
-  int src_fd = -1;
-  int retval = -1;
-  size_t src_size = 0;
-  unsigned char *src_ptr = MAP_FAILED;
-  int dst_fd = -1;
-  int need_unlink = 0;
-  unsigned char *dst_ptr = MAP_FAILED;
+  fclose(log_f); log_f = NULL;
 
-  src_fd = open(src_path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0);
-  if (src_fd < 0) {
-    err("%s: open '%s' failed: %s", __FUNCTION__, src_path, os_ErrorMsg());
-    goto done;
-  }
-  struct stat stb;
-  if (fstat(src_fd, &stb) < 0) {
-    err("%s: fstat failed: %s", __FUNCTION__, os_ErrorMsg());
-    goto done;
-  }
-  if (!S_ISREG(stb.st_mode)) {
-    err("%s: '%s' is not regular", __FUNCTION__, src_path);
-    goto done;
+  // with an agent the log is uploaded together with the reply
+  if (!agent) {
+    r = generic_copy_file(0, NULL, log_work_path, "", 0, NULL, log_path, "");
+    if (r < 0) {
+      rpl.run_block = NULL;
+      compile_request_packet_free(req);
+      clear_directory(full_working_dir);
+      unlink(exe_path);
+      unlink(log_path);
+      return;
+    }
   }
-  if (stb.st_size < 0 || stb.st_size > 128 * 1024 * 1024) {
-    err("%s: '%s' is too big", __FUNCTION__, src_path);
-    goto done;
+
+  int log_as_exe = 0;
+  if (override_exe || (rpl.status == RUN_STYLE_ERR || rpl.status == RUN_COMPILE_ERR || rpl.status == RUN_CHECK_FAILED)) {
+    if (agent) {
+      log_as_exe = 1;
+    } else {
+      generic_copy_file(0, NULL, log_work_path, "", 0, NULL, exe_path, "");
+    }
   }
-  src_size = stb.st_size;
 
-  dst_fd = open(dst_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, stb.st_mode & 0777);
-  if (dst_fd < 0) {
-    err("%s: open '%s' failed: %s", __FUNCTION__, dst_path, os_ErrorMsg());
-    goto done;
+  void *rpl_pkt = NULL;
+  size_t rpl_size = 0;
+  if (compile_reply_packet_write(&rpl, &rpl_size, &rpl_pkt) < 0) {
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    clear_directory(full_working_dir);
+    unlink(exe_path);
+    unlink(log_path);
+    return;
   }
-  need_unlink = 1;
-  if (fstat(dst_fd, &stb) < 0) {
-    err("%s: fstat failed: %s", __FUNCTION__, os_ErrorMsg());
-    goto done;
+  if (agent) {
+    struct AgentResultFile result_files[2] =
+    {
+      { AGENT_RESULT_REPORT, ".txt", log_work_path },
+      { AGENT_RESULT_REPORT, exe_sfx, log_work_path },
+    };
+    r = agent->ops->put_results(agent, contest_server_id, rpl.contest_id, run_name,
+                                1 + log_as_exe, result_files, rpl_pkt, rpl_size);
+  } else {
+    r = generic_write_file(rpl_pkt, rpl_size, SAFE, status_dir, run_name, 0);
   }
-  if (!S_ISREG(stb.st_mode)) {
-    err("%s: '%s' is not regular", __FUNCTION__, dst_path);
-    goto done;
+  if (r < 0) {
+    rpl.run_block = NULL;
+    compile_request_packet_free(req);
+    xfree(rpl_pkt);
+    clear_directory(full_working_dir);
+    unlink(exe_path);
+    unlink(log_path);
+    return;
   }
 
-  if (src_size > 0) {
-    src_ptr = mmap(NULL, src_size, PROT_READ, MAP_PRIVATE, src_fd, 0);
-    if (src_ptr == MAP_FAILED) {
-      err("%s: mmap of '%s' failed: %s", __FUNCTION__, src_path, os_ErrorMsg());
-      goto done;
+  // all good
+  rpl.run_block = NULL;
+  compile_request_packet_free(req);
+  xfree(rpl_pkt);
+  clear_directory(full_working_dir);
+}
+
+/*
+ * In the prefetch mode the next packet is claimed before the current
+ * request is compiled, and its source is downloaded from the agent
+ * in background meanwhile. A packet from the local spool is kept in
+ * the claim directory of the process until it is handled.
+ */
+static unsigned char claim_dir[PATH_MAX];
+
+struct prefetched_packet
+{
+  unsigned char pkt_name[PATH_MAX];
+  char *pkt_ptr;
+  size_t pkt_len;
+  unsigned char *src_sfx;
+  struct Future *src_future;
+};
+
+static void
+prefetch_packet(
+        struct prefetched_packet *pp,
+        struct spool_queue *spool_queue,
+        struct Future **p_future)
+{
+  int r;
+
+  if (pp->pkt_name[0]) return;
+
+  if (agent) {
+    // the wait in progress is completed in background anyway
+    if (*p_future) return;
+    r = agent->ops->async_wait_init(agent, SIGUSR2, 0,
+                                    1,
+                                    pp->pkt_name, sizeof(pp->pkt_name), p_future,
+                                    DEFAULT_WAIT_TIMEOUT_MS,
+                                    &pp->pkt_ptr,
+                                    &pp->pkt_len);
+    if (r <= 0 || !pp->pkt_name[0]) {
+      if (r < 0) err("async_wait_init failed");
+      goto fail;
     }
+    if (!pp->pkt_ptr) return;
 
-    if (posix_fallocate(dst_fd, 0, src_size) < 0) {
-      err("%s: fallocate failed: %s", __FUNCTION__, os_ErrorMsg());
-      goto done;
+    struct compile_request_packet *req = NULL;
+    if (compile_request_packet_read(pp->pkt_len, pp->pkt_ptr, &req) >= 0 && req->contest_id) {
+      const unsigned char *src_sfx = req->src_sfx;
+      if (!src_sfx) src_sfx = "";
+      pp->src_sfx = xstrdup(src_sfx);
+      if (agent->ops->get_data_async(agent, pp->pkt_name, pp->src_sfx, &pp->src_future) < 0) {
+        xfree(pp->src_sfx); pp->src_sfx = NULL;
+      }
     }
-    dst_ptr = mmap(NULL, src_size, PROT_READ | PROT_WRITE, MAP_SHARED, dst_fd, 0);
-    if (dst_ptr == MAP_FAILED) {
-      err("%s: mmap of '%s' failed: %s", __FUNCTION__, dst_path, os_ErrorMsg());
-      goto done;
+    compile_request_packet_free(req);
+  } else {
+    if (!claim_dir[0]) goto fail;
+    r = spool_queue_get(spool_queue, pp->pkt_name, sizeof(pp->pkt_name), 0);
+    if (r > 0) {
+      r = spool_claim_packet(compile_server_queue_dir, claim_dir, pp->pkt_name, &pp->pkt_ptr, &pp->pkt_len);
     }
-    memcpy(dst_ptr, src_ptr, src_size);
+    if (r <= 0) goto fail;
   }
+  info("prefetched packet %s", pp->pkt_name);
+  return;
 
-  retval = 0;
-  need_unlink = 0;
-
-done:;
-  if (dst_ptr != MAP_FAILED) munmap(dst_ptr, src_size);
-  if (src_ptr != MAP_FAILED) munmap(src_ptr, src_size);
-  if (need_unlink) unlink(dst_path);
-  if (dst_fd >= 0) close(dst_fd);
-  if (src_fd >= 0) close(src_fd);
-  return retval;
+fail:
+  pp->pkt_name[0] = 0;
+  xfree(pp->pkt_ptr); pp->pkt_ptr = NULL;
+  pp->pkt_len = 0;
 }
 
-static int
-copy_to_local_cache(
-        const struct compile_request_packet *req,
-        const unsigned char *exe_work_path,
-        const unsigned char *exe_sfx)
+/* drops the prefetched source, or puts it back, if 'src_sfx' is not NULL */
+static void
+return_prefetched_source(
+        const unsigned char *pkt_name,
+        struct Future **p_src_future,
+        const unsigned char *src_sfx)
 {
-  unsigned char uuid_buf[64];
-  unsigned char cached_path[PATH_MAX];
-  int r;
+  char *data = NULL;
+  size_t size = 0;
 
-  r = snprintf(cached_path, sizeof(cached_path), "%s/%s%s",
-               local_cache,
-               ej_uuid_unparse_r(uuid_buf, sizeof(uuid_buf),
-                                 &req->judge_uuid, ""),
-               exe_sfx);
-  if (r >= (int)sizeof(cached_path)) {
-    err("%s: cached_path is too long", __FUNCTION__);
-    return -1;
+  if (!*p_src_future) return;
+  if (agent->ops->get_data_async_complete(agent, p_src_future, &data, &size) > 0 && src_sfx) {
+    if (agent->ops->put_data(agent, pkt_name, src_sfx, data, size) < 0) {
+      err("failed to return source for packet %s", pkt_name);
+    }
   }
+  free(data);
+}
 
-  struct stat stb;
-  if (stat(exe_work_path, &stb) < 0) {
-    err("%s: stat failed for '%s': %s", __FUNCTION__, exe_work_path, os_ErrorMsg());
-    return -1;
-  }
-  if (!S_ISREG(stb.st_mode)) {
-    err("%s: '%s' not regular", __FUNCTION__, exe_work_path);
-    return -1;
-  }
+/* puts the packet, which is not handled, back to the queue */
+static void
+return_prefetched_packet(struct prefetched_packet *pp)
+{
+  if (!pp->pkt_name[0]) return;
 
-  if (rename(exe_work_path, cached_path) >= 0) {
-    if (do_write_string(exe_work_path, 777, stub_program) < 0) {
-      err("%s: writing of stub file failed", __FUNCTION__);
-      unlink(cached_path);
-      return -1;
+  info("returning prefetched packet %s", pp->pkt_name);
+  if (!agent) {
+    if (spool_claim_return(compile_server_queue_dir, claim_dir, pp->pkt_name) < 0) {
+      err("failed to return packet %s: %s", pp->pkt_name, os_ErrorMsg());
     }
-    return 0;
-  }
-  if (errno != EXDEV) {
-    err("%s: rename failed: %s", __FUNCTION__, os_ErrorMsg());
-    return -1;
-  }
-  if (do_copy_regular_file(cached_path, exe_work_path) < 0) {
-    return -1;
-  }
-  if (do_write_string(exe_work_path, 777, stub_program) < 0) {
-    err("%s: writing of stub file failed", __FUNCTION__);
-    unlink(cached_path);
-    return -1;
-  }
-  return 0;
+  } else if (pp->pkt_ptr) {
+    // the source must be in place before the packet is visible
+    return_prefetched_source(pp->pkt_name, &pp->src_future, pp->src_sfx);
+    agent->ops->put_packet(agent, pp->pkt_name, pp->pkt_ptr, pp->pkt_len);
+  }
+  xfree(pp->pkt_ptr);
+  xfree(pp->src_sfx);
+  memset(pp, 0, sizeof(*pp));
 }
 
 static int
@@ -1468,17 +2976,19 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
 {
   int retval = 0;
   const struct section_global_data *global = serve_state.global;
-  int override_exe = 0;
-  int exe_copied = 0;
   path_t full_working_dir = { 0 };
   struct Future *future = NULL;
   int ifd = -1;
-  int ifd_wd = -1;
+  struct spool_queue *spool_queue = NULL;
   sigset_t emptymask;
   int efd = -1;
+  struct prefetched_packet next_packet;
+  struct Future *src_future = NULL;
+  unsigned char claimed_pkt_name[PATH_MAX] = { 0 };
 
   random_init();
   sigemptyset(&emptymask);
+  memset(&next_packet, 0, sizeof(next_packet));
 
   if (parallel_mode) {
     unsigned long long u64 = random_u64();
@@ -1508,12 +3018,6 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
       err("invalid agent");
       return -1;
     }
-  } else {
-    ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
-    if (ifd < 0) {
-      err("inotify_init1 failed: %s", os_ErrorMsg());
-      return -1;
-    }
   }
 
 #if defined EJUDGE_COMPILE_SPOOL_DIR
@@ -1529,15 +3033,19 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
   }
 #endif
 
-  snprintf(compile_server_queue_dir_dir, sizeof(compile_server_queue_dir_dir),
-           "%s/dir", compile_server_queue_dir);
-
-  if (ifd >= 0) {
-    ifd_wd = inotify_add_watch(ifd, compile_server_queue_dir_dir, IN_CREATE | IN_MOVED_TO);
-    if (ifd_wd < 0) {
-      err("inotify_add_watch failed: %s", os_ErrorMsg());
+  if (!agent) {
+    spool_queue = spool_queue_create(compile_server_queue_dir);
+    if (!spool_queue) {
+      err("failed to create spool queue for %s", compile_server_queue_dir);
       return -1;
     }
+    ifd = spool_queue_fd(spool_queue);
+
+    // the packets prefetched by a dead process are returned to the spool
+    if (spool_claim_init(compile_server_queue_dir, claim_dir, sizeof(claim_dir)) < 0) {
+      err("failed to create claim directory in %s", compile_server_queue_dir);
+      claim_dir[0] = 0;
+    }
 
     efd = epoll_create1(EPOLL_CLOEXEC);
     if (efd < 0) {
@@ -1565,6 +3073,12 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
     interrupt_enable();
     interrupt_disable();
 
+    if (claimed_pkt_name[0]) {
+      // the previous prefetched packet is handled
+      spool_claim_remove(claim_dir, claimed_pkt_name);
+      claimed_pkt_name[0] = 0;
+    }
+
     // terminate if signaled
     if (interrupt_get_status() || interrupt_restart_requested()) break;
     if (interrupt_was_usr1()) {
@@ -1587,7 +3101,17 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
     char *pkt_ptr = NULL;
     size_t pkt_len = 0;
 
-    if (agent) {
+    if (next_packet.pkt_name[0]) {
+      // claimed while the previous request was compiled
+      snprintf(pkt_name, sizeof(pkt_name), "%s", next_packet.pkt_name);
+      pkt_ptr = next_packet.pkt_ptr;
+      pkt_len = next_packet.pkt_len;
+      src_future = next_packet.src_future;
+      xfree(next_packet.src_sfx);
+      memset(&next_packet, 0, sizeof(next_packet));
+      if (!agent) snprintf(claimed_pkt_name, sizeof(claimed_pkt_name), "%s", pkt_name);
+      r = 1;
+    } else if (agent) {
       if (interrupt_was_usr2()) {
         interrupt_reset_usr2();
         if (future) {
@@ -1620,7 +3144,7 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
         }
       }
     } else {
-      r = scan_dir(compile_server_queue_dir, pkt_name, sizeof(pkt_name), 0);
+      r = spool_queue_get(spool_queue, pkt_name, sizeof(pkt_name), 0);
       if (r < 0) {
         switch (-r) {
         case ENOMEM:
@@ -1648,358 +3172,502 @@ new_loop(int parallel_mode, const unsigned char *global_log_path)
         int r = epoll_pwait(efd, events, 1, HEARTBEAT_UPDATE_MS, &emptymask);
         if (r == 1) {
           if (events[0].data.fd != ifd) abort();
-          // just read all the data in the ifd without any processing
-          unsigned char ibuf[4096];
-          while (1) {
-            int r = read(ifd, ibuf, sizeof(ibuf));
-            if (r <= 0) break;
-          }
+          spool_queue_update(spool_queue);
         }
       }
       continue;
     }
 
-    if (agent) {
-      if (!pkt_ptr) {
-        r = agent->ops->get_packet(agent, pkt_name, &pkt_ptr, &pkt_len);
-      } else {
-        r = 1;
-      }
-    } else {
-      r = generic_read_file(&pkt_ptr, 0, &pkt_len, SAFE | REMOVE, compile_server_queue_dir, pkt_name, "");
-    }
-    if (r == 0){
-      continue;
+    if (pkt_ptr) {
+      r = 1;
+    } else if (agent) {
+      r = agent->ops->get_packet(agent, pkt_name, &pkt_ptr, &pkt_len);
+    } else {
+      r = generic_read_file(&pkt_ptr, 0, &pkt_len, SAFE | REMOVE, compile_server_queue_dir, pkt_name, "");
+    }
+    if (r == 0){
+      continue;
+    }
+    if (r < 0 || !pkt_ptr) {
+      // it looks like there's no reasonable recovery strategy
+      // so, just ignore the error
+      continue;
+    }
+
+    struct compile_request_packet *req = NULL;
+    r = compile_request_packet_read(pkt_len, pkt_ptr, &req);
+    xfree(pkt_ptr); pkt_ptr = NULL;
+    if (r < 0) {
+      continue;
+    }
+
+    if (lang_id_map
+        && req->lang_id > 0 && req->lang_id < lang_id_map_size
+        && lang_id_map[req->lang_id] > 0) {
+      info("language %d mapped to %d", req->lang_id, lang_id_map[req->lang_id]);
+      req->lang_id = lang_id_map[req->lang_id];
+    }
+
+    if (!req->contest_id) {
+      // special packets
+      r = req->lang_id;
+      req = compile_request_packet_free(req);
+      switch (r) {
+      case 1:
+        interrupt_flag_interrupt();
+        break;
+      case 2:
+        interrupt_flag_sighup();
+        break;
+      }
+      continue;
+    }
+
+    if (prefetch_mode) {
+      prefetch_packet(&next_packet, spool_queue, &future);
+    }
+
+    handle_request(req, pkt_name, full_working_dir, &src_future);
+    if (src_future) {
+      // the request is dropped, the source is not needed
+      return_prefetched_source(pkt_name, &src_future, NULL);
+    }
+  }
+
+  if (agent && future && prefetch_mode) {
+    // the packet might be claimed while the last request was compiled
+    int r = agent->ops->async_wait_complete(agent, &future,
+                                            next_packet.pkt_name, sizeof(next_packet.pkt_name),
+                                            &next_packet.pkt_ptr,
+                                            &next_packet.pkt_len);
+    if (r <= 0) next_packet.pkt_name[0] = 0;
+  }
+  return_prefetched_packet(&next_packet);
+  if (claimed_pkt_name[0]) {
+    spool_claim_remove(claim_dir, claimed_pkt_name);
+  }
+  if (claim_dir[0]) {
+    spool_claim_fini(claim_dir);
+    claim_dir[0] = 0;
+  }
+
+  stop_all_compile_daemons();
+  delete_heartbeat();
+
+  if (agent) {
+    agent->ops->close(agent);
+  }
+  if (efd >= 0) close(efd);
+  spool_queue_free(spool_queue);
+
+  return retval;
+}
+
+/*
+ * The supervisor mode: one process takes the packets from the spool
+ * directory and starts the compilations in the worker processes, at
+ * most 'slot_count' slots are used at once. A compilation occupies
+ * 'compile_weight' slots of its language, the number of simultaneous
+ * compilations of a language is limited by 'compile_concurrency'.
+ * The lighter compilations are started first, but a packet waiting
+ * for longer than SUPERVISOR_MAX_WAIT_MS is not overtaken anymore.
+ * The packets waiting for a slot stay in the claim directory of
+ * the supervisor until their compilation is started.
+ */
+enum { SUPERVISOR_MAX_WAIT_MS = 30000 };
+enum { SUPERVISOR_PENDING_PER_SLOT = 2 };
+
+struct compile_slot
+{
+  pid_t pid;                    // 0, if the slot is free
+  int lang_id;
+  int weight;
+  long long start_ms;
+  unsigned char working_dir[PATH_MAX];
+};
+
+struct pending_request
+{
+  unsigned char *pkt_name;      // the packet is in the claim directory
+  struct compile_request_packet *req;
+  long long arrival_ms;
+};
+
+static void
+sigchld_handler(int signo)
+{
+}
+
+static int
+get_request_weight(const struct compile_request_packet *req, int slot_count)
+{
+  const struct section_language_data *lang = NULL;
+  int weight = 1;
+
+  if (req->lang_id > 0 && req->lang_id <= serve_state.max_lang) {
+    lang = serve_state.langs[req->lang_id];
+  }
+  if (lang && lang->compile_weight > 0) weight = lang->compile_weight;
+  if (weight > slot_count) weight = slot_count;
+  return weight;
+}
+
+static int
+is_concurrency_exceeded(
+        const struct compile_request_packet *req,
+        const struct compile_slot *slots,
+        int slot_count)
+{
+  const struct section_language_data *lang = NULL;
+  int count = 0;
+
+  if (req->lang_id > 0 && req->lang_id <= serve_state.max_lang) {
+    lang = serve_state.langs[req->lang_id];
+  }
+  if (!lang || lang->compile_concurrency <= 0) return 0;
+  for (int i = 0; i < slot_count; ++i) {
+    if (slots[i].pid > 0 && slots[i].lang_id == req->lang_id) ++count;
+  }
+  return count >= lang->compile_concurrency;
+}
+
+/* returns the index of the pending request to start, or -1 */
+static int
+select_pending_request(
+        const struct pending_request *pending,
+        int pending_u,
+        const struct compile_slot *slots,
+        int slot_count,
+        long long current_ms)
+{
+  int used_weight = 0;
+  int best = -1, best_weight = 0;
+
+  for (int i = 0; i < slot_count; ++i) {
+    if (slots[i].pid > 0) used_weight += slots[i].weight;
+  }
+
+  // the pending requests are in the queue order
+  for (int i = 0; i < pending_u; ++i) {
+    const struct compile_request_packet *req = pending[i].req;
+    if (is_concurrency_exceeded(req, slots, slot_count)) continue;
+    int weight = get_request_weight(req, slot_count);
+    int fits = used_weight + weight <= slot_count;
+    if (current_ms - pending[i].arrival_ms >= SUPERVISOR_MAX_WAIT_MS) {
+      // reserve the slots for the long waiting request
+      return fits ? i : -1;
     }
-    if (r < 0 || !pkt_ptr) {
-      // it looks like there's no reasonable recovery strategy
-      // so, just ignore the error
-      continue;
+    if (fits && (best < 0 || weight < best_weight)) {
+      best = i;
+      best_weight = weight;
     }
+  }
+  return best;
+}
 
-    struct compile_request_packet *req = NULL;
-    r = compile_request_packet_read(pkt_len, pkt_ptr, &req);
-    xfree(pkt_ptr); pkt_ptr = NULL;
-    if (r < 0) {
-      continue;
-    }
+/*
+ * claims the next packet from the spool, returns 1, if a request is added,
+ * 2, if the packet is skipped, 0, if the spool is empty
+ */
+static int
+read_pending_request(
+        struct spool_queue *spool_queue,
+        struct pending_request *p)
+{
+  unsigned char pkt_name[PATH_MAX];
+  char *pkt_ptr = NULL;
+  size_t pkt_len = 0;
+  struct compile_request_packet *req = NULL;
+  int r;
 
-    if (lang_id_map
-        && req->lang_id > 0 && req->lang_id < lang_id_map_size
-        && lang_id_map[req->lang_id] > 0) {
-      info("language %d mapped to %d", req->lang_id, lang_id_map[req->lang_id]);
-      req->lang_id = lang_id_map[req->lang_id];
+  if ((r = spool_queue_get(spool_queue, pkt_name, sizeof(pkt_name), 0)) <= 0) {
+    return r;
+  }
+  r = spool_claim_packet(compile_server_queue_dir, claim_dir, pkt_name, &pkt_ptr, &pkt_len);
+  if (r <= 0 || !pkt_ptr) {
+    xfree(pkt_ptr);
+    // the packet is taken by another process, or cannot be read
+    return 2;
+  }
+  r = compile_request_packet_read(pkt_len, pkt_ptr, &req);
+  xfree(pkt_ptr);
+  if (r < 0) {
+    spool_claim_remove(claim_dir, pkt_name);
+    return 2;
+  }
+
+  if (lang_id_map
+      && req->lang_id > 0 && req->lang_id < lang_id_map_size
+      && lang_id_map[req->lang_id] > 0) {
+    info("language %d mapped to %d", req->lang_id, lang_id_map[req->lang_id]);
+    req->lang_id = lang_id_map[req->lang_id];
+  }
+
+  if (!req->contest_id) {
+    // special packets
+    r = req->lang_id;
+    req = compile_request_packet_free(req);
+    spool_claim_remove(claim_dir, pkt_name);
+    switch (r) {
+    case 1:
+      interrupt_flag_interrupt();
+      break;
+    case 2:
+      interrupt_flag_sighup();
+      break;
     }
+    return 2;
+  }
 
-    if (!req->contest_id) {
-      // special packets
-      r = req->lang_id;
-      req = compile_request_packet_free(req);
-      switch (r) {
-      case 1:
-        interrupt_flag_interrupt();
-        break;
-      case 2:
-        interrupt_flag_sighup();
+  p->pkt_name = xstrdup(pkt_name);
+  p->req = req;
+  p->arrival_ms = get_current_time_ms();
+  return 1;
+}
+
+static int
+start_compile_slot(
+        struct compile_slot *slots,
+        int slot_idx,
+        struct pending_request *p,
+        int slot_count)
+{
+  struct compile_slot *slot = &slots[slot_idx];
+  pid_t pid = fork();
+  if (pid < 0) {
+    err("fork failed: %s", os_ErrorMsg());
+    return -1;
+  }
+  if (!pid) {
+    sigset_t chld_mask;
+    signal(SIGCHLD, SIG_DFL);
+    sigemptyset(&chld_mask);
+    sigaddset(&chld_mask, SIGCHLD);
+    sigprocmask(SIG_UNBLOCK, &chld_mask, NULL);
+    compile_daemons_disabled = 1;
+    handle_request(p->req, p->pkt_name, slot->working_dir, NULL);
+    _exit(0);
+  }
+
+  info("compile slot %d: run %d, language %d started in process %d",
+       slot_idx, p->req->run_id, p->req->lang_id, (int) pid);
+  slot->pid = pid;
+  slot->lang_id = p->req->lang_id;
+  slot->weight = get_request_weight(p->req, slot_count);
+  slot->start_ms = get_current_time_ms();
+  last_handled_request_ms = slot->start_ms;
+  return 0;
+}
+
+static int
+reap_compile_slots(struct compile_slot *slots, int slot_count, int block_mode)
+{
+  int status = 0, count = 0;
+  pid_t pid;
+
+  while ((pid = waitpid(-1, &status, block_mode ? 0 : WNOHANG)) > 0) {
+    for (int i = 0; i < slot_count; ++i) {
+      if (slots[i].pid == pid) {
+        if (WIFSIGNALED(status)) {
+          err("compile slot %d: process %d terminated by signal %d", i, (int) pid, WTERMSIG(status));
+        }
+        accumulated_ms += get_current_time_ms() - slots[i].start_ms;
+        ++request_count;
+        slots[i].pid = 0;
+        ++count;
         break;
       }
-      continue;
     }
+  }
+  return count;
+}
 
-    struct compile_reply_packet rpl;
-    memset(&rpl, 0, sizeof(rpl));
-    rpl.judge_id = req->judge_id;
-    rpl.judge_uuid = req->judge_uuid;
-    rpl.contest_id = req->contest_id;
-    rpl.run_id = req->run_id;
-    rpl.submit_id = req->submit_id;
-    rpl.ts1 = req->ts1;
-    rpl.ts1_us = req->ts1_us;
-    rpl.use_uuid = req->use_uuid;
-    rpl.uuid = req->uuid;
-    get_current_time(&rpl.ts2, &rpl.ts2_us);
-    rpl.run_block_len = req->run_block_len;
-    rpl.run_block = req->run_block; /* !!! shares memory with req */
-
-    last_handled_request_ms = rpl.ts2 * 1000LL + rpl.ts2_us / 1000;
-
-    unsigned char contest_server_reply_dir[PATH_MAX];
-    contest_server_reply_dir[0] = 0;
-    const unsigned char *contest_server_id = NULL;
-    unsigned char contest_reply_dir[PATH_MAX];
+static void
+free_pending_request(struct pending_request *p)
+{
+  compile_request_packet_free(p->req);
+  xfree(p->pkt_name);
+  memset(p, 0, sizeof(*p));
+}
 
-#if defined EJUDGE_COMPILE_SPOOL_DIR
-    {
-      if (req->contest_server_id && *req->contest_server_id) {
-        contest_server_id = req->contest_server_id;
-      }
-      if (!contest_server_id) {
-        contest_server_id = compile_server_id;
-      }
-      if (!contest_server_id || !*contest_server_id) {
-        contest_server_id = "localhost";
-      }
-      if (snprintf(contest_server_reply_dir, sizeof(contest_server_reply_dir), "%s/%s", EJUDGE_COMPILE_SPOOL_DIR, contest_server_id) >= sizeof(contest_server_reply_dir)) {
-        rpl.run_block = NULL;
-        compile_request_packet_free(req);
-        continue;
-      }
-      if (make_dir(contest_server_reply_dir, 0777) < 0) {
-        rpl.run_block = NULL;
-        compile_request_packet_free(req);
-        continue;
-      }
+static int
+supervisor_loop(int parallel_mode, int slot_count, const unsigned char *global_log_path)
+{
+  const struct section_global_data *global = serve_state.global;
+  path_t base_working_dir = { 0 };
+  struct compile_slot *slots = NULL;
+  struct pending_request *pending = NULL;
+  int pending_u = 0;
+  int pending_a = slot_count * SUPERVISOR_PENDING_PER_SLOT;
+  struct spool_queue *spool_queue = NULL;
+  int ifd = -1, efd = -1;
+  sigset_t emptymask, chld_mask;
+  struct sigaction sa;
+  int retval = -1;
+
+  random_init();
+  sigemptyset(&emptymask);
+
+  if (parallel_mode) {
+    snprintf(base_working_dir, sizeof(base_working_dir), "%s/%016llx", global->compile_work_dir, random_u64());
+    if (make_dir(base_working_dir, 0) < 0) {
+      err("cannot create '%s': %s", base_working_dir, os_ErrorMsg());
+      return -1;
     }
-    strcpy(contest_reply_dir, contest_server_reply_dir);
-#else
-    if (snprintf(contest_server_reply_dir, sizeof(contest_server_reply_dir), "%s", global->compile_dir) >= sizeof(contest_server_reply_dir)) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      continue;
+  } else {
+    snprintf(base_working_dir, sizeof(base_working_dir), "%s", global->compile_work_dir);
+  }
+  XCALLOC(slots, slot_count);
+  for (int i = 0; i < slot_count; ++i) {
+    snprintf(slots[i].working_dir, sizeof(slots[i].working_dir), "%s/slot%d", base_working_dir, i);
+    if (make_dir(slots[i].working_dir, 0) < 0) {
+      err("cannot create '%s': %s", slots[i].working_dir, os_ErrorMsg());
+      goto cleanup;
     }
+  }
+  XCALLOC(pending, pending_a);
 
-    snprintf(contest_reply_dir, sizeof(contest_reply_dir), "%s/%06d", contest_server_reply_dir, rpl.contest_id);
-    if (make_dir(contest_reply_dir, 0777) < 0) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      continue;
-    }
+#if !defined EJUDGE_COMPILE_SPOOL_DIR
+  if (snprintf(compile_server_queue_dir, sizeof(compile_server_queue_dir), "%s", global->compile_queue_dir) >= sizeof(compile_server_queue_dir)) {
+    err("path '%s' is too long", global->compile_queue_dir);
+    goto cleanup;
+  }
+  if (snprintf(compile_server_src_dir, sizeof(compile_server_src_dir), "%s", global->compile_src_dir) >= sizeof(compile_server_src_dir)) {
+    err("path '%s' is too long", global->compile_src_dir);
+    goto cleanup;
+  }
 #endif
 
-    unsigned char status_dir[PATH_MAX];
-    snprintf(status_dir, sizeof(status_dir), "%s/status", contest_reply_dir);
-    if (make_all_dir(status_dir, 0777) < 0) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      continue;
-    }
+  // the packets claimed by a dead supervisor are returned before the scan
+  if (spool_claim_init(compile_server_queue_dir, claim_dir, sizeof(claim_dir)) < 0) {
+    err("failed to create claim directory in %s", compile_server_queue_dir);
+    claim_dir[0] = 0;
+    goto cleanup;
+  }
+  if (!(spool_queue = spool_queue_create(compile_server_queue_dir))) {
+    err("failed to create spool queue for %s", compile_server_queue_dir);
+    goto cleanup;
+  }
+  ifd = spool_queue_fd(spool_queue);
+  if ((efd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+    err("epoll_create1 failed: %s", os_ErrorMsg());
+    goto cleanup;
+  }
+  struct epoll_event ev =
+  {
+    .events = EPOLLIN,
+    .data.fd = ifd,
+  };
+  if (epoll_ctl(efd, EPOLL_CTL_ADD, ifd, &ev) < 0) {
+    err("epoll_ctl failed: %s", os_ErrorMsg());
+    goto cleanup;
+  }
 
-    unsigned char run_name[PATH_MAX];
-    if (req->use_uuid > 0) {
-      if (ej_uuid_is_nonempty(req->judge_uuid)) {
-        snprintf(run_name, sizeof(run_name), "%s", ej_uuid_unparse(&req->judge_uuid, NULL));
-      } else {
-        snprintf(run_name, sizeof(run_name), "%s", ej_uuid_unparse(&req->uuid, NULL));
-      }
-    } else {
-      snprintf(run_name, sizeof(run_name), "%06d", rpl.run_id);
-    }
+  // SIGCHLD is delivered only while waiting for events
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = sigchld_handler;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGCHLD, &sa, NULL);
+  sigemptyset(&chld_mask);
+  sigaddset(&chld_mask, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &chld_mask, NULL);
 
-    unsigned char report_dir[PATH_MAX];
-    snprintf(report_dir, sizeof(report_dir), "%s/report", contest_reply_dir);
-    if (make_dir(report_dir, 0777) < 0) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      continue;
-    }
+  interrupt_init();
+  interrupt_setup_usr1();
+  interrupt_disable();
 
-    unsigned char log_path[PATH_MAX];
-    snprintf(log_path, sizeof(log_path), "%s/%s.txt", report_dir, run_name);
-    unlink(log_path);
+  info("compile supervisor started with %d slots", slot_count);
 
-    unsigned char exe_work_name[PATH_MAX];
-    exe_work_name[0] = 0;
-
-    unsigned char log_work_name[PATH_MAX];
-    snprintf(log_work_name, sizeof(log_work_name), "log_%06d.txt", req->run_id);
-    unsigned char log_work_path[PATH_MAX];
-    snprintf(log_work_path, sizeof(log_work_path), "%s/%s", full_working_dir, log_work_name);
-    unlink(log_work_path);
-    FILE *log_f = fopen(log_work_path, "a");
-    if (!log_f) {
-      err("cannot open log file '%s': %s", log_work_path, strerror(errno));
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      continue;
-    }
+  while (1) {
+    interrupt_enable();
+    interrupt_disable();
 
-    const struct section_language_data *lang = NULL;
-    if (req->lang_id) {
-      if (req->lang_id <= 0 || req->lang_id > serve_state.max_lang || !(lang = serve_state.langs[req->lang_id])) {
-        fprintf(log_f, "invalid language id %d passed from ej-contest\n", req->lang_id);
+    if (interrupt_get_status() || interrupt_restart_requested()) break;
+    if (interrupt_was_usr1()) {
+      if ((daemon_mode || slave_mode) && global_log_path && *global_log_path) {
+        start_open_log(global_log_path);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
       }
+      interrupt_reset_usr1();
+      continue;
     }
 
-    unsigned char exe_path[PATH_MAX];
-    const unsigned char *exe_sfx = "";
-    if (lang /*&& lang->exe_sfx*/) exe_sfx = lang->exe_sfx;
-    snprintf(exe_path, sizeof(exe_path), "%s/%s%s", report_dir, run_name, exe_sfx);
-    unlink(exe_path);
-
-    unsigned char src_path[PATH_MAX];
-    const unsigned char *src_sfx = "";
-    if (req->src_sfx) src_sfx = req->src_sfx;
-    snprintf(src_path, sizeof(src_path), "%s/%s%s", compile_server_src_dir, pkt_name, src_sfx);
+    int changed = reap_compile_slots(slots, slot_count, 0);
 
-    char *src_buf = NULL;
-    size_t src_len = 0;
-    if (agent) {
-      r = agent->ops->get_data(agent, pkt_name, src_sfx, &src_buf, &src_len);
-      if (r < 0) {
-        err("agent get_data failed");
-        fclose(log_f); log_f = NULL;
-        rpl.run_block = NULL;
-        compile_request_packet_free(req);
-        continue;
-      }
-      if (!r || !src_buf) {
-        fclose(log_f); log_f = NULL;
-        rpl.run_block = NULL;
-        compile_request_packet_free(req);
-        continue;
-      }
+    save_heartbeat();
+    if (pending_stop_flag || pending_down_flag || pending_reboot_flag) {
+      break;
     }
 
-    override_exe = 0;
-    exe_copied = 0;
-    handle_packet(log_f, &serve_state, pkt_name, req, &rpl,
-                  lang,
-                  contest_server_id,
-                  run_name,
-                  src_path,
-                  src_buf,
-                  src_len,
-                  exe_sfx,
-                  exe_path,
-                  full_working_dir,
-                  log_work_path,
-                  exe_work_name,
-                  &override_exe,
-                  &exe_copied);
-
-    free(src_buf); src_buf = NULL; src_len = 0;
-
-    get_current_time(&rpl.ts3, &rpl.ts3_us);
-    long long current_time_ms = rpl.ts3 * 1000LL + rpl.ts3_us / 1000;
-    accumulated_ms += (current_time_ms - last_handled_request_ms);
-    ++request_count;
-
-    if (rpl.status == RUN_OK && !override_exe && !exe_copied) {
-      if (!exe_work_name[0]) {
-        err("the resulting executable name is empty");
-        fprintf(log_f, "\ncompiler output file is empty\n");
-        rpl.status = RUN_CHECK_FAILED;
-      } else {
-        unsigned char exe_work_path[PATH_MAX];
-        snprintf(exe_work_path, sizeof(exe_work_path), "%s/%s", full_working_dir, exe_work_name);
-        struct stat stb;
-
-        if (lstat(exe_work_path, &stb) < 0) {
-          err("the resulting executable '%s' does not exist", exe_work_path);
-          fprintf(log_f, "\ncompiler output file '%s' does not exist\n", exe_work_path);
-          rpl.status = RUN_COMPILE_ERR;
-        } else {
-          if (!S_ISREG(stb.st_mode)) {
-            err("the resulting executable '%s' is not a regular file", exe_work_path);
-            fprintf(log_f, "\ncompiler output file '%s' is not a regular file\n", exe_work_path);
-            rpl.status = RUN_CHECK_FAILED;
-          } else if (stb.st_size > MAX_EXE_SIZE) {
-            err("the resulting executable '%s' is too large (size = %lld)", exe_work_path, (long long) stb.st_size);
-            fprintf(log_f, "\ncompiler output file '%s' is too large\n (size = %lld)", exe_work_path, (long long) stb.st_size);
-            rpl.status = RUN_COMPILE_ERR;
-          } else {
-            if (agent) {
-              if (req->enable_remote_cache > 0 && local_cache && *local_cache
-                  && ej_uuid_is_nonempty(req->judge_uuid)) {
-                if (copy_to_local_cache(req, exe_work_path, exe_sfx) >= 0) {
-                  rpl.cached_on_remote = 1;
-                }
-              }
-              if (agent->ops->put_output_2(agent,
-                                           contest_server_id,
-                                           rpl.contest_id,
-                                           run_name,
-                                           exe_sfx,
-                                           exe_work_path) < 0) {
-                err("put_output failed");
-                fprintf(log_f, "\nput_output failed\n");
-                rpl.status = RUN_CHECK_FAILED;
-              }
-            } else if (rename(exe_work_path, exe_path) >= 0) {
-              // good!
-            } else if (errno != EXDEV) {
-              int e = errno;
-              err("rename %s -> %s failed: %s", exe_work_path, exe_path, strerror(e));
-              fprintf(log_f, "\nrename %s -> %s failed: %s\n", exe_work_path, exe_path, strerror(e));
-              rpl.status = RUN_CHECK_FAILED;
-            } else {
-              if (generic_copy_file(0, NULL, exe_work_path, "", 0, NULL, exe_path, "") < 0) {
-                fprintf(log_f, "\ncopy %s -> %s failed\n", exe_work_path, exe_path);
-                rpl.status = RUN_CHECK_FAILED;
-              }
-            }
-          }
-        }
+    while (pending_u < pending_a) {
+      int r = read_pending_request(spool_queue, &pending[pending_u]);
+      if (r < 0) {
+        err("spool queue error, sleep for 5 seconds");
+        interrupt_enable();
+        os_Sleep(5000);
+        interrupt_disable();
+        break;
       }
+      if (!r) break;
+      if (r == 2) continue;
+      ++pending_u;
+      changed = 1;
     }
 
-    fclose(log_f); log_f = NULL;
-
-    if (agent) {
-      r = agent->ops->put_output_2(agent,
-                                   contest_server_id,
-                                   rpl.contest_id,
-                                   run_name,
-                                   ".txt",
-                                   log_work_path);
-    } else {
-      r = generic_copy_file(0, NULL, log_work_path, "", 0, NULL, log_path, "");
+    long long current_ms = get_current_time_ms();
+    int idx;
+    while ((idx = select_pending_request(pending, pending_u, slots, slot_count, current_ms)) >= 0) {
+      int si;
+      for (si = 0; si < slot_count && slots[si].pid > 0; ++si) {}
+      if (si >= slot_count) break;
+      if (start_compile_slot(slots, si, &pending[idx], slot_count) < 0) break;
+      spool_claim_remove(claim_dir, pending[idx].pkt_name);
+      free_pending_request(&pending[idx]);
+      memmove(&pending[idx], &pending[idx + 1], (pending_u - idx - 1) * sizeof(pending[0]));
+      --pending_u;
+      memset(&pending[pending_u], 0, sizeof(pending[0]));
+      changed = 1;
     }
-    if (r < 0) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      clear_directory(full_working_dir);
-      unlink(exe_path);
-      unlink(log_path);
-      continue;
+    if (changed) continue;
+
+    // a pending request may become overdue
+    int timeout_ms = HEARTBEAT_UPDATE_MS;
+    if (pending_u > 0) timeout_ms = 1000;
+    struct epoll_event events[1];
+    int r = epoll_pwait(efd, events, 1, timeout_ms, &emptymask);
+    if (r == 1) {
+      if (events[0].data.fd != ifd) abort();
+      spool_queue_update(spool_queue);
     }
+  }
 
-    if (override_exe || (rpl.status == RUN_STYLE_ERR || rpl.status == RUN_COMPILE_ERR || rpl.status == RUN_CHECK_FAILED)) {
-      if (agent) {
-        agent->ops->put_output_2(agent, contest_server_id, rpl.contest_id, run_name, exe_sfx, log_work_path);
-      } else {
-        generic_copy_file(0, NULL, log_work_path, "", 0, NULL, exe_path, "");
-      }
-    }
+  retval = 0;
 
-    void *rpl_pkt = NULL;
-    size_t rpl_size = 0;
-    if (compile_reply_packet_write(&rpl, &rpl_size, &rpl_pkt) < 0) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      clear_directory(full_working_dir);
-      unlink(exe_path);
-      unlink(log_path);
-      continue;
-    }
-    if (agent) {
-      r = agent->ops->put_reply(agent, contest_server_id, rpl.contest_id, run_name, rpl_pkt, rpl_size);
-    } else {
-      r = generic_write_file(rpl_pkt, rpl_size, SAFE, status_dir, run_name, 0);
+cleanup:
+  // the compilations in progress are completed
+  if (slots) {
+    for (int i = 0; i < slot_count; ++i) {
+      while (slots[i].pid > 0) {
+        reap_compile_slots(slots, slot_count, 1);
+      }
     }
-    if (r < 0) {
-      rpl.run_block = NULL;
-      compile_request_packet_free(req);
-      xfree(rpl_pkt);
-      clear_directory(full_working_dir);
-      unlink(exe_path);
-      unlink(log_path);
-      continue;
+  }
+  // the requests not started yet are returned to the spool
+  for (int i = 0; i < pending_u; ++i) {
+    if (spool_claim_return(compile_server_queue_dir, claim_dir, pending[i].pkt_name) < 0) {
+      err("failed to return packet '%s' to the spool: %s", pending[i].pkt_name, os_ErrorMsg());
     }
-
-    // all good
-    rpl.run_block = NULL;
-    compile_request_packet_free(req);
-    xfree(rpl_pkt);
-    clear_directory(full_working_dir);
+    free_pending_request(&pending[i]);
   }
-
-  delete_heartbeat();
-
-  if (agent) {
-    agent->ops->close(agent);
+  if (claim_dir[0]) {
+    spool_claim_fini(claim_dir);
+    claim_dir[0] = 0;
   }
-
+  delete_heartbeat();
+  if (efd >= 0) close(efd);
+  spool_queue_free(spool_queue);
+  xfree(pending);
+  xfree(slots);
   return retval;
 }
 
@@ -2318,6 +3986,32 @@ main(int argc, char *argv[])
       local_cache = xstrdup(argv[i++]);
       argv_restart[j++] = argv[i];
       argv_restart[j++] = argv[i - 1];
+    } else if (!strcmp(argv[i], "--compile-cache-size")) {
+      if (++i >= argc) goto print_usage;
+      if (size_str_to_size64_t(argv[i], &compile_cache_size) < 0 || compile_cache_size < 0) {
+        fprintf(stderr, "%s: invalid argument for --compile-cache-size: %s\n", argv[0], argv[i]);
+        return 1;
+      }
+      ++i;
+      argv_restart[j++] = argv[i - 2];
+      argv_restart[j++] = argv[i - 1];
+    } else if (!strcmp(argv[i], "--style-pipeline")) {
+      style_pipeline_mode = 1;
+      argv_restart[j++] = argv[i];
+      ++i;
+    } else if (!strcmp(argv[i], "--prefetch")) {
+      prefetch_mode = 1;
+      argv_restart[j++] = argv[i];
+      ++i;
+    } else if (!strcmp(argv[i], "--slots")) {
+      if (++i >= argc) goto print_usage;
+      if ((supervisor_slots = strtol(argv[i], NULL, 10)) <= 0 || supervisor_slots > 128) {
+        fprintf(stderr, "%s: invalid argument for --slots: %s\n", argv[0], argv[i]);
+        return 1;
+      }
+      ++i;
+      argv_restart[j++] = argv[i - 2];
+      argv_restart[j++] = argv[i - 1];
     } else if (!strcmp(argv[i], "-p")) {
       parallel_mode = 1;
       ++i;
@@ -2421,6 +4115,16 @@ main(int argc, char *argv[])
     return 1;
   }
   if (parallelism > 1) parallel_mode = 1;
+  if (style_pipeline_mode < 0) {
+    style_pipeline_mode = ejudge_cfg_get_host_option_int(ejudge_config, host_names, "compile_style_pipeline", 0, 0);
+  }
+  if (supervisor_slots <= 0) {
+    supervisor_slots = ejudge_cfg_get_host_option_int(ejudge_config, host_names, "compile_slots", 1, 0);
+  }
+  if (supervisor_slots <= 0 || supervisor_slots > 128) {
+    fprintf(stderr, "%s: invalid value of compile_slots host option\n", argv[0]);
+    return 1;
+  }
   for (int hi = 0; host_names[hi]; ++hi) {
     free(host_names[hi]);
   }
@@ -2638,6 +4342,19 @@ main(int argc, char *argv[])
   if (local_cache && *local_cache) {
     if (make_dir(local_cache, 0770) < 0) return 1;
   }
+  if (compile_cache_size > 0) {
+#if defined EJUDGE_COMPILE_SPOOL_DIR
+    snprintf(compile_cache_dir, sizeof(compile_cache_dir), "%s/cache", compile_server_spool_dir);
+#else
+    snprintf(compile_cache_dir, sizeof(compile_cache_dir), "%s/cache", serve_state.global->compile_dir);
+#endif
+    if (make_dir(compile_cache_dir, 0700) < 0) return 1;
+  }
+#if defined EJUDGE_COMPILE_SPOOL_DIR
+  snprintf(compile_pch_dir, sizeof(compile_pch_dir), "%s/pch", compile_server_spool_dir);
+#else
+  snprintf(compile_pch_dir, sizeof(compile_pch_dir), "%s/pch", serve_state.global->compile_dir);
+#endif
 
   if (initialize_mode) return 0;
 
@@ -2674,7 +4391,11 @@ main(int argc, char *argv[])
   xfree(lang_log_t); lang_log_t = 0; lang_log_z = 0;
 #endif /* HAVE_OPEN_MEMSTREAM */
 
-  if (new_loop(parallel_mode, log_path) < 0) return 1;
+  if (supervisor_slots > 1 && !(agent_name && *agent_name)) {
+    if (supervisor_loop(parallel_mode, supervisor_slots, log_path) < 0) return 1;
+  } else {
+    if (new_loop(parallel_mode, log_path) < 0) return 1;
+  }
 
   if (pending_down_flag) {
     info("DOWN request from the server");
@@ -2713,5 +4434,9 @@ main(int argc, char *argv[])
   printf("  -c C   - substitute ${COMPILE_HOME_DIR} for C in the config\n");
   printf("  -a A   - use agent A to access to compile queue\n");
   printf("  -s I   - set instance Id to I\n");
+  printf("  --compile-cache-size SIZE - cache the compilation results up to SIZE bytes\n");
+  printf("  --slots N - start the compilations in N worker slots\n");
+  printf("  --style-pipeline - run the style checker together with the compiler\n");
+  printf("  --prefetch - claim the next packet while the current one is compiled\n");
   return code;
 }
@@ -117,6 +117,8 @@ do_loop(void)
   path_t full_report_dir;
   path_t full_status_dir;
   path_t full_full_dir;
+  const unsigned char *zip_suffix;
+  size_t full_report_len;
 
   char   exe_name[64];
   int    tester_id;
@@ -388,19 +390,16 @@ do_loop(void)
     if (generic_copy_file(0, NULL, report_path, "",
                           0, full_report_dir, run_base, "") < 0)
       return -1;
-#if defined CONF_HAS_LIBZIP
+    // the indexed archive is written without .zip suffix
+    zip_suffix = "";
+    if ((full_report_len = strlen(full_report_path)) > 4
+        && !strcmp(full_report_path + full_report_len - 4, ".zip"))
+      zip_suffix = ".zip";
     if (full_report_path[0]
         && generic_copy_file(0, NULL, full_report_path, "",
                              0, full_full_dir,
-                             run_base, ".zip") < 0)
+                             run_base, zip_suffix) < 0)
       return -1;
-#else
-    if (full_report_path[0]
-        && generic_copy_file(0, NULL, full_report_path, "",
-                             0, full_full_dir,
-                             run_base, "") < 0)
-      return -1;
-#endif
 
     //run_reply_packet_dump(&reply_pkt);
 
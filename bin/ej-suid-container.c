@@ -50,6 +50,7 @@
 #include <netinet/ip.h>
 #include <net/if.h>
 #include <arpa/inet.h>
+#include <linux/perf_event.h>
 
 #include "config.h"
 
@@ -143,6 +144,7 @@ static int enable_loopback = 0;
 static int enable_vm_limit = 1;
 static int enable_mem_limit_detect = 0;
 static int enable_security_detect = 0;
+static int enable_perf_counters = 0;
 
 static int enable_seccomp = 1;
 static int enable_sys_execve = 0;
@@ -195,6 +197,7 @@ static long long limit_file_size = -1;
 static int limit_processes = 5;
 static int limit_cpu_time_ms = DEFAULT_LIMIT_CPU_TIME_MS;
 static int limit_real_time_ms = 5000;
+static long long limit_instructions = -1;
 
 static char *start_program;
 static char **start_args;
@@ -1342,6 +1345,8 @@ struct CGroupStat
     long long usage_us;
     long long user_us;
     long long system_us;
+    // memory.peak (v2 only)
+    long long memory_peak;
 };
 
 static void
@@ -1377,7 +1382,22 @@ read_cgroup_stats_v2(struct CGroupStat *ps)
             ps->system_us = vval;
         }
     }
-    fclose(f);
+    fclose(f); f = NULL;
+
+    // memory.peak is available since linux 5.19
+    char memory_peak_path[PATH_MAX];
+    if (snprintf(memory_peak_path, sizeof(memory_peak_path),
+                 "%s/ejudge/%s/memory.peak",
+                 cgroup_path, cgroup_name) >= sizeof(memory_peak_path)) {
+        goto fail;
+    }
+    if ((f = fopen(memory_peak_path, "r"))) {
+        long long vval;
+        if (fscanf(f, "%lld", &vval) == 1 && vval > 0) {
+            ps->memory_peak = vval;
+        }
+    }
+    if (f) fclose(f);
     return;
 
 fail:
@@ -1435,6 +1455,49 @@ read_cgroup_stats(struct CGroupStat *ps)
     }
 }
 
+struct PerfCounters
+{
+    int task_clock_fd;
+    int instructions_fd;
+};
+
+static int
+open_perf_counter(int pid, unsigned type, unsigned long long config, int exclude_kernel)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // start counting when the tested program is exec'ed, include its children
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = exclude_kernel;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+static void
+open_perf_counters(int pid, struct PerfCounters *pc)
+{
+    pc->task_clock_fd = open_perf_counter(pid, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, 0);
+    if (pc->task_clock_fd < 0) {
+        flog("perf_event_open for task-clock failed: %s", strerror(errno));
+    }
+    // hardware counters are often unavailable in virtual machines
+    pc->instructions_fd = open_perf_counter(pid, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1);
+}
+
+static long long
+read_perf_counter(int fd)
+{
+    uint64_t val = 0;
+    if (fd < 0) return -1;
+    if (read(fd, &val, sizeof(val)) != sizeof(val)) return -1;
+    return (long long) val;
+}
+
 static struct sock_filter seccomp_filter_default[] =
 {
     // load syscall number
@@ -2114,6 +2177,9 @@ main(int argc, char *argv[])
             } else if (*opt == 'm' && opt[1] == 'E') {
                 enable_security_detect = 1;
                 opt += 2;
+            } else if (*opt == 'm' && opt[1] == 'T') {
+                enable_perf_counters = 1;
+                opt += 2;
             } else if (*opt == 'w') {
                 working_dir = extract_string(&opt, 1, "w");
             } else if (*opt == 'r' && opt[1] == 'n') {
@@ -2216,6 +2282,17 @@ main(int argc, char *argv[])
                 if (!v) v = -1;
                 limit_real_time_ms = v;
                 opt = eptr;
+            } else if (*opt == 'l' && opt[1] == 'I') {
+                char *eptr = NULL;
+                errno = 0;
+                long long v = strtoll(opt + 2, &eptr, 10);
+                if (errno || eptr == opt + 2 || v < 0) {
+                    ffatal("invalid instructions limit");
+                }
+                if (!v) v = -1;
+                limit_instructions = v;
+                enable_perf_counters = 1;
+                opt = eptr;
             } else if (*opt == 's' && opt[1] == '0') {
                 enable_seccomp = 0;
                 opt += 2;
@@ -2424,6 +2501,12 @@ main(int argc, char *argv[])
             set_cgroup_rss_limit();
         }
 
+        // the program waits until the perf counters are attached
+        int perf_sync_pipe[2] = { -1, -1 };
+        if (enable_perf_counters && pipe2(perf_sync_pipe, O_CLOEXEC) < 0) {
+            ffatal("pipe2 failed: %s", strerror(errno));
+        }
+
         // we need another child, because this one has PID 1
         int pid2 = fork();
         if (pid2 < 0) {
@@ -2431,6 +2514,9 @@ main(int argc, char *argv[])
         }
 
         if (!pid2) {
+            if (perf_sync_pipe[1] >= 0) {
+                close(perf_sync_pipe[1]);
+            }
             if (response_fd != 2) {
                 close(response_fd);
                 response_fd = -1;
@@ -2567,6 +2653,14 @@ main(int argc, char *argv[])
                 setenv("HOME", compile_dir, 1);
             }
 
+            if (perf_sync_pipe[0] >= 0) {
+                char c;
+                if (read(perf_sync_pipe[0], &c, 1) < 0) {
+                    fprintf(stderr, "failed to wait for perf counters: %s\n", strerror(errno));
+                    _exit(127);
+                }
+            }
+
             if (bash_mode) {
                 printf("child: %d, %d, %d\n", getpid(), getppid(), tidptr);
                 printf("init success, starting /bin/bash\n");
@@ -2593,6 +2687,22 @@ main(int argc, char *argv[])
         if (stderr_fd >= 0) close(stderr_fd);
         stdin_fd = -1; stdout_fd = -1; stderr_fd = -1;
 
+        struct PerfCounters perf_counters = { -1, -1 };
+        if (enable_perf_counters) {
+            close(perf_sync_pipe[0]);
+            open_perf_counters(pid2, &perf_counters);
+            if (limit_instructions > 0 && perf_counters.instructions_fd < 0) {
+                kill_all();
+                ffatal("instructions limit is set, but the instructions counter is unavailable: %s", strerror(errno));
+            }
+            // the counters are informational, so the program is started anyway
+            if (write(perf_sync_pipe[1], "", 1) < 0) {
+                kill_all();
+                ffatal("failed to start the program: %s", strerror(errno));
+            }
+            close(perf_sync_pipe[1]);
+        }
+
         int sfd = signalfd(-1, &bs, 0);
         if (sfd < 0) {
             kill_all();
@@ -2737,6 +2847,10 @@ main(int argc, char *argv[])
                         if (limit_cpu_time_ms > 0 && cur_cpu_time >= limit_cpu_time_ms) {
                             prc_time_exceeded = 1;
                             kill(pid2, SIGKILL);
+                        } else if (limit_instructions > 0
+                                   && read_perf_counter(perf_counters.instructions_fd) >= limit_instructions) {
+                            prc_time_exceeded = 1;
+                            kill(pid2, SIGKILL);
                         } else {
                             long long cur_time_us = 0;
                             {
@@ -2797,6 +2911,12 @@ main(int argc, char *argv[])
             ipc_objects += scan_shm(slave_uid);
         }
 
+        // the counters of the terminated children are already accumulated
+        long long perf_task_clock_ns = read_perf_counter(perf_counters.task_clock_fd);
+        long long perf_instructions = read_perf_counter(perf_counters.instructions_fd);
+        if (perf_counters.task_clock_fd >= 0) close(perf_counters.task_clock_fd);
+        if (perf_counters.instructions_fd >= 0) close(perf_counters.instructions_fd);
+
         long long cpu_utime_us = prc_usage.ru_utime.tv_sec * 1000000LL + prc_usage.ru_utime.tv_usec;
         long long cpu_stime_us = prc_usage.ru_stime.tv_sec * 1000000LL + prc_usage.ru_stime.tv_usec;
         long long cpu_time_us = cpu_utime_us + cpu_stime_us;
@@ -2813,6 +2933,9 @@ main(int argc, char *argv[])
             prc_real_time_exceeded = 1;
             real_time_us = limit_real_time_ms * 1000LL;
         }
+        if (limit_instructions > 0 && perf_instructions >= limit_instructions) {
+            prc_time_exceeded = 1;
+        }
 
         // heuristics to detect OOM condition
         if (!prc_time_exceeded && !prc_real_time_exceeded
@@ -2866,6 +2989,15 @@ main(int argc, char *argv[])
             if (cgstat.system_us > 0) {
                 dprintf(response_fd, "cs%lld", cgstat.system_us);
             }
+            if (cgstat.memory_peak > 0) {
+                dprintf(response_fd, "cm%lld", cgstat.memory_peak);
+            }
+        }
+        if (perf_task_clock_ns > 0) {
+            dprintf(response_fd, "pt%lld", perf_task_clock_ns / 1000);
+        }
+        if (perf_instructions > 0) {
+            dprintf(response_fd, "pi%lld", perf_instructions);
         }
 
         if (log_f) {
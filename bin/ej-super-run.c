@@ -31,7 +31,11 @@
 #include "ejudge/xml_utils.h"
 #include "ejudge/ej_uuid.h"
 #include "ejudge/super_run_status.h"
+#include "ejudge/super_run_progress.h"
 #include "ejudge/agent_client.h"
+#include "ejudge/misctext.h"
+#include "ejudge/spool_queue.h"
+#include "ejudge/exe_store.h"
 
 #include "ejudge/xalloc.h"
 #include "ejudge/osdeps.h"
@@ -51,6 +55,10 @@
 #include <sys/inotify.h>
 #include <sys/epoll.h>
 #include <sys/mman.h>
+#include <sys/mount.h>
+#include <sched.h>
+#include <pwd.h>
+#include <grp.h>
 #include <fcntl.h>
 
 enum { DEFAULT_WAIT_TIMEOUT_MS = 300000 }; // 5m
@@ -91,6 +99,7 @@ static unsigned char *status_file_name = NULL;
 static unsigned char *agent_name = NULL;
 static unsigned char *agent_instance_id = NULL;
 static struct AgentClient *agent;
+static struct super_run_progress *progress;
 static int verbose_mode;
 static int daemon_mode;
 static unsigned char *ip_address = NULL;
@@ -104,6 +113,11 @@ static int ignore_rejudge = 0;
 static unsigned char **host_names = NULL;
 static unsigned char *mirror_dir = NULL;
 static unsigned char *local_cache = NULL;
+static ej_size64_t tmpfs_size = 0;
+static ej_size64_t gen_cache_size = 0;
+static unsigned char tmpfs_dir[PATH_MAX];
+static int builtin_checkers_mode = 0;
+static int prefetch_mode = 0;
 
 #define HEARTBEAT_SAVE_INTERVAL_MS 5000
 static long long last_heartbear_save_time = 0;
@@ -205,13 +219,14 @@ struct super_run_listener
   long long queue_ts;
   long long testing_start_ts;
   int test_count;
+  ej_uuid_t run_uuid;
 };
 
 static void
 do_super_run_status_init(struct super_run_status *prs);
 
 static void
-super_run_before_tests(struct run_listener *gself, int test_no)
+super_run_before_tests(struct run_listener *gself, int test_no, long long cpu_ms)
 {
   struct super_run_listener *self = (struct super_run_listener *) gself;
   if (!heartbeat_mode) return;
@@ -223,6 +238,22 @@ super_run_before_tests(struct run_listener *gself, int test_no)
   gettimeofday(&ctv, NULL);
   long long current_time_ms = ((long long) ctv.tv_sec) * 1000 + ctv.tv_usec / 1000;
 
+  if (progress) {
+    // the progress table is cheap to update, so it is updated on every test
+    struct super_run_progress_info info = {};
+    info.update_ms = current_time_ms;
+    info.start_ms = self->testing_start_ts;
+    info.cpu_ms = cpu_ms;
+    info.run_uuid = self->run_uuid;
+    info.status = SRS_TESTING;
+    info.contest_id = self->contest_id;
+    info.run_id = self->run_id;
+    info.test_num = test_no;
+    info.test_count = self->test_count;
+    snprintf(info.file_name, sizeof(info.file_name), "%s", status_file_name);
+    super_run_progress_update(progress, &info);
+  }
+
   rs.timestamp = current_time_ms;
   rs.last_run_ts = current_time_ms;
   rs.status = SRS_TESTING;
@@ -375,12 +406,85 @@ move_from_local_cache(
   return 0;
 }
 
+/*
+ * In the prefetch mode the next packet is claimed before the current
+ * run is started, and its executable is downloaded from the agent
+ * in background meanwhile. A packet from the local spool is kept in
+ * the claim directory of the process until it is handled.
+ */
+static unsigned char claim_dir[PATH_MAX];
+
+struct prefetched_packet
+{
+  unsigned char pkt_name[PATH_MAX];
+  char *pkt_data;
+  size_t pkt_size;
+  unsigned char *exe_sfx;
+  struct Future *exe_future;
+};
+
+/* puts the prefetched executable back, or drops it, if 'exe_sfx' is NULL */
+static void
+return_prefetched_exe(
+        const unsigned char *pkt_name,
+        struct Future **p_exe_future,
+        const unsigned char *exe_sfx)
+{
+  char *data = NULL;
+  size_t size = 0;
+
+  if (!*p_exe_future) return;
+  if (agent->ops->get_data_async_complete(agent, p_exe_future, &data, &size) > 0 && exe_sfx) {
+    if (agent->ops->put_data(agent, pkt_name, exe_sfx, data, size) < 0) {
+      err("failed to return executable for packet %s", pkt_name);
+    }
+  }
+  free(data);
+}
+
+static int
+write_prefetched_exe(
+        struct Future **p_exe_future,
+        const unsigned char *dir,
+        const unsigned char *name,
+        const unsigned char *sfx)
+{
+  char *data = NULL;
+  size_t size = 0;
+
+  int r = agent->ops->get_data_async_complete(agent, p_exe_future, &data, &size);
+  if (r > 0 && generic_write_file(data, size, 0, dir, name, sfx) < 0) {
+    r = -1;
+  }
+  free(data);
+  return r;
+}
+
+/* puts the packet being handled back to the queue */
+static void
+return_packet(
+        const unsigned char *pkt_name,
+        const char *srp_b,
+        size_t srp_z,
+        struct Future **p_exe_future,
+        const unsigned char *exe_sfx)
+{
+  if (agent) {
+    // the executable must be in place before the packet is visible
+    if (p_exe_future) return_prefetched_exe(pkt_name, p_exe_future, exe_sfx);
+    agent->ops->put_packet(agent, pkt_name, srp_b, srp_z);
+  } else {
+    generic_write_file(srp_b, srp_z, SAFE, super_run_spool_path, pkt_name, "");
+  }
+}
+
 static int
 handle_packet(
         serve_state_t state,
         const unsigned char *pkt_name,
         char *srp_b,
-        size_t srp_z)
+        size_t srp_z,
+        struct Future **p_exe_future)
 {
   int r;
   struct super_run_in_packet *srp = NULL;
@@ -396,6 +500,9 @@ handle_packet(
 
   unsigned char exe_pkt_name[PATH_MAX];
   unsigned char exe_name[PATH_MAX];
+  unsigned char exe_queue_path[PATH_MAX];
+  unsigned char exe_work_path[PATH_MAX];
+  unsigned char exe_sha256[32];
   unsigned char reply_packet_name[PATH_MAX];
 
   struct section_global_data *global = state->global;
@@ -428,12 +535,14 @@ handle_packet(
     } else {
       r = 1;
     }
-  } else {
+  } else if (!srp_b) {
     r = generic_read_file(&srp_b, 0, &srp_z, SAFE | REMOVE, super_run_spool_path, pkt_name, "");
     if (r < 0) {
       err("generic_read_file failed for packet %s in %s", pkt_name, super_run_spool_path);
       goto cleanup;
     }
+  } else {
+    r = 1;
   }
   if (r == 0) {
     // ignore this packet
@@ -475,11 +584,7 @@ handle_packet(
 
   if (is_packet_to_ignore(pkt_name, srgp->contest_id, srgp->rejudge_flag, short_name, arch)) {
     retval = 0;
-    if (agent) {
-      agent->ops->put_packet(agent, pkt_name, srp_b, srp_z);
-    } else {
-      generic_write_file(srp_b, srp_z, SAFE, super_run_spool_path, pkt_name, "");
-    }
+    return_packet(pkt_name, srp_b, srp_z, p_exe_future, srgp->exe_sfx);
     goto cleanup;
   }
 
@@ -500,24 +605,32 @@ handle_packet(
       if (!tst) {
         err("no support for architecture %s here", arch);
         retval = 0;
-        if (agent) {
-          agent->ops->put_packet(agent, pkt_name, srp_b, srp_z);
-        } else {
-          generic_write_file(srp_b, srp_z, SAFE, super_run_spool_path, pkt_name, "");
-        }
+        return_packet(pkt_name, srp_b, srp_z, p_exe_future, srgp->exe_sfx);
         goto cleanup;
       }
     }
 
     snprintf(exe_pkt_name, sizeof(exe_pkt_name), "%s%s", pkt_name, srgp->exe_sfx);
     snprintf(exe_name, sizeof(exe_name), "%s%s", run_base, srgp->exe_sfx);
+    snprintf(exe_queue_path, sizeof(exe_queue_path), "%s/%s", super_run_exe_path, exe_pkt_name);
+    snprintf(exe_work_path, sizeof(exe_work_path), "%s/%s", global->run_work_dir, exe_name);
 
     if (agent) {
-      r = agent->ops->get_data_2(agent, pkt_name, srgp->exe_sfx,
-                                 global->run_work_dir, run_base, srgp->exe_sfx);
+      if (p_exe_future && *p_exe_future) {
+        r = write_prefetched_exe(p_exe_future, global->run_work_dir, run_base, srgp->exe_sfx);
+      } else {
+        r = agent->ops->get_data_2(agent, pkt_name, srgp->exe_sfx,
+                                   global->run_work_dir, run_base, srgp->exe_sfx);
+      }
       if (local_cache && *local_cache && srgp->judge_uuid && *srgp->judge_uuid && srgp->cached_on_remote > 0) {
         move_from_local_cache(srgp->judge_uuid, global->run_work_dir, run_base, srgp->exe_sfx);
       }
+    } else if (srgp->exe_sha256 && exe_store_dir()
+               && exe_store_parse_hash(srgp->exe_sha256, exe_sha256) >= 0
+               && exe_store_get(exe_store_dir(), exe_sha256, exe_work_path) >= 0) {
+      // the executable is linked from the store, the queued file is not needed
+      unlink(exe_queue_path);
+      r = 1;
     } else {
       r = generic_copy_file(REMOVE, super_run_exe_path, exe_pkt_name, "",
                             0, global->run_work_dir, exe_name, "");
@@ -525,11 +638,7 @@ handle_packet(
     if (r <= 0) {
       // FIXME: handle this differently?
       retval = 0;
-      if (agent) {
-        agent->ops->put_packet(agent, pkt_name, srp_b, srp_z);
-      } else {
-        generic_write_file(srp_b, srp_z, SAFE, super_run_spool_path, pkt_name, "");
-      }
+      return_packet(pkt_name, srp_b, srp_z, NULL, NULL);
       goto cleanup;
     }
 
@@ -610,6 +719,7 @@ handle_packet(
       run_listener.user = srgp->user_login;
     }
     run_listener.test_count = srpp->test_count;
+    run_listener.run_uuid = reply_pkt.uuid;
 
     //if (cr_serialize_lock(state) < 0) return -1;
     run_tests(ejudge_config, state, tst, srp, &reply_pkt,
@@ -686,39 +796,19 @@ handle_packet(
     snprintf(reply_packet_name, sizeof(reply_packet_name), "%s", run_base);
   }
 
+  // the indexed archive is written without .zip suffix
+  const unsigned char *zip_suffix = "";
+  size_t full_report_len = strlen(full_report_path);
+  if (full_report_len > 4 && !strcmp(full_report_path + full_report_len - 4, ".zip")) {
+    zip_suffix = ".zip";
+  }
+
   // copy full report from temporary location
-  if (agent) {
-    if (agent->ops->put_output_2(agent,
-                                 srgp->contest_server_id,
-                                 srgp->contest_id,
-                                 reply_packet_name,
-                                 "",
-                                 report_path) < 0) {
-      goto cleanup;
-    }
-  } else {
+  if (!agent) {
     if (generic_copy_file(0, NULL, report_path, "", 0, full_report_dir, reply_packet_name, "") < 0) {
       goto cleanup;
     }
-  }
-
-#if defined CONF_HAS_LIBZIP
-  const unsigned char *zip_suffix = ".zip";
-#else
-  const unsigned char *zip_suffix = "";
-#endif
-
-  if (full_report_path[0]) {
-    if (agent) {
-      if (agent->ops->put_archive_2(agent,
-                                    srgp->contest_server_id,
-                                    srgp->contest_id,
-                                    reply_packet_name,
-                                    zip_suffix,
-                                    full_report_path) < 0) {
-        goto cleanup;
-      }
-    } else {
+    if (full_report_path[0]) {
       if (generic_copy_file(0, NULL, full_report_path, "", 0, full_full_dir, reply_packet_name, zip_suffix) < 0) {
         goto cleanup;
       }
@@ -732,11 +822,19 @@ handle_packet(
   }
 
   if (agent) {
-    if (agent->ops->put_reply(agent,
-                              srgp->contest_server_id,
-                              srgp->contest_id,
-                              reply_packet_name,
-                              reply_pkt_buf, reply_pkt_buf_size) < 0)
+    // the report, the archive and the reply in one exchange
+    struct AgentResultFile result_files[2] =
+    {
+      { AGENT_RESULT_REPORT, "", report_path },
+      { AGENT_RESULT_ARCHIVE, zip_suffix, full_report_path },
+    };
+    if (agent->ops->put_results(agent,
+                                srgp->contest_server_id,
+                                srgp->contest_id,
+                                reply_packet_name,
+                                full_report_path[0]?2:1,
+                                result_files,
+                                reply_pkt_buf, reply_pkt_buf_size) < 0)
       goto cleanup;
   } else {
     if (generic_write_file(reply_pkt_buf, reply_pkt_buf_size, SAFE, full_status_dir, reply_packet_name, "") < 0) {
@@ -745,6 +843,10 @@ handle_packet(
   }
 
 cleanup:
+  if (p_exe_future && *p_exe_future) {
+    // the packet is dropped, the executable is not needed
+    return_prefetched_exe(pkt_name, p_exe_future, NULL);
+  }
   xfree(srp_b); srp_b = NULL; srp_z = 0;
   srp = super_run_in_packet_free(srp);
   xfree(reply_pkt_buf); reply_pkt_buf = NULL;
@@ -786,6 +888,15 @@ report_waiting_state(long long current_time_ms, long long last_check_time_ms)
 
   if (!heartbeat_mode) return;
 
+  if (progress) {
+    struct super_run_progress_info info = {};
+    info.update_ms = current_time_ms;
+    info.start_ms = last_check_time_ms;
+    info.status = SRS_WAITING;
+    snprintf(info.file_name, sizeof(info.file_name), "%s", status_file_name);
+    super_run_progress_update(progress, &info);
+  }
+
   do_super_run_status_init(&rs);
   rs.timestamp = current_time_ms;
   rs.last_run_ts = last_check_time_ms;
@@ -799,6 +910,76 @@ report_waiting_state(long long current_time_ms, long long last_check_time_ms)
   if (!master_reboot_enabled) pending_reboot_flag = 0;
 }
 
+static void
+prefetch_packet(
+        struct prefetched_packet *pp,
+        struct spool_queue *spool_queue,
+        struct Future **p_future)
+{
+  int r;
+
+  if (pp->pkt_name[0]) return;
+
+  if (agent) {
+    // the wait in progress is completed in background anyway
+    if (*p_future) return;
+    r = agent->ops->async_wait_init(agent, SIGUSR2, 1,
+                                    1,
+                                    pp->pkt_name, sizeof(pp->pkt_name), p_future,
+                                    DEFAULT_WAIT_TIMEOUT_MS,
+                                    &pp->pkt_data,
+                                    &pp->pkt_size);
+    if (r <= 0 || !pp->pkt_name[0]) {
+      if (r < 0) err("async_wait_init failed");
+      goto fail;
+    }
+    if (!pp->pkt_data) return;
+
+    struct super_run_in_packet *srp = super_run_in_packet_parse_cfg_str(pp->pkt_name, pp->pkt_data, pp->pkt_size);
+    if (srp && srp->global && srp->problem && srp->global->restart <= 0
+        && srp->problem->type_val != PROB_TYPE_TESTS && srp->global->exe_sfx) {
+      pp->exe_sfx = xstrdup(srp->global->exe_sfx);
+      if (agent->ops->get_data_async(agent, pp->pkt_name, pp->exe_sfx, &pp->exe_future) < 0) {
+        xfree(pp->exe_sfx); pp->exe_sfx = NULL;
+      }
+    }
+    super_run_in_packet_free(srp);
+  } else {
+    if (!claim_dir[0]) goto fail;
+    r = spool_queue_get(spool_queue, pp->pkt_name, sizeof(pp->pkt_name), 1);
+    if (r > 0) {
+      r = spool_claim_packet(super_run_spool_path, claim_dir, pp->pkt_name, &pp->pkt_data, &pp->pkt_size);
+    }
+    if (r <= 0) goto fail;
+  }
+  info("prefetched packet %s", pp->pkt_name);
+  return;
+
+fail:
+  pp->pkt_name[0] = 0;
+  free(pp->pkt_data); pp->pkt_data = NULL;
+  pp->pkt_size = 0;
+}
+
+/* puts the packet, which is not handled, back to the queue */
+static void
+return_prefetched_packet(struct prefetched_packet *pp)
+{
+  if (!pp->pkt_name[0]) return;
+
+  info("returning prefetched packet %s", pp->pkt_name);
+  if (!agent) {
+    if (spool_claim_return(super_run_spool_path, claim_dir, pp->pkt_name) < 0) {
+      err("failed to return packet %s: %s", pp->pkt_name, os_ErrorMsg());
+    }
+  } else if (pp->pkt_data) {
+    return_packet(pp->pkt_name, pp->pkt_data, pp->pkt_size, &pp->exe_future, pp->exe_sfx);
+  }
+  free(pp->pkt_data);
+  xfree(pp->exe_sfx);
+  memset(pp, 0, sizeof(*pp));
+}
+
 static int
 do_loop(
         serve_state_t state,
@@ -817,10 +998,14 @@ do_loop(
   size_t pkt_size = 0;
   int ifd = -1;
   int efd = -1;
-  int ifd_wd = -1;
+  struct spool_queue *spool_queue = NULL;
   sigset_t emptymask;
+  struct prefetched_packet next_packet;
+  struct Future *exe_future = NULL;
+  int pkt_claimed = 0;
 
   sigemptyset(&emptymask);
+  memset(&next_packet, 0, sizeof(next_packet));
 
   if (agent_name && *agent_name) {
     if (!strncmp(agent_name, "ssh:", 4)) {
@@ -843,18 +1028,17 @@ do_loop(
       return -1;
     }
   } else {
-    ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
-    if (ifd < 0) {
-      err("inotify_init1 failed: %s", os_ErrorMsg());
+    spool_queue = spool_queue_create(super_run_spool_path);
+    if (!spool_queue) {
+      err("failed to create spool queue for %s", super_run_spool_path);
       return -1;
     }
+    ifd = spool_queue_fd(spool_queue);
 
-    unsigned char srspd[PATH_MAX];
-    snprintf(srspd, sizeof(srspd), "%s/dir", super_run_spool_path);
-    ifd_wd = inotify_add_watch(ifd, srspd, IN_CREATE | IN_MOVED_TO);
-    if (ifd_wd < 0) {
-      err("inotify_add_watch failed: %s", os_ErrorMsg());
-      return -1;
+    // the packets prefetched by a dead process are returned to the spool
+    if (spool_claim_init(super_run_spool_path, claim_dir, sizeof(claim_dir)) < 0) {
+      err("failed to create claim directory in %s", super_run_spool_path);
+      claim_dir[0] = 0;
     }
 
     efd = epoll_create1(EPOLL_CLOEXEC);
@@ -872,6 +1056,15 @@ do_loop(
       err("epoll_ctl failed: %s", os_ErrorMsg());
       return -1;
     }
+
+    // the live progress is available only for the local ej-contests
+    if (heartbeat_mode) {
+      progress = super_run_progress_open(super_run_heartbeat_path, 1);
+      if (progress && super_run_progress_acquire(progress, status_file_name) < 0) {
+        super_run_progress_close(progress);
+        progress = NULL;
+      }
+    }
   }
 
   gettimeofday(&ctv, NULL);
@@ -923,7 +1116,17 @@ do_loop(
 
     r = 0;
     pkt_name[0] = 0;
-    if (agent) {
+    if (next_packet.pkt_name[0]) {
+      // claimed while the previous run was executing
+      snprintf(pkt_name, sizeof(pkt_name), "%s", next_packet.pkt_name);
+      pkt_data = next_packet.pkt_data;
+      pkt_size = next_packet.pkt_size;
+      exe_future = next_packet.exe_future;
+      xfree(next_packet.exe_sfx);
+      memset(&next_packet, 0, sizeof(next_packet));
+      pkt_claimed = !agent;
+      r = 1;
+    } else if (agent) {
       if (interrupt_was_usr2()) {
         interrupt_reset_usr2();
         if (future) {
@@ -960,9 +1163,14 @@ do_loop(
       }
       */
     } else {
-      r = scan_dir(super_run_spool_path, pkt_name, sizeof(pkt_name), 1);
+      r = spool_queue_get(spool_queue, pkt_name, sizeof(pkt_name), 1);
       if (r < 0) {
-        err("scan_dir failed for %s, waiting...", super_run_spool_path);
+        err("spool_queue_get failed for %s, waiting...", super_run_spool_path);
+      }
+      if (r > 0 && prefetch_mode) {
+        // the packet must leave the spool before the next one is looked up
+        r = generic_read_file(&pkt_data, 0, &pkt_size, SAFE | REMOVE, super_run_spool_path, pkt_name, "");
+        if (!r) continue;
       }
     }
     if (r < 0) {
@@ -992,12 +1200,7 @@ do_loop(
         int r = epoll_pwait(efd, events, 1, 30000, &emptymask);
         if (r == 1) {
           if (events[0].data.fd != ifd) abort();
-          // just read all the data in the ifd without any processing
-          unsigned char ibuf[4096];
-          while (1) {
-            int r = read(ifd, ibuf, sizeof(ibuf));
-            if (r <= 0) break;
-          }
+          spool_queue_update(spool_queue);
         }
       } else {
         interrupt_enable();
@@ -1007,14 +1210,22 @@ do_loop(
       continue;
     }
 
-    r = handle_packet(state, pkt_name, pkt_data, pkt_size);
+    if (prefetch_mode) {
+      prefetch_packet(&next_packet, spool_queue, &future);
+    }
+
+    r = handle_packet(state, pkt_name, pkt_data, pkt_size, &exe_future);
     pkt_data = NULL;
     pkt_size = 0;
+    if (pkt_claimed) {
+      spool_claim_remove(claim_dir, pkt_name);
+      pkt_claimed = 0;
+    }
     if (!r) {
       if (agent) {
         //agent->ops->add_ignored(agent, pkt_name);
       } else {
-        scan_dir_add_ignored(super_run_spool_path, pkt_name);
+        spool_queue_add_ignored(spool_queue, pkt_name);
       }
     }
 
@@ -1023,11 +1234,29 @@ do_loop(
     last_handled_ms = ((long long) ctv.tv_sec) * 1000 + ctv.tv_usec / 1000;
   }
 
+  if (agent && future && prefetch_mode) {
+    // the packet might be claimed while the last run was executing
+    r = agent->ops->async_wait_complete(agent, &future,
+                                        next_packet.pkt_name, sizeof(next_packet.pkt_name),
+                                        &next_packet.pkt_data,
+                                        &next_packet.pkt_size);
+    if (r <= 0) next_packet.pkt_name[0] = 0;
+  }
+  return_prefetched_packet(&next_packet);
+  if (claim_dir[0]) {
+    spool_claim_fini(claim_dir);
+    claim_dir[0] = 0;
+  }
+
+  super_run_progress_close(progress);
+  progress = NULL;
   super_run_status_remove(agent, super_run_heartbeat_path, status_file_name);
 
   if (agent) {
     agent->ops->close(agent);
   }
+  if (efd >= 0) close(efd);
+  spool_queue_free(spool_queue);
 
   return 0;
 }
@@ -1056,7 +1285,11 @@ write_help(void)
          "    -hc CMD      machine halt command\n"
          "    -hb          enable heartbeat mode (default)\n"
          "    -nhb         disable heartbeat mode\n"
-         "    -hi          set super_run id\n",
+         "    -hi          set super_run id\n"
+         "    --tmpfs-size SIZE use private tmpfs of SIZE for working directories\n"
+         "    --gen-cache-size SIZE cache the generated tests up to SIZE bytes\n"
+         "    --builtin-checkers run standard comparison checkers in-process\n"
+         "    --prefetch   claim the next packet while the current one is tested\n",
          program_name, program_name);
   exit(0);
 }
@@ -1096,6 +1329,116 @@ create_directories(void)
   }
 }
 
+static int
+is_mount_point(const unsigned char *path)
+{
+  unsigned char parent[PATH_MAX];
+  struct stat stb1, stb2;
+
+  snprintf(parent, sizeof(parent), "%s/..", path);
+  if (stat(path, &stb1) < 0 || !S_ISDIR(stb1.st_mode)) return 0;
+  if (stat(parent, &stb2) < 0) return 0;
+  return stb1.st_dev != stb2.st_dev;
+}
+
+/* like os_MakeDirPath, but newly created components are owned by uid:gid */
+static int
+make_owned_dir_path(const unsigned char *path, int mode, int uid, int gid)
+{
+  unsigned char buf[PATH_MAX];
+  int len = snprintf(buf, sizeof(buf), "%s", path);
+  if (len >= (int) sizeof(buf)) return -1;
+
+  for (int i = 1; i <= len; ++i) {
+    if (buf[i] != '/' && buf[i] != 0) continue;
+    unsigned char c = buf[i];
+    buf[i] = 0;
+    if (mkdir(buf, mode) >= 0) {
+      if (chown(buf, uid, gid) < 0) {
+        err("chown '%s' failed: %s", buf, os_ErrorMsg());
+        return -1;
+      }
+    } else if (errno != EEXIST) {
+      err("mkdir '%s' failed: %s", buf, os_ErrorMsg());
+      return -1;
+    }
+    buf[i] = c;
+  }
+  return 0;
+}
+
+static int
+mount_tmpfs(const unsigned char *path, int uid, int gid)
+{
+  unsigned char opts[256];
+
+  if (make_owned_dir_path(path, 0755, uid, gid) < 0) return -1;
+  snprintf(opts, sizeof(opts), "size=%lld,mode=0755,uid=%d,gid=%d",
+           (long long) tmpfs_size, uid, gid);
+  if (mount("tmpfs", path, "tmpfs", MS_NOSUID | MS_NODEV, opts) < 0) {
+    err("mounting tmpfs on '%s' failed: %s", path, os_ErrorMsg());
+    return -1;
+  }
+  info("tmpfs (%s) mounted on '%s'", opts, path);
+  return 0;
+}
+
+/*
+ * mount size-limited tmpfs for the working and the check directories
+ * in a private mount namespace, so the mounts disappear together
+ * with this process. Must be called before the privileges are dropped.
+ */
+static void
+setup_tmpfs_directories(
+        serve_state_t state,
+        const unsigned char *user,
+        const unsigned char *group)
+{
+  unsigned char work_path[PATH_MAX];
+  unsigned char check_path[PATH_MAX];
+  int uid = getuid();
+  int gid = getgid();
+
+#if defined EJUDGE_LOCAL_DIR
+  snprintf(tmpfs_dir, sizeof(tmpfs_dir), "%s/%s/tmpfs/%s_%d",
+           EJUDGE_LOCAL_DIR, super_run_dir, os_NodeName(), state->exec_user_serial);
+#else
+  snprintf(tmpfs_dir, sizeof(tmpfs_dir), "%s/var/tmpfs/%s_%d",
+           super_run_path, os_NodeName(), state->exec_user_serial);
+#endif
+  snprintf(work_path, sizeof(work_path), "%s/work", tmpfs_dir);
+  snprintf(check_path, sizeof(check_path), "%s/check", tmpfs_dir);
+
+  // restart keeps the mount namespace of the process
+  if (is_mount_point(work_path) && is_mount_point(check_path)) return;
+
+  if (getuid() != 0) {
+    fatal("--tmpfs-size requires %s to be started as root", program_name);
+  }
+  if (user && *user) {
+    struct passwd *pw = getpwnam(user);
+    if (!pw) fatal("no such user: %s", user);
+    uid = pw->pw_uid;
+    gid = pw->pw_gid;
+  }
+  if (group && *group) {
+    struct group *gr = getgrnam(group);
+    if (!gr) fatal("no such group: %s", group);
+    gid = gr->gr_gid;
+  }
+
+  if (unshare(CLONE_NEWNS) < 0) {
+    fatal("unshare failed: %s", os_ErrorMsg());
+  }
+  if (mount(NULL, "/", NULL, MS_REC | MS_PRIVATE, NULL) < 0) {
+    fatal("failed to make mounts private: %s", os_ErrorMsg());
+  }
+  if (mount_tmpfs(work_path, uid, gid) < 0
+      || mount_tmpfs(check_path, uid, gid) < 0) {
+    fatal("failed to setup tmpfs working directories");
+  }
+}
+
 static int
 create_working_directories(serve_state_t state)
 {
@@ -1104,6 +1447,24 @@ create_working_directories(serve_state_t state)
   int pid = getpid();
   int retval = 0;
 
+#if defined EJUDGE_LOCAL_DIR
+  usprintf(&state->run_stats_dir, "%s/%s/stats", EJUDGE_LOCAL_DIR, super_run_dir);
+  usprintf(&state->run_manifest_dir, "%s/%s/manifest", EJUDGE_LOCAL_DIR, super_run_dir);
+  usprintf(&state->run_gen_cache_dir, "%s/%s/gencache", EJUDGE_LOCAL_DIR, super_run_dir);
+#else
+  usprintf(&state->run_stats_dir, "%s/var/stats", super_run_path);
+  usprintf(&state->run_manifest_dir, "%s/var/manifest", super_run_path);
+  usprintf(&state->run_gen_cache_dir, "%s/var/gencache", super_run_path);
+#endif
+  state->run_gen_cache_size = gen_cache_size;
+
+  if (tmpfs_size > 0) {
+    usprintf(&global->run_work_dir, "%s/work", tmpfs_dir);
+    usprintf(&global->run_check_dir, "%s/check", tmpfs_dir);
+    state->run_tmpfs_size = tmpfs_size;
+    return 0;
+  }
+
 #if defined EJUDGE_LOCAL_DIR
   if (!global->run_work_dir || !global->run_work_dir[0]) {
     usprintf(&global->run_work_dir, "%s/%s/work", EJUDGE_LOCAL_DIR, super_run_dir);
@@ -1140,11 +1501,13 @@ remove_working_directory(serve_state_t state)
   struct section_global_data *global = state->global;
 
   if (!global) return;
+  // tmpfs mount points cannot be removed, they vanish with the namespace
+  int preserve_root = tmpfs_size > 0;
   if (global->run_work_dir && global->run_work_dir[0]) {
-    remove_directory_recursively(global->run_work_dir, 0);
+    remove_directory_recursively(global->run_work_dir, preserve_root);
   }
   if (global->run_check_dir && global->run_check_dir[0]) {
-    remove_directory_recursively(global->run_check_dir, 0);
+    remove_directory_recursively(global->run_check_dir, preserve_root);
   }
 }
 
@@ -1691,6 +2054,30 @@ main(int argc, char *argv[])
       argv_restart[argc_restart++] = argv[cur_arg];
       argv_restart[argc_restart++] = argv[cur_arg + 1];
       cur_arg += 2;
+    } else if (!strcmp(argv[cur_arg], "--tmpfs-size")) {
+      if (cur_arg + 1 >= argc) fatal("argument expected for --tmpfs-size");
+      if (size_str_to_size64_t(argv[cur_arg + 1], &tmpfs_size) < 0 || tmpfs_size <= 0) {
+        fatal("invalid argument for --tmpfs-size: %s", argv[cur_arg + 1]);
+      }
+      argv_restart[argc_restart++] = argv[cur_arg];
+      argv_restart[argc_restart++] = argv[cur_arg + 1];
+      cur_arg += 2;
+    } else if (!strcmp(argv[cur_arg], "--gen-cache-size")) {
+      if (cur_arg + 1 >= argc) fatal("argument expected for --gen-cache-size");
+      if (size_str_to_size64_t(argv[cur_arg + 1], &gen_cache_size) < 0 || gen_cache_size < 0) {
+        fatal("invalid argument for --gen-cache-size: %s", argv[cur_arg + 1]);
+      }
+      argv_restart[argc_restart++] = argv[cur_arg];
+      argv_restart[argc_restart++] = argv[cur_arg + 1];
+      cur_arg += 2;
+    } else if (!strcmp(argv[cur_arg], "--builtin-checkers")) {
+      argv_restart[argc_restart++] = argv[cur_arg];
+      builtin_checkers_mode = 1;
+      ++cur_arg;
+    } else if (!strcmp(argv[cur_arg], "--prefetch")) {
+      argv_restart[argc_restart++] = argv[cur_arg];
+      prefetch_mode = 1;
+      ++cur_arg;
     } else if (!strcmp(argv[cur_arg], "-i")) {
       if (cur_arg + 1 >= argc) fatal("argument expected for -i");
       if (parse_ignored_problem(argv[cur_arg + 1], &ignored_problems[ignored_problems_count++]) < 0) {
@@ -1909,6 +2296,9 @@ main(int argc, char *argv[])
   if (!workdir || *workdir) {
     workdir = super_run_path;
   }
+  if (tmpfs_size > 0) {
+    setup_tmpfs_directories(state, user, group);
+  }
   if (start_prepare(user, group, workdir) < 0) return 1;
 
   create_directories();
@@ -1920,6 +2310,7 @@ main(int argc, char *argv[])
     fatal("config file parsing failed");
   }
   collect_sections(state);
+  state->run_builtin_checkers = builtin_checkers_mode;
 
   if (daemon_mode) {
     if (start_daemon(super_run_log_path) < 0) {
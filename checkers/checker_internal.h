@@ -393,6 +393,62 @@ checker_require_nl(FILE *f, int allow_fail);
 void
 checker_skip_bom(FILE *f);
 
+/* the rest of the input stream mapped to memory */
+struct checker_mapped_file
+{
+  const unsigned char *data;
+  size_t size;
+  size_t pos;
+
+  void *map_addr;
+  size_t map_size;
+  char *buf;                    /* the data, if mmap is not possible */
+};
+
+struct checker_cmp_ctx;
+struct checker_cmp_text;
+
+void
+checker_map_file(int ind, int text_flag, struct checker_mapped_file *mf);
+void
+checker_unmap_file(struct checker_mapped_file *mf);
+const unsigned char *
+checker_mem_read_buf(
+        int ind,
+        struct checker_mapped_file *mf,
+        int eof_error_flag,
+        size_t *p_len);
+int
+checker_mem_read_int(
+        int ind,
+        struct checker_mapped_file *mf,
+        const char *name,
+        int eof_error_flag,
+        int base,
+        int *p_val);
+int
+checker_mem_read_long_long(
+        int ind,
+        struct checker_mapped_file *mf,
+        const char *name,
+        int eof_error_flag,
+        int base,
+        libchecker_i64_t *p_val);
+void
+checker_mem_eof(int ind, struct checker_mapped_file *mf);
+void
+checker_mem_cmp_lines(
+        struct checker_mapped_file *out,
+        struct checker_mapped_file *corr,
+        int nocase,
+        int nospace);
+void
+checker_mem_prepare_ctx(struct checker_cmp_ctx *cc);
+void
+checker_mem_text(
+        const struct checker_mapped_file *mf,
+        struct checker_cmp_text *t);
+
 int
 checker_kill(int pid, int signal);
 
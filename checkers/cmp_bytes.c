@@ -24,23 +24,22 @@
 
 int checker_main(int argc, char **argv)
 {
-  char *corr_data = 0, *out_data = 0;
-  size_t corr_size = 0, out_size = 0, i;
+  struct checker_mapped_file out_mf, corr_mf;
+  size_t i;
 
   checker_l10n_prepare();
 
-  checker_read_file(1, &out_data, &out_size);
-  checker_read_file(2, &corr_data, &corr_size);
+  checker_map_file(1, 0, &out_mf);
+  checker_map_file(2, 0, &corr_mf);
 
-  if (out_size != corr_size)
-    fatal_WA(_("Different size: output: %zu, correct: %zu"), out_size, corr_size);
-  for (i = 0; i < corr_size; i++)
-    if (corr_data[i] != out_data[i])
-      break;
-  if (i < corr_size)
+  if (out_mf.size != corr_mf.size)
+    fatal_WA(_("Different size: output: %zu, correct: %zu"),
+             out_mf.size, corr_mf.size);
+  if (memcmp(out_mf.data, corr_mf.data, corr_mf.size) != 0) {
+    for (i = 0; corr_mf.data[i] == out_mf.data[i]; i++);
     fatal_WA(_("Difference at byte %zu: output: %d, correct: %d"), i,
-             ((unsigned char*)out_data)[i],
-             ((unsigned char*)corr_data)[i]);
+             out_mf.data[i], corr_mf.data[i]);
+  }
 
   checker_OK();
 }
@@ -18,15 +18,18 @@
 #define NEED_INFO 0
 #define NEED_TGZ  0
 #include "checker.h"
+#include "checker_cmp.h"
 
 #include "l10n_impl.h"
 
 int checker_main(int argc, char **argv)
 {
-  double out_ans, corr_ans, eps;
+  double eps;
   unsigned char *s, *abs_flag = 0;
-  int n, i = 0;
-  unsigned char buf[32];
+  int n;
+  struct checker_mapped_file out_mf, corr_mf;
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text out_t, corr_t;
 
   checker_l10n_prepare();
 
@@ -46,22 +49,12 @@ int checker_main(int argc, char **argv)
 
   checker_skip_bom(f_corr);
   checker_skip_bom(f_out);
-
-  while (1) {
-    i++;
-    snprintf(buf, sizeof(buf), "[%d]", i);
-    if (checker_read_corr_double(buf, 0, &corr_ans) < 0) break;
-    if (checker_read_out_double(buf, 0, &out_ans) < 0) {
-      fatal_WA(_("Too few numbers in the output"));
-    }
-    if (!(abs_flag?checker_eq_double_abs:checker_eq_double)(out_ans, corr_ans, eps))
-      fatal_WA(_("Answers differ: %s: output: %.10g, correct: %.10g"),
-               buf, out_ans, corr_ans);
-  }
-  if (checker_read_out_double("x", 0, &out_ans) >= 0) {
-    fatal_WA(_("Too many numbers in the output"));
-  }
-  checker_out_eof();
+  checker_map_file(2, 0, &corr_mf);
+  checker_map_file(1, 0, &out_mf);
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(&out_mf, &out_t);
+  checker_mem_text(&corr_mf, &corr_t);
+  checker_cmp_double_seq(&cc, &out_t, &corr_t, eps, abs_flag != NULL);
 
   checker_OK();
 }
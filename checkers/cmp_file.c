@@ -23,8 +23,7 @@
 
 int checker_main(int argc, char **argv)
 {
-  char **out_lines, **corr_lines;
-  size_t out_lines_num, corr_lines_num, i;
+  struct checker_mapped_file out_mf, corr_mf;
   int nocase = 0;
 
   checker_l10n_prepare();
@@ -36,29 +35,11 @@ int checker_main(int argc, char **argv)
   checker_skip_bom(f_corr);
   checker_skip_bom(f_out);
 
-  // считываем файл результата работы программы
-  checker_read_file_by_line(1, &out_lines, &out_lines_num);
-  // считываем эталонный файл
-  checker_read_file_by_line(2, &corr_lines, &corr_lines_num);
-  // отбрасываем пробелы в результате работы программы
-  checker_normalize_file(out_lines, &out_lines_num);
-  // отбрасываем пробелы в эталонном файле
-  checker_normalize_file(corr_lines, &corr_lines_num);
   if (getenv("EJUDGE_NOCASE")) nocase = 1;
 
-  if (out_lines_num != corr_lines_num)
-    fatal_WA(_("Different number of lines: output: %zu, correct: %zu"),
-             out_lines_num, corr_lines_num);
-  for (i = 0; i < out_lines_num; i++)
-    if (nocase) {
-      if (strcasecmp(out_lines[i], corr_lines[i]) != 0)
-        fatal_WA(_("Line %zu differs: output:\n>%s<\ncorrect:\n>%s<"),
-                 i + 1, out_lines[i], corr_lines[i]);
-    } else {
-      if (strcmp(out_lines[i], corr_lines[i]) != 0)
-        fatal_WA(_("Line %zu differs: output:\n>%s<\ncorrect:\n>%s<"),
-                 i + 1, out_lines[i], corr_lines[i]);
-    }
+  checker_map_file(1, 1, &out_mf);
+  checker_map_file(2, 1, &corr_mf);
+  checker_mem_cmp_lines(&out_mf, &corr_mf, nocase, 0);
 
   checker_OK();
 }
@@ -27,6 +27,7 @@ int checker_main(int argc, char **argv)
 {
   int out_ans, corr_ans;
   int base = 10;
+  struct checker_mapped_file out_mf, corr_mf;
   char *s;
 
   checker_l10n_prepare();
@@ -44,11 +45,13 @@ int checker_main(int argc, char **argv)
   }
 
   checker_skip_bom(f_corr);
-  checker_read_int_2(2, _("correct"), 1, base, &corr_ans);
-  checker_corr_eof();
+  checker_map_file(2, 0, &corr_mf);
+  checker_mem_read_int(2, &corr_mf, _("correct"), 1, base, &corr_ans);
+  checker_mem_eof(2, &corr_mf);
   checker_skip_bom(f_out);
-  checker_read_int_2(1, _("output"), 1, base, &out_ans);
-  checker_out_eof();
+  checker_map_file(1, 0, &out_mf);
+  checker_mem_read_int(1, &out_mf, _("output"), 1, base, &out_ans);
+  checker_mem_eof(1, &out_mf);
   if (out_ans != corr_ans)
     fatal_WA(_("Answers do not match: output: %d, correct: %d"), out_ans, corr_ans);
   checker_OK();
@@ -18,6 +18,7 @@
 #define NEED_INFO 0
 #define NEED_TGZ  0
 #include "checker.h"
+#include "checker_cmp.h"
 
 #include "l10n_impl.h"
 
@@ -25,10 +26,10 @@
 
 int checker_main(int argc, char **argv)
 {
-  int out_ans, corr_ans;
-  int i = 0;
-  unsigned char buf[32];
   int base = 10;
+  struct checker_mapped_file out_mf, corr_mf;
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text out_t, corr_t;
   char *s;
 
   checker_l10n_prepare();
@@ -47,21 +48,12 @@ int checker_main(int argc, char **argv)
 
   checker_skip_bom(f_corr);
   checker_skip_bom(f_out);
-
-  while (1) {
-    i++;
-    snprintf(buf, sizeof(buf), "[%d]", i);
-    if (checker_read_int_2(2, buf, 0, base, &corr_ans) < 0) break;
-    if (checker_read_int_2(1, buf, 0, base, &out_ans) < 0) {
-      fatal_WA(_("Too few numbers in the output"));
-    }
-    if (corr_ans != out_ans)
-      fatal_WA(_("Answers differ: %s: output: %d, correct: %d"), buf, out_ans, corr_ans);
-  }
-  if (checker_read_out_int("x", 0, &out_ans) >= 0) {
-    fatal_WA(_("Too many numbers in the output"));
-  }
-  checker_out_eof();
+  checker_map_file(2, 0, &corr_mf);
+  checker_map_file(1, 0, &out_mf);
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(&out_mf, &out_t);
+  checker_mem_text(&corr_mf, &corr_t);
+  checker_cmp_int_seq(&cc, &out_t, &corr_t, base);
 
   checker_OK();
 }
@@ -29,6 +29,7 @@ int checker_main(int argc, char **argv)
   int i = 0;
   unsigned char buf[32];
   int base = 10;
+  struct checker_mapped_file out_mf, corr_mf;
   char *s;
 
   checker_l10n_prepare();
@@ -47,21 +48,23 @@ int checker_main(int argc, char **argv)
 
   checker_skip_bom(f_corr);
   checker_skip_bom(f_out);
+  checker_map_file(2, 0, &corr_mf);
+  checker_map_file(1, 0, &out_mf);
 
   while (1) {
     i++;
     snprintf(buf, sizeof(buf), "[%d]", i);
-    if (checker_read_long_long_2(2, buf, 0, base, &corr_ans) < 0) break;
-    if (checker_read_long_long_2(1, buf, 0, base, &out_ans) < 0) {
+    if (checker_mem_read_long_long(2, &corr_mf, buf, 0, base, &corr_ans) < 0) break;
+    if (checker_mem_read_long_long(1, &out_mf, buf, 0, base, &out_ans) < 0) {
       fatal_WA(_("Too few numbers in the output"));
     }
     if (corr_ans != out_ans)
       fatal_WA(_("Answers differ: %s: output: %lld, correct: %lld"), buf, out_ans, corr_ans);
   }
-  if (checker_read_out_long_long("x", 0, &out_ans) >= 0) {
+  if (checker_mem_read_long_long(1, &out_mf, "x", 0, 10, &out_ans) >= 0) {
     fatal_WA(_("Too many numbers in the output"));
   }
-  checker_out_eof();
+  checker_mem_eof(1, &out_mf);
 
   checker_OK();
 }
@@ -16,12 +16,15 @@
 
 #define NEED_CORR 1
 #include "checker.h"
+#include "checker_cmp.h"
 
 #include "l10n_impl.h"
 
 int checker_main(int argc, char **argv)
 {
-  char user_buf[1024], corr_buf[1024];
+  struct checker_mapped_file out_mf, corr_mf;
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text out_t, corr_t;
 
   if (getenv("EJ_REQUIRE_NL")) {
     checker_require_nl(f_out, 1);
@@ -29,23 +32,12 @@ int checker_main(int argc, char **argv)
 
   checker_skip_bom(f_corr);
   checker_skip_bom(f_out);
-
-  checker_read_buf_2(1, _("output"), 1, user_buf, sizeof(user_buf), 0, 0);
-  checker_read_buf_2(2, _("correct"), 1, corr_buf, sizeof(corr_buf), 0, 0);
-  if (strcasecmp(corr_buf, "yes") && strcasecmp(corr_buf, "no"))
-    fatal_CF(_("Correct answer is neither `yes' nor `no' (case insensitive)"));
-
-  if (strcasecmp(user_buf, "yes") && strcasecmp(user_buf, "no"))
-    fatal_PE(_("User answer is neither `yes' nor `no' (case insensitive)"));
-
-  if (strcasecmp(user_buf, corr_buf))
-    fatal_WA(_("Answers do not match"));
-  if (!getenv("CASE_INSENSITIVE"))
-    if (strcmp(user_buf, corr_buf))
-      fatal_PE(_("Letter case mismatch"));
-
-  checker_corr_eof();
-  checker_out_eof();
+  checker_map_file(1, 0, &out_mf);
+  checker_map_file(2, 0, &corr_mf);
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(&out_mf, &out_t);
+  checker_mem_text(&corr_mf, &corr_t);
+  checker_cmp_yesno(&cc, &out_t, &corr_t, getenv("CASE_INSENSITIVE") != NULL);
 
   checker_OK();
 }
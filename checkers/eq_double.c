@@ -16,6 +16,7 @@
  */
 
 #include "checker_internal.h"
+#include "checker_cmp.h"
 
 /*
  * 63 - sign bit
@@ -58,31 +59,6 @@ checker_eq_double(double v1, double v2, double eps)
   if (fabs(v1 - v2) <= 1.125*eps) return 1;
   return 0;
 #else
-  double m1, m2;
-  int e1, e2, em;
-
-  if (fpclassify(v1) == FP_NAN && fpclassify(v2) == FP_NAN) return 1;
-  if (fpclassify(v1) == FP_NAN || fpclassify(v2) == FP_NAN) return 0;
-  if (fpclassify(v1) == FP_INFINITE && fpclassify(v2) == FP_INFINITE) {
-    if (signbit(v1) == signbit(v2)) return 1;
-    return 0;
-  }
-  if (fpclassify(v1) == FP_INFINITE || fpclassify(v2) == FP_INFINITE) return 0;
-  if (fabs(v1) <= 1.0 && fabs(v2) <= 1.0) {
-    if (fabs(v1 - v2) <= 1.125*eps) return 1;
-    return 0;
-  }
-  if (signbit(v1) != signbit(v2)) return 0;
-  m1 = frexp(v1, &e1);
-  m2 = frexp(v2, &e2);
-  if (abs(e1 - e2) > 1) return 0;
-  em = e1;
-  if (e2 < em) em = e2;
-  e1 -= em;
-  e2 -= em;
-  m1 = ldexp(m1, e1);
-  m2 = ldexp(m2, e2);
-  if (fabs(m1 - m2) <= 1.125*eps) return 1;
-  return 0;
+  return checker_cmp_eq_double(v1, v2, eps);
 #endif
 }
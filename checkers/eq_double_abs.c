@@ -16,6 +16,7 @@
  */
 
 #include "checker_internal.h"
+#include "checker_cmp.h"
 
 /*
  * 63 - sign bit
@@ -42,14 +43,6 @@ checker_eq_double_abs(double v1, double v2, double eps)
   if (fabs(v1 - v2) <= 1.125*eps) return 1;
   return 0;
 #else
-  if (fpclassify(v1) == FP_NAN && fpclassify(v2) == FP_NAN) return 1;
-  if (fpclassify(v1) == FP_NAN || fpclassify(v2) == FP_NAN) return 0;
-  if (fpclassify(v1) == FP_INFINITE && fpclassify(v2) == FP_INFINITE) {
-    if (signbit(v1) == signbit(v2)) return 1;
-    return 0;
-  }
-  if (fpclassify(v1) == FP_INFINITE || fpclassify(v2) == FP_INFINITE) return 0;
-  if (fabs(v1 - v2) <= 1.125*eps) return 1;
-  return 0;
+  return checker_cmp_eq_double_abs(v1, v2, eps);
 #endif
 }
@@ -0,0 +1,89 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+
+#include "l10n_impl.h"
+
+#if !defined __MINGW32__ && !defined _MSC_VER
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*
+ * map the rest of the stream (from the current position) to memory,
+ * non-regular files are read into a buffer
+ */
+void
+checker_map_file(int ind, int text_flag, struct checker_mapped_file *mf)
+{
+  FILE *f = f_arr[ind];
+  size_t size = 0;
+
+  assert(ind >= 0 && ind <= 2);
+  assert(f);
+
+  memset(mf, 0, sizeof(*mf));
+
+#if !defined __MINGW32__ && !defined _MSC_VER
+  {
+    struct stat stb;
+    long pos = ftell(f);
+
+    if (pos >= 0 && fstat(fileno(f), &stb) >= 0 && S_ISREG(stb.st_mode)
+        && pos <= stb.st_size) {
+      if (pos == stb.st_size) {
+        mf->data = (const unsigned char *) "";
+        mf->size = 0;
+      } else {
+        void *addr = mmap(NULL, stb.st_size, PROT_READ, MAP_PRIVATE,
+                          fileno(f), 0);
+        if (addr != MAP_FAILED) {
+          madvise(addr, stb.st_size, MADV_SEQUENTIAL);
+          mf->map_addr = addr;
+          mf->map_size = stb.st_size;
+          mf->data = (const unsigned char *) addr + pos;
+          mf->size = stb.st_size - pos;
+        }
+      }
+    }
+  }
+#endif
+
+  if (!mf->data) {
+    checker_read_file(ind, &mf->buf, &size);
+    mf->data = (const unsigned char *) mf->buf;
+    mf->size = size;
+  }
+
+  if (text_flag && memchr(mf->data, 0, mf->size)) {
+    fatal_read(ind, _("\\0 byte in file"));
+  }
+}
+
+void
+checker_unmap_file(struct checker_mapped_file *mf)
+{
+#if !defined __MINGW32__ && !defined _MSC_VER
+  if (mf->map_addr) {
+    munmap(mf->map_addr, mf->map_size);
+  }
+#endif
+  free(mf->buf);
+  memset(mf, 0, sizeof(*mf));
+}
@@ -0,0 +1,37 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+#include "checker_cmp.h"
+
+/*
+ * compare the mapped files by line, see checker_cmp_lines
+ */
+void
+checker_mem_cmp_lines(
+        struct checker_mapped_file *out,
+        struct checker_mapped_file *corr,
+        int nocase,
+        int nospace)
+{
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text out_t, corr_t;
+
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(out, &out_t);
+  checker_mem_text(corr, &corr_t);
+  checker_cmp_lines(&cc, &out_t, &corr_t, nocase, nospace);
+}
@@ -0,0 +1,58 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+#include "checker_cmp.h"
+
+#include "l10n_impl.h"
+
+static void
+mem_error(
+        struct checker_cmp_ctx *cc,
+        int status,
+        int ind,
+        const char *format,
+        va_list args)
+{
+  if (ind >= 0) fprintf(stderr, "%s: ", cc->stream_names[ind]);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  exit(status);
+}
+
+/* the comparison context, which reports failures as fatal_* do */
+void
+checker_mem_prepare_ctx(struct checker_cmp_ctx *cc)
+{
+  int i;
+
+  memset(cc, 0, sizeof(*cc));
+  cc->error = mem_error;
+  for (i = 0; i < 3; ++i) {
+    cc->stream_names[i] = gettext(f_arr_names[i]);
+  }
+}
+
+/* the text to compare is the mapped file from its current position */
+void
+checker_mem_text(
+        const struct checker_mapped_file *mf,
+        struct checker_cmp_text *t)
+{
+  t->data = mf->data;
+  t->size = mf->size;
+  t->pos = mf->pos;
+}
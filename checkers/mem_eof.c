@@ -0,0 +1,31 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+#include "checker_cmp.h"
+
+/* the same as checker_out_eof/checker_corr_eof for the mapped file */
+void
+checker_mem_eof(int ind, struct checker_mapped_file *mf)
+{
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text t;
+
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(mf, &t);
+  checker_cmp_eof(&cc, ind, &t);
+  mf->pos = t.pos;
+}
@@ -0,0 +1,46 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+#include "checker_cmp.h"
+
+/**
+   find the next sequence of non-whitespace chars in the mapped file,
+   the same rules as in checker_read_buf_2 apply
+   \param ind input stream index (0 - test in, 1 - program out, 2 - correct)
+   \param mf mapped file
+   \param eof_error_flag if TRUE, EOF condition is error
+   \param p_len length of the sequence
+   \return pointer to the sequence (not \0-terminated), NULL on EOF
+ */
+const unsigned char *
+checker_mem_read_buf(
+        int ind,
+        struct checker_mapped_file *mf,
+        int eof_error_flag,
+        size_t *p_len)
+{
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text t;
+  const unsigned char *s = NULL;
+
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(mf, &t);
+  if (checker_cmp_read_token(&cc, ind, &t, eof_error_flag, 0, &s, p_len) <= 0)
+    s = NULL;
+  mf->pos = t.pos;
+  return s;
+}
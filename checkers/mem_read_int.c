@@ -0,0 +1,38 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+#include "checker_cmp.h"
+
+int
+checker_mem_read_int(
+        int ind,
+        struct checker_mapped_file *mf,
+        const char *name,
+        int eof_error_flag,
+        int base,
+        int *p_val)
+{
+  struct checker_cmp_ctx cc;
+  struct checker_cmp_text t;
+  int r;
+
+  checker_mem_prepare_ctx(&cc);
+  checker_mem_text(mf, &t);
+  r = checker_cmp_read_int(&cc, ind, &t, name, eof_error_flag, base, p_val);
+  mf->pos = t.pos;
+  return (r > 0)?1:-1;
+}
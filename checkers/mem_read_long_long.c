@@ -0,0 +1,51 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "checker_internal.h"
+
+#include <errno.h>
+
+#include "l10n_impl.h"
+
+int
+checker_mem_read_long_long(
+        int ind,
+        struct checker_mapped_file *mf,
+        const char *name,
+        int eof_error_flag,
+        int base,
+        libchecker_i64_t *p_val)
+{
+  long long x;
+  char sb[128], *db = 0, *vb = sb, *ep = 0;
+  const unsigned char *s;
+  size_t len = 0;
+
+  if (!name) name = "";
+  if (!(s = checker_mem_read_buf(ind, mf, eof_error_flag, &len))) return -1;
+  if (len >= sizeof(sb)) {
+    vb = db = (char *) xmalloc(len + 1);
+  }
+  memcpy(vb, s, len);
+  vb[len] = 0;
+  errno = 0;
+  x = strtoll(vb, &ep, base);
+  if (*ep) fatal_read(ind, _("%s: cannot parse int64 value"), name);
+  if (errno) fatal_read(ind, _("%s: int64 value is out of range"), name);
+  free(db);
+  *p_val = x;
+  return 1;
+}
@@ -0,0 +1,180 @@
+import java.io.BufferedReader;
+import java.io.FileOutputStream;
+import java.io.InputStreamReader;
+import java.io.OutputStreamWriter;
+import java.io.PrintWriter;
+import java.io.Writer;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.nio.file.StandardCopyOption;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.jar.Attributes;
+import java.util.jar.JarEntry;
+import java.util.jar.JarOutputStream;
+import java.util.jar.Manifest;
+import java.util.stream.Collectors;
+
+import javax.tools.JavaCompiler;
+import javax.tools.ToolProvider;
+
+import com.sun.source.tree.ClassTree;
+import com.sun.source.tree.Tree.Kind;
+import com.sun.source.util.JavacTask;
+
+/*
+ * The compiler daemon for ej-compile: does the same as the javac
+ * compilation script, but the JVM and the compiler stay loaded.
+ * As the script, it does not use EJUDGE_FLAGS, so a job gives the same
+ * result, when ej-compile falls back to the script.
+ * The jobs are read from stdin, see the protocol in ej-compile.c.
+ * Usage: JavacDaemon [TARGET]
+ */
+public final class JavacDaemon
+{
+    private static final class Job
+    {
+        String dir;
+        String src;
+        String exe;
+        String log;
+        HashMap<String, String> env = new HashMap<>();
+    }
+
+    private static final JavaCompiler compiler = ToolProvider.getSystemJavaCompiler();
+    private static String target;
+
+    public static void main(String[] args) throws Exception
+    {
+        if (args.length > 0) target = args[0];
+
+        var in = new BufferedReader(new InputStreamReader(System.in, StandardCharsets.UTF_8));
+        var out = new PrintWriter(new OutputStreamWriter(System.out, StandardCharsets.UTF_8));
+        Job job;
+        while ((job = readJob(in)) != null) {
+            int code;
+            try (var log = new PrintWriter(new OutputStreamWriter(new FileOutputStream(job.log, true), StandardCharsets.UTF_8))) {
+                try {
+                    code = compile(job, log);
+                } catch (Exception e) {
+                    log.println("compilation failed: " + e);
+                    code = 1;
+                }
+            }
+            out.print(code + "\n");
+            out.flush();
+        }
+    }
+
+    private static Job readJob(BufferedReader in) throws Exception
+    {
+        var job = new Job();
+        String line;
+        while ((line = in.readLine()) != null) {
+            if (line.isEmpty()) {
+                if (job.dir == null || job.src == null || job.exe == null || job.log == null) {
+                    throw new IllegalArgumentException("incomplete job");
+                }
+                return job;
+            }
+            int pos = line.indexOf(' ');
+            if (pos < 0) throw new IllegalArgumentException("invalid line: " + line);
+            var key = line.substring(0, pos);
+            var value = line.substring(pos + 1);
+            switch (key) {
+            case "dir": job.dir = value; break;
+            case "src": job.src = value; break;
+            case "exe": job.exe = value; break;
+            case "log": job.log = value; break;
+            case "env": {
+                int eq = value.indexOf('=');
+                if (eq > 0) job.env.put(value.substring(0, eq), value.substring(eq + 1));
+                break;
+            }
+            default:
+                throw new IllegalArgumentException("invalid line: " + line);
+            }
+        }
+        return null;
+    }
+
+    private static String findClassName(Path src, Writer log) throws Exception
+    {
+        var fileManager = compiler.getStandardFileManager(null, null, StandardCharsets.UTF_8);
+        var units = fileManager.getJavaFileObjects(src.toFile());
+        var task = (JavacTask) compiler.getTask(log, fileManager, null, null, null, units);
+        for (var t : task.parse()) {
+            if (t.getPackage() != null) {
+                throw new IllegalArgumentException("java packages are not allowed: " + t.getPackage());
+            }
+            for (var c : t.getTypeDecls()) {
+                var ct = (ClassTree) c;
+                if (ct.getKind() == Kind.CLASS) return ct.getSimpleName().toString();
+            }
+        }
+        return null;
+    }
+
+    private static List<Path> listFiles(Path dir, String suffix) throws Exception
+    {
+        try (var s = Files.list(dir)) {
+            return s.filter(p -> p.getFileName().toString().endsWith(suffix)).collect(Collectors.toList());
+        }
+    }
+
+    private static int compile(Job job, PrintWriter log) throws Exception
+    {
+        var dir = Paths.get(job.dir);
+        var src = dir.resolve(job.src);
+
+        for (var p : listFiles(dir, ".class")) Files.delete(p);
+
+        var userClass = findClassName(src, log);
+        if (userClass == null) {
+            log.println("failed to detect java class name");
+            return 1;
+        }
+        var userSource = dir.resolve(userClass + ".java");
+        if (!userSource.equals(src)) {
+            Files.move(src, userSource, StandardCopyOption.REPLACE_EXISTING);
+        }
+        var mainClass = job.env.getOrDefault("EJUDGE_MAIN_CLASS", "");
+        if (mainClass.isEmpty()) mainClass = userClass;
+        var classPath = job.env.getOrDefault("EJUDGE_CLASSPATH", "");
+
+        var options = new ArrayList<String>();
+        if (target != null && !target.isEmpty()) {
+            options.add("--target");
+            options.add(target);
+        }
+        if (!classPath.isEmpty()) {
+            options.add("-cp");
+            options.add(classPath);
+        }
+        options.add("-d");
+        options.add(dir.toString());
+
+        var fileManager = compiler.getStandardFileManager(null, null, StandardCharsets.UTF_8);
+        var units = fileManager.getJavaFileObjectsFromPaths(listFiles(dir, ".java"));
+        if (!compiler.getTask(log, fileManager, null, options, null, units).call()) {
+            return 1;
+        }
+
+        var manifest = new Manifest();
+        var attrs = manifest.getMainAttributes();
+        attrs.put(Attributes.Name.MANIFEST_VERSION, "1.0");
+        attrs.put(Attributes.Name.MAIN_CLASS, mainClass);
+        if (!classPath.isEmpty()) attrs.put(Attributes.Name.CLASS_PATH, classPath);
+        try (var jar = new JarOutputStream(Files.newOutputStream(dir.resolve(job.exe)), manifest)) {
+            for (var p : listFiles(dir, ".class")) {
+                jar.putNextEntry(new JarEntry(p.getFileName().toString()));
+                Files.copy(p, jar);
+                jar.closeEntry();
+            }
+        }
+        return 0;
+    }
+}
@@ -176,6 +176,7 @@ static struct meta_info_item meta_info_section_global_data_data[] =
   [CNTSGLOB_rounding_mode] = { CNTSGLOB_rounding_mode, 'i', XSIZE(struct section_global_data, rounding_mode), "rounding_mode", XOFFSET(struct section_global_data, rounding_mode) },
   [CNTSGLOB_max_file_length] = { CNTSGLOB_max_file_length, 'z', XSIZE(struct section_global_data, max_file_length), "max_file_length", XOFFSET(struct section_global_data, max_file_length) },
   [CNTSGLOB_max_line_length] = { CNTSGLOB_max_line_length, 'z', XSIZE(struct section_global_data, max_line_length), "max_line_length", XOFFSET(struct section_global_data, max_line_length) },
+  [CNTSGLOB_max_file_tail_length] = { CNTSGLOB_max_file_tail_length, 'z', XSIZE(struct section_global_data, max_file_tail_length), "max_file_tail_length", XOFFSET(struct section_global_data, max_file_tail_length) },
   [CNTSGLOB_max_cmd_length] = { CNTSGLOB_max_cmd_length, 'z', XSIZE(struct section_global_data, max_cmd_length), "max_cmd_length", XOFFSET(struct section_global_data, max_cmd_length) },
   [CNTSGLOB_team_info_url] = { CNTSGLOB_team_info_url, 's', XSIZE(struct section_global_data, team_info_url), "team_info_url", XOFFSET(struct section_global_data, team_info_url) },
   [CNTSGLOB_prob_info_url] = { CNTSGLOB_prob_info_url, 's', XSIZE(struct section_global_data, prob_info_url), "prob_info_url", XOFFSET(struct section_global_data, prob_info_url) },
@@ -275,7 +276,11 @@ static struct meta_info_item meta_info_section_global_data_data[] =
   [CNTSGLOB_html_report] = { CNTSGLOB_html_report, 'B', XSIZE(struct section_global_data, html_report), "html_report", XOFFSET(struct section_global_data, html_report) },
   [CNTSGLOB_xml_report] = { CNTSGLOB_xml_report, 'B', XSIZE(struct section_global_data, xml_report), "xml_report", XOFFSET(struct section_global_data, xml_report) },
   [CNTSGLOB_enable_full_archive] = { CNTSGLOB_enable_full_archive, 'B', XSIZE(struct section_global_data, enable_full_archive), "enable_full_archive", XOFFSET(struct section_global_data, enable_full_archive) },
+  [CNTSGLOB_enable_flatbuf_report] = { CNTSGLOB_enable_flatbuf_report, 'B', XSIZE(struct section_global_data, enable_flatbuf_report), "enable_flatbuf_report", XOFFSET(struct section_global_data, enable_flatbuf_report) },
   [CNTSGLOB_cpu_bogomips] = { CNTSGLOB_cpu_bogomips, 'i', XSIZE(struct section_global_data, cpu_bogomips), "cpu_bogomips", XOFFSET(struct section_global_data, cpu_bogomips) },
+  [CNTSGLOB_enable_perf_counters] = { CNTSGLOB_enable_perf_counters, 'B', XSIZE(struct section_global_data, enable_perf_counters), "enable_perf_counters", XOFFSET(struct section_global_data, enable_perf_counters) },
+  [CNTSGLOB_perf_instructions_per_ms] = { CNTSGLOB_perf_instructions_per_ms, 'i', XSIZE(struct section_global_data, perf_instructions_per_ms), "perf_instructions_per_ms", XOFFSET(struct section_global_data, perf_instructions_per_ms) },
+  [CNTSGLOB_full_archive_threads] = { CNTSGLOB_full_archive_threads, 'i', XSIZE(struct section_global_data, full_archive_threads), "full_archive_threads", XOFFSET(struct section_global_data, full_archive_threads) },
   [CNTSGLOB_skip_full_testing] = { CNTSGLOB_skip_full_testing, 'B', XSIZE(struct section_global_data, skip_full_testing), "skip_full_testing", XOFFSET(struct section_global_data, skip_full_testing) },
   [CNTSGLOB_skip_accept_testing] = { CNTSGLOB_skip_accept_testing, 'B', XSIZE(struct section_global_data, skip_accept_testing), "skip_accept_testing", XOFFSET(struct section_global_data, skip_accept_testing) },
   [CNTSGLOB_enable_problem_history] = { CNTSGLOB_enable_problem_history, 'B', XSIZE(struct section_global_data, enable_problem_history), "enable_problem_history", XOFFSET(struct section_global_data, enable_problem_history) },
@@ -602,6 +607,14 @@ static struct meta_info_item meta_info_section_problem_data_data[] =
   [CNTSPROB_checker_max_rss_size] = { CNTSPROB_checker_max_rss_size, 'E', XSIZE(struct section_problem_data, checker_max_rss_size), "checker_max_rss_size", XOFFSET(struct section_problem_data, checker_max_rss_size) },
   [CNTSPROB_max_open_file_count] = { CNTSPROB_max_open_file_count, 'i', XSIZE(struct section_problem_data, max_open_file_count), "max_open_file_count", XOFFSET(struct section_problem_data, max_open_file_count) },
   [CNTSPROB_max_process_count] = { CNTSPROB_max_process_count, 'i', XSIZE(struct section_problem_data, max_process_count), "max_process_count", XOFFSET(struct section_problem_data, max_process_count) },
+  [CNTSPROB_probe_test_count] = { CNTSPROB_probe_test_count, 'i', XSIZE(struct section_problem_data, probe_test_count), "probe_test_count", XOFFSET(struct section_problem_data, probe_test_count) },
+  [CNTSPROB_tl_remeasure_count] = { CNTSPROB_tl_remeasure_count, 'i', XSIZE(struct section_problem_data, tl_remeasure_count), "tl_remeasure_count", XOFFSET(struct section_problem_data, tl_remeasure_count) },
+  [CNTSPROB_tl_remeasure_margin] = { CNTSPROB_tl_remeasure_margin, 'i', XSIZE(struct section_problem_data, tl_remeasure_margin), "tl_remeasure_margin", XOFFSET(struct section_problem_data, tl_remeasure_margin) },
+  [CNTSPROB_tl_remeasure_median] = { CNTSPROB_tl_remeasure_median, 'i', XSIZE(struct section_problem_data, tl_remeasure_median), "tl_remeasure_median", XOFFSET(struct section_problem_data, tl_remeasure_median) },
+  [CNTSPROB_enable_checker_cache] = { CNTSPROB_enable_checker_cache, 'i', XSIZE(struct section_problem_data, enable_checker_cache), "enable_checker_cache", XOFFSET(struct section_problem_data, enable_checker_cache) },
+  [CNTSPROB_checker_exact_match_ok] = { CNTSPROB_checker_exact_match_ok, 'i', XSIZE(struct section_problem_data, checker_exact_match_ok), "checker_exact_match_ok", XOFFSET(struct section_problem_data, checker_exact_match_ok) },
+  [CNTSPROB_test_generator_ignores_source] = { CNTSPROB_test_generator_ignores_source, 'i', XSIZE(struct section_problem_data, test_generator_ignores_source), "test_generator_ignores_source", XOFFSET(struct section_problem_data, test_generator_ignores_source) },
+  [CNTSPROB_checker_ignores_source] = { CNTSPROB_checker_ignores_source, 'i', XSIZE(struct section_problem_data, checker_ignores_source), "checker_ignores_source", XOFFSET(struct section_problem_data, checker_ignores_source) },
   [CNTSPROB_extid] = { CNTSPROB_extid, 's', XSIZE(struct section_problem_data, extid), "extid", XOFFSET(struct section_problem_data, extid) },
   [CNTSPROB_unhandled_vars] = { CNTSPROB_unhandled_vars, 's', XSIZE(struct section_problem_data, unhandled_vars), "unhandled_vars", XOFFSET(struct section_problem_data, unhandled_vars) },
   [CNTSPROB_score_view] = { CNTSPROB_score_view, 'x', XSIZE(struct section_problem_data, score_view), "score_view", XOFFSET(struct section_problem_data, score_view) },
@@ -667,6 +680,9 @@ static struct meta_info_item meta_info_section_language_data_data[] =
   [CNTSLANG_compile_id] = { CNTSLANG_compile_id, 'i', XSIZE(struct section_language_data, compile_id), "compile_id", XOFFSET(struct section_language_data, compile_id) },
   [CNTSLANG_disabled] = { CNTSLANG_disabled, 'B', XSIZE(struct section_language_data, disabled), "disabled", XOFFSET(struct section_language_data, disabled) },
   [CNTSLANG_compile_real_time_limit] = { CNTSLANG_compile_real_time_limit, 'i', XSIZE(struct section_language_data, compile_real_time_limit), "compile_real_time_limit", XOFFSET(struct section_language_data, compile_real_time_limit) },
+  [CNTSLANG_compile_concurrency] = { CNTSLANG_compile_concurrency, 'i', XSIZE(struct section_language_data, compile_concurrency), "compile_concurrency", XOFFSET(struct section_language_data, compile_concurrency) },
+  [CNTSLANG_compile_weight] = { CNTSLANG_compile_weight, 'i', XSIZE(struct section_language_data, compile_weight), "compile_weight", XOFFSET(struct section_language_data, compile_weight) },
+  [CNTSLANG_compile_daemon_max_jobs] = { CNTSLANG_compile_daemon_max_jobs, 'i', XSIZE(struct section_language_data, compile_daemon_max_jobs), "compile_daemon_max_jobs", XOFFSET(struct section_language_data, compile_daemon_max_jobs) },
   [CNTSLANG_binary] = { CNTSLANG_binary, 'B', XSIZE(struct section_language_data, binary), "binary", XOFFSET(struct section_language_data, binary) },
   [CNTSLANG_priority_adjustment] = { CNTSLANG_priority_adjustment, 'i', XSIZE(struct section_language_data, priority_adjustment), "priority_adjustment", XOFFSET(struct section_language_data, priority_adjustment) },
   [CNTSLANG_insecure] = { CNTSLANG_insecure, 'B', XSIZE(struct section_language_data, insecure), "insecure", XOFFSET(struct section_language_data, insecure) },
@@ -683,6 +699,8 @@ static struct meta_info_item meta_info_section_language_data_data[] =
   [CNTSLANG_cmd] = { CNTSLANG_cmd, 's', XSIZE(struct section_language_data, cmd), "cmd", XOFFSET(struct section_language_data, cmd) },
   [CNTSLANG_style_checker_cmd] = { CNTSLANG_style_checker_cmd, 's', XSIZE(struct section_language_data, style_checker_cmd), "style_checker_cmd", XOFFSET(struct section_language_data, style_checker_cmd) },
   [CNTSLANG_style_checker_env] = { CNTSLANG_style_checker_env, 'X', XSIZE(struct section_language_data, style_checker_env), "style_checker_env", XOFFSET(struct section_language_data, style_checker_env) },
+  [CNTSLANG_compile_daemon_cmd] = { CNTSLANG_compile_daemon_cmd, 's', XSIZE(struct section_language_data, compile_daemon_cmd), "compile_daemon_cmd", XOFFSET(struct section_language_data, compile_daemon_cmd) },
+  [CNTSLANG_compile_pch_headers] = { CNTSLANG_compile_pch_headers, 's', XSIZE(struct section_language_data, compile_pch_headers), "compile_pch_headers", XOFFSET(struct section_language_data, compile_pch_headers) },
   [CNTSLANG_extid] = { CNTSLANG_extid, 's', XSIZE(struct section_language_data, extid), "extid", XOFFSET(struct section_language_data, extid) },
   [CNTSLANG_super_run_dir] = { CNTSLANG_super_run_dir, 's', XSIZE(struct section_language_data, super_run_dir), "super_run_dir", XOFFSET(struct section_language_data, super_run_dir) },
   [CNTSLANG_disable_auto_testing] = { CNTSLANG_disable_auto_testing, 'B', XSIZE(struct section_language_data, disable_auto_testing), "disable_auto_testing", XOFFSET(struct section_language_data, disable_auto_testing) },
@@ -697,6 +715,7 @@ static struct meta_info_item meta_info_section_language_data_data[] =
   [CNTSLANG_run_max_stack_size] = { CNTSLANG_run_max_stack_size, 'E', XSIZE(struct section_language_data, run_max_stack_size), "run_max_stack_size", XOFFSET(struct section_language_data, run_max_stack_size) },
   [CNTSLANG_run_max_vm_size] = { CNTSLANG_run_max_vm_size, 'E', XSIZE(struct section_language_data, run_max_vm_size), "run_max_vm_size", XOFFSET(struct section_language_data, run_max_vm_size) },
   [CNTSLANG_run_max_rss_size] = { CNTSLANG_run_max_rss_size, 'E', XSIZE(struct section_language_data, run_max_rss_size), "run_max_rss_size", XOFFSET(struct section_language_data, run_max_rss_size) },
+  [CNTSLANG_compile_daemon_max_rss] = { CNTSLANG_compile_daemon_max_rss, 'E', XSIZE(struct section_language_data, compile_daemon_max_rss), "compile_daemon_max_rss", XOFFSET(struct section_language_data, compile_daemon_max_rss) },
   [CNTSLANG_compile_dir_index] = { CNTSLANG_compile_dir_index, 'i', XSIZE(struct section_language_data, compile_dir_index), "compile_dir_index", XOFFSET(struct section_language_data, compile_dir_index) },
   [CNTSLANG_compile_dir] = { CNTSLANG_compile_dir, 's', XSIZE(struct section_language_data, compile_dir), "compile_dir", XOFFSET(struct section_language_data, compile_dir) },
   [CNTSLANG_compile_queue_dir] = { CNTSLANG_compile_queue_dir, 's', XSIZE(struct section_language_data, compile_queue_dir), "compile_queue_dir", XOFFSET(struct section_language_data, compile_queue_dir) },
@@ -39,8 +39,13 @@ static struct meta_info_item meta_info_super_run_in_global_packet_data[] =
   [META_SUPER_RUN_IN_GLOBAL_PACKET_is_virtual] = { META_SUPER_RUN_IN_GLOBAL_PACKET_is_virtual, 'B', XSIZE(struct super_run_in_global_packet, is_virtual), "is_virtual", XOFFSET(struct super_run_in_global_packet, is_virtual) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_max_file_length] = { META_SUPER_RUN_IN_GLOBAL_PACKET_max_file_length, 'z', XSIZE(struct super_run_in_global_packet, max_file_length), "max_file_length", XOFFSET(struct super_run_in_global_packet, max_file_length) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_max_line_length] = { META_SUPER_RUN_IN_GLOBAL_PACKET_max_line_length, 'z', XSIZE(struct super_run_in_global_packet, max_line_length), "max_line_length", XOFFSET(struct super_run_in_global_packet, max_line_length) },
+  [META_SUPER_RUN_IN_GLOBAL_PACKET_max_file_tail_length] = { META_SUPER_RUN_IN_GLOBAL_PACKET_max_file_tail_length, 'z', XSIZE(struct super_run_in_global_packet, max_file_tail_length), "max_file_tail_length", XOFFSET(struct super_run_in_global_packet, max_file_tail_length) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_max_cmd_length] = { META_SUPER_RUN_IN_GLOBAL_PACKET_max_cmd_length, 'z', XSIZE(struct super_run_in_global_packet, max_cmd_length), "max_cmd_length", XOFFSET(struct super_run_in_global_packet, max_cmd_length) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_enable_full_archive] = { META_SUPER_RUN_IN_GLOBAL_PACKET_enable_full_archive, 'B', XSIZE(struct super_run_in_global_packet, enable_full_archive), "enable_full_archive", XOFFSET(struct super_run_in_global_packet, enable_full_archive) },
+  [META_SUPER_RUN_IN_GLOBAL_PACKET_enable_flatbuf_report] = { META_SUPER_RUN_IN_GLOBAL_PACKET_enable_flatbuf_report, 'B', XSIZE(struct super_run_in_global_packet, enable_flatbuf_report), "enable_flatbuf_report", XOFFSET(struct super_run_in_global_packet, enable_flatbuf_report) },
+  [META_SUPER_RUN_IN_GLOBAL_PACKET_enable_perf_counters] = { META_SUPER_RUN_IN_GLOBAL_PACKET_enable_perf_counters, 'B', XSIZE(struct super_run_in_global_packet, enable_perf_counters), "enable_perf_counters", XOFFSET(struct super_run_in_global_packet, enable_perf_counters) },
+  [META_SUPER_RUN_IN_GLOBAL_PACKET_perf_instructions_per_ms] = { META_SUPER_RUN_IN_GLOBAL_PACKET_perf_instructions_per_ms, 'i', XSIZE(struct super_run_in_global_packet, perf_instructions_per_ms), "perf_instructions_per_ms", XOFFSET(struct super_run_in_global_packet, perf_instructions_per_ms) },
+  [META_SUPER_RUN_IN_GLOBAL_PACKET_full_archive_threads] = { META_SUPER_RUN_IN_GLOBAL_PACKET_full_archive_threads, 'i', XSIZE(struct super_run_in_global_packet, full_archive_threads), "full_archive_threads", XOFFSET(struct super_run_in_global_packet, full_archive_threads) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_accepting_mode] = { META_SUPER_RUN_IN_GLOBAL_PACKET_accepting_mode, 'B', XSIZE(struct super_run_in_global_packet, accepting_mode), "accepting_mode", XOFFSET(struct super_run_in_global_packet, accepting_mode) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_separate_user_score] = { META_SUPER_RUN_IN_GLOBAL_PACKET_separate_user_score, 'B', XSIZE(struct super_run_in_global_packet, separate_user_score), "separate_user_score", XOFFSET(struct super_run_in_global_packet, separate_user_score) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_mime_type] = { META_SUPER_RUN_IN_GLOBAL_PACKET_mime_type, 'i', XSIZE(struct super_run_in_global_packet, mime_type), "mime_type", XOFFSET(struct super_run_in_global_packet, mime_type) },
@@ -64,6 +69,7 @@ static struct meta_info_item meta_info_super_run_in_global_packet_data[] =
   [META_SUPER_RUN_IN_GLOBAL_PACKET_checker_locale] = { META_SUPER_RUN_IN_GLOBAL_PACKET_checker_locale, 's', XSIZE(struct super_run_in_global_packet, checker_locale), "checker_locale", XOFFSET(struct super_run_in_global_packet, checker_locale) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_run_uuid] = { META_SUPER_RUN_IN_GLOBAL_PACKET_run_uuid, 's', XSIZE(struct super_run_in_global_packet, run_uuid), "run_uuid", XOFFSET(struct super_run_in_global_packet, run_uuid) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_judge_uuid] = { META_SUPER_RUN_IN_GLOBAL_PACKET_judge_uuid, 's', XSIZE(struct super_run_in_global_packet, judge_uuid), "judge_uuid", XOFFSET(struct super_run_in_global_packet, judge_uuid) },
+  [META_SUPER_RUN_IN_GLOBAL_PACKET_exe_sha256] = { META_SUPER_RUN_IN_GLOBAL_PACKET_exe_sha256, 's', XSIZE(struct super_run_in_global_packet, exe_sha256), "exe_sha256", XOFFSET(struct super_run_in_global_packet, exe_sha256) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_zip_mode] = { META_SUPER_RUN_IN_GLOBAL_PACKET_zip_mode, 'B', XSIZE(struct super_run_in_global_packet, zip_mode), "zip_mode", XOFFSET(struct super_run_in_global_packet, zip_mode) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_testlib_mode] = { META_SUPER_RUN_IN_GLOBAL_PACKET_testlib_mode, 'B', XSIZE(struct super_run_in_global_packet, testlib_mode), "testlib_mode", XOFFSET(struct super_run_in_global_packet, testlib_mode) },
   [META_SUPER_RUN_IN_GLOBAL_PACKET_contest_server_id] = { META_SUPER_RUN_IN_GLOBAL_PACKET_contest_server_id, 's', XSIZE(struct super_run_in_global_packet, contest_server_id), "contest_server_id", XOFFSET(struct super_run_in_global_packet, contest_server_id) },
@@ -230,6 +236,14 @@ static struct meta_info_item meta_info_super_run_in_problem_packet_data[] =
   [META_SUPER_RUN_IN_PROBLEM_PACKET_copy_exe_to_tgzdir] = { META_SUPER_RUN_IN_PROBLEM_PACKET_copy_exe_to_tgzdir, 'B', XSIZE(struct super_run_in_problem_packet, copy_exe_to_tgzdir), "copy_exe_to_tgzdir", XOFFSET(struct super_run_in_problem_packet, copy_exe_to_tgzdir) },
   [META_SUPER_RUN_IN_PROBLEM_PACKET_checker_extra_files] = { META_SUPER_RUN_IN_PROBLEM_PACKET_checker_extra_files, 'x', XSIZE(struct super_run_in_problem_packet, checker_extra_files), "checker_extra_files", XOFFSET(struct super_run_in_problem_packet, checker_extra_files) },
   [META_SUPER_RUN_IN_PROBLEM_PACKET_disable_vm_size_limit] = { META_SUPER_RUN_IN_PROBLEM_PACKET_disable_vm_size_limit, 'B', XSIZE(struct super_run_in_problem_packet, disable_vm_size_limit), "disable_vm_size_limit", XOFFSET(struct super_run_in_problem_packet, disable_vm_size_limit) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_probe_test_count] = { META_SUPER_RUN_IN_PROBLEM_PACKET_probe_test_count, 'i', XSIZE(struct super_run_in_problem_packet, probe_test_count), "probe_test_count", XOFFSET(struct super_run_in_problem_packet, probe_test_count) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_count] = { META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_count, 'i', XSIZE(struct super_run_in_problem_packet, tl_remeasure_count), "tl_remeasure_count", XOFFSET(struct super_run_in_problem_packet, tl_remeasure_count) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_margin] = { META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_margin, 'i', XSIZE(struct super_run_in_problem_packet, tl_remeasure_margin), "tl_remeasure_margin", XOFFSET(struct super_run_in_problem_packet, tl_remeasure_margin) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_median] = { META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_median, 'i', XSIZE(struct super_run_in_problem_packet, tl_remeasure_median), "tl_remeasure_median", XOFFSET(struct super_run_in_problem_packet, tl_remeasure_median) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_enable_checker_cache] = { META_SUPER_RUN_IN_PROBLEM_PACKET_enable_checker_cache, 'i', XSIZE(struct super_run_in_problem_packet, enable_checker_cache), "enable_checker_cache", XOFFSET(struct super_run_in_problem_packet, enable_checker_cache) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_checker_exact_match_ok] = { META_SUPER_RUN_IN_PROBLEM_PACKET_checker_exact_match_ok, 'i', XSIZE(struct super_run_in_problem_packet, checker_exact_match_ok), "checker_exact_match_ok", XOFFSET(struct super_run_in_problem_packet, checker_exact_match_ok) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_test_generator_ignores_source] = { META_SUPER_RUN_IN_PROBLEM_PACKET_test_generator_ignores_source, 'i', XSIZE(struct super_run_in_problem_packet, test_generator_ignores_source), "test_generator_ignores_source", XOFFSET(struct super_run_in_problem_packet, test_generator_ignores_source) },
+  [META_SUPER_RUN_IN_PROBLEM_PACKET_checker_ignores_source] = { META_SUPER_RUN_IN_PROBLEM_PACKET_checker_ignores_source, 'i', XSIZE(struct super_run_in_problem_packet, checker_ignores_source), "checker_ignores_source", XOFFSET(struct super_run_in_problem_packet, checker_ignores_source) },
 };
 
 int meta_super_run_in_problem_packet_get_type(int tag)
@@ -92,7 +92,9 @@ enum
     Tag_submit_id,
     Tag_judge_uuid,
     Tag_test_checker,
-    Tag_verdict_bits
+    Tag_verdict_bits,
+    Tag_time_samples,
+    Tag_checker_cached
 };
 static __attribute__((unused)) const char * const tag_table[] =
 {
@@ -189,6 +191,8 @@ static __attribute__((unused)) const char * const tag_table[] =
     "judge_uuid",
     "test_checker",
     "verdict_bits",
+    "time_samples",
+    "checker_cached",
 };
 static __attribute__((unused)) int
 match(const char *s)
@@ -226,8 +230,14 @@ match(const char *s)
             if (!s[7]) {
                 return Tag_checker;
             } else if (s[7] == '_') {
-                if (s[8] == 'c' && s[9] == 'o' && s[10] == 'm' && s[11] == 'm' && s[12] == 'e' && s[13] == 'n' && s[14] == 't' && !s[15]) {
-                    return Tag_checker_comment;
+                if (s[8] == 'c') {
+                    if (s[9] == 'a' && s[10] == 'c' && s[11] == 'h' && s[12] == 'e' && s[13] == 'd' && !s[14]) {
+                        return Tag_checker_cached;
+                    } else if (s[9] == 'o' && s[10] == 'm' && s[11] == 'm' && s[12] == 'e' && s[13] == 'n' && s[14] == 't' && !s[15]) {
+                        return Tag_checker_comment;
+                    } else {
+                        return 0;
+                    }
                 } else if (s[8] == 'o' && s[9] == 'u' && s[10] == 't' && s[11] == 'p' && s[12] == 'u' && s[13] == 't' && s[14] == '_' && s[15] == 'a' && s[16] == 'v' && s[17] == 'a' && s[18] == 'i' && s[19] == 'l' && s[20] == 'a' && s[21] == 'b' && s[22] == 'l' && s[23] == 'e' && !s[24]) {
                     return Tag_checker_output_available;
                 } else if (s[8] == 's' && s[9] == 't' && s[10] == 'a' && s[11] == 't' && s[12] == 's' && s[13] == '_' && s[14] == 's' && s[15] == 't' && s[16] == 'r' && !s[17]) {
@@ -497,8 +507,14 @@ match(const char *s)
         } else if (s[1] == 'i'&& s[2] == 'm'&& s[3] == 'e') {
             if (!s[4]) {
                 return Tag_time;
-            } else if (s[4] == '_' && s[5] == 'l' && s[6] == 'i' && s[7] == 'm' && s[8] == 'i' && s[9] == 't' && s[10] == '_' && s[11] == 'm' && s[12] == 's' && !s[13]) {
-                return Tag_time_limit_ms;
+            } else if (s[4] == '_') {
+                if (s[5] == 'l' && s[6] == 'i' && s[7] == 'm' && s[8] == 'i' && s[9] == 't' && s[10] == '_' && s[11] == 'm' && s[12] == 's' && !s[13]) {
+                    return Tag_time_limit_ms;
+                } else if (s[5] == 's' && s[6] == 'a' && s[7] == 'm' && s[8] == 'p' && s[9] == 'l' && s[10] == 'e' && s[11] == 's' && !s[12]) {
+                    return Tag_time_samples;
+                } else {
+                    return 0;
+                }
             } else {
                 return 0;
             }
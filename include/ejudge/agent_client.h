@@ -21,6 +21,29 @@
 struct AgentClient;
 struct Future;
 
+/* the state of a file on the agent side, as reported by mirror_stat */
+struct AgentMirrorInfo
+{
+    long long size;             // -1, if the file is not available
+    time_t mtime;
+    int mode;
+    unsigned char sha256[32];
+};
+
+/* the destination directory of a file uploaded with put_results */
+enum
+{
+    AGENT_RESULT_REPORT = 1,    // the report directory, as put_output
+    AGENT_RESULT_ARCHIVE,       // the output directory, as put_archive
+};
+
+struct AgentResultFile
+{
+    int kind;
+    const unsigned char *suffix;
+    const unsigned char *path;
+};
+
 struct AgentClientOps
 {
     struct AgentClient *(*destroy)(struct AgentClient *ac);
@@ -155,6 +178,66 @@ struct AgentClientOps
         int *p_new_mode,
         int *p_uid,
         int *p_gid);
+
+    /* queries the state of several files in one exchange */
+    int (*mirror_stat)(
+        struct AgentClient *ac,
+        int count,
+        const unsigned char * const *paths,
+        struct AgentMirrorInfo *infos);
+
+    /*
+     * fetches the contents of several files in one exchange,
+     * p_ptrs[i] is NULL, if the file is not available
+     */
+    int (*mirror_fetch)(
+        struct AgentClient *ac,
+        int count,
+        const unsigned char * const *paths,
+        char **p_ptrs,
+        size_t *p_lens);
+
+    /*
+     * uploads the result files and the reply packet in one exchange,
+     * the reply packet is written last and nothing is written,
+     * if any of the files cannot be stored; the files which do not
+     * fit in one exchange are uploaded one request per file
+     */
+    int (*put_results)(
+        struct AgentClient *ac,
+        const unsigned char *contest_server_name,
+        int contest_id,
+        const unsigned char *run_name,
+        int file_count,
+        const struct AgentResultFile *files,
+        const unsigned char *reply_ptr,
+        size_t reply_len);
+
+    /*
+     * starts fetching the data file in background, returns -1,
+     * if the agent cannot take the file back with put_data,
+     * the caller then falls back to get_data
+     */
+    int (*get_data_async)(
+        struct AgentClient *ac,
+        const unsigned char *pkt_name,
+        const unsigned char *suffix,
+        struct Future **p_future);
+
+    /* waits for the data file, the result is the same as of get_data */
+    int (*get_data_async_complete)(
+        struct AgentClient *ac,
+        struct Future **p_future,
+        char **p_pkt_ptr,
+        size_t *p_pkt_len);
+
+    /* puts the data file fetched in advance back to the agent */
+    int (*put_data)(
+        struct AgentClient *ac,
+        const unsigned char *pkt_name,
+        const unsigned char *suffix,
+        const unsigned char *pkt_ptr,
+        size_t pkt_len);
 };
 
 struct AgentClient
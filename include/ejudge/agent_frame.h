@@ -0,0 +1,108 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __AGENT_FRAME_H__
+#define __AGENT_FRAME_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdlib.h>
+#include <sys/types.h>
+
+/*
+ * The binary framing of the agent protocol. A text message is a JSON
+ * object terminated by an empty line. A binary frame is
+ *   "\0EJF" flags json_size wire_size payload_size
+ * (32-bit little-endian numbers), followed by the JSON object and
+ * the payload. The files are stored in the payload as is, the JSON
+ * objects describing them contain "size" and "boff" (the offset in the
+ * payload). If the AGENT_FRAME_DEFLATE flag is set, the payload is
+ * compressed with zlib and takes wire_size bytes on the wire.
+ * Both kinds of messages may be mixed in the same stream.
+ */
+
+struct cJSON;
+
+enum
+{
+    AGENT_FRAME_HEADER_SIZE = 20,
+    AGENT_FRAME_DEFLATE = 1,
+};
+
+struct agent_frame_payload
+{
+    unsigned char *data;
+    size_t size;
+    size_t reserved;
+};
+
+void
+agent_frame_payload_free(struct agent_frame_payload *p);
+
+/* appends the file to the payload and describes it in 'j' */
+void
+agent_frame_add_file(
+        struct agent_frame_payload *p,
+        struct cJSON *j,
+        const unsigned char *data,
+        size_t size);
+
+/*
+ * extracts the file described in 'j' from the payload,
+ * returns 1 on success, -1 on error
+ */
+int
+agent_frame_get_file(
+        const unsigned char *payload,
+        size_t payload_size,
+        struct cJSON *j,
+        char **p_data,
+        size_t *p_size);
+
+/* returns 1, if the file described in 'j' is in the payload */
+int
+agent_frame_has_file(struct cJSON *j);
+
+/*
+ * returns the length of the first complete message in the buffer,
+ * 0, if the message is incomplete, -1, if the stream is broken
+ */
+ssize_t
+agent_frame_scan(const unsigned char *data, size_t size);
+
+int
+agent_frame_is_binary(const unsigned char *data, size_t size);
+
+/* makes a binary frame, the result is allocated with malloc */
+int
+agent_frame_encode(
+        const char *json,
+        size_t json_size,
+        const struct agent_frame_payload *p,
+        unsigned char **p_out,
+        size_t *p_out_size);
+
+/*
+ * decodes a complete binary frame, the JSON text is 0-terminated,
+ * the results are allocated with malloc
+ */
+int
+agent_frame_decode(
+        const unsigned char *data,
+        size_t size,
+        char **p_json,
+        unsigned char **p_payload,
+        size_t *p_payload_size);
+
+#endif /* __AGENT_FRAME_H__ */
@@ -0,0 +1,57 @@
+/* -*- c -*- */
+#ifndef __BUILTIN_CHECKER_H__
+#define __BUILTIN_CHECKER_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdio.h>
+
+/*
+ * In-process implementations of some standard checkers from checkers/.
+ * The verdicts and the messages match the standalone checkers
+ * running in the default (english) locale.
+ */
+
+enum
+{
+  BUILTIN_CHECKER_NONE = 0,
+  BUILTIN_CHECKER_CMP_FILE,
+  BUILTIN_CHECKER_CMP_INT_SEQ,
+  BUILTIN_CHECKER_CMP_DOUBLE_SEQ,
+  BUILTIN_CHECKER_CMP_YESNO,
+};
+
+/* environment lookup as seen by the checker process */
+typedef const char *(*builtin_checker_getenv_t)(void *data, const char *name);
+
+/* returns BUILTIN_CHECKER_NONE, if the checker is not built in */
+int builtin_checker_find(const unsigned char *standard_checker);
+
+/*
+ * runs the built-in checker, the checker messages are written to log_f
+ * returns RUN_OK, RUN_PRESENTATION_ERR, RUN_WRONG_ANSWER_ERR or
+ * RUN_CHECK_FAILED
+ */
+int
+builtin_checker_run(
+        int kind,
+        const unsigned char *input_path,
+        const unsigned char *output_path,
+        const unsigned char *corr_path,
+        FILE *log_f,
+        builtin_checker_getenv_t getenv_func,
+        void *getenv_data);
+
+#endif /* __BUILTIN_CHECKER_H__ */
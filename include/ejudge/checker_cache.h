@@ -0,0 +1,56 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __CHECKER_CACHE_H__
+#define __CHECKER_CACHE_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdlib.h>
+
+/*
+ * The in-memory cache of the checker verdicts. The key is the SHA-256 of
+ * everything the checker depends on: the checker itself, the test input,
+ * the answer, the program output and the environment. The cache has
+ * a fixed number of slots, a new entry replaces the entry in its slot.
+ */
+
+struct checker_cache_result
+{
+    int status;
+    int score;
+    unsigned char *checker_token;
+    // the text written by the checker
+    unsigned char *output;
+    size_t output_size;
+};
+
+/* the checker output is not cached, if it is larger */
+enum { CHECKER_CACHE_MAX_OUTPUT = 4096 };
+
+/* returns 1 and fills the allocated copy of the result, if found */
+int
+checker_cache_lookup(
+        const unsigned char key[32],
+        struct checker_cache_result *res);
+
+void
+checker_cache_store(
+        const unsigned char key[32],
+        const struct checker_cache_result *res);
+
+void
+checker_cache_free_result(struct checker_cache_result *res);
+
+#endif /* __CHECKER_CACHE_H__ */
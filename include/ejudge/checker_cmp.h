@@ -0,0 +1,122 @@
+/* -*- c -*- */
+#ifndef __CHECKER_CMP_H__
+#define __CHECKER_CMP_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The comparison loops of the standard checkers working on the files
+ * loaded into memory. The code is shared by the checker library
+ * (checkers/) and the in-process checkers (lib/builtin_checker.c).
+ */
+
+/* the file contents, the data is read starting from pos */
+struct checker_cmp_text
+{
+  const unsigned char *data;
+  size_t size;
+  size_t pos;
+};
+
+struct checker_cmp_ctx;
+
+/*
+ * reports the checker failure, ind is the stream index
+ * (0 - test in, 1 - program out, 2 - correct) for the read errors
+ * and -1 otherwise, the checker library does not return from it
+ */
+typedef void (*checker_cmp_error_t)(
+        struct checker_cmp_ctx *cc,
+        int status,
+        int ind,
+        const char *format,
+        va_list args);
+
+struct checker_cmp_ctx
+{
+  checker_cmp_error_t error;
+  const char *stream_names[3];
+  void *user;
+  int status;
+};
+
+/* the functions below return -1 after reporting a failure */
+int checker_cmp_fail(struct checker_cmp_ctx *cc, int status,
+                     const char *format, ...)
+#ifdef __GNUC__
+  __attribute__((format(printf, 3, 4)))
+#endif
+  ;
+int checker_cmp_fail_read(struct checker_cmp_ctx *cc, int ind,
+                          const char *format, ...)
+#ifdef __GNUC__
+  __attribute__((format(printf, 3, 4)))
+#endif
+  ;
+
+int checker_cmp_check_text(struct checker_cmp_ctx *cc, int ind,
+                           const struct checker_cmp_text *t);
+
+/*
+ * find the next sequence of non-whitespace chars,
+ * max_len == 0 means no limit on the length,
+ * returns 1 on success, 0 on EOF, -1 on failure
+ */
+int checker_cmp_read_token(struct checker_cmp_ctx *cc, int ind,
+                           struct checker_cmp_text *t, int eof_error_flag,
+                           size_t max_len,
+                           const unsigned char **p_s, size_t *p_len);
+int checker_cmp_read_int(struct checker_cmp_ctx *cc, int ind,
+                         struct checker_cmp_text *t, const char *name,
+                         int eof_error_flag, int base, int *p_val);
+int checker_cmp_read_double(struct checker_cmp_ctx *cc, int ind,
+                            struct checker_cmp_text *t, const char *name,
+                            int eof_error_flag, double *p_val);
+int checker_cmp_eof(struct checker_cmp_ctx *cc, int ind,
+                    struct checker_cmp_text *t);
+
+int checker_cmp_eq_double(double v1, double v2, double eps);
+int checker_cmp_eq_double_abs(double v1, double v2, double eps);
+
+/* the checkers, return 0, if the output is accepted */
+int checker_cmp_lines(struct checker_cmp_ctx *cc,
+                      const struct checker_cmp_text *out,
+                      const struct checker_cmp_text *corr,
+                      int nocase, int nospace);
+int checker_cmp_int_seq(struct checker_cmp_ctx *cc,
+                        struct checker_cmp_text *out,
+                        struct checker_cmp_text *corr,
+                        int base);
+int checker_cmp_double_seq(struct checker_cmp_ctx *cc,
+                           struct checker_cmp_text *out,
+                           struct checker_cmp_text *corr,
+                           double eps, int abs_flag);
+int checker_cmp_yesno(struct checker_cmp_ctx *cc,
+                      struct checker_cmp_text *out,
+                      struct checker_cmp_text *corr,
+                      int case_insensitive);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CHECKER_CMP_H__ */
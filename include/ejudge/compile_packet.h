@@ -40,6 +40,7 @@ struct compile_request_packet
   int not_ok_is_cf;
   int preserve_numbers;
   int enable_remote_cache;
+  int accept_exe_sha256;           // 1, if the reply may carry the executable hash
   int64_t submit_id;
   ej_uuid_t uuid;
   ej_uuid_t judge_uuid;
@@ -93,6 +94,9 @@ struct compile_reply_packet
   ej_uuid_t judge_uuid;
   int prepended_size;
   int cached_on_remote;
+  /* the executable is in the local executable store (see exe_store.h) */
+  int has_exe_sha256;
+  unsigned char exe_sha256[32];
 };
 
 int
@@ -0,0 +1,58 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __EXE_STORE_H__
+#define __EXE_STORE_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * The content-addressed store of the compiled executables on the local
+ * host. An executable is stored as <store_dir>/<SHA-256 in hex>
+ * and is passed from ej-compile to serve and from serve to ej-super-run
+ * by its hash. The files are shared by hard links, so the executable is
+ * not copied, when the spool directories and the store are on the same
+ * file system. The files not linked from anywhere are removed after
+ * a while. The store is used, if its directory exists.
+ */
+
+/* returns the store directory, or NULL, if the store is not available */
+const unsigned char *
+exe_store_dir(void);
+
+/*
+ * puts 'src_path' into the store and returns its hash in 'hash',
+ * 'src_path' is not modified, returns -1 on error
+ */
+int
+exe_store_put(
+        const unsigned char *store_dir,
+        const unsigned char *src_path,
+        unsigned char hash[32]);
+
+/*
+ * links (or copies) the stored executable to 'dst_path',
+ * returns -1, if the executable is not in the store
+ */
+int
+exe_store_get(
+        const unsigned char *store_dir,
+        const unsigned char hash[32],
+        const unsigned char *dst_path);
+
+/* parses the hash in hex, returns -1 on error */
+int
+exe_store_parse_hash(const unsigned char *str, unsigned char hash[32]);
+
+#endif /* __EXE_STORE_H__ */
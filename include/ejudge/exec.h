@@ -109,6 +109,8 @@ int      task_AppendContainerOptions(tpTask, const char *);
 int      task_SetLanguageName(tpTask, const char *);
 int      task_SetControlSocket(tpTask, int fd1, int fd2);
 int      task_SetUserSerial(tpTask, int serial);
+int      task_EnablePerfCounters(tpTask);
+int      task_SetMaxInstructions(tpTask, long long count);
 
 int      task_SetSuidHelperDir(tpTask, const char *);
 
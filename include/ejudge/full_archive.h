@@ -39,6 +39,14 @@ struct full_archive
   // for reading
   const unsigned char *mptr;    /* memory mapping address */
   long msize;                   /* file size */
+
+  // for writing the indexed archive (version 2)
+  struct full_archive_writer *writer;
+
+  // for reading the indexed archive (version 2)
+  const ruint64_t *index;       /* entry offsets sorted by entry name */
+  long index_count;
+  long data_end;                /* the offset of the index */
 };
 typedef struct full_archive *full_archive_t;
 
@@ -49,6 +57,20 @@ struct full_archive_file_header
   unsigned char pad[4];         /* padding to 16 bytes */
 };
 
+/*
+ * The indexed archive (version 2) has the same entries as version 1,
+ * but they are written in the order of compression, which is done by
+ * several threads. The entries are followed by the array of the entry
+ * offsets sorted by the entry names, and the trailer at the end of file.
+ */
+struct full_archive_index_trailer
+{
+  unsigned char sig[8];         /* the index signature */
+  rint64_t index_offset;        /* the offset of the entry offset array */
+  unsigned int count;           /* the number of entries */
+  unsigned char pad[12];        /* padding to 32 bytes */
+};
+
 #define FULL_ARCHIVE_MAX_NAME_LEN 255
 
 typedef struct full_archive_entry_header
@@ -61,8 +83,15 @@ typedef struct full_archive_entry_header
 } full_archive_entry_header_t;
 
 full_archive_t full_archive_open_write(const unsigned char *path);
+full_archive_t full_archive_open_write_indexed(const unsigned char *path,
+                                               int thread_count);
 full_archive_t full_archive_open_read(const unsigned char *path);
 full_archive_t full_archive_close(full_archive_t af);
+/*
+ * closes the archive opened for writing, returns -1, if the indexed
+ * archive cannot be completed, the incomplete archive is removed
+ */
+int full_archive_close_write(full_archive_t af);
 int full_archive_append_file(full_archive_t af,
                              const unsigned char *entry_name,
                              unsigned int flags,
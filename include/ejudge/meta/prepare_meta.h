@@ -171,6 +171,7 @@ enum
   CNTSGLOB_rounding_mode,
   CNTSGLOB_max_file_length,
   CNTSGLOB_max_line_length,
+  CNTSGLOB_max_file_tail_length,
   CNTSGLOB_max_cmd_length,
   CNTSGLOB_team_info_url,
   CNTSGLOB_prob_info_url,
@@ -270,7 +271,11 @@ enum
   CNTSGLOB_html_report,
   CNTSGLOB_xml_report,
   CNTSGLOB_enable_full_archive,
+  CNTSGLOB_enable_flatbuf_report,
   CNTSGLOB_cpu_bogomips,
+  CNTSGLOB_enable_perf_counters,
+  CNTSGLOB_perf_instructions_per_ms,
+  CNTSGLOB_full_archive_threads,
   CNTSGLOB_skip_full_testing,
   CNTSGLOB_skip_accept_testing,
   CNTSGLOB_enable_problem_history,
@@ -562,6 +567,14 @@ enum
   CNTSPROB_checker_max_rss_size,
   CNTSPROB_max_open_file_count,
   CNTSPROB_max_process_count,
+  CNTSPROB_probe_test_count,
+  CNTSPROB_tl_remeasure_count,
+  CNTSPROB_tl_remeasure_margin,
+  CNTSPROB_tl_remeasure_median,
+  CNTSPROB_enable_checker_cache,
+  CNTSPROB_checker_exact_match_ok,
+  CNTSPROB_test_generator_ignores_source,
+  CNTSPROB_checker_ignores_source,
   CNTSPROB_extid,
   CNTSPROB_unhandled_vars,
   CNTSPROB_score_view,
@@ -592,6 +605,9 @@ enum
   CNTSLANG_compile_id,
   CNTSLANG_disabled,
   CNTSLANG_compile_real_time_limit,
+  CNTSLANG_compile_concurrency,
+  CNTSLANG_compile_weight,
+  CNTSLANG_compile_daemon_max_jobs,
   CNTSLANG_binary,
   CNTSLANG_priority_adjustment,
   CNTSLANG_insecure,
@@ -608,6 +624,8 @@ enum
   CNTSLANG_cmd,
   CNTSLANG_style_checker_cmd,
   CNTSLANG_style_checker_env,
+  CNTSLANG_compile_daemon_cmd,
+  CNTSLANG_compile_pch_headers,
   CNTSLANG_extid,
   CNTSLANG_super_run_dir,
   CNTSLANG_disable_auto_testing,
@@ -622,6 +640,7 @@ enum
   CNTSLANG_run_max_stack_size,
   CNTSLANG_run_max_vm_size,
   CNTSLANG_run_max_rss_size,
+  CNTSLANG_compile_daemon_max_rss,
   CNTSLANG_compile_dir_index,
   CNTSLANG_compile_dir,
   CNTSLANG_compile_queue_dir,
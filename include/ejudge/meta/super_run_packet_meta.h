@@ -34,8 +34,13 @@ enum
   META_SUPER_RUN_IN_GLOBAL_PACKET_is_virtual,
   META_SUPER_RUN_IN_GLOBAL_PACKET_max_file_length,
   META_SUPER_RUN_IN_GLOBAL_PACKET_max_line_length,
+  META_SUPER_RUN_IN_GLOBAL_PACKET_max_file_tail_length,
   META_SUPER_RUN_IN_GLOBAL_PACKET_max_cmd_length,
   META_SUPER_RUN_IN_GLOBAL_PACKET_enable_full_archive,
+  META_SUPER_RUN_IN_GLOBAL_PACKET_enable_flatbuf_report,
+  META_SUPER_RUN_IN_GLOBAL_PACKET_enable_perf_counters,
+  META_SUPER_RUN_IN_GLOBAL_PACKET_perf_instructions_per_ms,
+  META_SUPER_RUN_IN_GLOBAL_PACKET_full_archive_threads,
   META_SUPER_RUN_IN_GLOBAL_PACKET_accepting_mode,
   META_SUPER_RUN_IN_GLOBAL_PACKET_separate_user_score,
   META_SUPER_RUN_IN_GLOBAL_PACKET_mime_type,
@@ -59,6 +64,7 @@ enum
   META_SUPER_RUN_IN_GLOBAL_PACKET_checker_locale,
   META_SUPER_RUN_IN_GLOBAL_PACKET_run_uuid,
   META_SUPER_RUN_IN_GLOBAL_PACKET_judge_uuid,
+  META_SUPER_RUN_IN_GLOBAL_PACKET_exe_sha256,
   META_SUPER_RUN_IN_GLOBAL_PACKET_zip_mode,
   META_SUPER_RUN_IN_GLOBAL_PACKET_testlib_mode,
   META_SUPER_RUN_IN_GLOBAL_PACKET_contest_server_id,
@@ -190,6 +196,14 @@ enum
   META_SUPER_RUN_IN_PROBLEM_PACKET_copy_exe_to_tgzdir,
   META_SUPER_RUN_IN_PROBLEM_PACKET_checker_extra_files,
   META_SUPER_RUN_IN_PROBLEM_PACKET_disable_vm_size_limit,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_probe_test_count,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_count,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_margin,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_tl_remeasure_median,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_enable_checker_cache,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_checker_exact_match_ok,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_test_generator_ignores_source,
+  META_SUPER_RUN_IN_PROBLEM_PACKET_checker_ignores_source,
 
   META_SUPER_RUN_IN_PROBLEM_PACKET_LAST_FIELD,
 };
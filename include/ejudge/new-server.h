@@ -752,6 +752,13 @@ void
 ns_scan_heartbeat_dirs(
         serve_state_t cs,
         struct super_run_status_vector *vec);
+struct run_entry;
+struct super_run_progress_info;
+int
+ns_find_run_progress(
+        const serve_state_t cs,
+        const struct run_entry *pre,
+        struct super_run_progress_info *info);
 
 struct compile_heartbeat_vector;
 void
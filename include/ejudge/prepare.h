@@ -520,6 +520,8 @@ struct section_global_data
   ejintsize_t max_file_length;
   /** maximal length of line in reports */
   ejintsize_t max_line_length;
+  /** length of the file tail to keep in reports for too long files */
+  ejintsize_t max_file_tail_length;
   /** maximal length of command line in reports */
   ejintsize_t max_cmd_length;
 
@@ -728,8 +730,16 @@ struct section_global_data
   ejintbool_t xml_report;
   /** store the full output of the program being tested */
   ejintbool_t enable_full_archive;
+  /** store testing reports in the FlatBuffers format */
+  ejintbool_t enable_flatbuf_report;
   /** reference CPU speed (BogoMIPS) */
   int cpu_bogomips;
+  /** measure the tested programs with perf counters (container mode) */
+  ejintbool_t enable_perf_counters;
+  /** if > 0, the time limit is enforced on the instruction count, normalized by this rate */
+  int perf_instructions_per_ms;
+  /** if > 0, the full archive is written in the indexed format, compressed by this number of threads */
+  int full_archive_threads;
   ejintbool_t skip_full_testing;
   ejintbool_t skip_accept_testing;
 
@@ -1302,6 +1312,22 @@ struct section_problem_data
   int max_open_file_count;
   /** max number of processes per user */
   int max_process_count;
+  /** number of historically failing tests to run first (0 - numeric order) */
+  int probe_test_count;
+  /** number of measurements for a test with the time close to the time limit */
+  int tl_remeasure_count;
+  /** the time is close to the time limit, if within this margin (percent) */
+  int tl_remeasure_margin;
+  /** use the median of the measurements instead of the minimum */
+  int tl_remeasure_median;
+  /** cache the checker verdicts by the checker, the test, the answer and the output */
+  int enable_checker_cache;
+  /** the output equal to the answer is OK without running the checker */
+  int checker_exact_match_ok;
+  /** the test generator output does not depend on the submission source */
+  int test_generator_ignores_source;
+  /** the checker verdict does not depend on the submission source */
+  int checker_ignores_source;
 
   /** external id (for external application binding) */
   unsigned char *extid;
@@ -1338,6 +1364,12 @@ struct section_language_data
   /** participant cannot use this language */
   ejintbool_t disabled;
   int compile_real_time_limit;
+  /** max number of simultaneous compilations in the ej-compile supervisor, 0 - unlimited */
+  int compile_concurrency;
+  /** the number of ej-compile supervisor slots a compilation occupies */
+  int compile_weight;
+  /** the compiler daemon is restarted after this number of compilations */
+  int compile_daemon_max_jobs;
   /** whether binary files are accepted */
   ejintbool_t binary;
   /** priority adjustment for this language */
@@ -1370,6 +1402,10 @@ struct section_language_data
   unsigned char *style_checker_cmd;
   /** environment to pass to the style checker */
   ejenvlist_t style_checker_env;
+  /** persistent compiler process, which accepts the compilation jobs */
+  unsigned char *compile_daemon_cmd;
+  /** headers to precompile for the compilation script, separated by spaces */
+  unsigned char *compile_pch_headers;
 
   /** external id (for external application binding) */
   unsigned char *extid;
@@ -1402,6 +1438,8 @@ struct section_language_data
   ej_size64_t run_max_vm_size;
   /** max resident set size limit for compiled programs, overrides the problem settings */
   ej_size64_t run_max_rss_size;
+  /** the compiler daemon is restarted, when its RSS grows above this limit */
+  ej_size64_t compile_daemon_max_rss;
 
   /** index of the compile directory in the list of compile servers */
   int compile_dir_index;
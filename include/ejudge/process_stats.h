@@ -33,6 +33,10 @@ struct ej_process_stats
     long long cgroup_ptime_us;
     long long cgroup_utime_us;
     long long cgroup_stime_us;
+    long long cgroup_memory_peak; // memory.peak of the cgroup (bytes)
+    // perf counters of the process tree
+    long long perf_task_clock_us;
+    long long perf_instructions;  // user-mode instructions
 };
 
 void
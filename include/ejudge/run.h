@@ -65,6 +65,8 @@ struct run_test_info
   unsigned char *interactor_stats_str;
   unsigned char *checker_stats_str;
   unsigned char *checker_token;
+  unsigned char *time_samples;  /* all the time measurements of the test */
+  int            checker_cached; /* TESTING_REPORT_CHECKER_* */
   /* for output-only separate-user-score problems */
   int user_status;
   int user_score;
@@ -88,7 +90,8 @@ struct run_test_info_vector
 struct run_listener;
 struct run_listener_ops
 {
-  void (*before_test)(struct run_listener *self, int test_no);
+  /* 'cpu_ms' is the CPU time of the program runs completed so far */
+  void (*before_test)(struct run_listener *self, int test_no, long long cpu_ms);
 };
 struct run_listener
 {
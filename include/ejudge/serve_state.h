@@ -379,6 +379,18 @@ struct serve_state
 
   // serial number for the testing user
   int exec_user_serial;
+  // size of the private tmpfs for the working directories, 0 if disabled
+  long long run_tmpfs_size;
+  // directory for the per-problem test failure statistics
+  unsigned char *run_stats_dir;
+  // directory for the test-set manifests
+  unsigned char *run_manifest_dir;
+  // directory for the generated tests cache
+  unsigned char *run_gen_cache_dir;
+  // maximal size of the generated tests cache, 0 if disabled
+  long long run_gen_cache_size;
+  // run the standard comparison checkers in-process
+  int run_builtin_checkers;
 };
 typedef struct serve_state *serve_state_t;
 
@@ -0,0 +1,100 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __SPOOL_QUEUE_H__
+#define __SPOOL_QUEUE_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdlib.h>
+
+/*
+ * An in-memory index of a spool directory, a replacement for scan_dir.
+ * The packet names are kept in per-priority heaps, which are updated
+ * from inotify events and rebuilt by a full scan on creation and on
+ * the inotify queue overflow. The packets are selected in the same
+ * order as scan_dir does.
+ */
+
+struct spool_queue;
+
+/* 'spool_dir' is the same as for scan_dir, the packets are in spool_dir/dir */
+struct spool_queue *spool_queue_create(const unsigned char *spool_dir);
+void spool_queue_free(struct spool_queue *sq);
+
+/* the inotify descriptor to wait for new packets on */
+int spool_queue_fd(const struct spool_queue *sq);
+
+/* processes the pending inotify events, returns -1 on error */
+int spool_queue_update(struct spool_queue *sq);
+
+/*
+ * returns the next packet, like scan_dir does: 1, if a packet is found,
+ * 0, if the queue is empty, < 0 on error
+ */
+int
+spool_queue_get(
+        struct spool_queue *sq,
+        char *found_item,
+        size_t fi_size,
+        int random_mode);
+
+/* the packet is not to be returned while it is in the spool directory */
+void spool_queue_add_ignored(struct spool_queue *sq, const unsigned char *name);
+
+/*
+ * The packets taken ahead of their handling are kept on disk in the
+ * claim directory of the process, spool_dir/claim/<host>.<pid>, so they
+ * are not lost, if the process dies. The claim directories left by
+ * the dead processes of the same host are returned to the spool, when
+ * a claim directory is created.
+ */
+
+/* creates the claim directory, returns -1 on error */
+int
+spool_claim_init(
+        const unsigned char *spool_dir,
+        unsigned char *claim_dir,
+        size_t claim_dir_size);
+
+/* removes the claim directory, which must be empty */
+void spool_claim_fini(const unsigned char *claim_dir);
+
+/*
+ * moves the packet from the spool into the claim directory and reads it,
+ * returns 1 on success, 0, if the packet is taken by another process,
+ * < 0 on error
+ */
+int
+spool_claim_packet(
+        const unsigned char *spool_dir,
+        const unsigned char *claim_dir,
+        const unsigned char *name,
+        char **p_data,
+        size_t *p_size);
+
+/* removes the claimed packet, when it is handled */
+void
+spool_claim_remove(
+        const unsigned char *claim_dir,
+        const unsigned char *name);
+
+/* moves the claimed packet back to the spool, returns -1 on error */
+int
+spool_claim_return(
+        const unsigned char *spool_dir,
+        const unsigned char *claim_dir,
+        const unsigned char *name);
+
+#endif /* __SPOOL_QUEUE_H__ */
@@ -59,8 +59,13 @@ struct super_run_in_global_packet
   ejintbool_t is_virtual;
   ejintsize_t max_file_length;
   ejintsize_t max_line_length;
+  ejintsize_t max_file_tail_length;
   ejintsize_t max_cmd_length;
   ejintbool_t enable_full_archive;
+  ejintbool_t enable_flatbuf_report;
+  ejintbool_t enable_perf_counters;
+  int perf_instructions_per_ms;
+  int full_archive_threads;
   ejintbool_t accepting_mode;
   ejintbool_t separate_user_score;
   int mime_type;
@@ -84,6 +89,7 @@ struct super_run_in_global_packet
   unsigned char *checker_locale;
   unsigned char *run_uuid;
   unsigned char *judge_uuid;
+  unsigned char *exe_sha256;
   ejintbool_t zip_mode;
   ejintbool_t testlib_mode;
   unsigned char *contest_server_id;
@@ -204,6 +210,14 @@ struct super_run_in_problem_packet
   ejintbool_t copy_exe_to_tgzdir;
   char **checker_extra_files;
   ejintbool_t disable_vm_size_limit;
+  int probe_test_count;
+  int tl_remeasure_count;
+  int tl_remeasure_margin;
+  int tl_remeasure_median;
+  int enable_checker_cache;
+  int checker_exact_match_ok;
+  int test_generator_ignores_source;
+  int checker_ignores_source;
 
   int type_val META_ATTRIB((meta_hidden));
 };
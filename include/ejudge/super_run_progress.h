@@ -0,0 +1,94 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __SUPER_RUN_PROGRESS_H__
+#define __SUPER_RUN_PROGRESS_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/ej_types.h"
+
+#include <stdlib.h>
+
+/*
+ * The live testing progress table: a per-host file in the heartbeat
+ * directory, which is mapped into memory by all the ej-super-run
+ * instances of the host and by ej-contests running on the same host. Each ej-super-run instance owns a slot and
+ * updates it on every test without any locking, the readers use
+ * the slot sequence counter to get a consistent copy.
+ * The status files are still written with a lower rate, they are used
+ * for the remote invokers.
+ */
+
+enum { SUPER_RUN_PROGRESS_SLOTS = 256 };
+
+struct super_run_progress_info
+{
+    long long update_ms;        // last update time, ms from the epoch
+    long long start_ms;         // testing start time, or the last testing time if waiting
+    long long cpu_ms;           // CPU time of the completed runs of the program
+    ej_uuid_t run_uuid;
+    int pid;                    // ej-super-run pid
+    int status;                 // SRS_*
+    int contest_id;
+    int run_id;
+    int test_num;
+    int test_count;
+    unsigned char file_name[64];// the status file name
+};
+
+struct super_run_progress;
+
+/* opens (and creates, if 'writer_flag' is set) the table */
+struct super_run_progress *
+super_run_progress_open(
+        const unsigned char *heartbeat_dir,
+        int writer_flag);
+void
+super_run_progress_close(struct super_run_progress *srp);
+
+/* claims a free slot or a slot of a dead process, returns -1 if none */
+int
+super_run_progress_acquire(
+        struct super_run_progress *srp,
+        const unsigned char *file_name);
+void
+super_run_progress_release(struct super_run_progress *srp);
+
+/* publishes the progress into the owned slot */
+void
+super_run_progress_update(
+        struct super_run_progress *srp,
+        const struct super_run_progress_info *info);
+
+/*
+ * reads a consistent copy of the slot 'index',
+ * returns 1 if the slot is in use, 0 if it is free
+ */
+int
+super_run_progress_read(
+        const struct super_run_progress *srp,
+        int index,
+        struct super_run_progress_info *info);
+
+/* looks up the run in the table, returns 1 if found */
+int
+super_run_progress_find(
+        const struct super_run_progress *srp,
+        const ej_uuid_t *run_uuid,
+        int contest_id,
+        int run_id,
+        struct super_run_progress_info *info);
+
+#endif /* __SUPER_RUN_PROGRESS_H__ */
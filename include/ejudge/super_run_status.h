@@ -109,6 +109,9 @@ struct super_run_status_vector_item
     struct super_run_status status;
     unsigned char *queue;
     unsigned char *file;
+    // the status is updated from the live progress table
+    int has_progress;
+    long long cpu_ms;
 };
 
 struct super_run_status_vector
@@ -0,0 +1,65 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __TEST_GEN_CACHE_H__
+#define __TEST_GEN_CACHE_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * The cache of the tests produced by test generators. The output of
+ * a generator is assumed to depend only on the generator file, its
+ * command line and its environment, so the generated directory is
+ * stored under the SHA-256 of all of them and is reused by the
+ * following runs. The total size of the cache is bounded, the least
+ * recently used entries are removed first. ej-compile keeps the
+ * compilation results in the same kind of cache, lookup and store
+ * do not depend on how the key is computed.
+ */
+
+/*
+ * computes the cache key, 'argv' and 'envp' are NULL-terminated
+ * and may be NULL, returns -1, if the generator cannot be read
+ */
+int
+test_gen_cache_make_key(
+        const unsigned char *generator_path,
+        char **argv,
+        char **envp,
+        unsigned char key[32]);
+
+/*
+ * copies the cached files into 'dst_dir',
+ * returns 1 on success, 0, if the entry does not exist or does not match
+ * its manifest, the entry is not removed while it is being copied
+ */
+int
+test_gen_cache_lookup(
+        const unsigned char *cache_dir,
+        const unsigned char key[32],
+        const unsigned char *dst_dir);
+
+/*
+ * stores the files of 'src_dir' (subdirectories are not supported)
+ * and removes the old entries to fit the cache into 'max_size' bytes,
+ * returns -1 on error
+ */
+int
+test_gen_cache_store(
+        const unsigned char *cache_dir,
+        const unsigned char key[32],
+        const unsigned char *src_dir,
+        long long max_size);
+
+#endif /* __TEST_GEN_CACHE_H__ */
@@ -0,0 +1,127 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+#ifndef __TEST_MANIFEST_H__
+#define __TEST_MANIFEST_H__
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/testinfo.h"
+
+#include <time.h>
+
+/*
+ * The test-set manifest of a problem: the number of tests, the sizes,
+ * the modification times and the SHA-256 of the test, answer and
+ * test info files. The manifest is rebuilt when the modification time
+ * of any of the test directories changes and is stored in the cache
+ * directory, so it survives restarts. On a rebuild the SHA-256 is
+ * computed only for the files with a changed size or modification time.
+ * Only the recently used manifests are kept in memory.
+ */
+
+enum
+{
+    TEST_MANIFEST_TEST = 0,
+    TEST_MANIFEST_CORR,
+    TEST_MANIFEST_INFO,
+};
+
+struct test_manifest_file
+{
+    long long size;             // -1, if the file does not exist
+    long long mtime_us;
+    unsigned char sha256[32];
+
+    // the last copy checked by test_manifest_check_file
+    long long checked_size;
+    long long checked_mtime_us;
+    int checked_state;          // 0 - not checked, 1 - matches, -1 - differs
+};
+
+struct test_manifest_test
+{
+    struct test_manifest_file test;
+    struct test_manifest_file corr;
+    struct test_manifest_file info;
+
+    // the parsed test info file, valid while the file is not changed
+    long long tinfo_mtime_us;
+    long long tinfo_size;
+    int tinfo_state;            // 0 - not parsed, 1 - parsed, -1 - not usable
+    testinfo_t tinfo;
+};
+
+struct test_manifest
+{
+    unsigned char *key;
+    unsigned char *test_dir;
+    unsigned char *test_pat;
+    unsigned char *corr_dir;
+    unsigned char *corr_pat;
+    unsigned char *info_dir;
+    unsigned char *info_pat;
+    struct timespec test_dir_mtime;
+    struct timespec corr_dir_mtime;
+    struct timespec info_dir_mtime;
+    int test_count;
+    struct test_manifest_test *tests; // indexed from 1
+
+    struct test_manifest *prev, *next;
+};
+
+/*
+ * returns the up-to-date manifest for the given test directories,
+ * or NULL, if the directories are not available, the manifest is valid
+ * until the next call,
+ * cache_dir may be NULL, then the manifest is kept only in memory,
+ * corr_pat and info_pat may be NULL or empty
+ */
+struct test_manifest *
+test_manifest_get(
+        const unsigned char *cache_dir,
+        const unsigned char *test_dir,
+        const unsigned char *test_pat,
+        const unsigned char *corr_dir,
+        const unsigned char *corr_pat,
+        const unsigned char *info_dir,
+        const unsigned char *info_pat);
+
+/*
+ * copies the parsed test info file for the test to *pt,
+ * returns 0 on success, -1, if the caller should parse the file itself
+ * (the file uses substitutions, cannot be parsed or is not available)
+ */
+int
+test_manifest_get_testinfo(
+        struct test_manifest *tm,
+        int test_num,
+        testinfo_t *pt);
+
+/*
+ * checks that the file (for example, a mirrored copy) has the size and
+ * the SHA-256 of the test file of the given kind (TEST_MANIFEST_*),
+ * the result is cached until the size or the modification time of
+ * the file changes,
+ * returns 1, if the file matches, 0, if it does not match, -1, if
+ * the manifest has no such file
+ */
+int
+test_manifest_check_file(
+        struct test_manifest *tm,
+        int test_num,
+        int kind,
+        const unsigned char *path);
+
+#endif /* __TEST_MANIFEST_H__ */
@@ -97,6 +97,7 @@ struct testinfo_subst_handler
 
 int testinfo_parse(const char *path, testinfo_t *pt, struct testinfo_subst_handler *sh);
 void testinfo_free(testinfo_t *pt);
+void testinfo_copy(testinfo_t *dst, const testinfo_t *src);
 const char *testinfo_strerror(int errcode);
 unsigned char *testinfo_unparse_cmdline(const testinfo_t *pt);
 unsigned char *testinfo_unparse_environ(const struct testinfo_struct *ti);
@@ -0,0 +1,528 @@
+#ifndef TESTING_REPORT_FB_BUILDER_H
+#define TESTING_REPORT_FB_BUILDER_H
+
+/*
+ * The builder functions for the testing report (flatbuf/testing_report.fbs).
+ * The file is maintained by hand in the form of the flatcc output
+ * and must be kept in sync with the schema.
+ */
+
+#ifndef TESTING_REPORT_FB_READER_H
+#include "ejudge/testing_report_fb_reader.h"
+#endif
+#ifndef FLATBUFFERS_COMMON_BUILDER_H
+#include "flatbuf-gen/flatbuffers_common_builder.h"
+#endif
+#include "flatcc/flatcc_prologue.h"
+#undef flatbuffers_identifier
+#define flatbuffers_identifier "EJTR"
+#undef flatbuffers_extension
+#define flatbuffers_extension "bin"
+
+static const flatbuffers_voffset_t __ej_report_FileContent_required[] = { 0 };
+typedef flatbuffers_ref_t ej_report_FileContent_ref_t;
+static ej_report_FileContent_ref_t ej_report_FileContent_clone(flatbuffers_builder_t *B, ej_report_FileContent_table_t t);
+__flatbuffers_build_table(flatbuffers_, ej_report_FileContent, 6)
+
+static const flatbuffers_voffset_t __ej_report_Test_required[] = { 0 };
+typedef flatbuffers_ref_t ej_report_Test_ref_t;
+static ej_report_Test_ref_t ej_report_Test_clone(flatbuffers_builder_t *B, ej_report_Test_table_t t);
+__flatbuffers_build_table(flatbuffers_, ej_report_Test, 39)
+
+static const flatbuffers_voffset_t __ej_report_Row_required[] = { 0 };
+typedef flatbuffers_ref_t ej_report_Row_ref_t;
+static ej_report_Row_ref_t ej_report_Row_clone(flatbuffers_builder_t *B, ej_report_Row_table_t t);
+__flatbuffers_build_table(flatbuffers_, ej_report_Row, 6)
+
+static const flatbuffers_voffset_t __ej_report_Cell_required[] = { 0 };
+typedef flatbuffers_ref_t ej_report_Cell_ref_t;
+static ej_report_Cell_ref_t ej_report_Cell_clone(flatbuffers_builder_t *B, ej_report_Cell_table_t t);
+__flatbuffers_build_table(flatbuffers_, ej_report_Cell, 5)
+
+static const flatbuffers_voffset_t __ej_report_Report_required[] = { 0 };
+typedef flatbuffers_ref_t ej_report_Report_ref_t;
+static ej_report_Report_ref_t ej_report_Report_clone(flatbuffers_builder_t *B, ej_report_Report_table_t t);
+__flatbuffers_build_table(flatbuffers_, ej_report_Report, 47)
+
+#define __ej_report_FileContent_formal_args ,\
+  int64_t v0, int64_t v1, flatbuffers_uint8_vec_ref_t v2, int32_t v3,\
+  int32_t v4, int32_t v5
+#define __ej_report_FileContent_call_args ,\
+  v0, v1, v2, v3,\
+  v4, v5
+static inline ej_report_FileContent_ref_t ej_report_FileContent_create(flatbuffers_builder_t *B __ej_report_FileContent_formal_args);
+__flatbuffers_build_table_prolog(flatbuffers_, ej_report_FileContent, ej_report_FileContent_file_identifier, ej_report_FileContent_type_identifier)
+
+#define __ej_report_Test_formal_args ,\
+  int32_t v0, int32_t v1, int32_t v2, int32_t v3,\
+  int32_t v4, int32_t v5, int32_t v6, int32_t v7,\
+  int32_t v8, int32_t v9, int32_t v10, int32_t v11,\
+  int32_t v12, uint64_t v13, int64_t v14, int32_t v15,\
+  int32_t v16, int32_t v17, int32_t v18, flatbuffers_uint8_vec_ref_t v19,\
+  flatbuffers_uint8_vec_ref_t v20, flatbuffers_uint8_vec_ref_t v21, flatbuffers_string_ref_t v22, flatbuffers_string_ref_t v23,\
+  flatbuffers_string_ref_t v24, flatbuffers_string_ref_t v25, flatbuffers_string_ref_t v26, flatbuffers_string_ref_t v27,\
+  flatbuffers_string_ref_t v28, flatbuffers_string_ref_t v29, flatbuffers_string_ref_t v30, ej_report_FileContent_ref_t v31,\
+  ej_report_FileContent_ref_t v32, ej_report_FileContent_ref_t v33, ej_report_FileContent_ref_t v34, ej_report_FileContent_ref_t v35,\
+  ej_report_FileContent_ref_t v36, flatbuffers_string_ref_t v37, int32_t v38
+#define __ej_report_Test_call_args ,\
+  v0, v1, v2, v3,\
+  v4, v5, v6, v7,\
+  v8, v9, v10, v11,\
+  v12, v13, v14, v15,\
+  v16, v17, v18, v19,\
+  v20, v21, v22, v23,\
+  v24, v25, v26, v27,\
+  v28, v29, v30, v31,\
+  v32, v33, v34, v35,\
+  v36, v37, v38
+static inline ej_report_Test_ref_t ej_report_Test_create(flatbuffers_builder_t *B __ej_report_Test_formal_args);
+__flatbuffers_build_table_prolog(flatbuffers_, ej_report_Test, ej_report_Test_file_identifier, ej_report_Test_type_identifier)
+
+#define __ej_report_Row_formal_args ,\
+  int32_t v0, flatbuffers_string_ref_t v1, int32_t v2, int32_t v3,\
+  int32_t v4, int32_t v5
+#define __ej_report_Row_call_args ,\
+  v0, v1, v2, v3,\
+  v4, v5
+static inline ej_report_Row_ref_t ej_report_Row_create(flatbuffers_builder_t *B __ej_report_Row_formal_args);
+__flatbuffers_build_table_prolog(flatbuffers_, ej_report_Row, ej_report_Row_file_identifier, ej_report_Row_type_identifier)
+
+#define __ej_report_Cell_formal_args ,\
+  int32_t v0, int32_t v1, int32_t v2, int32_t v3,\
+  int32_t v4
+#define __ej_report_Cell_call_args ,\
+  v0, v1, v2, v3,\
+  v4
+static inline ej_report_Cell_ref_t ej_report_Cell_create(flatbuffers_builder_t *B __ej_report_Cell_formal_args);
+__flatbuffers_build_table_prolog(flatbuffers_, ej_report_Cell, ej_report_Cell_file_identifier, ej_report_Cell_type_identifier)
+
+#define __ej_report_Report_formal_args ,\
+  int64_t v0, int32_t v1, int32_t v2, int32_t v3,\
+  int32_t v4, int32_t v5, int32_t v6, int32_t v7,\
+  int32_t v8, int32_t v9, int32_t v10, int32_t v11,\
+  int32_t v12, int32_t v13, int32_t v14, int32_t v15,\
+  int32_t v16, int32_t v17, int32_t v18, int32_t v19,\
+  int32_t v20, int32_t v21, int32_t v22, int32_t v23,\
+  int32_t v24, int32_t v25, int32_t v26, int32_t v27,\
+  int32_t v28, int32_t v29, uint32_t v30, flatbuffers_string_ref_t v31,\
+  flatbuffers_string_ref_t v32, flatbuffers_string_ref_t v33, flatbuffers_string_ref_t v34, flatbuffers_string_ref_t v35,\
+  flatbuffers_string_ref_t v36, flatbuffers_string_ref_t v37, flatbuffers_string_ref_t v38, flatbuffers_string_ref_t v39,\
+  flatbuffers_uint8_vec_ref_t v40, flatbuffers_uint8_vec_ref_t v41, ej_report_Test_vec_ref_t v42, int32_t v43,\
+  int32_t v44, ej_report_Row_vec_ref_t v45, ej_report_Cell_vec_ref_t v46
+#define __ej_report_Report_call_args ,\
+  v0, v1, v2, v3,\
+  v4, v5, v6, v7,\
+  v8, v9, v10, v11,\
+  v12, v13, v14, v15,\
+  v16, v17, v18, v19,\
+  v20, v21, v22, v23,\
+  v24, v25, v26, v27,\
+  v28, v29, v30, v31,\
+  v32, v33, v34, v35,\
+  v36, v37, v38, v39,\
+  v40, v41, v42, v43,\
+  v44, v45, v46
+static inline ej_report_Report_ref_t ej_report_Report_create(flatbuffers_builder_t *B __ej_report_Report_formal_args);
+__flatbuffers_build_table_prolog(flatbuffers_, ej_report_Report, ej_report_Report_file_identifier, ej_report_Report_type_identifier)
+
+__flatbuffers_build_scalar_field(0, flatbuffers_, ej_report_FileContent_size, flatbuffers_int64, int64_t, 8, 8, INT64_C(0), ej_report_FileContent)
+__flatbuffers_build_scalar_field(1, flatbuffers_, ej_report_FileContent_orig_size, flatbuffers_int64, int64_t, 8, 8, INT64_C(0), ej_report_FileContent)
+__flatbuffers_build_vector_field(2, flatbuffers_, ej_report_FileContent_data, flatbuffers_uint8, uint8_t, ej_report_FileContent)
+__flatbuffers_build_scalar_field(3, flatbuffers_, ej_report_FileContent_is_too_big, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_FileContent)
+__flatbuffers_build_scalar_field(4, flatbuffers_, ej_report_FileContent_is_base64, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_FileContent)
+__flatbuffers_build_scalar_field(5, flatbuffers_, ej_report_FileContent_is_bzip2, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_FileContent)
+
+static inline ej_report_FileContent_ref_t ej_report_FileContent_create(flatbuffers_builder_t *B __ej_report_FileContent_formal_args)
+{
+    if (ej_report_FileContent_start(B)
+        || ej_report_FileContent_size_add(B, v0)
+        || ej_report_FileContent_orig_size_add(B, v1)
+        || ej_report_FileContent_data_add(B, v2)
+        || ej_report_FileContent_is_too_big_add(B, v3)
+        || ej_report_FileContent_is_base64_add(B, v4)
+        || ej_report_FileContent_is_bzip2_add(B, v5)) {
+        return 0;
+    }
+    return ej_report_FileContent_end(B);
+}
+
+static ej_report_FileContent_ref_t ej_report_FileContent_clone(flatbuffers_builder_t *B, ej_report_FileContent_table_t t)
+{
+    __flatbuffers_memoize_begin(B, t);
+    if (ej_report_FileContent_start(B)
+        || ej_report_FileContent_size_pick(B, t)
+        || ej_report_FileContent_orig_size_pick(B, t)
+        || ej_report_FileContent_data_pick(B, t)
+        || ej_report_FileContent_is_too_big_pick(B, t)
+        || ej_report_FileContent_is_base64_pick(B, t)
+        || ej_report_FileContent_is_bzip2_pick(B, t)) {
+        return 0;
+    }
+    __flatbuffers_memoize_end(B, t, ej_report_FileContent_end(B));
+}
+
+__flatbuffers_build_scalar_field(0, flatbuffers_, ej_report_Test_num, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(1, flatbuffers_, ej_report_Test_status, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(2, flatbuffers_, ej_report_Test_time, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(3, flatbuffers_, ej_report_Test_real_time, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(4, flatbuffers_, ej_report_Test_exit_code, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(5, flatbuffers_, ej_report_Test_term_signal, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(6, flatbuffers_, ej_report_Test_nominal_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(7, flatbuffers_, ej_report_Test_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(8, flatbuffers_, ej_report_Test_output_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(9, flatbuffers_, ej_report_Test_stderr_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(10, flatbuffers_, ej_report_Test_checker_output_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(11, flatbuffers_, ej_report_Test_args_too_long, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(12, flatbuffers_, ej_report_Test_visibility, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(13, flatbuffers_, ej_report_Test_max_memory_used, flatbuffers_uint64, uint64_t, 8, 8, UINT64_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(14, flatbuffers_, ej_report_Test_max_rss, flatbuffers_int64, int64_t, 8, 8, INT64_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(15, flatbuffers_, ej_report_Test_has_user, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(16, flatbuffers_, ej_report_Test_user_status, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(17, flatbuffers_, ej_report_Test_user_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_scalar_field(18, flatbuffers_, ej_report_Test_user_nominal_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+__flatbuffers_build_vector_field(19, flatbuffers_, ej_report_Test_input_digest, flatbuffers_uint8, uint8_t, ej_report_Test)
+__flatbuffers_build_vector_field(20, flatbuffers_, ej_report_Test_correct_digest, flatbuffers_uint8, uint8_t, ej_report_Test)
+__flatbuffers_build_vector_field(21, flatbuffers_, ej_report_Test_info_digest, flatbuffers_uint8, uint8_t, ej_report_Test)
+__flatbuffers_build_string_field(22, flatbuffers_, ej_report_Test_comment, ej_report_Test)
+__flatbuffers_build_string_field(23, flatbuffers_, ej_report_Test_team_comment, ej_report_Test)
+__flatbuffers_build_string_field(24, flatbuffers_, ej_report_Test_checker_comment, ej_report_Test)
+__flatbuffers_build_string_field(25, flatbuffers_, ej_report_Test_exit_comment, ej_report_Test)
+__flatbuffers_build_string_field(26, flatbuffers_, ej_report_Test_checker_token, ej_report_Test)
+__flatbuffers_build_string_field(27, flatbuffers_, ej_report_Test_program_stats_str, ej_report_Test)
+__flatbuffers_build_string_field(28, flatbuffers_, ej_report_Test_interactor_stats_str, ej_report_Test)
+__flatbuffers_build_string_field(29, flatbuffers_, ej_report_Test_checker_stats_str, ej_report_Test)
+__flatbuffers_build_string_field(30, flatbuffers_, ej_report_Test_args, ej_report_Test)
+__flatbuffers_build_table_field(31, flatbuffers_, ej_report_Test_input, ej_report_FileContent, ej_report_Test)
+__flatbuffers_build_table_field(32, flatbuffers_, ej_report_Test_output, ej_report_FileContent, ej_report_Test)
+__flatbuffers_build_table_field(33, flatbuffers_, ej_report_Test_correct, ej_report_FileContent, ej_report_Test)
+__flatbuffers_build_table_field(34, flatbuffers_, ej_report_Test_error, ej_report_FileContent, ej_report_Test)
+__flatbuffers_build_table_field(35, flatbuffers_, ej_report_Test_checker, ej_report_FileContent, ej_report_Test)
+__flatbuffers_build_table_field(36, flatbuffers_, ej_report_Test_test_checker, ej_report_FileContent, ej_report_Test)
+__flatbuffers_build_string_field(37, flatbuffers_, ej_report_Test_time_samples, ej_report_Test)
+__flatbuffers_build_scalar_field(38, flatbuffers_, ej_report_Test_checker_cached, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Test)
+
+static inline ej_report_Test_ref_t ej_report_Test_create(flatbuffers_builder_t *B __ej_report_Test_formal_args)
+{
+    if (ej_report_Test_start(B)
+        || ej_report_Test_max_memory_used_add(B, v13)
+        || ej_report_Test_max_rss_add(B, v14)
+        || ej_report_Test_num_add(B, v0)
+        || ej_report_Test_status_add(B, v1)
+        || ej_report_Test_time_add(B, v2)
+        || ej_report_Test_real_time_add(B, v3)
+        || ej_report_Test_exit_code_add(B, v4)
+        || ej_report_Test_term_signal_add(B, v5)
+        || ej_report_Test_nominal_score_add(B, v6)
+        || ej_report_Test_score_add(B, v7)
+        || ej_report_Test_output_available_add(B, v8)
+        || ej_report_Test_stderr_available_add(B, v9)
+        || ej_report_Test_checker_output_available_add(B, v10)
+        || ej_report_Test_args_too_long_add(B, v11)
+        || ej_report_Test_visibility_add(B, v12)
+        || ej_report_Test_has_user_add(B, v15)
+        || ej_report_Test_user_status_add(B, v16)
+        || ej_report_Test_user_score_add(B, v17)
+        || ej_report_Test_user_nominal_score_add(B, v18)
+        || ej_report_Test_input_digest_add(B, v19)
+        || ej_report_Test_correct_digest_add(B, v20)
+        || ej_report_Test_info_digest_add(B, v21)
+        || ej_report_Test_comment_add(B, v22)
+        || ej_report_Test_team_comment_add(B, v23)
+        || ej_report_Test_checker_comment_add(B, v24)
+        || ej_report_Test_exit_comment_add(B, v25)
+        || ej_report_Test_checker_token_add(B, v26)
+        || ej_report_Test_program_stats_str_add(B, v27)
+        || ej_report_Test_interactor_stats_str_add(B, v28)
+        || ej_report_Test_checker_stats_str_add(B, v29)
+        || ej_report_Test_args_add(B, v30)
+        || ej_report_Test_input_add(B, v31)
+        || ej_report_Test_output_add(B, v32)
+        || ej_report_Test_correct_add(B, v33)
+        || ej_report_Test_error_add(B, v34)
+        || ej_report_Test_checker_add(B, v35)
+        || ej_report_Test_test_checker_add(B, v36)
+        || ej_report_Test_time_samples_add(B, v37)
+        || ej_report_Test_checker_cached_add(B, v38)) {
+        return 0;
+    }
+    return ej_report_Test_end(B);
+}
+
+static ej_report_Test_ref_t ej_report_Test_clone(flatbuffers_builder_t *B, ej_report_Test_table_t t)
+{
+    __flatbuffers_memoize_begin(B, t);
+    if (ej_report_Test_start(B)
+        || ej_report_Test_max_memory_used_pick(B, t)
+        || ej_report_Test_max_rss_pick(B, t)
+        || ej_report_Test_num_pick(B, t)
+        || ej_report_Test_status_pick(B, t)
+        || ej_report_Test_time_pick(B, t)
+        || ej_report_Test_real_time_pick(B, t)
+        || ej_report_Test_exit_code_pick(B, t)
+        || ej_report_Test_term_signal_pick(B, t)
+        || ej_report_Test_nominal_score_pick(B, t)
+        || ej_report_Test_score_pick(B, t)
+        || ej_report_Test_output_available_pick(B, t)
+        || ej_report_Test_stderr_available_pick(B, t)
+        || ej_report_Test_checker_output_available_pick(B, t)
+        || ej_report_Test_args_too_long_pick(B, t)
+        || ej_report_Test_visibility_pick(B, t)
+        || ej_report_Test_has_user_pick(B, t)
+        || ej_report_Test_user_status_pick(B, t)
+        || ej_report_Test_user_score_pick(B, t)
+        || ej_report_Test_user_nominal_score_pick(B, t)
+        || ej_report_Test_input_digest_pick(B, t)
+        || ej_report_Test_correct_digest_pick(B, t)
+        || ej_report_Test_info_digest_pick(B, t)
+        || ej_report_Test_comment_pick(B, t)
+        || ej_report_Test_team_comment_pick(B, t)
+        || ej_report_Test_checker_comment_pick(B, t)
+        || ej_report_Test_exit_comment_pick(B, t)
+        || ej_report_Test_checker_token_pick(B, t)
+        || ej_report_Test_program_stats_str_pick(B, t)
+        || ej_report_Test_interactor_stats_str_pick(B, t)
+        || ej_report_Test_checker_stats_str_pick(B, t)
+        || ej_report_Test_args_pick(B, t)
+        || ej_report_Test_input_pick(B, t)
+        || ej_report_Test_output_pick(B, t)
+        || ej_report_Test_correct_pick(B, t)
+        || ej_report_Test_error_pick(B, t)
+        || ej_report_Test_checker_pick(B, t)
+        || ej_report_Test_test_checker_pick(B, t)
+        || ej_report_Test_time_samples_pick(B, t)
+        || ej_report_Test_checker_cached_pick(B, t)) {
+        return 0;
+    }
+    __flatbuffers_memoize_end(B, t, ej_report_Test_end(B));
+}
+
+__flatbuffers_build_scalar_field(0, flatbuffers_, ej_report_Row_row, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Row)
+__flatbuffers_build_string_field(1, flatbuffers_, ej_report_Row_name, ej_report_Row)
+__flatbuffers_build_scalar_field(2, flatbuffers_, ej_report_Row_must_fail, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Row)
+__flatbuffers_build_scalar_field(3, flatbuffers_, ej_report_Row_status, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Row)
+__flatbuffers_build_scalar_field(4, flatbuffers_, ej_report_Row_nominal_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Row)
+__flatbuffers_build_scalar_field(5, flatbuffers_, ej_report_Row_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Row)
+
+static inline ej_report_Row_ref_t ej_report_Row_create(flatbuffers_builder_t *B __ej_report_Row_formal_args)
+{
+    if (ej_report_Row_start(B)
+        || ej_report_Row_row_add(B, v0)
+        || ej_report_Row_name_add(B, v1)
+        || ej_report_Row_must_fail_add(B, v2)
+        || ej_report_Row_status_add(B, v3)
+        || ej_report_Row_nominal_score_add(B, v4)
+        || ej_report_Row_score_add(B, v5)) {
+        return 0;
+    }
+    return ej_report_Row_end(B);
+}
+
+static ej_report_Row_ref_t ej_report_Row_clone(flatbuffers_builder_t *B, ej_report_Row_table_t t)
+{
+    __flatbuffers_memoize_begin(B, t);
+    if (ej_report_Row_start(B)
+        || ej_report_Row_row_pick(B, t)
+        || ej_report_Row_name_pick(B, t)
+        || ej_report_Row_must_fail_pick(B, t)
+        || ej_report_Row_status_pick(B, t)
+        || ej_report_Row_nominal_score_pick(B, t)
+        || ej_report_Row_score_pick(B, t)) {
+        return 0;
+    }
+    __flatbuffers_memoize_end(B, t, ej_report_Row_end(B));
+}
+
+__flatbuffers_build_scalar_field(0, flatbuffers_, ej_report_Cell_row, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Cell)
+__flatbuffers_build_scalar_field(1, flatbuffers_, ej_report_Cell_column, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Cell)
+__flatbuffers_build_scalar_field(2, flatbuffers_, ej_report_Cell_status, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Cell)
+__flatbuffers_build_scalar_field(3, flatbuffers_, ej_report_Cell_time, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Cell)
+__flatbuffers_build_scalar_field(4, flatbuffers_, ej_report_Cell_real_time, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Cell)
+
+static inline ej_report_Cell_ref_t ej_report_Cell_create(flatbuffers_builder_t *B __ej_report_Cell_formal_args)
+{
+    if (ej_report_Cell_start(B)
+        || ej_report_Cell_row_add(B, v0)
+        || ej_report_Cell_column_add(B, v1)
+        || ej_report_Cell_status_add(B, v2)
+        || ej_report_Cell_time_add(B, v3)
+        || ej_report_Cell_real_time_add(B, v4)) {
+        return 0;
+    }
+    return ej_report_Cell_end(B);
+}
+
+static ej_report_Cell_ref_t ej_report_Cell_clone(flatbuffers_builder_t *B, ej_report_Cell_table_t t)
+{
+    __flatbuffers_memoize_begin(B, t);
+    if (ej_report_Cell_start(B)
+        || ej_report_Cell_row_pick(B, t)
+        || ej_report_Cell_column_pick(B, t)
+        || ej_report_Cell_status_pick(B, t)
+        || ej_report_Cell_time_pick(B, t)
+        || ej_report_Cell_real_time_pick(B, t)) {
+        return 0;
+    }
+    __flatbuffers_memoize_end(B, t, ej_report_Cell_end(B));
+}
+
+__flatbuffers_build_scalar_field(0, flatbuffers_, ej_report_Report_submit_id, flatbuffers_int64, int64_t, 8, 8, INT64_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(1, flatbuffers_, ej_report_Report_contest_id, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(2, flatbuffers_, ej_report_Report_run_id, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(3, flatbuffers_, ej_report_Report_judge_id, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(4, flatbuffers_, ej_report_Report_status, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(5, flatbuffers_, ej_report_Report_scoring_system, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(6, flatbuffers_, ej_report_Report_archive_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(7, flatbuffers_, ej_report_Report_correct_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(8, flatbuffers_, ej_report_Report_info_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(9, flatbuffers_, ej_report_Report_real_time_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(10, flatbuffers_, ej_report_Report_max_memory_used_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(11, flatbuffers_, ej_report_Report_max_rss_available, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(12, flatbuffers_, ej_report_Report_run_tests, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(13, flatbuffers_, ej_report_Report_variant, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(14, flatbuffers_, ej_report_Report_accepting_mode, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(15, flatbuffers_, ej_report_Report_failed_test, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(16, flatbuffers_, ej_report_Report_tests_passed, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(17, flatbuffers_, ej_report_Report_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(18, flatbuffers_, ej_report_Report_max_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(19, flatbuffers_, ej_report_Report_time_limit_ms, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(20, flatbuffers_, ej_report_Report_real_time_limit_ms, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(21, flatbuffers_, ej_report_Report_marked_flag, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(22, flatbuffers_, ej_report_Report_tests_mode, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(23, flatbuffers_, ej_report_Report_separate_user_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(24, flatbuffers_, ej_report_Report_user_status, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(25, flatbuffers_, ej_report_Report_user_tests_passed, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(26, flatbuffers_, ej_report_Report_user_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(27, flatbuffers_, ej_report_Report_user_max_score, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(28, flatbuffers_, ej_report_Report_user_run_tests, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(29, flatbuffers_, ej_report_Report_compile_error, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(30, flatbuffers_, ej_report_Report_verdict_bits, flatbuffers_uint32, uint32_t, 4, 4, UINT32_C(0), ej_report_Report)
+__flatbuffers_build_string_field(31, flatbuffers_, ej_report_Report_comment, ej_report_Report)
+__flatbuffers_build_string_field(32, flatbuffers_, ej_report_Report_valuer_comment, ej_report_Report)
+__flatbuffers_build_string_field(33, flatbuffers_, ej_report_Report_valuer_judge_comment, ej_report_Report)
+__flatbuffers_build_string_field(34, flatbuffers_, ej_report_Report_valuer_errors, ej_report_Report)
+__flatbuffers_build_string_field(35, flatbuffers_, ej_report_Report_host, ej_report_Report)
+__flatbuffers_build_string_field(36, flatbuffers_, ej_report_Report_cpu_model, ej_report_Report)
+__flatbuffers_build_string_field(37, flatbuffers_, ej_report_Report_cpu_mhz, ej_report_Report)
+__flatbuffers_build_string_field(38, flatbuffers_, ej_report_Report_errors, ej_report_Report)
+__flatbuffers_build_string_field(39, flatbuffers_, ej_report_Report_compiler_output, ej_report_Report)
+__flatbuffers_build_vector_field(40, flatbuffers_, ej_report_Report_uuid, flatbuffers_uint8, uint8_t, ej_report_Report)
+__flatbuffers_build_vector_field(41, flatbuffers_, ej_report_Report_judge_uuid, flatbuffers_uint8, uint8_t, ej_report_Report)
+__flatbuffers_build_table_vector_field(42, flatbuffers_, ej_report_Report_tests, ej_report_Test, ej_report_Report)
+__flatbuffers_build_scalar_field(43, flatbuffers_, ej_report_Report_tt_row_count, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_scalar_field(44, flatbuffers_, ej_report_Report_tt_column_count, flatbuffers_int32, int32_t, 4, 4, INT32_C(0), ej_report_Report)
+__flatbuffers_build_table_vector_field(45, flatbuffers_, ej_report_Report_tt_rows, ej_report_Row, ej_report_Report)
+__flatbuffers_build_table_vector_field(46, flatbuffers_, ej_report_Report_tt_cells, ej_report_Cell, ej_report_Report)
+
+static inline ej_report_Report_ref_t ej_report_Report_create(flatbuffers_builder_t *B __ej_report_Report_formal_args)
+{
+    if (ej_report_Report_start(B)
+        || ej_report_Report_submit_id_add(B, v0)
+        || ej_report_Report_contest_id_add(B, v1)
+        || ej_report_Report_run_id_add(B, v2)
+        || ej_report_Report_judge_id_add(B, v3)
+        || ej_report_Report_status_add(B, v4)
+        || ej_report_Report_scoring_system_add(B, v5)
+        || ej_report_Report_archive_available_add(B, v6)
+        || ej_report_Report_correct_available_add(B, v7)
+        || ej_report_Report_info_available_add(B, v8)
+        || ej_report_Report_real_time_available_add(B, v9)
+        || ej_report_Report_max_memory_used_available_add(B, v10)
+        || ej_report_Report_max_rss_available_add(B, v11)
+        || ej_report_Report_run_tests_add(B, v12)
+        || ej_report_Report_variant_add(B, v13)
+        || ej_report_Report_accepting_mode_add(B, v14)
+        || ej_report_Report_failed_test_add(B, v15)
+        || ej_report_Report_tests_passed_add(B, v16)
+        || ej_report_Report_score_add(B, v17)
+        || ej_report_Report_max_score_add(B, v18)
+        || ej_report_Report_time_limit_ms_add(B, v19)
+        || ej_report_Report_real_time_limit_ms_add(B, v20)
+        || ej_report_Report_marked_flag_add(B, v21)
+        || ej_report_Report_tests_mode_add(B, v22)
+        || ej_report_Report_separate_user_score_add(B, v23)
+        || ej_report_Report_user_status_add(B, v24)
+        || ej_report_Report_user_tests_passed_add(B, v25)
+        || ej_report_Report_user_score_add(B, v26)
+        || ej_report_Report_user_max_score_add(B, v27)
+        || ej_report_Report_user_run_tests_add(B, v28)
+        || ej_report_Report_compile_error_add(B, v29)
+        || ej_report_Report_verdict_bits_add(B, v30)
+        || ej_report_Report_comment_add(B, v31)
+        || ej_report_Report_valuer_comment_add(B, v32)
+        || ej_report_Report_valuer_judge_comment_add(B, v33)
+        || ej_report_Report_valuer_errors_add(B, v34)
+        || ej_report_Report_host_add(B, v35)
+        || ej_report_Report_cpu_model_add(B, v36)
+        || ej_report_Report_cpu_mhz_add(B, v37)
+        || ej_report_Report_errors_add(B, v38)
+        || ej_report_Report_compiler_output_add(B, v39)
+        || ej_report_Report_uuid_add(B, v40)
+        || ej_report_Report_judge_uuid_add(B, v41)
+        || ej_report_Report_tests_add(B, v42)
+        || ej_report_Report_tt_row_count_add(B, v43)
+        || ej_report_Report_tt_column_count_add(B, v44)
+        || ej_report_Report_tt_rows_add(B, v45)
+        || ej_report_Report_tt_cells_add(B, v46)) {
+        return 0;
+    }
+    return ej_report_Report_end(B);
+}
+
+static ej_report_Report_ref_t ej_report_Report_clone(flatbuffers_builder_t *B, ej_report_Report_table_t t)
+{
+    __flatbuffers_memoize_begin(B, t);
+    if (ej_report_Report_start(B)
+        || ej_report_Report_submit_id_pick(B, t)
+        || ej_report_Report_contest_id_pick(B, t)
+        || ej_report_Report_run_id_pick(B, t)
+        || ej_report_Report_judge_id_pick(B, t)
+        || ej_report_Report_status_pick(B, t)
+        || ej_report_Report_scoring_system_pick(B, t)
+        || ej_report_Report_archive_available_pick(B, t)
+        || ej_report_Report_correct_available_pick(B, t)
+        || ej_report_Report_info_available_pick(B, t)
+        || ej_report_Report_real_time_available_pick(B, t)
+        || ej_report_Report_max_memory_used_available_pick(B, t)
+        || ej_report_Report_max_rss_available_pick(B, t)
+        || ej_report_Report_run_tests_pick(B, t)
+        || ej_report_Report_variant_pick(B, t)
+        || ej_report_Report_accepting_mode_pick(B, t)
+        || ej_report_Report_failed_test_pick(B, t)
+        || ej_report_Report_tests_passed_pick(B, t)
+        || ej_report_Report_score_pick(B, t)
+        || ej_report_Report_max_score_pick(B, t)
+        || ej_report_Report_time_limit_ms_pick(B, t)
+        || ej_report_Report_real_time_limit_ms_pick(B, t)
+        || ej_report_Report_marked_flag_pick(B, t)
+        || ej_report_Report_tests_mode_pick(B, t)
+        || ej_report_Report_separate_user_score_pick(B, t)
+        || ej_report_Report_user_status_pick(B, t)
+        || ej_report_Report_user_tests_passed_pick(B, t)
+        || ej_report_Report_user_score_pick(B, t)
+        || ej_report_Report_user_max_score_pick(B, t)
+        || ej_report_Report_user_run_tests_pick(B, t)
+        || ej_report_Report_compile_error_pick(B, t)
+        || ej_report_Report_verdict_bits_pick(B, t)
+        || ej_report_Report_comment_pick(B, t)
+        || ej_report_Report_valuer_comment_pick(B, t)
+        || ej_report_Report_valuer_judge_comment_pick(B, t)
+        || ej_report_Report_valuer_errors_pick(B, t)
+        || ej_report_Report_host_pick(B, t)
+        || ej_report_Report_cpu_model_pick(B, t)
+        || ej_report_Report_cpu_mhz_pick(B, t)
+        || ej_report_Report_errors_pick(B, t)
+        || ej_report_Report_compiler_output_pick(B, t)
+        || ej_report_Report_uuid_pick(B, t)
+        || ej_report_Report_judge_uuid_pick(B, t)
+        || ej_report_Report_tests_pick(B, t)
+        || ej_report_Report_tt_row_count_pick(B, t)
+        || ej_report_Report_tt_column_count_pick(B, t)
+        || ej_report_Report_tt_rows_pick(B, t)
+        || ej_report_Report_tt_cells_pick(B, t)) {
+        return 0;
+    }
+    __flatbuffers_memoize_end(B, t, ej_report_Report_end(B));
+}
+
+#include "flatcc/flatcc_epilogue.h"
+#endif /* TESTING_REPORT_FB_BUILDER_H */
@@ -0,0 +1,265 @@
+#ifndef TESTING_REPORT_FB_READER_H
+#define TESTING_REPORT_FB_READER_H
+
+/*
+ * The read accessors for the testing report (flatbuf/testing_report.fbs).
+ * The file is maintained by hand in the form of the flatcc output
+ * and must be kept in sync with the schema.
+ */
+
+#ifndef FLATBUFFERS_COMMON_READER_H
+#include "flatbuf-gen/flatbuffers_common_reader.h"
+#endif
+#include "flatcc/flatcc_flatbuffers.h"
+#ifndef __alignas_is_defined
+#include <stdalign.h>
+#endif
+#include "flatcc/flatcc_prologue.h"
+#undef flatbuffers_identifier
+#define flatbuffers_identifier "EJTR"
+#undef flatbuffers_extension
+#define flatbuffers_extension "bin"
+
+
+typedef const struct ej_report_FileContent_table *ej_report_FileContent_table_t;
+typedef struct ej_report_FileContent_table *ej_report_FileContent_mutable_table_t;
+typedef const flatbuffers_uoffset_t *ej_report_FileContent_vec_t;
+typedef flatbuffers_uoffset_t *ej_report_FileContent_mutable_vec_t;
+#ifndef ej_report_FileContent_file_identifier
+#define ej_report_FileContent_file_identifier "EJTR"
+#endif
+/* deprecated, use ej_report_FileContent_file_identifier */
+#ifndef ej_report_FileContent_identifier
+#define ej_report_FileContent_identifier "EJTR"
+#endif
+#define ej_report_FileContent_type_hash ((flatbuffers_thash_t)0x79fe1953)
+#define ej_report_FileContent_type_identifier "\x53\x19\xfe\x79"
+#ifndef ej_report_FileContent_file_extension
+#define ej_report_FileContent_file_extension "bin"
+#endif
+
+typedef const struct ej_report_Test_table *ej_report_Test_table_t;
+typedef struct ej_report_Test_table *ej_report_Test_mutable_table_t;
+typedef const flatbuffers_uoffset_t *ej_report_Test_vec_t;
+typedef flatbuffers_uoffset_t *ej_report_Test_mutable_vec_t;
+#ifndef ej_report_Test_file_identifier
+#define ej_report_Test_file_identifier "EJTR"
+#endif
+/* deprecated, use ej_report_Test_file_identifier */
+#ifndef ej_report_Test_identifier
+#define ej_report_Test_identifier "EJTR"
+#endif
+#define ej_report_Test_type_hash ((flatbuffers_thash_t)0x079a1508)
+#define ej_report_Test_type_identifier "\x08\x15\x9a\x07"
+#ifndef ej_report_Test_file_extension
+#define ej_report_Test_file_extension "bin"
+#endif
+
+typedef const struct ej_report_Row_table *ej_report_Row_table_t;
+typedef struct ej_report_Row_table *ej_report_Row_mutable_table_t;
+typedef const flatbuffers_uoffset_t *ej_report_Row_vec_t;
+typedef flatbuffers_uoffset_t *ej_report_Row_mutable_vec_t;
+#ifndef ej_report_Row_file_identifier
+#define ej_report_Row_file_identifier "EJTR"
+#endif
+/* deprecated, use ej_report_Row_file_identifier */
+#ifndef ej_report_Row_identifier
+#define ej_report_Row_identifier "EJTR"
+#endif
+#define ej_report_Row_type_hash ((flatbuffers_thash_t)0x9aaf0da8)
+#define ej_report_Row_type_identifier "\xa8\x0d\xaf\x9a"
+#ifndef ej_report_Row_file_extension
+#define ej_report_Row_file_extension "bin"
+#endif
+
+typedef const struct ej_report_Cell_table *ej_report_Cell_table_t;
+typedef struct ej_report_Cell_table *ej_report_Cell_mutable_table_t;
+typedef const flatbuffers_uoffset_t *ej_report_Cell_vec_t;
+typedef flatbuffers_uoffset_t *ej_report_Cell_mutable_vec_t;
+#ifndef ej_report_Cell_file_identifier
+#define ej_report_Cell_file_identifier "EJTR"
+#endif
+/* deprecated, use ej_report_Cell_file_identifier */
+#ifndef ej_report_Cell_identifier
+#define ej_report_Cell_identifier "EJTR"
+#endif
+#define ej_report_Cell_type_hash ((flatbuffers_thash_t)0x95e88960)
+#define ej_report_Cell_type_identifier "\x60\x89\xe8\x95"
+#ifndef ej_report_Cell_file_extension
+#define ej_report_Cell_file_extension "bin"
+#endif
+
+typedef const struct ej_report_Report_table *ej_report_Report_table_t;
+typedef struct ej_report_Report_table *ej_report_Report_mutable_table_t;
+typedef const flatbuffers_uoffset_t *ej_report_Report_vec_t;
+typedef flatbuffers_uoffset_t *ej_report_Report_mutable_vec_t;
+#ifndef ej_report_Report_file_identifier
+#define ej_report_Report_file_identifier "EJTR"
+#endif
+/* deprecated, use ej_report_Report_file_identifier */
+#ifndef ej_report_Report_identifier
+#define ej_report_Report_identifier "EJTR"
+#endif
+#define ej_report_Report_type_hash ((flatbuffers_thash_t)0xcfa34b7e)
+#define ej_report_Report_type_identifier "\x7e\x4b\xa3\xcf"
+#ifndef ej_report_Report_file_extension
+#define ej_report_Report_file_extension "bin"
+#endif
+
+
+
+struct ej_report_FileContent_table { uint8_t unused__; };
+
+static inline size_t ej_report_FileContent_vec_len(ej_report_FileContent_vec_t vec)
+__flatbuffers_vec_len(vec)
+static inline ej_report_FileContent_table_t ej_report_FileContent_vec_at(ej_report_FileContent_vec_t vec, size_t i)
+__flatbuffers_offset_vec_at(ej_report_FileContent_table_t, vec, i, 0)
+__flatbuffers_table_as_root(ej_report_FileContent)
+
+__flatbuffers_define_scalar_field(0, ej_report_FileContent, size, flatbuffers_int64, int64_t, INT64_C(0))
+__flatbuffers_define_scalar_field(1, ej_report_FileContent, orig_size, flatbuffers_int64, int64_t, INT64_C(0))
+__flatbuffers_define_vector_field(2, ej_report_FileContent, data, flatbuffers_uint8_vec_t, 0)
+__flatbuffers_define_scalar_field(3, ej_report_FileContent, is_too_big, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(4, ej_report_FileContent, is_base64, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(5, ej_report_FileContent, is_bzip2, flatbuffers_int32, int32_t, INT32_C(0))
+
+
+struct ej_report_Test_table { uint8_t unused__; };
+
+static inline size_t ej_report_Test_vec_len(ej_report_Test_vec_t vec)
+__flatbuffers_vec_len(vec)
+static inline ej_report_Test_table_t ej_report_Test_vec_at(ej_report_Test_vec_t vec, size_t i)
+__flatbuffers_offset_vec_at(ej_report_Test_table_t, vec, i, 0)
+__flatbuffers_table_as_root(ej_report_Test)
+
+__flatbuffers_define_scalar_field(0, ej_report_Test, num, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(1, ej_report_Test, status, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(2, ej_report_Test, time, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(3, ej_report_Test, real_time, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(4, ej_report_Test, exit_code, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(5, ej_report_Test, term_signal, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(6, ej_report_Test, nominal_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(7, ej_report_Test, score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(8, ej_report_Test, output_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(9, ej_report_Test, stderr_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(10, ej_report_Test, checker_output_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(11, ej_report_Test, args_too_long, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(12, ej_report_Test, visibility, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(13, ej_report_Test, max_memory_used, flatbuffers_uint64, uint64_t, UINT64_C(0))
+__flatbuffers_define_scalar_field(14, ej_report_Test, max_rss, flatbuffers_int64, int64_t, INT64_C(0))
+__flatbuffers_define_scalar_field(15, ej_report_Test, has_user, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(16, ej_report_Test, user_status, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(17, ej_report_Test, user_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(18, ej_report_Test, user_nominal_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_vector_field(19, ej_report_Test, input_digest, flatbuffers_uint8_vec_t, 0)
+__flatbuffers_define_vector_field(20, ej_report_Test, correct_digest, flatbuffers_uint8_vec_t, 0)
+__flatbuffers_define_vector_field(21, ej_report_Test, info_digest, flatbuffers_uint8_vec_t, 0)
+__flatbuffers_define_string_field(22, ej_report_Test, comment, 0)
+__flatbuffers_define_string_field(23, ej_report_Test, team_comment, 0)
+__flatbuffers_define_string_field(24, ej_report_Test, checker_comment, 0)
+__flatbuffers_define_string_field(25, ej_report_Test, exit_comment, 0)
+__flatbuffers_define_string_field(26, ej_report_Test, checker_token, 0)
+__flatbuffers_define_string_field(27, ej_report_Test, program_stats_str, 0)
+__flatbuffers_define_string_field(28, ej_report_Test, interactor_stats_str, 0)
+__flatbuffers_define_string_field(29, ej_report_Test, checker_stats_str, 0)
+__flatbuffers_define_string_field(30, ej_report_Test, args, 0)
+__flatbuffers_define_table_field(31, ej_report_Test, input, ej_report_FileContent_table_t, 0)
+__flatbuffers_define_table_field(32, ej_report_Test, output, ej_report_FileContent_table_t, 0)
+__flatbuffers_define_table_field(33, ej_report_Test, correct, ej_report_FileContent_table_t, 0)
+__flatbuffers_define_table_field(34, ej_report_Test, error, ej_report_FileContent_table_t, 0)
+__flatbuffers_define_table_field(35, ej_report_Test, checker, ej_report_FileContent_table_t, 0)
+__flatbuffers_define_table_field(36, ej_report_Test, test_checker, ej_report_FileContent_table_t, 0)
+__flatbuffers_define_string_field(37, ej_report_Test, time_samples, 0)
+__flatbuffers_define_scalar_field(38, ej_report_Test, checker_cached, flatbuffers_int32, int32_t, INT32_C(0))
+
+
+struct ej_report_Row_table { uint8_t unused__; };
+
+static inline size_t ej_report_Row_vec_len(ej_report_Row_vec_t vec)
+__flatbuffers_vec_len(vec)
+static inline ej_report_Row_table_t ej_report_Row_vec_at(ej_report_Row_vec_t vec, size_t i)
+__flatbuffers_offset_vec_at(ej_report_Row_table_t, vec, i, 0)
+__flatbuffers_table_as_root(ej_report_Row)
+
+__flatbuffers_define_scalar_field(0, ej_report_Row, row, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_string_field(1, ej_report_Row, name, 0)
+__flatbuffers_define_scalar_field(2, ej_report_Row, must_fail, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(3, ej_report_Row, status, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(4, ej_report_Row, nominal_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(5, ej_report_Row, score, flatbuffers_int32, int32_t, INT32_C(0))
+
+
+struct ej_report_Cell_table { uint8_t unused__; };
+
+static inline size_t ej_report_Cell_vec_len(ej_report_Cell_vec_t vec)
+__flatbuffers_vec_len(vec)
+static inline ej_report_Cell_table_t ej_report_Cell_vec_at(ej_report_Cell_vec_t vec, size_t i)
+__flatbuffers_offset_vec_at(ej_report_Cell_table_t, vec, i, 0)
+__flatbuffers_table_as_root(ej_report_Cell)
+
+__flatbuffers_define_scalar_field(0, ej_report_Cell, row, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(1, ej_report_Cell, column, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(2, ej_report_Cell, status, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(3, ej_report_Cell, time, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(4, ej_report_Cell, real_time, flatbuffers_int32, int32_t, INT32_C(0))
+
+
+struct ej_report_Report_table { uint8_t unused__; };
+
+static inline size_t ej_report_Report_vec_len(ej_report_Report_vec_t vec)
+__flatbuffers_vec_len(vec)
+static inline ej_report_Report_table_t ej_report_Report_vec_at(ej_report_Report_vec_t vec, size_t i)
+__flatbuffers_offset_vec_at(ej_report_Report_table_t, vec, i, 0)
+__flatbuffers_table_as_root(ej_report_Report)
+
+__flatbuffers_define_scalar_field(0, ej_report_Report, submit_id, flatbuffers_int64, int64_t, INT64_C(0))
+__flatbuffers_define_scalar_field(1, ej_report_Report, contest_id, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(2, ej_report_Report, run_id, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(3, ej_report_Report, judge_id, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(4, ej_report_Report, status, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(5, ej_report_Report, scoring_system, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(6, ej_report_Report, archive_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(7, ej_report_Report, correct_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(8, ej_report_Report, info_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(9, ej_report_Report, real_time_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(10, ej_report_Report, max_memory_used_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(11, ej_report_Report, max_rss_available, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(12, ej_report_Report, run_tests, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(13, ej_report_Report, variant, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(14, ej_report_Report, accepting_mode, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(15, ej_report_Report, failed_test, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(16, ej_report_Report, tests_passed, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(17, ej_report_Report, score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(18, ej_report_Report, max_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(19, ej_report_Report, time_limit_ms, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(20, ej_report_Report, real_time_limit_ms, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(21, ej_report_Report, marked_flag, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(22, ej_report_Report, tests_mode, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(23, ej_report_Report, separate_user_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(24, ej_report_Report, user_status, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(25, ej_report_Report, user_tests_passed, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(26, ej_report_Report, user_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(27, ej_report_Report, user_max_score, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(28, ej_report_Report, user_run_tests, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(29, ej_report_Report, compile_error, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(30, ej_report_Report, verdict_bits, flatbuffers_uint32, uint32_t, UINT32_C(0))
+__flatbuffers_define_string_field(31, ej_report_Report, comment, 0)
+__flatbuffers_define_string_field(32, ej_report_Report, valuer_comment, 0)
+__flatbuffers_define_string_field(33, ej_report_Report, valuer_judge_comment, 0)
+__flatbuffers_define_string_field(34, ej_report_Report, valuer_errors, 0)
+__flatbuffers_define_string_field(35, ej_report_Report, host, 0)
+__flatbuffers_define_string_field(36, ej_report_Report, cpu_model, 0)
+__flatbuffers_define_string_field(37, ej_report_Report, cpu_mhz, 0)
+__flatbuffers_define_string_field(38, ej_report_Report, errors, 0)
+__flatbuffers_define_string_field(39, ej_report_Report, compiler_output, 0)
+__flatbuffers_define_vector_field(40, ej_report_Report, uuid, flatbuffers_uint8_vec_t, 0)
+__flatbuffers_define_vector_field(41, ej_report_Report, judge_uuid, flatbuffers_uint8_vec_t, 0)
+__flatbuffers_define_vector_field(42, ej_report_Report, tests, ej_report_Test_vec_t, 0)
+__flatbuffers_define_scalar_field(43, ej_report_Report, tt_row_count, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_scalar_field(44, ej_report_Report, tt_column_count, flatbuffers_int32, int32_t, INT32_C(0))
+__flatbuffers_define_vector_field(45, ej_report_Report, tt_rows, ej_report_Row_vec_t, 0)
+__flatbuffers_define_vector_field(46, ej_report_Report, tt_cells, ej_report_Cell_vec_t, 0)
+
+
+#include "flatcc/flatcc_epilogue.h"
+#endif /* TESTING_REPORT_FB_READER_H */
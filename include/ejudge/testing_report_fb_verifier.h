@@ -0,0 +1,256 @@
+#ifndef TESTING_REPORT_FB_VERIFIER_H
+#define TESTING_REPORT_FB_VERIFIER_H
+
+/*
+ * The verifier for the testing report (flatbuf/testing_report.fbs).
+ * The file is maintained by hand in the form of the flatcc output
+ * and must be kept in sync with the schema.
+ */
+
+#ifndef TESTING_REPORT_FB_READER_H
+#include "ejudge/testing_report_fb_reader.h"
+#endif
+#include "flatcc/flatcc_verifier.h"
+#include "flatcc/flatcc_prologue.h"
+
+static int ej_report_FileContent_verify_table(flatcc_table_verifier_descriptor_t *td);
+static int ej_report_Test_verify_table(flatcc_table_verifier_descriptor_t *td);
+static int ej_report_Row_verify_table(flatcc_table_verifier_descriptor_t *td);
+static int ej_report_Cell_verify_table(flatcc_table_verifier_descriptor_t *td);
+static int ej_report_Report_verify_table(flatcc_table_verifier_descriptor_t *td);
+
+static int ej_report_FileContent_verify_table(flatcc_table_verifier_descriptor_t *td)
+{
+    int ret;
+    if ((ret = flatcc_verify_field(td, 0, 8, 8) /* size */)) return ret;
+    if ((ret = flatcc_verify_field(td, 1, 8, 8) /* orig_size */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 2, 0, 1, 1, INT64_C(4294967295)) /* data */)) return ret;
+    if ((ret = flatcc_verify_field(td, 3, 4, 4) /* is_too_big */)) return ret;
+    if ((ret = flatcc_verify_field(td, 4, 4, 4) /* is_base64 */)) return ret;
+    if ((ret = flatcc_verify_field(td, 5, 4, 4) /* is_bzip2 */)) return ret;
+    return flatcc_verify_ok;
+}
+
+static inline int ej_report_FileContent_verify_as_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_FileContent_identifier, &ej_report_FileContent_verify_table);
+}
+
+static inline int ej_report_FileContent_verify_as_typed_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_FileContent_type_identifier, &ej_report_FileContent_verify_table);
+}
+
+static inline int ej_report_FileContent_verify_as_root_with_identifier(const void *buf, size_t bufsiz, const char *fid)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, fid, &ej_report_FileContent_verify_table);
+}
+
+static inline int ej_report_FileContent_verify_as_root_with_type_hash(const void *buf, size_t bufsiz, flatbuffers_thash_t thash)
+{
+    return flatcc_verify_table_as_typed_root(buf, bufsiz, thash, &ej_report_FileContent_verify_table);
+}
+
+static int ej_report_Test_verify_table(flatcc_table_verifier_descriptor_t *td)
+{
+    int ret;
+    if ((ret = flatcc_verify_field(td, 0, 4, 4) /* num */)) return ret;
+    if ((ret = flatcc_verify_field(td, 1, 4, 4) /* status */)) return ret;
+    if ((ret = flatcc_verify_field(td, 2, 4, 4) /* time */)) return ret;
+    if ((ret = flatcc_verify_field(td, 3, 4, 4) /* real_time */)) return ret;
+    if ((ret = flatcc_verify_field(td, 4, 4, 4) /* exit_code */)) return ret;
+    if ((ret = flatcc_verify_field(td, 5, 4, 4) /* term_signal */)) return ret;
+    if ((ret = flatcc_verify_field(td, 6, 4, 4) /* nominal_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 7, 4, 4) /* score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 8, 4, 4) /* output_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 9, 4, 4) /* stderr_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 10, 4, 4) /* checker_output_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 11, 4, 4) /* args_too_long */)) return ret;
+    if ((ret = flatcc_verify_field(td, 12, 4, 4) /* visibility */)) return ret;
+    if ((ret = flatcc_verify_field(td, 13, 8, 8) /* max_memory_used */)) return ret;
+    if ((ret = flatcc_verify_field(td, 14, 8, 8) /* max_rss */)) return ret;
+    if ((ret = flatcc_verify_field(td, 15, 4, 4) /* has_user */)) return ret;
+    if ((ret = flatcc_verify_field(td, 16, 4, 4) /* user_status */)) return ret;
+    if ((ret = flatcc_verify_field(td, 17, 4, 4) /* user_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 18, 4, 4) /* user_nominal_score */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 19, 0, 1, 1, INT64_C(4294967295)) /* input_digest */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 20, 0, 1, 1, INT64_C(4294967295)) /* correct_digest */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 21, 0, 1, 1, INT64_C(4294967295)) /* info_digest */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 22, 0) /* comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 23, 0) /* team_comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 24, 0) /* checker_comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 25, 0) /* exit_comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 26, 0) /* checker_token */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 27, 0) /* program_stats_str */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 28, 0) /* interactor_stats_str */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 29, 0) /* checker_stats_str */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 30, 0) /* args */)) return ret;
+    if ((ret = flatcc_verify_table_field(td, 31, 0, &ej_report_FileContent_verify_table) /* input */)) return ret;
+    if ((ret = flatcc_verify_table_field(td, 32, 0, &ej_report_FileContent_verify_table) /* output */)) return ret;
+    if ((ret = flatcc_verify_table_field(td, 33, 0, &ej_report_FileContent_verify_table) /* correct */)) return ret;
+    if ((ret = flatcc_verify_table_field(td, 34, 0, &ej_report_FileContent_verify_table) /* error */)) return ret;
+    if ((ret = flatcc_verify_table_field(td, 35, 0, &ej_report_FileContent_verify_table) /* checker */)) return ret;
+    if ((ret = flatcc_verify_table_field(td, 36, 0, &ej_report_FileContent_verify_table) /* test_checker */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 37, 0) /* time_samples */)) return ret;
+    if ((ret = flatcc_verify_field(td, 38, 4, 4) /* checker_cached */)) return ret;
+    return flatcc_verify_ok;
+}
+
+static inline int ej_report_Test_verify_as_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Test_identifier, &ej_report_Test_verify_table);
+}
+
+static inline int ej_report_Test_verify_as_typed_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Test_type_identifier, &ej_report_Test_verify_table);
+}
+
+static inline int ej_report_Test_verify_as_root_with_identifier(const void *buf, size_t bufsiz, const char *fid)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, fid, &ej_report_Test_verify_table);
+}
+
+static inline int ej_report_Test_verify_as_root_with_type_hash(const void *buf, size_t bufsiz, flatbuffers_thash_t thash)
+{
+    return flatcc_verify_table_as_typed_root(buf, bufsiz, thash, &ej_report_Test_verify_table);
+}
+
+static int ej_report_Row_verify_table(flatcc_table_verifier_descriptor_t *td)
+{
+    int ret;
+    if ((ret = flatcc_verify_field(td, 0, 4, 4) /* row */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 1, 0) /* name */)) return ret;
+    if ((ret = flatcc_verify_field(td, 2, 4, 4) /* must_fail */)) return ret;
+    if ((ret = flatcc_verify_field(td, 3, 4, 4) /* status */)) return ret;
+    if ((ret = flatcc_verify_field(td, 4, 4, 4) /* nominal_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 5, 4, 4) /* score */)) return ret;
+    return flatcc_verify_ok;
+}
+
+static inline int ej_report_Row_verify_as_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Row_identifier, &ej_report_Row_verify_table);
+}
+
+static inline int ej_report_Row_verify_as_typed_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Row_type_identifier, &ej_report_Row_verify_table);
+}
+
+static inline int ej_report_Row_verify_as_root_with_identifier(const void *buf, size_t bufsiz, const char *fid)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, fid, &ej_report_Row_verify_table);
+}
+
+static inline int ej_report_Row_verify_as_root_with_type_hash(const void *buf, size_t bufsiz, flatbuffers_thash_t thash)
+{
+    return flatcc_verify_table_as_typed_root(buf, bufsiz, thash, &ej_report_Row_verify_table);
+}
+
+static int ej_report_Cell_verify_table(flatcc_table_verifier_descriptor_t *td)
+{
+    int ret;
+    if ((ret = flatcc_verify_field(td, 0, 4, 4) /* row */)) return ret;
+    if ((ret = flatcc_verify_field(td, 1, 4, 4) /* column */)) return ret;
+    if ((ret = flatcc_verify_field(td, 2, 4, 4) /* status */)) return ret;
+    if ((ret = flatcc_verify_field(td, 3, 4, 4) /* time */)) return ret;
+    if ((ret = flatcc_verify_field(td, 4, 4, 4) /* real_time */)) return ret;
+    return flatcc_verify_ok;
+}
+
+static inline int ej_report_Cell_verify_as_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Cell_identifier, &ej_report_Cell_verify_table);
+}
+
+static inline int ej_report_Cell_verify_as_typed_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Cell_type_identifier, &ej_report_Cell_verify_table);
+}
+
+static inline int ej_report_Cell_verify_as_root_with_identifier(const void *buf, size_t bufsiz, const char *fid)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, fid, &ej_report_Cell_verify_table);
+}
+
+static inline int ej_report_Cell_verify_as_root_with_type_hash(const void *buf, size_t bufsiz, flatbuffers_thash_t thash)
+{
+    return flatcc_verify_table_as_typed_root(buf, bufsiz, thash, &ej_report_Cell_verify_table);
+}
+
+static int ej_report_Report_verify_table(flatcc_table_verifier_descriptor_t *td)
+{
+    int ret;
+    if ((ret = flatcc_verify_field(td, 0, 8, 8) /* submit_id */)) return ret;
+    if ((ret = flatcc_verify_field(td, 1, 4, 4) /* contest_id */)) return ret;
+    if ((ret = flatcc_verify_field(td, 2, 4, 4) /* run_id */)) return ret;
+    if ((ret = flatcc_verify_field(td, 3, 4, 4) /* judge_id */)) return ret;
+    if ((ret = flatcc_verify_field(td, 4, 4, 4) /* status */)) return ret;
+    if ((ret = flatcc_verify_field(td, 5, 4, 4) /* scoring_system */)) return ret;
+    if ((ret = flatcc_verify_field(td, 6, 4, 4) /* archive_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 7, 4, 4) /* correct_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 8, 4, 4) /* info_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 9, 4, 4) /* real_time_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 10, 4, 4) /* max_memory_used_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 11, 4, 4) /* max_rss_available */)) return ret;
+    if ((ret = flatcc_verify_field(td, 12, 4, 4) /* run_tests */)) return ret;
+    if ((ret = flatcc_verify_field(td, 13, 4, 4) /* variant */)) return ret;
+    if ((ret = flatcc_verify_field(td, 14, 4, 4) /* accepting_mode */)) return ret;
+    if ((ret = flatcc_verify_field(td, 15, 4, 4) /* failed_test */)) return ret;
+    if ((ret = flatcc_verify_field(td, 16, 4, 4) /* tests_passed */)) return ret;
+    if ((ret = flatcc_verify_field(td, 17, 4, 4) /* score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 18, 4, 4) /* max_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 19, 4, 4) /* time_limit_ms */)) return ret;
+    if ((ret = flatcc_verify_field(td, 20, 4, 4) /* real_time_limit_ms */)) return ret;
+    if ((ret = flatcc_verify_field(td, 21, 4, 4) /* marked_flag */)) return ret;
+    if ((ret = flatcc_verify_field(td, 22, 4, 4) /* tests_mode */)) return ret;
+    if ((ret = flatcc_verify_field(td, 23, 4, 4) /* separate_user_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 24, 4, 4) /* user_status */)) return ret;
+    if ((ret = flatcc_verify_field(td, 25, 4, 4) /* user_tests_passed */)) return ret;
+    if ((ret = flatcc_verify_field(td, 26, 4, 4) /* user_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 27, 4, 4) /* user_max_score */)) return ret;
+    if ((ret = flatcc_verify_field(td, 28, 4, 4) /* user_run_tests */)) return ret;
+    if ((ret = flatcc_verify_field(td, 29, 4, 4) /* compile_error */)) return ret;
+    if ((ret = flatcc_verify_field(td, 30, 4, 4) /* verdict_bits */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 31, 0) /* comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 32, 0) /* valuer_comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 33, 0) /* valuer_judge_comment */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 34, 0) /* valuer_errors */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 35, 0) /* host */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 36, 0) /* cpu_model */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 37, 0) /* cpu_mhz */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 38, 0) /* errors */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 39, 0) /* compiler_output */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 40, 0, 1, 1, INT64_C(4294967295)) /* uuid */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 41, 0, 1, 1, INT64_C(4294967295)) /* judge_uuid */)) return ret;
+    if ((ret = flatcc_verify_table_vector_field(td, 42, 0, &ej_report_Test_verify_table) /* tests */)) return ret;
+    if ((ret = flatcc_verify_field(td, 43, 4, 4) /* tt_row_count */)) return ret;
+    if ((ret = flatcc_verify_field(td, 44, 4, 4) /* tt_column_count */)) return ret;
+    if ((ret = flatcc_verify_table_vector_field(td, 45, 0, &ej_report_Row_verify_table) /* tt_rows */)) return ret;
+    if ((ret = flatcc_verify_table_vector_field(td, 46, 0, &ej_report_Cell_verify_table) /* tt_cells */)) return ret;
+    return flatcc_verify_ok;
+}
+
+static inline int ej_report_Report_verify_as_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Report_identifier, &ej_report_Report_verify_table);
+}
+
+static inline int ej_report_Report_verify_as_typed_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, ej_report_Report_type_identifier, &ej_report_Report_verify_table);
+}
+
+static inline int ej_report_Report_verify_as_root_with_identifier(const void *buf, size_t bufsiz, const char *fid)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, fid, &ej_report_Report_verify_table);
+}
+
+static inline int ej_report_Report_verify_as_root_with_type_hash(const void *buf, size_t bufsiz, flatbuffers_thash_t thash)
+{
+    return flatcc_verify_table_as_typed_root(buf, bufsiz, thash, &ej_report_Report_verify_table);
+}
+
+#include "flatcc/flatcc_epilogue.h"
+#endif /* TESTING_REPORT_FB_VERIFIER_H */
@@ -36,6 +36,14 @@ enum
   TESTING_REPORT_LAST
 };
 
+// how the checker verdict is obtained without running the checker
+enum
+{
+  TESTING_REPORT_CHECKER_RUN,
+  TESTING_REPORT_CHECKER_CACHED,      // from the checker verdict cache
+  TESTING_REPORT_CHECKER_EXACT_MATCH, // the output is equal to the answer
+};
+
 struct testing_report_file_content
 {
   long long      size;
@@ -70,6 +78,7 @@ struct testing_report_test
   int user_status;
   int user_score;
   int user_nominal_score;
+  int checker_cached;
 
   // digests are BINARY SHA1 (20 bytes)
   unsigned char input_digest[32];
@@ -85,6 +94,8 @@ struct testing_report_test
   unsigned char *program_stats_str;
   unsigned char *interactor_stats_str;
   unsigned char *checker_stats_str;
+  /* CPU time measurements, if the test was measured several times */
+  unsigned char *time_samples;
 
   unsigned char *args;
 
@@ -226,4 +237,36 @@ testing_report_to_file_bson(
         const unsigned char *path,
         testing_report_xml_t r);
 
+// FlatBuffers format readers/writers, stored in place of BSON
+
+// returns 1, if the data is a FlatBuffers report
+int testing_report_is_flatbuf(const unsigned char *data, size_t size);
+
+// if test_num > 0, only the test test_num is decoded, other tests are NULL
+testing_report_xml_t
+testing_report_parse_flatbuf_data(
+        const unsigned char *data,
+        size_t size,
+        int test_num);
+
+int
+testing_report_to_mem_flatbuf(
+        char **pstr,
+        size_t *psize,
+        testing_report_xml_t r);
+
+int
+testing_report_to_file_flatbuf(
+        const unsigned char *path,
+        testing_report_xml_t r);
+
+// reads the report in any format, store_flags is as in the run entry,
+// read_flags is as returned by serve_make_xml_report_read_path
+testing_report_xml_t
+testing_report_parse_file(
+        const unsigned char *path,
+        int store_flags,
+        int read_flags,
+        int test_num);
+
 #endif /* __TESTING_REPORT_XML_H__ */
@@ -22,6 +22,7 @@
 #include "ejudge/osdeps.h"
 #include "ejudge/base64.h"
 #include "ejudge/ej_lzma.h"
+#include "ejudge/agent_frame.h"
 
 #include <stdlib.h>
 #include "ejudge/cJSON.h"
@@ -63,6 +64,9 @@ struct Future
     pthread_cond_t c;
 
     cJSON *value;
+    // the files of a binary frame
+    unsigned char *payload;
+    size_t payload_size;
     long long expiration_time_ms;
     int cancel_requested;
 
@@ -86,6 +90,9 @@ struct AgentClientSsh
     int mode;
     int verbose_mode;
     unsigned char *ip_address;
+    int binary_mode;            /* the agent supports binary frames */
+    int has_put_results;        /* the agent supports put-results */
+    int has_put_data;           /* the agent supports put-data */
 
     // read buffer
     unsigned char *rd_data;
@@ -147,6 +154,7 @@ static void future_fini(struct Future *f)
     pthread_mutex_destroy(&f->m);
     pthread_cond_destroy(&f->c);
     if (f->value) cJSON_Delete(f->value);
+    free(f->payload);
 }
 
 static void future_wait(struct AgentClientSsh *acs, struct Future *f)
@@ -318,18 +326,20 @@ do_pipe_read(struct AgentClientSsh *acs)
         acs->rd_size += r;
         acs->rd_data[acs->rd_size] = 0;
     }
-    if (acs->rd_size >= 2) {
-        int s = 0;
-        for (int i = 1; i < acs->rd_size; ++i) {
-            if (acs->rd_data[i] == '\n' && acs->rd_data[i - 1] == '\n') {
-                add_rchunk(acs, &acs->rd_data[s], i - s + 1);
-                s = i + 1;
-            }
-        }
-        if (s > 0) {
-            acs->rd_size -= s;
-            memcpy(acs->rd_data, acs->rd_data + s, acs->rd_size);
+    int s = 0;
+    while (s < acs->rd_size) {
+        ssize_t len = agent_frame_scan(acs->rd_data + s, acs->rd_size - s);
+        if (len < 0) {
+            acs->need_cleanup = 1;
+            return;
         }
+        if (!len) break;
+        add_rchunk(acs, &acs->rd_data[s], len);
+        s += len;
+    }
+    if (s > 0) {
+        acs->rd_size -= s;
+        memmove(acs->rd_data, acs->rd_data + s, acs->rd_size);
     }
 }
 
@@ -434,12 +444,24 @@ handle_rchunks(struct AgentClientSsh *acs)
 
     for (int i = 0; i < acs->rchunku; ++i) {
         struct FDChunk *c = &acs->rchunks[i];
+        unsigned char *payload = NULL;
+        size_t payload_size = 0;
+        if (agent_frame_is_binary(c->data, c->size)) {
+            char *json = NULL;
+            if (agent_frame_decode(c->data, c->size, &json, &payload, &payload_size) < 0) {
+                free(c->data); c->data = NULL; c->size = 0;
+                continue;
+            }
+            free(c->data);
+            c->data = (unsigned char *) json;
+            c->size = strlen(json);
+        }
         if (acs->verbose_mode) {
             while (c->size > 0 && isspace(c->data[c->size - 1])) {
                 --c->size;
             }
             c->data[c->size] = 0;
-            info("from agent: %s", c->data);
+            info("from agent: %s%s", c->data, payload?" (binary)":"");
         }
         cJSON *j = cJSON_Parse(c->data);
         if (!j) {
@@ -452,6 +474,8 @@ handle_rchunks(struct AgentClientSsh *acs)
                 int serial = js->valuedouble;
                 struct Future *f = get_future(acs, serial);
                 if (f) {
+                    f->payload = payload; payload = NULL;
+                    f->payload_size = payload_size;
                     if (f->callback) {
                         f->value = j; j = NULL;
                         f->ready = 1;
@@ -494,6 +518,7 @@ handle_rchunks(struct AgentClientSsh *acs)
             }
             if (j) cJSON_Delete(j);
         }
+        free(payload);
         free(c->data); c->data = NULL; c->size = 0;
     }
     acs->rchunku = 0;
@@ -506,6 +531,16 @@ static struct Future *
 internal_ping(struct AgentClientSsh *acs);
 static void
 internal_cancel(struct AgentClientSsh *acs, int channel);
+static cJSON *
+create_request(
+        struct AgentClientSsh *acs,
+        struct Future *f,
+        long long *p_time_ms,
+        const unsigned char *query);
+static void
+add_wchunk_json(
+        struct AgentClientSsh *acs,
+        cJSON *json);
 
 static void *
 thread_func(void *ptr)
@@ -651,6 +686,26 @@ connect_func(struct AgentClient *ac)
 {
     struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
     int tossh[2] = { -1, -1 }, fromssh[2] = { -1, -1 };
+    unsigned char mux_path[PATH_MAX];
+
+    // all the agent clients of the host to the same endpoint share
+    // a single ssh connection, the master connection is started by
+    // the first client and persists for a while after the last one
+    mux_path[0] = 0;
+    {
+        unsigned char mux_dir[PATH_MAX];
+        snprintf(mux_dir, sizeof(mux_dir), "%s/var/ssh-mux", EJUDGE_CONTESTS_HOME_DIR);
+        if (strlen(mux_dir) > 48) {
+            // ssh binds the socket to the 40-character hash with a 17-character
+            // suffix, sockaddr_un allows 107 characters
+            info("directory '%s' is too long, ssh connection sharing is disabled", mux_dir);
+        } else if (os_MakeDirPath(mux_dir, 0700) >= 0) {
+            // %C is the hash of the connection parameters
+            snprintf(mux_path, sizeof(mux_path), "ControlPath=%s/%%C", mux_dir);
+        } else {
+            err("cannot create directory '%s', ssh connection sharing is disabled", mux_dir);
+        }
+    }
 
     if (pipe2(tossh, O_CLOEXEC) < 0) {
         err("pipe2 failed: %s", os_ErrorMsg());
@@ -700,16 +755,23 @@ connect_func(struct AgentClient *ac)
         sigemptyset(&ss);
         sigprocmask(SIG_SETMASK, &ss, NULL);
 
-        char *args[] =
-        {
-            "ssh",
-            "-aTx",
-            "-o",
-            "StrictHostKeyChecking=no",
-            acs->endpoint,
-            cmd_s,
-            NULL,
-        };
+        char *args[16];
+        int argi = 0;
+        args[argi++] = "ssh";
+        args[argi++] = "-aTx";
+        args[argi++] = "-o";
+        args[argi++] = "StrictHostKeyChecking=no";
+        if (mux_path[0]) {
+            args[argi++] = "-o";
+            args[argi++] = "ControlMaster=auto";
+            args[argi++] = "-o";
+            args[argi++] = (char *) mux_path;
+            args[argi++] = "-o";
+            args[argi++] = "ControlPersist=600";
+        }
+        args[argi++] = acs->endpoint;
+        args[argi++] = cmd_s;
+        args[argi] = NULL;
 
         /*
         int fd = open("/dev/null", O_WRONLY);
@@ -789,6 +851,31 @@ connect_func(struct AgentClient *ac)
     }
     pthread_attr_destroy(&pa);
 
+    // offer the binary framing, an old agent just ignores it
+    {
+        struct Future f;
+        cJSON *jq = create_request(acs, &f, NULL, "set");
+        cJSON_AddStringToObject(jq, "framing", "binary");
+        add_wchunk_json(acs, jq);
+        cJSON_Delete(jq); jq = NULL;
+        future_wait(acs, &f);
+        if (!acs->is_stopped && f.value) {
+            cJSON *jf = cJSON_GetObjectItem(f.value, "framing");
+            if (jf && jf->type == cJSON_String && !strcmp(jf->valuestring, "binary")) {
+                acs->binary_mode = 1;
+            }
+            cJSON *jr = cJSON_GetObjectItem(f.value, "put-results");
+            if (jr && jr->type == cJSON_True) {
+                acs->has_put_results = 1;
+            }
+            cJSON *jd = cJSON_GetObjectItem(f.value, "put-data");
+            if (jd && jd->type == cJSON_True) {
+                acs->has_put_data = 1;
+            }
+        }
+        future_fini(&f);
+    }
+
     return 0;
 
 fail:
@@ -838,6 +925,78 @@ add_wchunk_json(
     add_wchunk_move(acs, str, len);
 }
 
+static void
+add_file_to_object(cJSON *j, const char *data, size_t size);
+
+/* describes the file in 'j', the data goes to 'payload' in the binary mode */
+static void
+add_request_file(
+        struct AgentClientSsh *acs,
+        struct agent_frame_payload *payload,
+        cJSON *j,
+        const char *data,
+        size_t size)
+{
+    if (acs->binary_mode) {
+        agent_frame_add_file(payload, j, (const unsigned char *) data, size);
+    } else {
+        add_file_to_object(j, data, size);
+    }
+}
+
+/*
+ * sends the request with the files added by add_request_file,
+ * returns -1, if the frame cannot be built (the payload is too big),
+ * the future of the request is unregistered then
+ */
+static int
+add_wchunk_json_payload(
+        struct AgentClientSsh *acs,
+        cJSON *json,
+        struct agent_frame_payload *payload)
+{
+    if (!acs->binary_mode) {
+        add_wchunk_json(acs, json);
+        return 0;
+    }
+
+    char *str = cJSON_PrintUnformatted(json);
+    if (acs->verbose_mode) {
+        info("to agent: %s (binary)", str);
+    }
+    unsigned char *out = NULL;
+    size_t out_size = 0;
+    if (agent_frame_encode(str, strlen(str), payload, &out, &out_size) < 0) {
+        free(str);
+        cJSON *js = cJSON_GetObjectItem(json, "s");
+        if (js && js->type == cJSON_Number) {
+            get_future(acs, (int) js->valuedouble);
+        }
+        return -1;
+    }
+    free(str);
+    add_wchunk_move(acs, out, out_size);
+    return 0;
+}
+
+/*
+ * sends the request with the file attached, returns -1, if the frame
+ * cannot be built, the caller drops its future and fails the request
+ */
+static int
+add_wchunk_json_file(
+        struct AgentClientSsh *acs,
+        cJSON *json,
+        const char *data,
+        size_t size)
+{
+    struct agent_frame_payload payload = {};
+    add_request_file(acs, &payload, json, data, size);
+    int result = add_wchunk_json_payload(acs, json, &payload);
+    agent_frame_payload_free(&payload);
+    return result;
+}
+
 static cJSON *
 create_request(
         struct AgentClientSsh *acs,
@@ -868,7 +1027,7 @@ create_request(
 static int
 process_file_result(
         struct AgentClientSsh *acs,
-        cJSON *j,
+        struct Future *f,
         char **p_pkt_ptr,
         size_t *p_pkt_len);
 
@@ -924,7 +1083,7 @@ poll_queue_func(
                     snprintf(pkt_name, pkt_len, "%s", jn->valuestring);
                     result = 1;
                 }
-                result = process_file_result(acs, f.value, p_data, p_size);
+                result = process_file_result(acs, &f, p_data, p_size);
             }
             cJSON *jt = cJSON_GetObjectItem(f.value, "t");
             if (jt && jt->type == cJSON_Number) {
@@ -940,21 +1099,13 @@ poll_queue_func(
 }
 
 static int
-process_file_result(
-        struct AgentClientSsh *acs,
+decode_file_object(
         cJSON *j,
+        const unsigned char *payload,
+        size_t payload_size,
         char **p_pkt_ptr,
         size_t *p_pkt_len)
 {
-    cJSON *jok = cJSON_GetObjectItem(j, "ok");
-    if (!jok || jok->type != cJSON_True) {
-        return -1;
-    }
-    cJSON *jq = cJSON_GetObjectItem(j, "q");
-    if (!jq || jq->type != cJSON_String || strcmp("file-result", jq->valuestring) != 0) {
-        err("invalid json");
-        return -1;
-    }
     cJSON *jf = cJSON_GetObjectItem(j, "found");
     if (!jf || jf->type != cJSON_True) {
         return 0;
@@ -976,6 +1127,9 @@ process_file_result(
         *p_pkt_len = 0;
         return 1;
     }
+    if (agent_frame_has_file(j)) {
+        return agent_frame_get_file(payload, payload_size, j, p_pkt_ptr, p_pkt_len);
+    }
     cJSON *jb64 = cJSON_GetObjectItem(j, "b64");
     if (!jb64 || jb64->type != cJSON_True) {
         err("invalid json: no encoding");
@@ -1077,6 +1231,26 @@ process_file_result(
     return 1;
 }
 
+static int
+process_file_result(
+        struct AgentClientSsh *acs,
+        struct Future *f,
+        char **p_pkt_ptr,
+        size_t *p_pkt_len)
+{
+    cJSON *j = f->value;
+    cJSON *jok = cJSON_GetObjectItem(j, "ok");
+    if (!jok || jok->type != cJSON_True) {
+        return -1;
+    }
+    cJSON *jq = cJSON_GetObjectItem(j, "q");
+    if (!jq || jq->type != cJSON_String || strcmp("file-result", jq->valuestring) != 0) {
+        err("invalid json");
+        return -1;
+    }
+    return decode_file_object(j, f->payload, f->payload_size, p_pkt_ptr, p_pkt_len);
+}
+
 static int
 get_packet_func(
         struct AgentClient *ac,
@@ -1097,7 +1271,7 @@ get_packet_func(
     if (acs->is_stopped) {
         result = -1;
     } else {
-        result = process_file_result(acs, f.value, p_pkt_ptr, p_pkt_len);
+        result = process_file_result(acs, &f, p_pkt_ptr, p_pkt_len);
     }
 
     future_fini(&f);
@@ -1128,7 +1302,7 @@ get_data_func(
     if (acs->is_stopped) {
         result = -1;
     } else {
-        result = process_file_result(acs, f.value, p_pkt_ptr, p_pkt_len);
+        result = process_file_result(acs, &f, p_pkt_ptr, p_pkt_len);
     }
 
     future_fini(&f);
@@ -1232,9 +1406,12 @@ put_reply_func(
     cJSON_AddStringToObject(jq, "server", contest_server_name);
     cJSON_AddNumberToObject(jq, "contest", contest_id);
     cJSON_AddStringToObject(jq, "run_name", run_name);
-    add_file_to_object(jq, pkt_ptr, pkt_len);
-    add_wchunk_json(acs, jq);
+    int sent = add_wchunk_json_file(acs, jq, pkt_ptr, pkt_len);
     cJSON_Delete(jq); jq = NULL;
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
 
     future_wait(acs, &f);
     if (acs->is_stopped) {
@@ -1271,9 +1448,12 @@ put_output_func(
     if (suffix) {
         cJSON_AddStringToObject(jq, "suffix", suffix);
     }
-    add_file_to_object(jq, pkt_ptr, pkt_len);
-    add_wchunk_json(acs, jq);
+    int sent = add_wchunk_json_file(acs, jq, pkt_ptr, pkt_len);
     cJSON_Delete(jq); jq = NULL;
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
 
     future_wait(acs, &f);
     if (acs->is_stopped) {
@@ -1343,12 +1523,15 @@ put_output_2_func(
     if (suffix) {
         cJSON_AddStringToObject(jq, "suffix", suffix);
     }
-    add_file_to_object(jq, pkt_ptr, pkt_len);
-    add_wchunk_json(acs, jq);
+    int sent = add_wchunk_json_file(acs, jq, pkt_ptr, pkt_len);
     cJSON_Delete(jq); jq = NULL;
     if (pkt_ptr) {
         munmap(pkt_ptr, pkt_len);
     }
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
 
     future_wait(acs, &f);
     if (acs->is_stopped) {
@@ -1430,7 +1613,7 @@ async_wait_init_func(
                     snprintf(pkt_name, pkt_len, "%s", jn->valuestring);
                     result = 1;
                 }
-                result = process_file_result(acs, f.value, p_data, p_size);
+                result = process_file_result(acs, &f, p_data, p_size);
             }
             if (jj && jj->type == cJSON_String && !strcmp("channel-result", jj->valuestring)) {
                 // the future to wait on is already create in the IO thread
@@ -1487,7 +1670,7 @@ async_wait_complete_func(
             snprintf(pkt_name, pkt_len, "%s", jn->valuestring);
             result = 1;
         }
-        result = process_file_result(acs, j, p_data, p_size);
+        result = process_file_result(acs, future, p_data, p_size);
     }
 
 done:
@@ -1576,9 +1759,12 @@ put_packet_func(
     long long time_ms;
     cJSON *jq = create_request(acs, &f, &time_ms, "put-packet");
     cJSON_AddStringToObject(jq, "pkt_name", pkt_name);
-    add_file_to_object(jq, pkt_ptr, pkt_len);
-    add_wchunk_json(acs, jq);
+    int sent = add_wchunk_json_file(acs, jq, pkt_ptr, pkt_len);
     cJSON_Delete(jq); jq = NULL;
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
 
     future_wait(acs, &f);
     if (acs->is_stopped) {
@@ -1667,9 +1853,12 @@ put_heartbeat_func(
     long long time_ms;
     cJSON *jq = create_request(acs, &f, &time_ms, "put-heartbeat");
     cJSON_AddStringToObject(jq, "name", file_name);
-    add_file_to_object(jq, data, size);
-    add_wchunk_json(acs, jq);
+    int sent = add_wchunk_json_file(acs, jq, data, size);
     cJSON_Delete(jq); jq = NULL;
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
 
     future_wait(acs, &f);
     if (acs->is_stopped) {
@@ -1790,12 +1979,15 @@ put_archive_2_func(
     if (suffix) {
         cJSON_AddStringToObject(jq, "suffix", suffix);
     }
-    add_file_to_object(jq, pkt_ptr, pkt_len);
-    add_wchunk_json(acs, jq);
+    int sent = add_wchunk_json_file(acs, jq, pkt_ptr, pkt_len);
     cJSON_Delete(jq); jq = NULL;
     if (pkt_ptr) {
         munmap(pkt_ptr, pkt_len);
     }
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
 
     future_wait(acs, &f);
     if (acs->is_stopped) {
@@ -1864,7 +2056,7 @@ mirror_file_func(
             result = 0;
             goto done;
         }
-        if (process_file_result(acs, f.value, &pkt_ptr, &pkt_len) < 0) {
+        if (process_file_result(acs, &f, &pkt_ptr, &pkt_len) < 0) {
             goto done;
         }
 
@@ -1909,6 +2101,393 @@ done:;
     return result;
 }
 
+static int
+parse_sha256_hex(const unsigned char *str, unsigned char *digest)
+{
+    for (int i = 0; i < 32; ++i) {
+        int v = 0;
+        for (int k = 0; k < 2; ++k) {
+            int c = str[i * 2 + k];
+            if (c >= '0' && c <= '9') {
+                v = v * 16 + c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                v = v * 16 + c - 'a' + 10;
+            } else {
+                return -1;
+            }
+        }
+        digest[i] = v;
+    }
+    if (str[64]) return -1;
+    return 0;
+}
+
+static int
+mirror_stat_func(
+        struct AgentClient *ac,
+        int count,
+        const unsigned char * const *paths,
+        struct AgentMirrorInfo *infos)
+{
+    int result = -1;
+    struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
+    struct Future f;
+    long long time_ms;
+    cJSON *jq = create_request(acs, &f, &time_ms, "mirror-stat");
+    cJSON *jps = cJSON_CreateArray();
+    for (int i = 0; i < count; ++i) {
+        cJSON_AddItemToArray(jps, cJSON_CreateString(paths[i]));
+        infos[i].size = -1;
+        infos[i].mtime = 0;
+        infos[i].mode = -1;
+    }
+    cJSON_AddItemToObject(jq, "paths", jps);
+    add_wchunk_json(acs, jq);
+    cJSON_Delete(jq); jq = NULL;
+
+    future_wait(acs, &f);
+    if (acs->is_stopped || !f.value) {
+        goto done;
+    }
+    cJSON *jok = cJSON_GetObjectItem(f.value, "ok");
+    if (!jok || jok->type != cJSON_True) {
+        goto done;
+    }
+    cJSON *jfs = cJSON_GetObjectItem(f.value, "files");
+    if (!jfs || jfs->type != cJSON_Array || cJSON_GetArraySize(jfs) != count) {
+        err("mirror_stat: invalid or missing 'files' in reply");
+        goto done;
+    }
+    for (int i = 0; i < count; ++i) {
+        cJSON *jf = cJSON_GetArrayItem(jfs, i);
+        cJSON *jfound = cJSON_GetObjectItem(jf, "found");
+        if (!jfound || jfound->type != cJSON_True) continue;
+        cJSON *jsize = cJSON_GetObjectItem(jf, "size");
+        cJSON *jmtime = cJSON_GetObjectItem(jf, "mtime");
+        cJSON *jmode = cJSON_GetObjectItem(jf, "mode");
+        cJSON *jsha = cJSON_GetObjectItem(jf, "sha256");
+        if (!jsize || jsize->type != cJSON_Number
+            || !jmtime || jmtime->type != cJSON_Number
+            || !jmode || jmode->type != cJSON_String
+            || !jsha || jsha->type != cJSON_String) {
+            err("mirror_stat: invalid file entry in reply");
+            goto done;
+        }
+        if (parse_sha256_hex(jsha->valuestring, infos[i].sha256) < 0) {
+            err("mirror_stat: invalid sha256 in reply");
+            goto done;
+        }
+        infos[i].size = jsize->valuedouble;
+        infos[i].mtime = jmtime->valuedouble;
+        infos[i].mode = strtol(jmode->valuestring, NULL, 8) & 07777;
+        if (infos[i].size < 0) infos[i].size = -1;
+    }
+    result = 0;
+
+done:;
+    future_fini(&f);
+    return result;
+}
+
+static int
+mirror_fetch_func(
+        struct AgentClient *ac,
+        int count,
+        const unsigned char * const *paths,
+        char **p_ptrs,
+        size_t *p_lens)
+{
+    int result = -1;
+    struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
+    struct Future f;
+    long long time_ms;
+    cJSON *jq = create_request(acs, &f, &time_ms, "mirror-fetch");
+    cJSON *jps = cJSON_CreateArray();
+    for (int i = 0; i < count; ++i) {
+        cJSON_AddItemToArray(jps, cJSON_CreateString(paths[i]));
+        p_ptrs[i] = NULL;
+        p_lens[i] = 0;
+    }
+    cJSON_AddItemToObject(jq, "paths", jps);
+    add_wchunk_json(acs, jq);
+    cJSON_Delete(jq); jq = NULL;
+
+    future_wait(acs, &f);
+    if (acs->is_stopped || !f.value) {
+        goto done;
+    }
+    cJSON *jok = cJSON_GetObjectItem(f.value, "ok");
+    if (!jok || jok->type != cJSON_True) {
+        goto done;
+    }
+    cJSON *jfs = cJSON_GetObjectItem(f.value, "files");
+    if (!jfs || jfs->type != cJSON_Array || cJSON_GetArraySize(jfs) != count) {
+        err("mirror_fetch: invalid or missing 'files' in reply");
+        goto done;
+    }
+    for (int i = 0; i < count; ++i) {
+        cJSON *jf = cJSON_GetArrayItem(jfs, i);
+        if (decode_file_object(jf, f.payload, f.payload_size, &p_ptrs[i], &p_lens[i]) < 0) {
+            goto fail;
+        }
+    }
+    result = 0;
+
+done:;
+    future_fini(&f);
+    return result;
+
+fail:;
+    for (int i = 0; i < count; ++i) {
+        free(p_ptrs[i]);
+        p_ptrs[i] = NULL;
+        p_lens[i] = 0;
+    }
+    goto done;
+}
+
+static int
+map_result_file(
+        const unsigned char *path,
+        char **p_ptr,
+        size_t *p_len)
+{
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_NOCTTY | O_NOFOLLOW, 0);
+    if (fd < 0) {
+        err("put_results: cannot open '%s': %s", path, os_ErrorMsg());
+        return -1;
+    }
+    struct stat stb;
+    if (fstat(fd, &stb) < 0) {
+        err("put_results: fstat failed '%s': %s", path, os_ErrorMsg());
+        close(fd);
+        return -1;
+    }
+    if (!S_ISREG(stb.st_mode)) {
+        err("put_results: not a regular file '%s'", path);
+        close(fd);
+        return -1;
+    }
+    if (stb.st_size < 0 || stb.st_size > 1000000000) {
+        err("put_results: file too big '%s': %lld", path, (long long) stb.st_size);
+        close(fd);
+        return -1;
+    }
+    *p_ptr = NULL;
+    *p_len = stb.st_size;
+    if (stb.st_size > 0) {
+        char *ptr = mmap(NULL, stb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            err("put_results: mmap failed '%s': %s", path, os_ErrorMsg());
+            close(fd);
+            return -1;
+        }
+        *p_ptr = ptr;
+    }
+    close(fd);
+    return 0;
+}
+
+/* uploads the result files one request per file, the reply goes last */
+static int
+put_results_separately(
+        struct AgentClient *ac,
+        const unsigned char *contest_server_name,
+        int contest_id,
+        const unsigned char *run_name,
+        int file_count,
+        const struct AgentResultFile *files,
+        const unsigned char *reply_ptr,
+        size_t reply_len)
+{
+    for (int i = 0; i < file_count; ++i) {
+        const struct AgentResultFile *rf = &files[i];
+        int r;
+        if (rf->kind == AGENT_RESULT_ARCHIVE) {
+            r = put_archive_2_func(ac, contest_server_name, contest_id, run_name, rf->suffix, rf->path);
+        } else {
+            r = put_output_2_func(ac, contest_server_name, contest_id, run_name, rf->suffix, rf->path);
+        }
+        if (r < 0) return -1;
+    }
+    return put_reply_func(ac, contest_server_name, contest_id, run_name, reply_ptr, reply_len);
+}
+
+static int
+put_results_func(
+        struct AgentClient *ac,
+        const unsigned char *contest_server_name,
+        int contest_id,
+        const unsigned char *run_name,
+        int file_count,
+        const struct AgentResultFile *files,
+        const unsigned char *reply_ptr,
+        size_t reply_len)
+{
+    struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
+
+    if (!acs->has_put_results) {
+        // an old agent, one request per file
+        return put_results_separately(ac, contest_server_name, contest_id, run_name,
+                                      file_count, files, reply_ptr, reply_len);
+    }
+
+    int result = -1;
+    int too_big = 0;
+    char *ptrs[file_count + 1];
+    size_t lens[file_count + 1];
+    int mapped = 0;
+    struct agent_frame_payload payload = {};
+    cJSON *jq = NULL;
+    struct Future f;
+    int has_future = 0;
+
+    for (; mapped < file_count; ++mapped) {
+        if (map_result_file(files[mapped].path, &ptrs[mapped], &lens[mapped]) < 0) {
+            goto done;
+        }
+    }
+
+    long long time_ms;
+    jq = create_request(acs, &f, &time_ms, "put-results");
+    has_future = 1;
+    cJSON_AddStringToObject(jq, "server", contest_server_name);
+    cJSON_AddNumberToObject(jq, "contest", contest_id);
+    cJSON_AddStringToObject(jq, "run_name", run_name);
+    cJSON *jfs = cJSON_CreateArray();
+    for (int i = 0; i < file_count; ++i) {
+        cJSON *jf = cJSON_CreateObject();
+        cJSON_AddStringToObject(jf, "dir", (files[i].kind == AGENT_RESULT_ARCHIVE)?"output":"report");
+        if (files[i].suffix) {
+            cJSON_AddStringToObject(jf, "suffix", files[i].suffix);
+        }
+        add_request_file(acs, &payload, jf, ptrs[i], lens[i]);
+        cJSON_AddItemToArray(jfs, jf);
+    }
+    cJSON_AddItemToObject(jq, "files", jfs);
+    cJSON *jr = cJSON_CreateObject();
+    add_request_file(acs, &payload, jr, (const char *) reply_ptr, reply_len);
+    cJSON_AddItemToObject(jq, "reply", jr);
+    if (add_wchunk_json_payload(acs, jq, &payload) < 0) {
+        // the files do not fit in one frame
+        too_big = 1;
+        goto done;
+    }
+    cJSON_Delete(jq); jq = NULL;
+    agent_frame_payload_free(&payload);
+    for (; mapped > 0; --mapped) {
+        if (ptrs[mapped - 1]) munmap(ptrs[mapped - 1], lens[mapped - 1]);
+    }
+
+    future_wait(acs, &f);
+    if (!acs->is_stopped && f.value) {
+        cJSON *jok = cJSON_GetObjectItem(f.value, "ok");
+        if (jok && jok->type == cJSON_True) {
+            result = 0;
+        }
+    }
+
+done:;
+    if (jq) cJSON_Delete(jq);
+    agent_frame_payload_free(&payload);
+    for (; mapped > 0; --mapped) {
+        if (ptrs[mapped - 1]) munmap(ptrs[mapped - 1], lens[mapped - 1]);
+    }
+    if (has_future) future_fini(&f);
+    if (too_big) {
+        result = put_results_separately(ac, contest_server_name, contest_id, run_name,
+                                        file_count, files, reply_ptr, reply_len);
+    }
+    return result;
+}
+
+static int
+get_data_async_func(
+        struct AgentClient *ac,
+        const unsigned char *pkt_name,
+        const unsigned char *suffix,
+        struct Future **p_future)
+{
+    struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
+    struct Future *f;
+
+    // a prefetched file must be returned, if it is not used
+    if (!acs->has_put_data) return -1;
+
+    XCALLOC(f, 1);
+    cJSON *jq = create_request(acs, f, NULL, "get-data");
+    cJSON_AddStringToObject(jq, "pkt_name", pkt_name);
+    if (suffix) {
+        cJSON_AddStringToObject(jq, "suffix", suffix);
+    }
+    add_wchunk_json(acs, jq);
+    cJSON_Delete(jq); jq = NULL;
+
+    *p_future = f;
+    return 0;
+}
+
+static int
+get_data_async_complete_func(
+        struct AgentClient *ac,
+        struct Future **p_future,
+        char **p_pkt_ptr,
+        size_t *p_pkt_len)
+{
+    int result = -1;
+    struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
+    struct Future *f = *p_future;
+    if (!f) return -1;
+
+    future_wait(acs, f);
+    if (!acs->is_stopped && f->value) {
+        result = process_file_result(acs, f, p_pkt_ptr, p_pkt_len);
+    }
+
+    future_fini(f);
+    free(f);
+    *p_future = NULL;
+    return result;
+}
+
+static int
+put_data_func(
+        struct AgentClient *ac,
+        const unsigned char *pkt_name,
+        const unsigned char *suffix,
+        const unsigned char *pkt_ptr,
+        size_t pkt_len)
+{
+    int result = 0;
+    struct AgentClientSsh *acs = (struct AgentClientSsh *) ac;
+    struct Future f;
+    long long time_ms;
+    cJSON *jq = create_request(acs, &f, &time_ms, "put-data");
+    cJSON_AddStringToObject(jq, "pkt_name", pkt_name);
+    if (suffix) {
+        cJSON_AddStringToObject(jq, "suffix", suffix);
+    }
+    int sent = add_wchunk_json_file(acs, jq, pkt_ptr, pkt_len);
+    cJSON_Delete(jq); jq = NULL;
+    if (sent < 0) {
+        future_fini(&f);
+        return -1;
+    }
+
+    future_wait(acs, &f);
+    if (acs->is_stopped) {
+        result = -1;
+    } else if (f.value) {
+        cJSON *jok = cJSON_GetObjectItem(f.value, "ok");
+        if (!jok || jok->type != cJSON_True) {
+            result = -1;
+        }
+    }
+
+    future_fini(&f);
+    return result;
+}
+
 static const struct AgentClientOps ops_ssh =
 {
     destroy_func,
@@ -1931,6 +2510,12 @@ static const struct AgentClientOps ops_ssh =
     delete_heartbeat_func,
     put_archive_2_func,
     mirror_file_func,
+    mirror_stat_func,
+    mirror_fetch_func,
+    put_results_func,
+    get_data_async_func,
+    get_data_async_complete_func,
+    put_data_func,
 };
 
 struct AgentClient *
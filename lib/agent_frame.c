@@ -0,0 +1,250 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/agent_frame.h"
+#include "ejudge/xalloc.h"
+#include "ejudge/errlog.h"
+
+#include "ejudge/cJSON.h"
+
+#include <string.h>
+#include <stdint.h>
+#include <zlib.h>
+
+#define FRAME_MAGIC "\0EJF"
+#define MAX_PART_SIZE 1000000000
+// smaller payloads are not compressed
+#define MIN_DEFLATE_SIZE 256
+
+static void
+put_le32(unsigned char *ptr, uint32_t value)
+{
+    ptr[0] = value;
+    ptr[1] = value >> 8;
+    ptr[2] = value >> 16;
+    ptr[3] = value >> 24;
+}
+
+static uint32_t
+get_le32(const unsigned char *ptr)
+{
+    return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((uint32_t) ptr[3] << 24);
+}
+
+void
+agent_frame_payload_free(struct agent_frame_payload *p)
+{
+    free(p->data);
+    memset(p, 0, sizeof(*p));
+}
+
+void
+agent_frame_add_file(
+        struct agent_frame_payload *p,
+        cJSON *j,
+        const unsigned char *data,
+        size_t size)
+{
+    cJSON_AddNumberToObject(j, "size", (double) size);
+    cJSON_AddNumberToObject(j, "boff", (double) p->size);
+    if (!size) return;
+
+    if (p->size + size > p->reserved) {
+        size_t new_reserved = p->reserved * 2;
+        if (!new_reserved) new_reserved = 4096;
+        while (new_reserved < p->size + size) new_reserved *= 2;
+        p->data = xrealloc(p->data, new_reserved);
+        p->reserved = new_reserved;
+    }
+    memcpy(p->data + p->size, data, size);
+    p->size += size;
+}
+
+int
+agent_frame_has_file(cJSON *j)
+{
+    cJSON *jo = cJSON_GetObjectItem(j, "boff");
+    return jo && jo->type == cJSON_Number;
+}
+
+int
+agent_frame_get_file(
+        const unsigned char *payload,
+        size_t payload_size,
+        cJSON *j,
+        char **p_data,
+        size_t *p_size)
+{
+    cJSON *jz = cJSON_GetObjectItem(j, "size");
+    cJSON *jo = cJSON_GetObjectItem(j, "boff");
+    if (!jz || jz->type != cJSON_Number || !jo || jo->type != cJSON_Number) {
+        err("agent_frame: invalid file object");
+        return -1;
+    }
+    double size = jz->valuedouble;
+    double offset = jo->valuedouble;
+    if (size < 0 || offset < 0 || size + offset > payload_size) {
+        err("agent_frame: file is out of the payload");
+        return -1;
+    }
+    char *ptr = malloc((size_t) size + 1);
+    if (size > 0) memcpy(ptr, payload + (size_t) offset, (size_t) size);
+    ptr[(size_t) size] = 0;
+    *p_data = ptr;
+    *p_size = (size_t) size;
+    return 1;
+}
+
+int
+agent_frame_is_binary(const unsigned char *data, size_t size)
+{
+    return size > 0 && !data[0];
+}
+
+ssize_t
+agent_frame_scan(const unsigned char *data, size_t size)
+{
+    if (!size) return 0;
+    if (agent_frame_is_binary(data, size)) {
+        if (size < AGENT_FRAME_HEADER_SIZE) return 0;
+        if (memcmp(data, FRAME_MAGIC, 4) != 0) {
+            err("agent_frame: invalid frame magic");
+            return -1;
+        }
+        size_t json_size = get_le32(data + 8);
+        size_t wire_size = get_le32(data + 12);
+        if (json_size > MAX_PART_SIZE || wire_size > MAX_PART_SIZE) {
+            err("agent_frame: frame is too big");
+            return -1;
+        }
+        size_t total = AGENT_FRAME_HEADER_SIZE + json_size + wire_size;
+        if (size < total) return 0;
+        return total;
+    }
+    for (size_t i = 1; i < size; ++i) {
+        if (data[i] == '\n' && data[i - 1] == '\n') {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+int
+agent_frame_encode(
+        const char *json,
+        size_t json_size,
+        const struct agent_frame_payload *p,
+        unsigned char **p_out,
+        size_t *p_out_size)
+{
+    size_t payload_size = 0;
+    const unsigned char *wire_data = NULL;
+    size_t wire_size = 0;
+    unsigned char *z_buf = NULL;
+    unsigned flags = 0;
+
+    if (p) payload_size = p->size;
+    if (json_size > MAX_PART_SIZE || payload_size > MAX_PART_SIZE) {
+        err("agent_frame: message is too big");
+        return -1;
+    }
+    wire_data = p?p->data:NULL;
+    wire_size = payload_size;
+    if (payload_size >= MIN_DEFLATE_SIZE) {
+        uLongf z_size = compressBound(payload_size);
+        z_buf = malloc(z_size);
+        if (compress2(z_buf, &z_size, p->data, payload_size, 1) == Z_OK
+            && z_size < payload_size) {
+            wire_data = z_buf;
+            wire_size = z_size;
+            flags |= AGENT_FRAME_DEFLATE;
+        }
+    }
+
+    size_t out_size = AGENT_FRAME_HEADER_SIZE + json_size + wire_size;
+    unsigned char *out = malloc(out_size + 1);
+    memcpy(out, FRAME_MAGIC, 4);
+    put_le32(out + 4, flags);
+    put_le32(out + 8, json_size);
+    put_le32(out + 12, wire_size);
+    put_le32(out + 16, payload_size);
+    memcpy(out + AGENT_FRAME_HEADER_SIZE, json, json_size);
+    if (wire_size > 0) {
+        memcpy(out + AGENT_FRAME_HEADER_SIZE + json_size, wire_data, wire_size);
+    }
+    out[out_size] = 0;
+    free(z_buf);
+
+    *p_out = out;
+    *p_out_size = out_size;
+    return 0;
+}
+
+int
+agent_frame_decode(
+        const unsigned char *data,
+        size_t size,
+        char **p_json,
+        unsigned char **p_payload,
+        size_t *p_payload_size)
+{
+    if (agent_frame_scan(data, size) != size || !agent_frame_is_binary(data, size)) {
+        err("agent_frame: invalid frame");
+        return -1;
+    }
+    unsigned flags = get_le32(data + 4);
+    size_t json_size = get_le32(data + 8);
+    size_t wire_size = get_le32(data + 12);
+    size_t payload_size = get_le32(data + 16);
+    const unsigned char *json_ptr = data + AGENT_FRAME_HEADER_SIZE;
+    const unsigned char *wire_ptr = json_ptr + json_size;
+    if (payload_size > MAX_PART_SIZE) {
+        err("agent_frame: payload is too big");
+        return -1;
+    }
+    if (memchr(json_ptr, 0, json_size)) {
+        err("agent_frame: binary data in JSON");
+        return -1;
+    }
+
+    unsigned char *payload = malloc(payload_size + 1);
+    if ((flags & AGENT_FRAME_DEFLATE)) {
+        uLongf out_size = payload_size;
+        if (uncompress(payload, &out_size, wire_ptr, wire_size) != Z_OK
+            || out_size != payload_size) {
+            err("agent_frame: payload decompression failed");
+            free(payload);
+            return -1;
+        }
+    } else {
+        if (wire_size != payload_size) {
+            err("agent_frame: payload size mismatch");
+            free(payload);
+            return -1;
+        }
+        if (payload_size > 0) memcpy(payload, wire_ptr, payload_size);
+    }
+    payload[payload_size] = 0;
+
+    char *json = malloc(json_size + 1);
+    memcpy(json, json_ptr, json_size);
+    json[json_size] = 0;
+
+    *p_json = json;
+    *p_payload = payload;
+    *p_payload_size = payload_size;
+    return 0;
+}
@@ -0,0 +1,322 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/config.h"
+#include "ejudge/builtin_checker.h"
+#include "ejudge/checker_cmp.h"
+#include "ejudge/runlog.h"
+
+#include "ejudge/xalloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/*
+ * The comparison itself is done by the same code as in the standard
+ * checkers (lib/checker_cmp.c), the failures are written to the log
+ * instead of stderr and do not terminate the process.
+ */
+
+static const char * const stream_names[3] =
+{
+  "test input data",
+  "user program output",
+  "test correct output"
+};
+
+struct checker_ctx
+{
+  FILE *f[3];
+  struct checker_cmp_ctx cc;
+  builtin_checker_getenv_t getenv_func;
+  void *getenv_data;
+
+  char *text[3];
+  void *map_addr[3];
+  size_t map_size[3];
+  struct checker_cmp_text t[3];
+};
+
+static void
+log_error(
+        struct checker_cmp_ctx *cc,
+        int status,
+        int ind,
+        const char *format,
+        va_list args)
+{
+  FILE *log_f = (FILE *) cc->user;
+
+  if (ind >= 0) fprintf(log_f, "%s: ", cc->stream_names[ind]);
+  vfprintf(log_f, format, args);
+  fprintf(log_f, "\n");
+}
+
+static const char *
+ctx_getenv(struct checker_ctx *cx, const char *name)
+{
+  return cx->getenv_func(cx->getenv_data, name);
+}
+
+static int
+checker_ok(struct checker_ctx *cx)
+{
+  fprintf((FILE *) cx->cc.user, "OK\n");
+  cx->cc.status = RUN_OK;
+  return 0;
+}
+
+/*
+ * maps the file to memory, so the program output of any size
+ * does not take the memory of the process,
+ * non-regular files are read into a buffer
+ */
+static int
+read_text(struct checker_ctx *cx, int ind)
+{
+  FILE *f = cx->f[ind];
+  size_t text_a = 4096, text_u = 0;
+  struct stat stb;
+
+  if (fstat(fileno(f), &stb) >= 0 && S_ISREG(stb.st_mode)) {
+    if (stb.st_size <= 0) {
+      cx->t[ind].data = (const unsigned char *) "";
+      cx->t[ind].size = 0;
+      cx->t[ind].pos = 0;
+      return 0;
+    }
+    if ((size_t) stb.st_size != stb.st_size) {
+      return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "%s: file is too big",
+                              stream_names[ind]);
+    }
+    void *addr = mmap(NULL, stb.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    if (addr == MAP_FAILED) {
+      return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "%s: mmap failed: %s",
+                              stream_names[ind], strerror(errno));
+    }
+    madvise(addr, stb.st_size, MADV_SEQUENTIAL);
+    cx->map_addr[ind] = addr;
+    cx->map_size[ind] = stb.st_size;
+    cx->t[ind].data = (const unsigned char *) addr;
+    cx->t[ind].size = stb.st_size;
+    cx->t[ind].pos = 0;
+    return 0;
+  }
+
+  cx->text[ind] = xmalloc(text_a);
+  while (1) {
+    if (text_u == text_a) {
+      cx->text[ind] = xrealloc(cx->text[ind], text_a *= 2);
+    }
+    size_t r = fread(cx->text[ind] + text_u, 1, text_a - text_u, f);
+    if (!r) break;
+    text_u += r;
+  }
+  if (ferror(f)) {
+    return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "%s: input error",
+                            stream_names[ind]);
+  }
+  cx->t[ind].data = (const unsigned char *) cx->text[ind];
+  cx->t[ind].size = text_u;
+  cx->t[ind].pos = 0;
+  return 0;
+}
+
+/* the same as checker_require_nl */
+static int
+require_nl(struct checker_ctx *cx, const struct checker_cmp_text *t)
+{
+  if (!t->size || t->data[t->size - 1] == '\n') return 0;
+  // check that the only content is BOM 0xEF, 0xBB, 0xBF
+  if (t->size == 3 && !memcmp(t->data, "\xEF\xBB\xBF", 3)) return 0;
+  return checker_cmp_fail(&cx->cc, RUN_PRESENTATION_ERR,
+                          "No final \\n in the output file");
+}
+
+static void
+skip_bom(struct checker_cmp_text *t)
+{
+  if (t->size - t->pos >= 3 && !memcmp(t->data + t->pos, "\xEF\xBB\xBF", 3)) {
+    t->pos += 3;
+  }
+}
+
+static int
+check_cmp_file(struct checker_ctx *cx)
+{
+  skip_bom(&cx->t[2]);
+  skip_bom(&cx->t[1]);
+  if (checker_cmp_check_text(&cx->cc, 1, &cx->t[1]) < 0) return -1;
+  if (checker_cmp_check_text(&cx->cc, 2, &cx->t[2]) < 0) return -1;
+  return checker_cmp_lines(&cx->cc, &cx->t[1], &cx->t[2],
+                           ctx_getenv(cx, "EJUDGE_NOCASE") != NULL, 0);
+}
+
+static int
+check_cmp_int_seq(struct checker_ctx *cx)
+{
+  int base = 10;
+  const char *s;
+
+  if ((s = ctx_getenv(cx, "EJ_BASE")) && *s) {
+    errno = 0;
+    char *eptr;
+    base = strtol(s, &eptr, 10);
+    if (errno || *eptr || base <= 1 || base > 36) {
+      return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "invalid conversion base");
+    }
+  }
+  skip_bom(&cx->t[2]);
+  skip_bom(&cx->t[1]);
+  return checker_cmp_int_seq(&cx->cc, &cx->t[1], &cx->t[2], base);
+}
+
+static int
+check_cmp_double_seq(struct checker_ctx *cx)
+{
+  double eps;
+  const char *s;
+  int n;
+
+  if (!(s = ctx_getenv(cx, "EPS"))) {
+    return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED,
+                            "Environment variable EPS is not set");
+  }
+  if (sscanf(s, "%lf%n", &eps, &n) != 1 || s[n]) {
+    return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "Cannot parse EPS value");
+  }
+  if (eps <= 0.0) {
+    return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "EPS <= 0");
+  }
+  if (eps >= 1) {
+    return checker_cmp_fail(&cx->cc, RUN_CHECK_FAILED, "EPS >= 1");
+  }
+  skip_bom(&cx->t[2]);
+  skip_bom(&cx->t[1]);
+  return checker_cmp_double_seq(&cx->cc, &cx->t[1], &cx->t[2], eps,
+                                ctx_getenv(cx, "ABSOLUTE") != NULL);
+}
+
+static int
+check_cmp_yesno(struct checker_ctx *cx)
+{
+  skip_bom(&cx->t[2]);
+  skip_bom(&cx->t[1]);
+  return checker_cmp_yesno(&cx->cc, &cx->t[1], &cx->t[2],
+                           ctx_getenv(cx, "CASE_INSENSITIVE") != NULL);
+}
+
+static const struct
+{
+  const char *name;
+  int kind;
+} builtin_checkers[] =
+{
+  { "cmp_file", BUILTIN_CHECKER_CMP_FILE },
+  { "cmp_int_seq", BUILTIN_CHECKER_CMP_INT_SEQ },
+  { "cmp_double_seq", BUILTIN_CHECKER_CMP_DOUBLE_SEQ },
+  { "cmp_yesno", BUILTIN_CHECKER_CMP_YESNO },
+  { NULL, BUILTIN_CHECKER_NONE },
+};
+
+int
+builtin_checker_find(const unsigned char *standard_checker)
+{
+  if (!standard_checker) return BUILTIN_CHECKER_NONE;
+  for (int i = 0; builtin_checkers[i].name; ++i) {
+    if (!strcmp(builtin_checkers[i].name, standard_checker))
+      return builtin_checkers[i].kind;
+  }
+  return BUILTIN_CHECKER_NONE;
+}
+
+int
+builtin_checker_run(
+        int kind,
+        const unsigned char *input_path,
+        const unsigned char *output_path,
+        const unsigned char *corr_path,
+        FILE *log_f,
+        builtin_checker_getenv_t getenv_func,
+        void *getenv_data)
+{
+  struct checker_ctx cx = {};
+  int r;
+
+  cx.cc.error = log_error;
+  for (int i = 0; i < 3; ++i) {
+    cx.cc.stream_names[i] = stream_names[i];
+  }
+  cx.cc.user = log_f;
+  cx.cc.status = RUN_CHECK_FAILED;
+  cx.getenv_func = getenv_func;
+  cx.getenv_data = getenv_data;
+
+  // the same order of opening as in checker_do_init
+  if (!(cx.f[0] = fopen(input_path, "r"))) {
+    checker_cmp_fail(&cx.cc, RUN_CHECK_FAILED, "Cannot open input file '%s'",
+                     input_path);
+    goto cleanup;
+  }
+  if (!(cx.f[1] = fopen(output_path, "r"))) {
+    checker_cmp_fail(&cx.cc, RUN_PRESENTATION_ERR, "Cannot open output file '%s'",
+                     output_path);
+    goto cleanup;
+  }
+  if (!corr_path || !(cx.f[2] = fopen(corr_path, "r"))) {
+    checker_cmp_fail(&cx.cc, RUN_CHECK_FAILED,
+                     "Cannot open correct output file '%s'",
+                     corr_path?(const char*) corr_path:"");
+    goto cleanup;
+  }
+
+  if (read_text(&cx, 1) < 0 || read_text(&cx, 2) < 0) goto cleanup;
+  if (ctx_getenv(&cx, "EJ_REQUIRE_NL") && require_nl(&cx, &cx.t[1]) < 0)
+    goto cleanup;
+
+  switch (kind) {
+  case BUILTIN_CHECKER_CMP_FILE:
+    r = check_cmp_file(&cx);
+    break;
+  case BUILTIN_CHECKER_CMP_INT_SEQ:
+    r = check_cmp_int_seq(&cx);
+    break;
+  case BUILTIN_CHECKER_CMP_DOUBLE_SEQ:
+    r = check_cmp_double_seq(&cx);
+    break;
+  case BUILTIN_CHECKER_CMP_YESNO:
+    r = check_cmp_yesno(&cx);
+    break;
+  default:
+    r = checker_cmp_fail(&cx.cc, RUN_CHECK_FAILED, "invalid built-in checker %d",
+                         kind);
+    break;
+  }
+  if (r >= 0) checker_ok(&cx);
+
+cleanup:
+  for (int i = 0; i < 3; ++i) {
+    if (cx.map_addr[i]) munmap(cx.map_addr[i], cx.map_size[i]);
+    if (cx.f[i]) fclose(cx.f[i]);
+    xfree(cx.text[i]);
+  }
+  return cx.cc.status;
+}
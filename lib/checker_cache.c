@@ -0,0 +1,94 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/checker_cache.h"
+#include "ejudge/xalloc.h"
+
+#include <string.h>
+
+#define CACHE_SLOTS 4096
+
+struct cache_slot
+{
+    int used;
+    unsigned char key[32];
+    struct checker_cache_result res;
+};
+
+static struct cache_slot *slots;
+
+static struct cache_slot *
+get_slot(const unsigned char key[32])
+{
+    unsigned idx;
+
+    if (!slots) {
+        XCALLOC(slots, CACHE_SLOTS);
+    }
+    // the key is a hash already
+    memcpy(&idx, key, sizeof(idx));
+    return &slots[idx % CACHE_SLOTS];
+}
+
+static void
+copy_result(
+        struct checker_cache_result *dst,
+        const struct checker_cache_result *src)
+{
+    *dst = *src;
+    dst->checker_token = NULL;
+    dst->output = NULL;
+    if (src->checker_token) dst->checker_token = xstrdup(src->checker_token);
+    if (src->output) {
+        dst->output = xmalloc(src->output_size + 1);
+        memcpy(dst->output, src->output, src->output_size);
+        dst->output[src->output_size] = 0;
+    }
+}
+
+int
+checker_cache_lookup(
+        const unsigned char key[32],
+        struct checker_cache_result *res)
+{
+    struct cache_slot *s = get_slot(key);
+
+    if (!s->used || memcmp(s->key, key, sizeof(s->key)) != 0) return 0;
+    copy_result(res, &s->res);
+    return 1;
+}
+
+void
+checker_cache_store(
+        const unsigned char key[32],
+        const struct checker_cache_result *res)
+{
+    if (res->output_size > CHECKER_CACHE_MAX_OUTPUT) return;
+
+    struct cache_slot *s = get_slot(key);
+    if (s->used) checker_cache_free_result(&s->res);
+    memcpy(s->key, key, sizeof(s->key));
+    copy_result(&s->res, res);
+    s->used = 1;
+}
+
+void
+checker_cache_free_result(struct checker_cache_result *res)
+{
+    xfree(res->checker_token);
+    xfree(res->output);
+    memset(res, 0, sizeof(*res));
+}
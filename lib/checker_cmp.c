@@ -0,0 +1,531 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifdef EJUDGE_CHECKER
+#include "checker_internal.h"
+#include "checker_cmp.h"
+
+#include "l10n_impl.h"
+#else
+#include "ejudge/config.h"
+#include "ejudge/checker_cmp.h"
+#include "ejudge/runlog.h"
+
+#include "ejudge/xalloc.h"
+
+#define _(x) x
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+
+int
+checker_cmp_fail(struct checker_cmp_ctx *cc, int status, const char *format, ...)
+{
+  va_list args;
+
+  cc->status = status;
+  va_start(args, format);
+  cc->error(cc, status, -1, format, args);
+  va_end(args);
+  return -1;
+}
+
+int
+checker_cmp_fail_read(struct checker_cmp_ctx *cc, int ind, const char *format, ...)
+{
+  va_list args;
+  int status = (ind == 1)?RUN_PRESENTATION_ERR:RUN_CHECK_FAILED;
+
+  cc->status = status;
+  va_start(args, format);
+  cc->error(cc, status, ind, format, args);
+  va_end(args);
+  return -1;
+}
+
+int
+checker_cmp_check_text(
+        struct checker_cmp_ctx *cc,
+        int ind,
+        const struct checker_cmp_text *t)
+{
+  if (memchr(t->data + t->pos, 0, t->size - t->pos)) {
+    return checker_cmp_fail_read(cc, ind, _("\\0 byte in file"));
+  }
+  return 0;
+}
+
+/* the same rules as in checker_read_buf_2 apply */
+int
+checker_cmp_read_token(
+        struct checker_cmp_ctx *cc,
+        int ind,
+        struct checker_cmp_text *t,
+        int eof_error_flag,
+        size_t max_len,
+        const unsigned char **p_s,
+        size_t *p_len)
+{
+  const unsigned char *p = t->data + t->pos;
+  const unsigned char *end = t->data + t->size;
+  const unsigned char *s;
+
+  while (p < end && isspace(*p)) ++p;
+  if (p == end) {
+    t->pos = t->size;
+    if (eof_error_flag) return checker_cmp_fail_read(cc, ind, _("Unexpected EOF"));
+    return 0;
+  }
+
+  s = p;
+  while (p < end && !isspace(*p)) {
+    if (max_len > 0 && (size_t) (p - s) >= max_len) {
+      return checker_cmp_fail_read(cc, ind, _("Input element is too long"));
+    }
+    if (*p < ' ') {
+      return checker_cmp_fail_read(cc, ind, _("Invalid control character %d"), *p);
+    }
+    ++p;
+  }
+  t->pos = p - t->data;
+  *p_s = s;
+  *p_len = p - s;
+  return 1;
+}
+
+int
+checker_cmp_read_int(
+        struct checker_cmp_ctx *cc,
+        int ind,
+        struct checker_cmp_text *t,
+        const char *name,
+        int eof_error_flag,
+        int base,
+        int *p_val)
+{
+  long x;
+  char sb[128], *db = 0, *vb = sb, *ep = 0;
+  const unsigned char *s = 0;
+  size_t len = 0;
+  int r;
+
+  if (!name) name = "";
+  if ((r = checker_cmp_read_token(cc, ind, t, eof_error_flag, 0, &s, &len)) <= 0)
+    return r;
+  if (len >= sizeof(sb)) {
+    vb = db = (char *) xmalloc(len + 1);
+  }
+  memcpy(vb, s, len);
+  vb[len] = 0;
+  errno = 0;
+  x = strtol(vb, &ep, base);
+  if (*ep) {
+    r = checker_cmp_fail_read(cc, ind, _("%s: cannot parse int32 value"), name);
+  } else if (errno || (int) x != x) {
+    r = checker_cmp_fail_read(cc, ind, _("%s: int32 value is out of range"), name);
+  } else {
+    *p_val = x;
+  }
+  free(db);
+  return r;
+}
+
+int
+checker_cmp_read_double(
+        struct checker_cmp_ctx *cc,
+        int ind,
+        struct checker_cmp_text *t,
+        const char *name,
+        int eof_error_flag,
+        double *p_val)
+{
+  double x;
+  char sb[128], *db = 0, *vb = sb, *ep = 0;
+  const unsigned char *s = 0;
+  size_t len = 0;
+  int r;
+
+  if (!name) name = "";
+  if ((r = checker_cmp_read_token(cc, ind, t, eof_error_flag, 0, &s, &len)) <= 0)
+    return r;
+  if (len >= sizeof(sb)) {
+    vb = db = (char *) xmalloc(len + 1);
+  }
+  memcpy(vb, s, len);
+  vb[len] = 0;
+  errno = 0;
+  x = strtod(vb, &ep);
+  if (*ep) {
+    r = checker_cmp_fail_read(cc, ind, _("%s: cannot parse double value"), name);
+  } else if (errno) {
+    r = checker_cmp_fail_read(cc, ind, _("%s: double value is out of range"), name);
+  } else {
+    *p_val = x;
+  }
+  free(db);
+  return r;
+}
+
+/* the same as checker_out_eof/checker_corr_eof */
+int
+checker_cmp_eof(struct checker_cmp_ctx *cc, int ind, struct checker_cmp_text *t)
+{
+  const unsigned char *p = t->data + t->pos;
+  const unsigned char *end = t->data + t->size;
+  int status = (ind == 1)?RUN_PRESENTATION_ERR:RUN_CHECK_FAILED;
+
+  while (p < end && isspace(*p)) ++p;
+  t->pos = p - t->data;
+  if (p < end) {
+    if (*p < ' ') {
+      return checker_cmp_fail(cc, status,
+                              _("%s: invalid control character with code %d"),
+                              cc->stream_names[ind], *p);
+    }
+    return checker_cmp_fail(cc, status, _("%s: garbage where EOF expected"),
+                            cc->stream_names[ind]);
+  }
+  return 0;
+}
+
+int
+checker_cmp_eq_double(double v1, double v2, double eps)
+{
+  double m1, m2;
+  int e1, e2, em;
+
+  if (fpclassify(v1) == FP_NAN && fpclassify(v2) == FP_NAN) return 1;
+  if (fpclassify(v1) == FP_NAN || fpclassify(v2) == FP_NAN) return 0;
+  if (fpclassify(v1) == FP_INFINITE && fpclassify(v2) == FP_INFINITE) {
+    if (signbit(v1) == signbit(v2)) return 1;
+    return 0;
+  }
+  if (fpclassify(v1) == FP_INFINITE || fpclassify(v2) == FP_INFINITE) return 0;
+  if (fabs(v1) <= 1.0 && fabs(v2) <= 1.0) {
+    if (fabs(v1 - v2) <= 1.125*eps) return 1;
+    return 0;
+  }
+  if (signbit(v1) != signbit(v2)) return 0;
+  m1 = frexp(v1, &e1);
+  m2 = frexp(v2, &e2);
+  if (abs(e1 - e2) > 1) return 0;
+  em = e1;
+  if (e2 < em) em = e2;
+  e1 -= em;
+  e2 -= em;
+  m1 = ldexp(m1, e1);
+  m2 = ldexp(m2, e2);
+  if (fabs(m1 - m2) <= 1.125*eps) return 1;
+  return 0;
+}
+
+int
+checker_cmp_eq_double_abs(double v1, double v2, double eps)
+{
+  if (fpclassify(v1) == FP_NAN && fpclassify(v2) == FP_NAN) return 1;
+  if (fpclassify(v1) == FP_NAN || fpclassify(v2) == FP_NAN) return 0;
+  if (fpclassify(v1) == FP_INFINITE && fpclassify(v2) == FP_INFINITE) {
+    if (signbit(v1) == signbit(v2)) return 1;
+    return 0;
+  }
+  if (fpclassify(v1) == FP_INFINITE || fpclassify(v2) == FP_INFINITE) return 0;
+  if (fabs(v1 - v2) <= 1.125*eps) return 1;
+  return 0;
+}
+
+struct line_iter
+{
+  const unsigned char *p;
+  const unsigned char *end;
+};
+
+/* get the next line with trailing spaces removed */
+static int
+next_line(struct line_iter *it, const unsigned char **p_s, size_t *p_len)
+{
+  const unsigned char *s = it->p, *e;
+  size_t len;
+
+  if (s >= it->end) return 0;
+  if ((e = memchr(s, '\n', it->end - s))) {
+    it->p = e + 1;
+  } else {
+    it->p = it->end;
+  }
+  len = it->p - s;
+  while (len > 0 && isspace(s[len - 1])) --len;
+  *p_s = s;
+  *p_len = len;
+  return 1;
+}
+
+/* the same as the number of lines after checker_normalize_file */
+static size_t
+count_lines(const struct checker_cmp_text *t)
+{
+  const unsigned char *p = t->data + t->pos, *q;
+  const unsigned char *end = t->data + t->size;
+  size_t count = 1;
+
+  while (end > p && isspace(end[-1])) --end;
+  if (end == p) return 0;
+  while ((q = memchr(p, '\n', end - p))) {
+    ++count;
+    p = q + 1;
+  }
+  return count;
+}
+
+/* the same as the number of lines after checker_normalize_spaces_in_file */
+static size_t
+count_nonempty_lines(const struct checker_cmp_text *t)
+{
+  struct line_iter it = { t->data + t->pos, t->data + t->size };
+  const unsigned char *s;
+  size_t len, count = 0;
+
+  while (next_line(&it, &s, &len)) {
+    if (len > 0) ++count;
+  }
+  return count;
+}
+
+/* collapse the whitespace sequences to one space and remove leading spaces */
+static size_t
+squeeze_spaces(const unsigned char *s, size_t len, unsigned char *dst)
+{
+  const unsigned char *end = s + len;
+  unsigned char *q = dst;
+
+  while (s < end && isspace(*s)) ++s;
+  while (s < end) {
+    while (s < end && !isspace(*s)) *q++ = *s++;
+    if (s < end) {
+      *q++ = ' ';
+      ++s;
+    }
+    while (s < end && isspace(*s)) ++s;
+  }
+  return q - dst;
+}
+
+static char *
+dup_line(const unsigned char *s, size_t len)
+{
+  char *r = (char *) xmalloc(len + 1);
+  memcpy(r, s, len);
+  r[len] = 0;
+  return r;
+}
+
+/*
+ * compare the files by line, the result (and the messages)
+ * are the same as for checker_read_file_by_line followed by
+ * checker_normalize_file (or checker_normalize_spaces_in_file,
+ * if nospace is set) and line-by-line strcmp (strcasecmp, if nocase is set)
+ */
+int
+checker_cmp_lines(
+        struct checker_cmp_ctx *cc,
+        const struct checker_cmp_text *out,
+        const struct checker_cmp_text *corr,
+        int nocase,
+        int nospace)
+{
+  struct line_iter out_it = { out->data + out->pos, out->data + out->size };
+  struct line_iter corr_it = { corr->data + corr->pos, corr->data + corr->size };
+  const unsigned char *out_s = 0, *corr_s = 0;
+  size_t out_len = 0, corr_len = 0;
+  size_t out_lines_num, corr_lines_num, i;
+  unsigned char *out_b = 0, *corr_b = 0;
+  size_t out_b_a = 0, corr_b_a = 0;
+  int diff, r = 0;
+
+  if (out->size - out->pos == corr->size - corr->pos
+      && !memcmp(out_it.p, corr_it.p, out->size - out->pos)) {
+    return 0;
+  }
+
+  if (nospace) {
+    out_lines_num = count_nonempty_lines(out);
+    corr_lines_num = count_nonempty_lines(corr);
+  } else {
+    out_lines_num = count_lines(out);
+    corr_lines_num = count_lines(corr);
+  }
+  if (out_lines_num != corr_lines_num) {
+    return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                            _("Different number of lines: output: %zu, correct: %zu"),
+                            out_lines_num, corr_lines_num);
+  }
+
+  for (i = 0; i < out_lines_num; ++i) {
+    next_line(&out_it, &out_s, &out_len);
+    next_line(&corr_it, &corr_s, &corr_len);
+    if (nospace) {
+      while (!out_len) next_line(&out_it, &out_s, &out_len);
+      while (!corr_len) next_line(&corr_it, &corr_s, &corr_len);
+      if (out_len > out_b_a) {
+        free(out_b);
+        out_b = (unsigned char *) xmalloc(out_b_a = out_len * 2);
+      }
+      if (corr_len > corr_b_a) {
+        free(corr_b);
+        corr_b = (unsigned char *) xmalloc(corr_b_a = corr_len * 2);
+      }
+      out_len = squeeze_spaces(out_s, out_len, out_b);
+      corr_len = squeeze_spaces(corr_s, corr_len, corr_b);
+      out_s = out_b;
+      corr_s = corr_b;
+    }
+    if (out_len != corr_len) {
+      diff = 1;
+    } else if (nocase) {
+      diff = strncasecmp((const char *) out_s, (const char *) corr_s, out_len);
+    } else {
+      diff = memcmp(out_s, corr_s, out_len);
+    }
+    if (diff) {
+      char *out_l = dup_line(out_s, out_len);
+      char *corr_l = dup_line(corr_s, corr_len);
+      r = checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                           _("Line %zu differs: output:\n>%s<\ncorrect:\n>%s<"),
+                           i + 1, out_l, corr_l);
+      free(out_l);
+      free(corr_l);
+      break;
+    }
+  }
+
+  free(out_b);
+  free(corr_b);
+  return r;
+}
+
+int
+checker_cmp_int_seq(
+        struct checker_cmp_ctx *cc,
+        struct checker_cmp_text *out,
+        struct checker_cmp_text *corr,
+        int base)
+{
+  int out_ans, corr_ans;
+  int i = 0, r;
+  char buf[32];
+
+  while (1) {
+    i++;
+    snprintf(buf, sizeof(buf), "[%d]", i);
+    if ((r = checker_cmp_read_int(cc, 2, corr, buf, 0, base, &corr_ans)) < 0) return r;
+    if (!r) break;
+    if ((r = checker_cmp_read_int(cc, 1, out, buf, 0, base, &out_ans)) < 0) return r;
+    if (!r) {
+      return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                              _("Too few numbers in the output"));
+    }
+    if (corr_ans != out_ans) {
+      return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                              _("Answers differ: %s: output: %d, correct: %d"),
+                              buf, out_ans, corr_ans);
+    }
+  }
+  if ((r = checker_cmp_read_int(cc, 1, out, "x", 0, 10, &out_ans)) < 0) return r;
+  if (r > 0) {
+    return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                            _("Too many numbers in the output"));
+  }
+  return checker_cmp_eof(cc, 1, out);
+}
+
+int
+checker_cmp_double_seq(
+        struct checker_cmp_ctx *cc,
+        struct checker_cmp_text *out,
+        struct checker_cmp_text *corr,
+        double eps,
+        int abs_flag)
+{
+  double out_ans, corr_ans;
+  int i = 0, r;
+  char buf[32];
+
+  while (1) {
+    i++;
+    snprintf(buf, sizeof(buf), "[%d]", i);
+    if ((r = checker_cmp_read_double(cc, 2, corr, buf, 0, &corr_ans)) < 0) return r;
+    if (!r) break;
+    if ((r = checker_cmp_read_double(cc, 1, out, buf, 0, &out_ans)) < 0) return r;
+    if (!r) {
+      return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                              _("Too few numbers in the output"));
+    }
+    if (!(abs_flag?checker_cmp_eq_double_abs:checker_cmp_eq_double)(out_ans, corr_ans, eps)) {
+      return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                              _("Answers differ: %s: output: %.10g, correct: %.10g"),
+                              buf, out_ans, corr_ans);
+    }
+  }
+  if ((r = checker_cmp_read_double(cc, 1, out, "x", 0, &out_ans)) < 0) return r;
+  if (r > 0) {
+    return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR,
+                            _("Too many numbers in the output"));
+  }
+  return checker_cmp_eof(cc, 1, out);
+}
+
+int
+checker_cmp_yesno(
+        struct checker_cmp_ctx *cc,
+        struct checker_cmp_text *out,
+        struct checker_cmp_text *corr,
+        int case_insensitive)
+{
+  // cmp_yesno always used 1024-byte buffers
+  char out_buf[1024], corr_buf[1024];
+  const unsigned char *s = 0;
+  size_t len = 0;
+
+  if (checker_cmp_read_token(cc, 1, out, 1, sizeof(out_buf) - 1, &s, &len) < 0)
+    return -1;
+  memcpy(out_buf, s, len);
+  out_buf[len] = 0;
+  if (checker_cmp_read_token(cc, 2, corr, 1, sizeof(corr_buf) - 1, &s, &len) < 0)
+    return -1;
+  memcpy(corr_buf, s, len);
+  corr_buf[len] = 0;
+
+  if (strcasecmp(corr_buf, "yes") && strcasecmp(corr_buf, "no")) {
+    return checker_cmp_fail(cc, RUN_CHECK_FAILED,
+                            _("Correct answer is neither `yes' nor `no' (case insensitive)"));
+  }
+  if (strcasecmp(out_buf, "yes") && strcasecmp(out_buf, "no")) {
+    return checker_cmp_fail(cc, RUN_PRESENTATION_ERR,
+                            _("User answer is neither `yes' nor `no' (case insensitive)"));
+  }
+  if (strcasecmp(out_buf, corr_buf)) {
+    return checker_cmp_fail(cc, RUN_WRONG_ANSWER_ERR, _("Answers do not match"));
+  }
+  if (!case_insensitive && strcmp(out_buf, corr_buf)) {
+    return checker_cmp_fail(cc, RUN_PRESENTATION_ERR, _("Letter case mismatch"));
+  }
+  if (checker_cmp_eof(cc, 2, corr) < 0) return -1;
+  return checker_cmp_eof(cc, 1, out);
+}
@@ -50,7 +50,7 @@ compile_reply_packet_read(
   FAIL_IF(pkt_size < 0 || pkt_size > EJ_MAX_COMPILE_PACKET_SIZE);
   FAIL_IF((pkt_size & 0xf));
   pkt_version = cvt_bin_to_host_32(pin->version);
-  FAIL_IF(pkt_version != 1);
+  FAIL_IF(pkt_version != 1 && pkt_version != 2);
   XCALLOC(pout, 1);
   pout->judge_id = cvt_bin_to_host_32(pin->judge_id);
   FAIL_IF(pout->judge_id < 0 || pout->judge_id > EJ_MAX_JUDGE_ID);
@@ -99,6 +99,12 @@ compile_reply_packet_read(
   }
 
   pkt_bin_align_addr(in_ptr, pin);
+  if (pkt_version >= 2) {
+    FAIL_IF(in_ptr + sizeof(pout->exe_sha256) > end_ptr);
+    pout->has_exe_sha256 = 1;
+    memcpy(pout->exe_sha256, in_ptr, sizeof(pout->exe_sha256));
+    in_ptr += sizeof(pout->exe_sha256);
+  }
   FAIL_IF(in_ptr != end_ptr);
 
 #if 0
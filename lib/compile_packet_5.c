@@ -52,13 +52,18 @@ compile_reply_packet_write(const struct compile_reply_packet *in_data,
 
   out_size = sizeof(*out_data);
   out_size += pkt_bin_align(in_data->run_block_len);
+  if (in_data->has_exe_sha256) {
+    // version 2: the executable hash follows the run block,
+    // ej-compile sets it only if serve declared accept_exe_sha256
+    out_size += sizeof(in_data->exe_sha256);
+  }
   FAIL_IF(out_size < 0 || out_size > EJ_MAX_COMPILE_PACKET_SIZE);
 
   out_data = xcalloc(1, out_size);
   out_ptr = (unsigned char*) out_data + sizeof(*out_data);
 
   out_data->packet_len = cvt_host_to_bin_32(out_size);
-  out_data->version = cvt_host_to_bin_32(1);
+  out_data->version = cvt_host_to_bin_32(in_data->has_exe_sha256?2:1);
   out_data->judge_id = cvt_host_to_bin_32(in_data->judge_id);
   out_data->contest_id = cvt_host_to_bin_32(in_data->contest_id);
   out_data->run_id = cvt_host_to_bin_32(in_data->run_id);
@@ -86,6 +91,10 @@ compile_reply_packet_write(const struct compile_reply_packet *in_data,
   if (in_data->run_block_len) {
     memcpy(out_ptr, in_data->run_block, in_data->run_block_len);
   }
+  if (in_data->has_exe_sha256) {
+    out_ptr += pkt_bin_align(in_data->run_block_len);
+    memcpy(out_ptr, in_data->exe_sha256, sizeof(in_data->exe_sha256));
+  }
 
   *p_out_size = (size_t) out_size;
   *p_out_data = out_data;
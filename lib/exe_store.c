@@ -0,0 +1,205 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/config.h"
+#include "ejudge/exe_store.h"
+#include "ejudge/sha256.h"
+#include "ejudge/misctext.h"
+#include "ejudge/fileutl.h"
+#include "ejudge/errlog.h"
+#include "ejudge/osdeps.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+/* the unused files are removed when they are older than this */
+#define UNUSED_FILE_AGE 3600
+/* the store is scanned for the unused files at most this often */
+#define TRIM_INTERVAL 600
+
+const unsigned char *
+exe_store_dir(void)
+{
+#if defined EJUDGE_CONTESTS_HOME_DIR
+    static int initialized;
+    static unsigned char *store_dir;
+    static unsigned char path[PATH_MAX];
+    struct stat stb;
+
+    if (!initialized) {
+        initialized = 1;
+        snprintf(path, sizeof(path), "%s/var/exe-store", EJUDGE_CONTESTS_HOME_DIR);
+        if (stat(path, &stb) >= 0 && S_ISDIR(stb.st_mode)) {
+            store_dir = path;
+        }
+    }
+    return store_dir;
+#else
+    return NULL;
+#endif
+}
+
+static int
+hash_file(const unsigned char *path, unsigned char hash[32])
+{
+    SHA256_CTX ctx;
+    unsigned char buf[65536];
+    int fd;
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0)) < 0) {
+        err("exe_store: cannot open '%s': %s", path, os_ErrorMsg());
+        return -1;
+    }
+    sha256_init(&ctx);
+    while (1) {
+        ssize_t r = read(fd, buf, sizeof(buf));
+        if (r < 0) {
+            err("exe_store: read error on '%s': %s", path, os_ErrorMsg());
+            close(fd);
+            return -1;
+        }
+        if (!r) break;
+        sha256_update(&ctx, buf, r);
+    }
+    close(fd);
+    sha256_final(&ctx, hash);
+    return 0;
+}
+
+static void
+trim_store(const unsigned char *store_dir)
+{
+    unsigned char path[PATH_MAX];
+    struct stat stb;
+    DIR *d;
+    struct dirent *dd;
+    time_t now = time(NULL);
+
+    snprintf(path, sizeof(path), "%s/.trim", store_dir);
+    if (stat(path, &stb) >= 0 && stb.st_mtime + TRIM_INTERVAL > now) return;
+    // only one process scans the store at a time
+    generic_write_file("", 0, 0, NULL, path, "");
+
+    if (!(d = opendir(store_dir))) return;
+    while ((dd = readdir(d))) {
+        if (dd->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", store_dir, dd->d_name);
+        if (lstat(path, &stb) < 0 || !S_ISREG(stb.st_mode)) continue;
+        // the file is linked only from the store
+        if (stb.st_nlink == 1 && stb.st_mtime + UNUSED_FILE_AGE < now) {
+            unlink(path);
+        }
+    }
+    closedir(d);
+}
+
+int
+exe_store_put(
+        const unsigned char *store_dir,
+        const unsigned char *src_path,
+        unsigned char hash[32])
+{
+    unsigned char path[PATH_MAX];
+    unsigned char tmp_path[PATH_MAX];
+    struct stat stb;
+
+    if (hash_file(src_path, hash) < 0) return -1;
+    if (snprintf(path, sizeof(path), "%s/%s", store_dir, unparse_sha256(hash)) >= sizeof(path)) {
+        return -1;
+    }
+    if (lstat(path, &stb) >= 0 && S_ISREG(stb.st_mode)) {
+        // the same executable is stored already
+        utimes(path, NULL);
+        return 0;
+    }
+    if (link(src_path, path) < 0) {
+        if (errno == EEXIST) return 0;
+        if (errno != EXDEV) {
+            err("exe_store: link '%s' -> '%s' failed: %s", src_path, path, os_ErrorMsg());
+            return -1;
+        }
+        snprintf(tmp_path, sizeof(tmp_path), "%s/.tmp.%d", store_dir, (int) getpid());
+        if (fast_copy_file(src_path, tmp_path) < 0) {
+            unlink(tmp_path);
+            return -1;
+        }
+        if (rename(tmp_path, path) < 0) {
+            err("exe_store: rename '%s' failed: %s", tmp_path, os_ErrorMsg());
+            unlink(tmp_path);
+            return -1;
+        }
+    }
+    // the stored file is shared by all the links, it must not be modified in place
+    chmod(path, 0555);
+    trim_store(store_dir);
+    return 0;
+}
+
+int
+exe_store_get(
+        const unsigned char *store_dir,
+        const unsigned char hash[32],
+        const unsigned char *dst_path)
+{
+    unsigned char path[PATH_MAX];
+
+    if (snprintf(path, sizeof(path), "%s/%s", store_dir, unparse_sha256(hash)) >= sizeof(path)) {
+        return -1;
+    }
+    unlink(dst_path);
+    if (link(path, dst_path) >= 0) {
+        // the file might be removed as unused right now
+        if (access(path, F_OK) < 0) {
+            unlink(dst_path);
+            return -1;
+        }
+        return 0;
+    }
+    if (errno == ENOENT) return -1;
+    if (errno != EXDEV) {
+        err("exe_store: link '%s' -> '%s' failed: %s", path, dst_path, os_ErrorMsg());
+        return -1;
+    }
+    if (fast_copy_file(path, dst_path) < 0) {
+        unlink(dst_path);
+        return -1;
+    }
+    return 0;
+}
+
+int
+exe_store_parse_hash(const unsigned char *str, unsigned char hash[32])
+{
+    if (!str || strlen(str) != 64) return -1;
+    for (int i = 0; i < 32; ++i) {
+        int hi = str[i * 2], lo = str[i * 2 + 1];
+        if (!isxdigit(hi) || !isxdigit(lo)) return -1;
+        hi = isdigit(hi) ? hi - '0' : (hi | 0x20) - 'a' + 10;
+        lo = isdigit(lo) ? lo - '0' : (lo | 0x20) - 'a' + 10;
+        hash[i] = (hi << 4) | lo;
+    }
+    return 0;
+}
@@ -1229,6 +1229,24 @@ lang_config_generate_compile_cfg(
     if ((s = shellconfig_get(p->cfg, "clean_up_cmd"))) {
       fprintf(f, "clean_up_cmd = \"%s\"\n", s);
     }
+    if ((s = shellconfig_get(p->cfg, "compile_concurrency"))) {
+      fprintf(f, "compile_concurrency = %d\n", atoi(s));
+    }
+    if ((s = shellconfig_get(p->cfg, "compile_weight"))) {
+      fprintf(f, "compile_weight = %d\n", atoi(s));
+    }
+    if ((s = shellconfig_get(p->cfg, "compile_daemon_cmd"))) {
+      fprintf(f, "compile_daemon_cmd = \"%s\"\n", s);
+    }
+    if ((s = shellconfig_get(p->cfg, "compile_pch_headers"))) {
+      fprintf(f, "compile_pch_headers = \"%s\"\n", s);
+    }
+    if ((s = shellconfig_get(p->cfg, "compile_daemon_max_jobs"))) {
+      fprintf(f, "compile_daemon_max_jobs = %d\n", atoi(s));
+    }
+    if ((s = shellconfig_get(p->cfg, "compile_daemon_max_rss"))) {
+      fprintf(f, "compile_daemon_max_rss = %s\n", s);
+    }
     fprintf(f, "\n");
   }
 
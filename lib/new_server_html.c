@@ -74,6 +74,7 @@
 #include "ejudge/userprob_plugin.h"
 #include "ejudge/job_packet.h"
 #include "ejudge/sha256utils.h"
+#include "ejudge/super_run_progress.h"
 #include "ejudge/metrics_contest.h"
 #include "ejudge/session_cache.h"
 #include "ejudge/tsc.h"
@@ -3787,7 +3788,7 @@ priv_submit_run(
   int store_flags = 0;
   if (global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
     store_flags = STORE_FLAGS_UUID;
-    if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+    if (testing_report_bson_available() || global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
   }
   run_id = run_add_record(cs->runlog_state,
                           &precise_time,
@@ -5789,7 +5790,7 @@ priv_new_run(FILE *fout,
   int store_flags = 0;
   if (global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
     store_flags = STORE_FLAGS_UUID;
-    if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+    if (testing_report_bson_available() || global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
   }
   run_id = run_add_record(cs->runlog_state,
                           &precise_time,
@@ -8560,6 +8561,17 @@ priv_run_status_json(
   if (re.test >= 0) {
     fprintf(fout, ",\"raw_test\":%d", re.test);
   }
+  if (re.status == RUN_RUNNING) {
+    struct super_run_progress_info srpi;
+    if (ns_find_run_progress(cs, &re, &srpi)) {
+      fprintf(fout, ",\"testing_progress\":{\"test_num\":%d", srpi.test_num);
+      if (srpi.test_count > 0) {
+        fprintf(fout, ",\"test_count\":%d", srpi.test_count);
+      }
+      fprintf(fout, ",\"cpu_ms\":%lld", srpi.cpu_ms);
+      fprintf(fout, ",\"update_time_ms\":%lld}", srpi.update_ms);
+    }
+  }
   if (re.is_marked) {
     fprintf(fout, ",\"is_marked\":%s", to_json_bool(re.is_marked));
   }
@@ -11680,7 +11692,7 @@ ns_submit_run(
   }
   if (global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
     store_flags = STORE_FLAGS_UUID;
-    if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+    if (testing_report_bson_available() || global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
   }
   run_id = run_add_record(cs->runlog_state,
                           &precise_time,
@@ -12421,7 +12433,7 @@ unpriv_submit_run(
   int store_flags = 0;
   if (global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
     store_flags = STORE_FLAGS_UUID;
-    if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+    if (testing_report_bson_available() || global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
   }
   int is_hidden = 0;
   if (cs->upsolving_mode) {
@@ -14863,7 +14875,7 @@ unpriv_xml_update_answer(
   if (run_id < 0) {
     if (global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
       store_flags = STORE_FLAGS_UUID;
-      if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+      if (testing_report_bson_available() || global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
     }
     run_id = run_add_record(cs->runlog_state,
                             &precise_time,
@@ -16018,8 +16030,6 @@ unpriv_run_test_json(
   struct html_armor_buffer ab = HTML_ARMOR_INITIALIZER;
   const struct section_problem_data *prob = NULL;
   phr->json_reply = 1;
-  char *rep_txt = NULL;
-  size_t rep_len = 0;
   testing_report_xml_t tr = NULL;
 
   time_t start_time = 0;
@@ -16104,32 +16114,17 @@ unpriv_run_test_json(
     error_page(fout, phr, 0, NEW_SRV_ERR_REPORT_NONEXISTANT);
     goto cleanup;
   }
-  if (re.store_flags == STORE_FLAGS_UUID_BSON) {
-    if (!(tr = testing_report_parse_bson_file(rep_path))) {
-      error_page(fout, phr, 0, NEW_SRV_ERR_REPORT_NONEXISTANT);
-      goto cleanup;
-    }
-  } else {
-    if (generic_read_file(&rep_txt, 0, &rep_len, flags, 0, rep_path, 0) < 0) {
-      error_page(fout, phr, 0, NEW_SRV_ERR_REPORT_NONEXISTANT);
-      goto cleanup;
-    }
-    const unsigned char *start_ptr = NULL;
-    if (get_content_type(rep_txt, &start_ptr) != CONTENT_TYPE_XML) {
-      error_page(fout, phr, 0, NEW_SRV_ERR_REPORT_NONEXISTANT);
-      goto cleanup;
-    }
-    if (!(tr = testing_report_parse_xml(start_ptr))) {
-      error_page(fout, phr, 0, NEW_SRV_ERR_REPORT_NONEXISTANT);
-      goto cleanup;
-    }
+  // only the requested test is decoded from the binary report
+  if (!(tr = testing_report_parse_file(rep_path, re.store_flags, flags, num))) {
+    error_page(fout, phr, 0, NEW_SRV_ERR_REPORT_NONEXISTANT);
+    goto cleanup;
   }
   if (num <= 0 || num > tr->run_tests) {
     error_page(fout, phr, 0, NEW_SRV_ERR_TEST_NONEXISTANT);
     goto cleanup;
   }
   struct testing_report_test *t = tr->tests[num - 1];
-  if (t->num != num) {
+  if (!t || t->num != num) {
     error_page(fout, phr, 0, NEW_SRV_ERR_TEST_NONEXISTANT);
     goto cleanup;
   }
@@ -16221,7 +16216,6 @@ unpriv_run_test_json(
 cleanup:
   html_armor_free(&ab);
   testing_report_free(tr);
-  free(rep_txt);
 }
 
 static cJSON *
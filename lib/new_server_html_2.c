@@ -51,6 +51,7 @@
 #include "ejudge/new_server_pi.h"
 #include "ejudge/xuser_plugin.h"
 #include "ejudge/super_run_status.h"
+#include "ejudge/super_run_progress.h"
 #include "ejudge/compile_heartbeat.h"
 #include "ejudge/mixed_id.h"
 #include "ejudge/userprob_plugin.h"
@@ -2518,9 +2519,6 @@ ns_write_tests(
 {
   int rep_flag;
   path_t rep_path;
-  char *rep_text = 0;
-  size_t rep_len = 0;
-  const unsigned char *start_ptr = 0;
   testing_report_xml_t r = 0;
   struct run_entry re;
   const struct section_problem_data *prb = 0;
@@ -2537,29 +2535,18 @@ ns_write_tests(
     FAIL(NEW_SRV_ERR_REPORT_NONEXISTANT);
   }
 
-  if (re.store_flags == STORE_FLAGS_UUID_BSON) {
-    if (!(r = testing_report_parse_bson_file(rep_path))) {
-      FAIL(NEW_SRV_ERR_REPORT_UNAVAILABLE);
-    }
-  } else {
-    if (generic_read_file(&rep_text, 0, &rep_len, rep_flag,0,rep_path, "") < 0) {
-      FAIL(NEW_SRV_ERR_DISK_READ_ERROR);
-    }
-    if (get_content_type(rep_text, &start_ptr) != CONTENT_TYPE_XML) {
-      // we expect the master log in XML format
-      FAIL(NEW_SRV_ERR_REPORT_UNAVAILABLE);
-    }
-    if (!(r = testing_report_parse_xml(start_ptr))) {
-      FAIL(NEW_SRV_ERR_REPORT_UNAVAILABLE);
-    }
+  // only the requested test is decoded from the binary report
+  if (!(r = testing_report_parse_file(rep_path, re.store_flags, rep_flag, test_num))) {
+    FAIL(NEW_SRV_ERR_REPORT_UNAVAILABLE);
   }
-  xfree(rep_text); rep_text = 0;
 
   if (test_num <= 0 || test_num > r->run_tests) {
     FAIL(NEW_SRV_ERR_INV_TEST);
   }
 
-  t = r->tests[test_num - 1];
+  if (!(t = r->tests[test_num - 1])) {
+    FAIL(NEW_SRV_ERR_INV_TEST);
+  }
 
   if (re.prob_id <= 0 || re.prob_id > cs->max_prob
       || !(prb = cs->probs[re.prob_id])) {
@@ -2625,7 +2612,6 @@ ns_write_tests(
 
 cleanup:
 done:
-  xfree(rep_text);
   testing_report_free(r);
   return retval;
 }
@@ -3511,7 +3497,7 @@ do_add_row(
   int store_flags = 0;
   if (cs->global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
     store_flags = STORE_FLAGS_UUID;
-    if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+    if (testing_report_bson_available() || cs->global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
   }
   run_id = run_add_record(cs->runlog_state,
                           &precise_time,
@@ -6503,6 +6489,23 @@ ns_scan_heartbeat_dirs(
   qsort(vec->v, vec->u, sizeof(vec->v[0]), heartbeat_status_sort_func);
 }
 
+int
+ns_find_run_progress(
+        const serve_state_t cs,
+        const struct run_entry *pre,
+        struct super_run_progress_info *info)
+{
+  for (int i = 0; i < cs->run_queues_u; ++i) {
+    if (!cs->run_queues[i].heartbeat_dir) continue;
+    struct super_run_progress *srp = super_run_progress_open(cs->run_queues[i].heartbeat_dir, 0);
+    if (!srp) continue;
+    int r = super_run_progress_find(srp, &pre->run_uuid, cs->contest_id, pre->run_id, info);
+    super_run_progress_close(srp);
+    if (r > 0) return 1;
+  }
+  return 0;
+}
+
 void
 collect_run_status(
         const serve_state_t cs,
@@ -8900,6 +8903,14 @@ write_xml_testing_report(
       }
       fprintf(f, "\n");
     }
+    if (t->time_samples) {
+      fprintf(f, "<u>--- Time measurements ---</u>\n%s\n\n", t->time_samples);
+    }
+    if (t->checker_cached == TESTING_REPORT_CHECKER_CACHED) {
+      fprintf(f, "<u>--- Checker ---</u>\nthe verdict is taken from the cache\n\n");
+    } else if (t->checker_cached == TESTING_REPORT_CHECKER_EXACT_MATCH) {
+      fprintf(f, "<u>--- Checker ---</u>\nnot run, the output is equal to the answer\n\n");
+    }
   }
   fprintf(f, "</pre>");
 
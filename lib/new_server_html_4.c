@@ -1109,7 +1109,7 @@ cmd_submit_run(
   int store_flags = 0;
   if (global->uuid_run_store > 0 && run_get_uuid_hash_state(cs->runlog_state) >= 0) {
     store_flags = STORE_FLAGS_UUID;
-    if (testing_report_bson_available()) store_flags = STORE_FLAGS_UUID_BSON;
+    if (testing_report_bson_available() || global->enable_flatbuf_report > 0) store_flags = STORE_FLAGS_UUID_BSON;
   }
   run_id = run_add_record(cs->runlog_state,
                           &precise_time,
@@ -93,6 +93,7 @@ static const struct config_parse_info section_global_params[] =
   GLOBAL_PARAM(disable_submit_after_ok, "d"),
   GLOBAL_PARAM(max_file_length, "d"),
   GLOBAL_PARAM(max_line_length, "d"),
+  GLOBAL_PARAM(max_file_tail_length, "d"),
   GLOBAL_PARAM(tests_to_accept, "d"),
   GLOBAL_PARAM(ignore_compile_errors, "d"),
   GLOBAL_PARAM(disable_failed_test_view, "d"),
@@ -316,7 +317,11 @@ static const struct config_parse_info section_global_params[] =
   GLOBAL_PARAM(html_report, "d"),
   GLOBAL_PARAM(xml_report, "d"),
   GLOBAL_PARAM(enable_full_archive, "d"),
+  GLOBAL_PARAM(enable_flatbuf_report, "d"),
   GLOBAL_PARAM(cpu_bogomips, "d"),
+  GLOBAL_PARAM(enable_perf_counters, "d"),
+  GLOBAL_PARAM(perf_instructions_per_ms, "d"),
+  GLOBAL_PARAM(full_archive_threads, "d"),
   GLOBAL_PARAM(skip_full_testing, "d"),
   GLOBAL_PARAM(skip_accept_testing, "d"),
   GLOBAL_PARAM(enable_problem_history, "d"),
@@ -487,6 +492,14 @@ static const struct config_parse_info section_problem_params[] =
   PROBLEM_PARAM(max_file_size, "E"),
   PROBLEM_PARAM(max_open_file_count, "d"),
   PROBLEM_PARAM(max_process_count, "d"),
+  PROBLEM_PARAM(probe_test_count, "d"),
+  PROBLEM_PARAM(tl_remeasure_count, "d"),
+  PROBLEM_PARAM(tl_remeasure_margin, "d"),
+  PROBLEM_PARAM(tl_remeasure_median, "d"),
+  PROBLEM_PARAM(enable_checker_cache, "d"),
+  PROBLEM_PARAM(checker_exact_match_ok, "d"),
+  PROBLEM_PARAM(test_generator_ignores_source, "d"),
+  PROBLEM_PARAM(checker_ignores_source, "d"),
   PROBLEM_PARAM_2(type, do_problem_parse_type),
   PROBLEM_PARAM(interactor_time_limit, "d"),
   PROBLEM_PARAM(interactor_real_time_limit, "d"),
@@ -618,6 +631,8 @@ static const struct config_parse_info section_language_params[] =
   LANGUAGE_PARAM(cmd, "S"),
   LANGUAGE_PARAM(content_type, "S"),
   LANGUAGE_PARAM(style_checker_cmd, "S"),
+  LANGUAGE_PARAM(compile_daemon_cmd, "S"),
+  LANGUAGE_PARAM(compile_pch_headers, "S"),
   LANGUAGE_PARAM(style_checker_env, "x"),
 
   LANGUAGE_PARAM(disable_auto_testing, "d"),
@@ -632,10 +647,14 @@ static const struct config_parse_info section_language_params[] =
   LANGUAGE_PARAM(run_max_stack_size, "E"),
   LANGUAGE_PARAM(run_max_vm_size, "E"),
   LANGUAGE_PARAM(run_max_rss_size, "E"),
+  LANGUAGE_PARAM(compile_daemon_max_rss, "E"),
 
   LANGUAGE_PARAM(compile_dir, "S"),
   LANGUAGE_PARAM(compile_dir_index, "d"),
   LANGUAGE_PARAM(compile_real_time_limit, "d"),
+  LANGUAGE_PARAM(compile_concurrency, "d"),
+  LANGUAGE_PARAM(compile_weight, "d"),
+  LANGUAGE_PARAM(compile_daemon_max_jobs, "d"),
   LANGUAGE_PARAM(compiler_env, "x"),
   LANGUAGE_PARAM(extid, "S"),
   LANGUAGE_PARAM(super_run_dir, "S"),
@@ -1277,6 +1296,8 @@ prepare_language_free_func(struct generic_section_config *gp)
   xfree(p->super_run_dir);
   xfree(p->cmd);
   xfree(p->style_checker_cmd);
+  xfree(p->compile_daemon_cmd);
+  xfree(p->compile_pch_headers);
   xfree(p->compile_dir);
   xfree(p->compile_queue_dir);
   xfree(p->compile_src_dir);
@@ -1409,6 +1430,14 @@ prepare_problem_init_func(struct generic_section_config *gp)
   p->max_file_size = -1LL;
   p->max_open_file_count = -1;
   p->max_process_count = -1;
+  p->probe_test_count = -1;
+  p->tl_remeasure_count = -1;
+  p->tl_remeasure_margin = -1;
+  p->tl_remeasure_median = -1;
+  p->enable_checker_cache = -1;
+  p->checker_exact_match_ok = -1;
+  p->test_generator_ignores_source = -1;
+  p->checker_ignores_source = -1;
   p->interactor_time_limit = -1;
   p->interactor_real_time_limit = -1;
   p->max_user_run_count = -1;
@@ -3605,6 +3634,19 @@ set_defaults(
       param_subst_2(&lang->cmd, subst_src, subst_dst);
 
       vinfo("language.%d.cmd is %s", i, lang->cmd);
+      if (lang->compile_daemon_cmd && lang->compile_daemon_cmd[0]) {
+        if (!os_IsAbsolutePath(lang->compile_daemon_cmd) && config && config->compile_home_dir) {
+          usprintf(&lang->compile_daemon_cmd, "%s/scripts/%s", config->compile_home_dir, lang->compile_daemon_cmd);
+        }
+        if (!os_IsAbsolutePath(lang->compile_daemon_cmd) && config && config->contests_home_dir) {
+          usprintf(&lang->compile_daemon_cmd, "%s/compile/scripts/%s", config->contests_home_dir, lang->compile_daemon_cmd);
+        }
+#if defined EJUDGE_CONTESTS_HOME_DIR
+        if (!os_IsAbsolutePath(lang->compile_daemon_cmd)) {
+          usprintf(&lang->compile_daemon_cmd, "%s/compile/scripts/%s", EJUDGE_CONTESTS_HOME_DIR, lang->compile_daemon_cmd);
+        }
+#endif /* EJUDGE_CONTESTS_HOME_DIR */
+      }
       if (lang->compile_real_time_limit == -1) {
         lang->compile_real_time_limit = g->compile_real_time_limit;
         vinfo("language.%d.compile_real_time_limit is inherited from global (%d)", i, lang->compile_real_time_limit);
@@ -3866,6 +3908,14 @@ set_defaults(
     prepare_set_prob_value(CNTSPROB_max_file_size, prob, aprob, g);
     prepare_set_prob_value(CNTSPROB_max_open_file_count, prob, aprob, g);
     prepare_set_prob_value(CNTSPROB_max_process_count, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_probe_test_count, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_tl_remeasure_count, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_tl_remeasure_margin, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_tl_remeasure_median, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_enable_checker_cache, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_checker_exact_match_ok, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_test_generator_ignores_source, prob, aprob, g);
+    prepare_set_prob_value(CNTSPROB_checker_ignores_source, prob, aprob, g);
     prepare_set_prob_value(CNTSPROB_checker_max_vm_size, prob, aprob, g);
     prepare_set_prob_value(CNTSPROB_checker_max_stack_size, prob, aprob, g);
     prepare_set_prob_value(CNTSPROB_checker_max_rss_size, prob, aprob, g);
@@ -6319,6 +6369,14 @@ prepare_copy_problem(const struct section_problem_data *in)
   out->max_file_size = in->max_file_size;
   out->max_open_file_count = in->max_open_file_count;
   out->max_process_count = in->max_process_count;
+  out->probe_test_count = in->probe_test_count;
+  out->tl_remeasure_count = in->tl_remeasure_count;
+  out->tl_remeasure_margin = in->tl_remeasure_margin;
+  out->tl_remeasure_median = in->tl_remeasure_median;
+  out->enable_checker_cache = in->enable_checker_cache;
+  out->checker_exact_match_ok = in->checker_exact_match_ok;
+  out->test_generator_ignores_source = in->test_generator_ignores_source;
+  out->checker_ignores_source = in->checker_ignores_source;
   out->checker_max_vm_size = in->checker_max_vm_size;
   out->checker_max_stack_size = in->checker_max_stack_size;
   out->checker_max_rss_size = in->checker_max_rss_size;
@@ -6596,6 +6654,36 @@ prepare_set_prob_value(
     if (out->max_process_count < 0 && abstr) out->max_process_count = abstr->max_process_count;
     break;
 
+  case CNTSPROB_probe_test_count:
+    if (out->probe_test_count < 0 && abstr) out->probe_test_count = abstr->probe_test_count;
+    break;
+
+  case CNTSPROB_tl_remeasure_count:
+    if (out->tl_remeasure_count < 0 && abstr) out->tl_remeasure_count = abstr->tl_remeasure_count;
+    break;
+
+  case CNTSPROB_tl_remeasure_margin:
+    if (out->tl_remeasure_margin < 0 && abstr) out->tl_remeasure_margin = abstr->tl_remeasure_margin;
+    break;
+
+  case CNTSPROB_tl_remeasure_median:
+    if (out->tl_remeasure_median < 0 && abstr) out->tl_remeasure_median = abstr->tl_remeasure_median;
+    break;
+
+  case CNTSPROB_enable_checker_cache:
+    if (out->enable_checker_cache < 0 && abstr) out->enable_checker_cache = abstr->enable_checker_cache;
+    break;
+
+  case CNTSPROB_checker_exact_match_ok:
+    if (out->checker_exact_match_ok < 0 && abstr) out->checker_exact_match_ok = abstr->checker_exact_match_ok;
+    break;
+  case CNTSPROB_test_generator_ignores_source:
+    if (out->test_generator_ignores_source < 0 && abstr) out->test_generator_ignores_source = abstr->test_generator_ignores_source;
+    break;
+  case CNTSPROB_checker_ignores_source:
+    if (out->checker_ignores_source < 0 && abstr) out->checker_ignores_source = abstr->checker_ignores_source;
+    break;
+
   case CNTSPROB_checker_max_vm_size:
     if (out->checker_max_vm_size < 0 && abstr) out->checker_max_vm_size = abstr->checker_max_vm_size;
     break;
@@ -7229,6 +7317,14 @@ prepare_set_all_prob_values(
     CNTSPROB_max_file_size,
     CNTSPROB_max_open_file_count,
     CNTSPROB_max_process_count,
+    CNTSPROB_probe_test_count,
+    CNTSPROB_tl_remeasure_count,
+    CNTSPROB_tl_remeasure_margin,
+    CNTSPROB_tl_remeasure_median,
+    CNTSPROB_enable_checker_cache,
+    CNTSPROB_checker_exact_match_ok,
+    CNTSPROB_test_generator_ignores_source,
+    CNTSPROB_checker_ignores_source,
     CNTSPROB_checker_max_vm_size,
     CNTSPROB_checker_max_stack_size,
     CNTSPROB_checker_max_rss_size,
@@ -254,6 +254,8 @@ prepare_unparse_global(
     unparse_bool(f, "prune_empty_users", global->prune_empty_users);
   if (global->enable_full_archive != DFLT_G_ENABLE_FULL_ARCHIVE)
     unparse_bool(f, "enable_full_archive", global->enable_full_archive);
+  if (global->enable_flatbuf_report > 0)
+    unparse_bool(f, "enable_flatbuf_report", global->enable_flatbuf_report);
   if (global->enable_problem_history)
     unparse_bool(f, "enable_problem_history", global->enable_problem_history);
   if (global->always_show_problems != DFLT_G_ALWAYS_SHOW_PROBLEMS)
@@ -489,6 +491,9 @@ prepare_unparse_global(
   if (global->max_line_length && global->max_line_length != DFLT_G_MAX_LINE_LENGTH)
     fprintf(f, "max_line_length = %s\n",
             num_to_size_str(nbuf, sizeof(nbuf), global->max_line_length));
+  if (global->max_file_tail_length > 0)
+    fprintf(f, "max_file_tail_length = %s\n",
+            num_to_size_str(nbuf, sizeof(nbuf), global->max_file_tail_length));
   if (global->disable_auto_testing != DFLT_G_DISABLE_AUTO_TESTING)
     unparse_bool(f, "disable_auto_testing", global->disable_auto_testing);
   if (global->disable_testing != DFLT_G_DISABLE_TESTING)
@@ -541,6 +546,12 @@ prepare_unparse_global(
     fprintf(f, "team_download_time = %d\n", global->team_download_time);
   if (global->cpu_bogomips > 0)
     fprintf(f, "cpu_bogomips = %d\n", global->cpu_bogomips);
+  if (global->enable_perf_counters > 0)
+    unparse_bool(f, "enable_perf_counters", global->enable_perf_counters);
+  if (global->perf_instructions_per_ms > 0)
+    fprintf(f, "perf_instructions_per_ms = %d\n", global->perf_instructions_per_ms);
+  if (global->full_archive_threads > 0)
+    fprintf(f, "full_archive_threads = %d\n", global->full_archive_threads);
   if (global->variant_map_file && need_variant_map)
     fprintf(f, "variant_map_file = \"%s\"\n", CARMOR(global->variant_map_file));
   if (global->clardb_plugin && global->clardb_plugin[0] && strcmp(global->clardb_plugin, "file"))
@@ -925,6 +936,18 @@ prepare_unparse_lang(
     unparse_bool(f, "enable_ejudge_env", lang->enable_ejudge_env);
   if (lang->preserve_line_numbers > 0)
     unparse_bool(f, "preserve_line_numbers", lang->preserve_line_numbers);
+  if (lang->compile_concurrency > 0)
+    fprintf(f, "compile_concurrency = %d\n", lang->compile_concurrency);
+  if (lang->compile_weight > 0)
+    fprintf(f, "compile_weight = %d\n", lang->compile_weight);
+  if (lang->compile_daemon_cmd && lang->compile_daemon_cmd[0])
+    fprintf(f, "compile_daemon_cmd = \"%s\"\n", CARMOR(lang->compile_daemon_cmd));
+  if (lang->compile_pch_headers && lang->compile_pch_headers[0])
+    fprintf(f, "compile_pch_headers = \"%s\"\n", CARMOR(lang->compile_pch_headers));
+  if (lang->compile_daemon_max_jobs > 0)
+    fprintf(f, "compile_daemon_max_jobs = %d\n", lang->compile_daemon_max_jobs);
+  if (lang->compile_daemon_max_rss > 0)
+    fprintf(f, "compile_daemon_max_rss = %s\n", ll_to_size_str(size_buf, sizeof(size_buf), lang->compile_daemon_max_rss));
   if (lang->content_type && lang->content_type[0]) {
     fprintf(f, "content_type = \"%s\"\n", CARMOR(lang->content_type));
   }
@@ -1361,6 +1384,30 @@ prepare_unparse_prob(
   if (prob->max_process_count >= 0) {
     fprintf(f, "max_process_count = %d\n", prob->max_process_count);
   }
+  if (prob->probe_test_count >= 0) {
+    fprintf(f, "probe_test_count = %d\n", prob->probe_test_count);
+  }
+  if (prob->tl_remeasure_count >= 0) {
+    fprintf(f, "tl_remeasure_count = %d\n", prob->tl_remeasure_count);
+  }
+  if (prob->tl_remeasure_margin >= 0) {
+    fprintf(f, "tl_remeasure_margin = %d\n", prob->tl_remeasure_margin);
+  }
+  if (prob->tl_remeasure_median >= 0) {
+    fprintf(f, "tl_remeasure_median = %d\n", prob->tl_remeasure_median);
+  }
+  if (prob->enable_checker_cache >= 0) {
+    fprintf(f, "enable_checker_cache = %d\n", prob->enable_checker_cache);
+  }
+  if (prob->checker_exact_match_ok >= 0) {
+    fprintf(f, "checker_exact_match_ok = %d\n", prob->checker_exact_match_ok);
+  }
+  if (prob->test_generator_ignores_source >= 0) {
+    fprintf(f, "test_generator_ignores_source = %d\n", prob->test_generator_ignores_source);
+  }
+  if (prob->checker_ignores_source >= 0) {
+    fprintf(f, "checker_ignores_source = %d\n", prob->checker_ignores_source);
+  }
   if (prob->umask && prob->umask[0])
     fprintf(f, "umask = \"%s\"\n", CARMOR(prob->umask));
 
@@ -1883,6 +1930,30 @@ prepare_unparse_actual_prob(
   if (prob->max_process_count > 0) {
     fprintf(f, "max_process_count = %d\n", prob->max_process_count);
   }
+  if (prob->probe_test_count > 0) {
+    fprintf(f, "probe_test_count = %d\n", prob->probe_test_count);
+  }
+  if (prob->tl_remeasure_count > 0) {
+    fprintf(f, "tl_remeasure_count = %d\n", prob->tl_remeasure_count);
+  }
+  if (prob->tl_remeasure_margin > 0) {
+    fprintf(f, "tl_remeasure_margin = %d\n", prob->tl_remeasure_margin);
+  }
+  if (prob->tl_remeasure_median > 0) {
+    fprintf(f, "tl_remeasure_median = %d\n", prob->tl_remeasure_median);
+  }
+  if (prob->enable_checker_cache > 0) {
+    fprintf(f, "enable_checker_cache = %d\n", prob->enable_checker_cache);
+  }
+  if (prob->checker_exact_match_ok > 0) {
+    fprintf(f, "checker_exact_match_ok = %d\n", prob->checker_exact_match_ok);
+  }
+  if (prob->test_generator_ignores_source > 0) {
+    fprintf(f, "test_generator_ignores_source = %d\n", prob->test_generator_ignores_source);
+  }
+  if (prob->checker_ignores_source > 0) {
+    fprintf(f, "checker_ignores_source = %d\n", prob->checker_ignores_source);
+  }
   if (prob->umask && prob->umask[0])
     fprintf(f, "umask = \"%s\"\n", CARMOR(prob->umask));
 
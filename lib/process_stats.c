@@ -76,6 +76,18 @@ process_stats_serialize(FILE *fout, const struct ej_process_stats *ps)
         fprintf(fout, "%scgstimeus=%lld", sep, ps->cgroup_stime_us);
         sep = sep2;
     }
+    if (ps->cgroup_memory_peak > 0) {
+        fprintf(fout, "%scgmempeak=%lld", sep, ps->cgroup_memory_peak);
+        sep = sep2;
+    }
+    if (ps->perf_task_clock_us > 0) {
+        fprintf(fout, "%spftimeus=%lld", sep, ps->perf_task_clock_us);
+        sep = sep2;
+    }
+    if (ps->perf_instructions > 0) {
+        fprintf(fout, "%spfinstr=%lld", sep, ps->perf_instructions);
+        sep = sep2;
+    }
     fprintf(fout, " }");
 }
 
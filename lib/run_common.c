@@ -41,6 +41,12 @@
 #include "ejudge/ej_libzip.h"
 #include "ejudge/agent_client.h"
 #include "ejudge/random.h"
+#include "ejudge/builtin_checker.h"
+#include "ejudge/sha256.h"
+#include "ejudge/test_manifest.h"
+#include "ejudge/test_gen_cache.h"
+#include "ejudge/checker_cache.h"
+#include "ejudge/dyntrie.h"
 
 #include "ejudge/xalloc.h"
 #include "ejudge/osdeps.h"
@@ -63,8 +69,10 @@
 #include <signal.h>
 #include <utime.h>
 #include <sys/mman.h>
+#include <dirent.h>
 #ifndef __MINGW32__
 #include <sys/vfs.h>
+#include <sys/file.h>
 #endif
 #ifdef HAVE_TERMIOS_H
 #include <termios.h>
@@ -287,6 +295,7 @@ generate_xml_report(
         int user_max_score,
         int correct_available_flag,
         int info_available_flag,
+        int archive_available_flag,
         int report_time_limit_ms,
         int report_real_time_limit_ms,
         int has_real_time,
@@ -315,7 +324,7 @@ generate_xml_report(
   tr->submit_id = srgp->submit_id;
   tr->status = reply_pkt->status;
   tr->scoring_system = srgp->scoring_system_val;
-  tr->archive_available = (srgp->enable_full_archive > 0);
+  tr->archive_available = archive_available_flag;
   tr->correct_available = correct_available_flag;
   tr->info_available = info_available_flag;
   tr->real_time_available = has_real_time;
@@ -439,6 +448,9 @@ generate_xml_report(
       if (ti->checker_stats_str) {
         trt->checker_stats_str = xstrdup(ti->checker_stats_str);
       }
+      if (ti->time_samples) {
+        trt->time_samples = xstrdup(ti->time_samples);
+      }
       if (srgp->scoring_system_val == SCORE_OLYMPIAD && srgp->accepting_mode <= 0) {
         trt->nominal_score = ti->max_score;
         trt->score = ti->score;
@@ -487,6 +499,9 @@ generate_xml_report(
       if (ti->visibility > 0) {
         trt->visibility = ti->visibility;
       }
+      if (ti->checker_cached > 0) {
+        trt->checker_cached = ti->checker_cached;
+      }
       if (ti->user_status >= 0) {
         trt->has_user = 1;
         trt->user_status = ti->user_status;
@@ -519,7 +534,12 @@ generate_xml_report(
   tr->verdict_bits = verdict_bits;
   reply_pkt->verdict_bits = verdict_bits;
 
-  if (srgp->bson_available && testing_report_bson_available()) {
+  if (srgp->bson_available && srgp->enable_flatbuf_report > 0) {
+    if (testing_report_to_file_flatbuf(report_path, tr) < 0) {
+      err("generate_xml_report: failed to save FlatBuffers file '%s'", report_path);
+    }
+    reply_pkt->bson_flag = 1;
+  } else if (srgp->bson_available && testing_report_bson_available()) {
     if (testing_report_to_file_bson(report_path, tr) < 0) {
       err("generate_xml_report: failed to save BSON file '%s'", report_path);
     }
@@ -1513,6 +1533,35 @@ check_free_space(const unsigned char *path, long expected_space)
 #endif
 }
 
+#ifndef TMPFS_MAGIC
+#define TMPFS_MAGIC 0x01021994
+#endif
+
+/*
+ * 'path' is on the private tmpfs mounted on 'tmpfs_root',
+ * and less than a block of its 'size' bytes is left
+ */
+static int
+is_tmpfs_quota_exceeded(
+        const unsigned char *path,
+        const unsigned char *tmpfs_root,
+        long long size)
+{
+#ifdef __MINGW32__
+  return 0;
+#else
+  struct statfs sb;
+  struct stat pstb, rstb;
+
+  if (!tmpfs_root || !*tmpfs_root || size <= 0) return 0;
+  if (stat(path, &pstb) < 0 || stat(tmpfs_root, &rstb) < 0) return 0;
+  if (pstb.st_dev != rstb.st_dev) return 0;
+  if (statfs(path, &sb) < 0 || sb.f_type != TMPFS_MAGIC) return 0;
+  long long used = (long long) (sb.f_blocks - sb.f_bfree) * sb.f_bsize;
+  return used + (long long) sb.f_bsize > size;
+#endif
+}
+
 static int
 get_num_prefix(int num)
 {
@@ -1526,6 +1575,9 @@ get_num_prefix(int num)
   return '6';
 }
 
+/* mirror paths known to be up to date during the current run */
+static struct dyntrie_node *agent_mirror_fresh;
+
 static void
 agent_mirror_file(
         struct AgentClient *agent,
@@ -1551,6 +1603,13 @@ agent_mirror_file(
   unsigned char mirror_path[PATH_MAX];
   snprintf(mirror_path, sizeof(mirror_path), "%s%s%s", mirror_dir, sep, buf);
 
+  if (dyntrie_get(&agent_mirror_fresh, mirror_path)) {
+    // validated by agent_mirror_prefetch during this run
+    info("using mirrored file '%s'", mirror_path);
+    snprintf(buf, size, "%s", mirror_path);
+    return;
+  }
+
   long long fsize = -1;
   time_t mtime = 0;
   int mode = -1;
@@ -1600,6 +1659,8 @@ agent_mirror_file(
     err("mirror directory '%s' is not a directory", dirname);
     goto done;
   }
+  // the file may be a hard link to the content-addressed store
+  unlink(mirror_path);
   fd = open(mirror_path, O_RDWR | O_CLOEXEC | O_CREAT | O_TRUNC | O_NOCTTY | O_NONBLOCK | O_NOFOLLOW, 0600);
   if (fd < 0) {
     err("failed to create mirrored file '%s': %s", mirror_path, os_ErrorMsg());
@@ -1653,6 +1714,394 @@ done:;
   free(pkt_ptr);
 }
 
+/*
+ * Bulk mirroring of the tests of a problem for remote agents.
+ * The file contents are kept in the content-addressed store
+ * <mirror_dir>/.cas/XX/<SHA-256>, and the mirrored files are hard links
+ * to the store, so the same file used in different problems and contests
+ * is transferred and stored only once. The store object is shared by all
+ * its links, so it is never modified: a file, which needs a different
+ * modification time or mode, is copied instead. The objects not linked
+ * from the mirror are removed after AGENT_CAS_UNUSED_AGE seconds.
+ */
+
+enum { AGENT_PREFETCH_BATCH = 256 };
+enum { AGENT_FETCH_MAX_SIZE = 64 * 1024 * 1024 };
+enum { AGENT_CAS_UNUSED_AGE = 3600 };
+enum { AGENT_CAS_TRIM_INTERVAL = 600 };
+
+struct agent_prefetch_file
+{
+  unsigned char *path;
+  unsigned char *mirror_path;
+  struct AgentMirrorInfo info;
+  int fetch_index;              // index in the fetch list, or -1
+};
+
+static void
+agent_cas_path(
+        unsigned char *buf,
+        int size,
+        const unsigned char *mirror_dir,
+        const unsigned char *sha256)
+{
+  const unsigned char *hex = unparse_sha256(sha256);
+  const unsigned char *sep = "/";
+  int md_len = strlen(mirror_dir);
+  if (md_len > 0 && mirror_dir[md_len - 1] == '/') sep = "";
+  snprintf(buf, size, "%s%s.cas/%c%c/%s", mirror_dir, sep, hex[0], hex[1], hex);
+}
+
+static int
+agent_make_parent_dir(const unsigned char *path)
+{
+  unsigned char dirname[PATH_MAX];
+  struct stat stb;
+
+  os_rDirName(path, dirname, sizeof(dirname));
+  if (stat(dirname, &stb) >= 0 && S_ISDIR(stb.st_mode)) return 0;
+  if (os_MakeDirPath(dirname, 0700) < 0) {
+    err("cannot create mirror directory '%s'", dirname);
+    return -1;
+  }
+  return 0;
+}
+
+static void
+agent_set_file_info(const unsigned char *path, const struct AgentMirrorInfo *info)
+{
+  if (info->mtime > 0) {
+    struct timespec ub[2] = {};
+    ub[0].tv_sec = info->mtime;
+    ub[1].tv_sec = info->mtime;
+    if (utimensat(AT_FDCWD, path, ub, 0) < 0) {
+      err("failed to change times of '%s': %s", path, os_ErrorMsg());
+    }
+  }
+  if (info->mode >= 0 && chmod(path, info->mode & 07777) < 0) {
+    err("failed to change perms of '%s': %s", path, os_ErrorMsg());
+  }
+}
+
+static int
+agent_same_file_info(const struct stat *stb, const struct AgentMirrorInfo *info)
+{
+  if (info->mtime > 0 && stb->st_mtime != info->mtime) return 0;
+  if (info->mode >= 0 && (stb->st_mode & 07777) != (info->mode & 07777)) return 0;
+  return 1;
+}
+
+/*
+ * links the store object to the mirror path, if it has the required
+ * modification time and mode, otherwise copies it
+ */
+static int
+agent_cas_install(
+        const unsigned char *cas_path,
+        const struct agent_prefetch_file *pf)
+{
+  struct stat stb;
+
+  if (agent_make_parent_dir(pf->mirror_path) < 0) return -1;
+  unlink(pf->mirror_path);
+  if (stat(cas_path, &stb) < 0 || !agent_same_file_info(&stb, &pf->info)
+      || link(cas_path, pf->mirror_path) < 0) {
+    if (generic_copy_file(0, NULL, cas_path, NULL, 0, NULL, pf->mirror_path, NULL) < 0) {
+      err("failed to install mirrored file '%s'", pf->mirror_path);
+      return -1;
+    }
+    agent_set_file_info(pf->mirror_path, &pf->info);
+  }
+  dyntrie_insert(&agent_mirror_fresh, pf->mirror_path, (void*) 1, 1, NULL);
+  return 0;
+}
+
+/* stores the fetched data, if its checksum matches */
+static int
+agent_cas_store(
+        const unsigned char *cas_path,
+        const struct AgentMirrorInfo *info,
+        const char *data,
+        size_t size)
+{
+  const unsigned char *sha256 = info->sha256;
+  unsigned char digest[32];
+  SHA256_CTX ctx;
+  sha256_init(&ctx);
+  sha256_update(&ctx, data, size);
+  sha256_final(&ctx, digest);
+  if (memcmp(digest, sha256, 32) != 0) {
+    // the file has changed since it was stat'ed
+    return -1;
+  }
+
+  if (agent_make_parent_dir(cas_path) < 0) return -1;
+  unsigned char tmp_path[PATH_MAX];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", cas_path, (int) getpid());
+  if (generic_write_file(data, size, 0, NULL, tmp_path, NULL) < 0) {
+    unlink(tmp_path);
+    return -1;
+  }
+  // the object gets the time and mode of the first file with this content
+  agent_set_file_info(tmp_path, info);
+  if (rename(tmp_path, cas_path) < 0) {
+    err("rename '%s' failed: %s", tmp_path, os_ErrorMsg());
+    unlink(tmp_path);
+    return -1;
+  }
+  return 0;
+}
+
+static void
+agent_prefetch_fetch(
+        struct AgentClient *agent,
+        const unsigned char *mirror_dir,
+        struct agent_prefetch_file *files,
+        int file_count,
+        int *fetch,
+        int fetch_count)
+{
+  const unsigned char **paths = NULL;
+  char **ptrs = NULL;
+  size_t *lens = NULL;
+  unsigned char cas_path[PATH_MAX];
+
+  XCALLOC(paths, fetch_count);
+  XCALLOC(ptrs, fetch_count);
+  XCALLOC(lens, fetch_count);
+
+  int first = 0;
+  while (first < fetch_count) {
+    int last = first;
+    long long batch_size = 0;
+    do {
+      batch_size += files[fetch[last]].info.size;
+      paths[last - first] = files[fetch[last]].path;
+      ++last;
+    } while (last < fetch_count
+             && batch_size + files[fetch[last]].info.size <= AGENT_FETCH_MAX_SIZE);
+
+    if (agent->ops->mirror_fetch(agent, last - first, paths, ptrs, lens) < 0) {
+      err("mirror_fetch failed");
+      break;
+    }
+    for (int i = first; i < last; ++i) {
+      struct agent_prefetch_file *pf = &files[fetch[i]];
+      char *ptr = ptrs[i - first];
+      if (!ptr) continue;
+      agent_cas_path(cas_path, sizeof(cas_path), mirror_dir, pf->info.sha256);
+      if (agent_cas_store(cas_path, &pf->info, ptr, lens[i - first]) >= 0) {
+        for (int j = 0; j < file_count; ++j) {
+          if (files[j].fetch_index == i) {
+            agent_cas_install(cas_path, &files[j]);
+          }
+        }
+      }
+      free(ptr);
+      ptrs[i - first] = NULL;
+    }
+    first = last;
+  }
+
+  free(paths);
+  free(ptrs);
+  free(lens);
+}
+
+/* removes the store objects, which are not linked from the mirror */
+static void
+agent_cas_trim(const unsigned char *mirror_dir)
+{
+  unsigned char cas_dir[PATH_MAX];
+  unsigned char path[PATH_MAX];
+  unsigned char sub_path[PATH_MAX];
+  struct stat stb;
+  DIR *d = NULL, *sd = NULL;
+  struct dirent *dd, *sdd;
+  time_t now = time(NULL);
+
+  snprintf(cas_dir, sizeof(cas_dir), "%s/.cas", mirror_dir);
+  snprintf(path, sizeof(path), "%s/.trim", cas_dir);
+  if (stat(path, &stb) >= 0 && stb.st_mtime + AGENT_CAS_TRIM_INTERVAL > now) return;
+  // only one process scans the store at a time
+  if (generic_write_file("", 0, 0, NULL, path, "") < 0) return;
+
+  if (!(d = opendir(cas_dir))) return;
+  while ((dd = readdir(d))) {
+    if (dd->d_name[0] == '.') continue;
+    snprintf(sub_path, sizeof(sub_path), "%s/%s", cas_dir, dd->d_name);
+    if (!(sd = opendir(sub_path))) continue;
+    while ((sdd = readdir(sd))) {
+      if (sdd->d_name[0] == '.') continue;
+      snprintf(path, sizeof(path), "%s/%s", sub_path, sdd->d_name);
+      if (lstat(path, &stb) < 0 || !S_ISREG(stb.st_mode)) continue;
+      // st_ctime is updated when a link to the object is removed
+      if (stb.st_nlink == 1 && stb.st_ctime + AGENT_CAS_UNUSED_AGE < now) {
+        unlink(path);
+      }
+    }
+    closedir(sd);
+  }
+  closedir(d);
+}
+
+/*
+ * brings the mirrored files up to date using one stat exchange with
+ * the agent and a fetch exchange for the contents missing in the store
+ */
+static void
+agent_prefetch_files(
+        struct AgentClient *agent,
+        const unsigned char *mirror_dir,
+        struct agent_prefetch_file *files,
+        int file_count)
+{
+  const unsigned char **paths = NULL;
+  struct AgentMirrorInfo *infos = NULL;
+  int *fetch = NULL;
+  int fetch_count = 0;
+  unsigned char cas_path[PATH_MAX];
+  struct stat stb;
+
+  XCALLOC(paths, file_count);
+  XCALLOC(infos, file_count);
+  for (int i = 0; i < file_count; ++i) {
+    paths[i] = files[i].path;
+  }
+  if (agent->ops->mirror_stat(agent, file_count, paths, infos) < 0) {
+    err("mirror_stat failed");
+    goto done;
+  }
+
+  XCALLOC(fetch, file_count);
+  for (int i = 0; i < file_count; ++i) {
+    struct agent_prefetch_file *pf = &files[i];
+    pf->info = infos[i];
+    pf->fetch_index = -1;
+    if (pf->info.size < 0) continue;
+
+    if (stat(pf->mirror_path, &stb) >= 0 && S_ISREG(stb.st_mode)
+        && stb.st_size == pf->info.size && stb.st_mtime == pf->info.mtime
+        && (stb.st_mode & 07777) == pf->info.mode) {
+      dyntrie_insert(&agent_mirror_fresh, pf->mirror_path, (void*) 1, 1, NULL);
+      continue;
+    }
+
+    agent_cas_path(cas_path, sizeof(cas_path), mirror_dir, pf->info.sha256);
+    if (stat(cas_path, &stb) >= 0 && S_ISREG(stb.st_mode)
+        && stb.st_size == pf->info.size) {
+      agent_cas_install(cas_path, pf);
+      continue;
+    }
+
+    // request each content only once
+    int j;
+    for (j = 0; j < fetch_count; ++j) {
+      if (!memcmp(files[fetch[j]].info.sha256, pf->info.sha256, 32)) break;
+    }
+    if (j == fetch_count) {
+      fetch[fetch_count++] = i;
+    }
+    pf->fetch_index = j;
+  }
+
+  if (fetch_count > 0) {
+    agent_prefetch_fetch(agent, mirror_dir, files, file_count, fetch, fetch_count);
+  }
+  agent_cas_trim(mirror_dir);
+
+done:;
+  free(paths);
+  free(infos);
+  free(fetch);
+}
+
+static void
+agent_prefetch_add(
+        struct agent_prefetch_file *pf,
+        const unsigned char *mirror_dir,
+        const unsigned char *dir,
+        const unsigned char *pat,
+        int num)
+{
+  unsigned char base[PATH_MAX];
+  unsigned char path[PATH_MAX];
+  unsigned char mirror_path[PATH_MAX];
+
+  snprintf(base, sizeof(base), pat, num);
+  snprintf(path, sizeof(path), "%s/%s", dir, base);
+  const unsigned char *sep = "";
+  int md_len = strlen(mirror_dir);
+  if (md_len > 0 && mirror_dir[md_len - 1] != '/' && path[0] != '/') {
+    sep = "/";
+  }
+  snprintf(mirror_path, sizeof(mirror_path), "%s%s%s", mirror_dir, sep, path);
+  pf->path = xstrdup(path);
+  pf->mirror_path = xstrdup(mirror_path);
+  pf->info.size = -1;
+  pf->fetch_index = -1;
+}
+
+/*
+ * mirrors all the tests (and answers) of the problem at once,
+ * if the number of tests is not known, the tests are mirrored in batches
+ * until the first missing test
+ */
+static void
+agent_mirror_prefetch(
+        struct AgentClient *agent,
+        const unsigned char *mirror_dir,
+        const struct super_run_in_problem_packet *srpp,
+        const unsigned char *test_dir,
+        const unsigned char *corr_dir)
+{
+  struct agent_prefetch_file *files = NULL;
+
+  dyntrie_free(&agent_mirror_fresh, NULL, NULL);
+  if (!mirror_dir || !*mirror_dir) return;
+  if (!agent->ops->mirror_stat || !agent->ops->mirror_fetch) return;
+  if (!test_dir || !srpp->test_pat || !*srpp->test_pat) return;
+  if (!strncmp(test_dir, EJUDGE_PREFIX_DIR, sizeof(EJUDGE_PREFIX_DIR) - 1)) return;
+
+  int use_corr = srpp->use_corr > 0 && corr_dir && srpp->corr_pat && *srpp->corr_pat;
+  int per_test = use_corr?2:1;
+  int first_test = 1;
+  int last_test = (srpp->test_count > 0)?srpp->test_count:AGENT_PREFETCH_BATCH;
+  XCALLOC(files, (size_t) per_test * AGENT_PREFETCH_BATCH);
+
+  while (first_test <= last_test) {
+    int batch_last = first_test + AGENT_PREFETCH_BATCH - 1;
+    if (batch_last > last_test) batch_last = last_test;
+    int file_count = 0;
+    for (int num = first_test; num <= batch_last; ++num) {
+      agent_prefetch_add(&files[file_count++], mirror_dir, test_dir, srpp->test_pat, num);
+      if (use_corr) {
+        agent_prefetch_add(&files[file_count++], mirror_dir, corr_dir, srpp->corr_pat, num);
+      }
+    }
+
+    agent_prefetch_files(agent, mirror_dir, files, file_count);
+
+    int all_found = 1;
+    for (int i = 0; i < file_count; i += per_test) {
+      if (files[i].info.size < 0) all_found = 0;
+    }
+    for (int i = 0; i < file_count; ++i) {
+      free(files[i].path);
+      free(files[i].mirror_path);
+    }
+    memset(files, 0, sizeof(files[0]) * file_count);
+
+    if (!all_found) break;
+    first_test = batch_last + 1;
+    if (srpp->test_count <= 0 && first_test > last_test && last_test < 100000) {
+      last_test += AGENT_PREFETCH_BATCH;
+    }
+  }
+
+  free(files);
+}
+
 static int
 copy_mirrored_file(unsigned char *buf, int size, const unsigned char *mirror_path, const struct stat *psrcstat)
 {
@@ -1729,6 +2178,32 @@ mirror_file(
   snprintf(buf, size, "%s", mirror_path);
 }
 
+/*
+ * mirrors the test file, the original file is used, if the mirrored
+ * copy does not match the manifest
+ */
+static void
+mirror_test_file(
+        struct AgentClient *agent,
+        unsigned char *buf,
+        int size,
+        const unsigned char *mirror_dir,
+        struct test_manifest *manifest,
+        int test_num,
+        int kind)
+{
+  unsigned char orig_path[PATH_MAX];
+
+  snprintf(orig_path, sizeof(orig_path), "%s", buf);
+  mirror_file(agent, buf, size, mirror_dir);
+  if (manifest && strcmp(buf, orig_path) != 0
+      && !test_manifest_check_file(manifest, test_num, kind, buf)) {
+    err("mirrored copy '%s' does not match '%s', using the original file",
+        buf, orig_path);
+    snprintf(buf, size, "%s", orig_path);
+  }
+}
+
 static const unsigned char b32_digits[]=
 "0123456789ABCDEFGHIJKLMNOPQRSTUV";
 
@@ -2322,6 +2797,78 @@ invoke_test_generator_cmd(
   return 0;
 }
 
+static int
+sha256_file(const unsigned char *path, unsigned char *digest)
+{
+  SHA256_CTX ctx;
+  unsigned char buf[65536];
+  int fd;
+
+  if ((fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0)) < 0) return -1;
+  sha256_init(&ctx);
+  while (1) {
+    ssize_t r = read(fd, buf, sizeof(buf));
+    if (r < 0) {
+      close(fd);
+      return -1;
+    }
+    if (!r) break;
+    sha256_update(&ctx, buf, r);
+  }
+  close(fd);
+  sha256_final(&ctx, digest);
+  return 0;
+}
+
+/*
+ * the generated tests are cached by the generator file, its command line
+ * and the environment it gets, except the run-specific variables,
+ * the source file passed in EJUDGE_SOURCE_PATH is keyed by its contents,
+ * it is not passed, if the problem has test_generator_ignores_source
+ */
+static int
+make_test_generator_key(
+        const struct super_run_in_packet *srp,
+        const unsigned char *test_generator_cmd,
+        const unsigned char *src_path,
+        unsigned char *key)
+{
+  const struct super_run_in_global_packet *srgp = srp->global;
+  const struct super_run_in_problem_packet *srpp = srp->problem;
+  char *argv[] = { (char *) test_generator_cmd, NULL };
+  int env_u = 0;
+  unsigned char locale_buf[1024];
+  unsigned char src_buf[128];
+  unsigned char digest[32];
+
+  if (srpp->test_generator_env) {
+    while (srpp->test_generator_env[env_u]) ++env_u;
+  }
+  char *envp[env_u + 8];
+  for (int i = 0; i < env_u; ++i) {
+    envp[i] = srpp->test_generator_env[i];
+  }
+  if (srgp->checker_locale && srgp->checker_locale[0]) {
+    int len = snprintf(locale_buf, sizeof(locale_buf), "EJUDGE_LOCALE=%s", srgp->checker_locale);
+    if (len >= (int) sizeof(locale_buf)) return -1;
+    envp[env_u++] = (char *) locale_buf;
+  }
+  if (srgp->testlib_mode > 0) {
+    envp[env_u++] = "EJUDGE_TESTLIB_MODE=1";
+  }
+  if (src_path) {
+    if (sha256_file(src_path, digest) < 0) return -1;
+    int len = snprintf(src_buf, sizeof(src_buf), "EJUDGE_SOURCE_SHA256=");
+    for (int i = 0; i < (int) sizeof(digest); ++i) {
+      len += snprintf(src_buf + len, sizeof(src_buf) - len, "%02x", digest[i]);
+    }
+    envp[env_u++] = (char *) src_buf;
+  }
+  envp[env_u] = NULL;
+
+  return test_gen_cache_make_key(test_generator_cmd, argv, envp, key);
+}
+
 static int
 invoke_init_cmd(
         const struct super_run_in_packet *srp,
@@ -2573,44 +3120,286 @@ make_java_limits(unsigned char *buf, int blen, ej_size64_t max_vm_size, ej_size6
   }
 }
 
-static void __attribute__((unused))
-make_mono_limits(unsigned char *buf, int blen, ej_size64_t max_vm_size, ej_size64_t max_stack_size)
+static void __attribute__((unused))
+make_mono_limits(unsigned char *buf, int blen, ej_size64_t max_vm_size, ej_size64_t max_stack_size)
+{
+  unsigned char bv[1024];
+  // stack limit is not supported
+  buf[0] = 0;
+  if (max_vm_size > 0) {
+    snprintf(buf, blen, "MONO_GC_PARAMS=max-heap-size=%s",
+             ej_size64_t_to_size(bv, sizeof(bv), max_vm_size));
+  }
+}
+
+static unsigned char *
+report_args_and_env(testinfo_t *ti)
+{
+  int i;
+  int cmd_args_len = 0;
+  unsigned char *s, *args = NULL;
+
+  if (!ti || ti->cmd.u <= 0) return NULL;
+
+  for (i = 0; i < ti->cmd.u; i++) {
+    cmd_args_len += 16;
+    if (ti->cmd.v[i]) {
+      cmd_args_len += strlen(ti->cmd.v[i]) + 16;
+    }
+  }
+  if (cmd_args_len > 0) {
+    s = args = (unsigned char *) xmalloc(cmd_args_len + 1);
+    for (i = 0; i < ti->cmd.u; i++) {
+      if (ti->cmd.v[i]) {
+        s += sprintf(s, "[%3d]: >%s<\n", i + 1, ti->cmd.v[i]);
+      } else {
+        s += sprintf(s, "[%3d]: NULL\n", i + 1);
+      }
+    }
+  }
+  return args;
+}
+
+struct checker_env
+{
+  char **envs;
+  int ti_env_u;
+  char **ti_env_v;
+};
+
+/* the value of the environment variable as set up by setup_environment */
+static const char *
+checker_env_getenv(void *data, const char *name)
+{
+  const struct checker_env *ce = (const struct checker_env *) data;
+  size_t len = strlen(name);
+  const char *value = getenv(name);
+
+  if (ce->envs) {
+    for (int i = 0; ce->envs[i]; ++i) {
+      if (!strncmp(ce->envs[i], name, len) && ce->envs[i][len] == '=') {
+        value = ce->envs[i] + len + 1;
+      }
+    }
+  }
+  if (ce->ti_env_v) {
+    for (int i = 0; i < ce->ti_env_u; ++i) {
+      const char *e = ce->ti_env_v[i];
+      if (!e || strncmp(e, name, len) != 0) continue;
+      if (e[len] == '=') {
+        value = e + len + 1;
+      } else if (!e[len]) {
+        value = NULL;
+      }
+    }
+  }
+  return value;
+}
+
+static void
+make_checked_path(
+        unsigned char *buf,
+        size_t size,
+        const unsigned char *check_dir,
+        const unsigned char *path)
+{
+  if (os_IsAbsolutePath(path)) {
+    snprintf(buf, size, "%s", path);
+  } else {
+    snprintf(buf, size, "%s/%s", check_dir, path);
+  }
+}
+
+static int
+run_builtin_checker(
+        int kind,
+        const unsigned char *check_dir,
+        const unsigned char *test_src,
+        const unsigned char *output_path,
+        const unsigned char *corr_src,
+        const unsigned char *check_out_path,
+        struct checker_env *ce)
+{
+  unsigned char test_path[PATH_MAX];
+  unsigned char out_path[PATH_MAX];
+  unsigned char corr_path[PATH_MAX];
+  FILE *log_f = NULL;
+  int status;
+
+  // relative paths are relative to the checker working directory
+  make_checked_path(test_path, sizeof(test_path), check_dir, test_src);
+  make_checked_path(out_path, sizeof(out_path), check_dir, output_path);
+  make_checked_path(corr_path, sizeof(corr_path), check_dir, corr_src);
+
+  if (!(log_f = fopen(check_out_path, "a"))) {
+    err("run_builtin_checker: cannot open '%s': %s", check_out_path, os_ErrorMsg());
+    return RUN_CHECK_FAILED;
+  }
+  status = builtin_checker_run(kind, test_path, out_path, corr_path, log_f,
+                               checker_env_getenv, ce);
+  if (fclose(log_f) < 0) {
+    err("run_builtin_checker: write error to '%s'", check_out_path);
+    status = RUN_CHECK_FAILED;
+  }
+  return status;
+}
+
+static int
+is_output_equal_to_answer(
+        const unsigned char *check_dir,
+        const unsigned char *output_path,
+        const unsigned char *corr_src)
+{
+  unsigned char out_path[PATH_MAX];
+  unsigned char buf1[32768], buf2[32768];
+  struct stat stb1, stb2;
+  int fd1 = -1, fd2 = -1;
+  int result = 0;
+
+  make_checked_path(out_path, sizeof(out_path), check_dir, output_path);
+  if ((fd1 = open(out_path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0)) < 0) goto done;
+  if ((fd2 = open(corr_src, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0)) < 0) goto done;
+  if (fstat(fd1, &stb1) < 0 || !S_ISREG(stb1.st_mode)) goto done;
+  if (fstat(fd2, &stb2) < 0 || !S_ISREG(stb2.st_mode)) goto done;
+  if (stb1.st_size != stb2.st_size) goto done;
+
+  while (1) {
+    ssize_t r1 = read(fd1, buf1, sizeof(buf1));
+    if (r1 < 0) goto done;
+    if (!r1) break;
+    ssize_t r2 = 0;
+    while (r2 < r1) {
+      ssize_t r = read(fd2, buf2 + r2, r1 - r2);
+      if (r <= 0) goto done;
+      r2 += r;
+    }
+    if (memcmp(buf1, buf2, r1) != 0) goto done;
+  }
+  result = 1;
+
+done:;
+  if (fd1 >= 0) close(fd1);
+  if (fd2 >= 0) close(fd2);
+  return result;
+}
+
+static void
+hash_env_list(SHA256_CTX *ctx, int env_u, char **env_v)
+{
+  for (int i = 0; env_v && (env_u < 0 || i < env_u) && env_v[i]; ++i) {
+    sha256_update(ctx, (const unsigned char *) env_v[i], strlen(env_v[i]) + 1);
+  }
+  sha256_update(ctx, (const unsigned char *) "\1", 1);
+}
+
+/*
+ * the checker verdict depends on the checker, the files it gets,
+ * and the environment, the test number and the user are not passed
+ * to the checker, if the cache is used
+ */
+static int
+make_checker_cache_key(
+        const struct super_run_in_packet *srp,
+        const unsigned char *check_cmd,
+        const unsigned char *test_src,
+        const unsigned char *output_path,
+        const unsigned char *corr_src,
+        const unsigned char *info_src,
+        const unsigned char *src_path,
+        const unsigned char *check_dir,
+        int env_u,
+        char **env_v,
+        int test_max_score,
+        uint64_t test_random_value,
+        unsigned char *key)
+{
+  const struct super_run_in_global_packet *srgp = srp->global;
+  const struct super_run_in_problem_packet *srpp = srp->problem;
+  unsigned char out_path[PATH_MAX];
+  unsigned char digest[32];
+  unsigned char buf[1024];
+  SHA256_CTX ctx;
+
+  sha256_init(&ctx);
+  if (filehash_get(check_cmd, digest) < 0) return -1;
+  sha256_update(&ctx, digest, 20);
+  if (filehash_get(test_src, digest) < 0) return -1;
+  sha256_update(&ctx, digest, 20);
+  if (srpp->use_corr > 0) {
+    if (!corr_src || filehash_get(corr_src, digest) < 0) return -1;
+    sha256_update(&ctx, digest, 20);
+  }
+  if (srpp->use_info > 0) {
+    if (!info_src || filehash_get(info_src, digest) < 0) return -1;
+    sha256_update(&ctx, digest, 20);
+  }
+  make_checked_path(out_path, sizeof(out_path), check_dir, output_path);
+  if (sha256_file(out_path, digest) < 0) return -1;
+  sha256_update(&ctx, digest, 32);
+  // the checker gets the source in EJUDGE_SOURCE_PATH, unless
+  // the problem has checker_ignores_source
+  if (src_path) {
+    if (sha256_file(src_path, digest) < 0) return -1;
+    sha256_update(&ctx, digest, 32);
+  }
+
+  int len = snprintf(buf, sizeof(buf), "%d %d %d %d %d %d %d %d %d %d %llx %s",
+                     srpp->use_corr, srpp->use_info,
+                     srpp->scoring_checker, srpp->enable_checker_token,
+                     test_max_score, srpp->disable_pe, srgp->not_ok_is_cf,
+                     srgp->testlib_mode, srpp->valuer_sets_marked,
+                     srgp->rejudge_flag,
+                     (unsigned long long) test_random_value,
+                     srgp->checker_locale?srgp->checker_locale:(unsigned char*) "");
+  if (len >= (int) sizeof(buf)) return -1;
+  sha256_update(&ctx, buf, len + 1);
+  hash_env_list(&ctx, -1, srpp->checker_env);
+  hash_env_list(&ctx, env_u, env_v);
+  sha256_final(&ctx, key);
+  return 0;
+}
+
+static void
+append_cached_checker_output(
+        const unsigned char *check_out_path,
+        const unsigned char *data,
+        size_t size)
 {
-  unsigned char bv[1024];
-  // stack limit is not supported
-  buf[0] = 0;
-  if (max_vm_size > 0) {
-    snprintf(buf, blen, "MONO_GC_PARAMS=max-heap-size=%s",
-             ej_size64_t_to_size(bv, sizeof(bv), max_vm_size));
-  }
+  FILE *f = fopen(check_out_path, "a");
+  if (!f) return;
+  fwrite(data, 1, size, f);
+  fclose(f);
 }
 
-static unsigned char *
-report_args_and_env(testinfo_t *ti)
+static void
+store_checker_verdict(
+        const unsigned char *key,
+        const unsigned char *check_out_path,
+        long long check_out_start,
+        const struct run_test_info *cur_info,
+        int status)
 {
-  int i;
-  int cmd_args_len = 0;
-  unsigned char *s, *args = NULL;
+  struct checker_cache_result cres = {};
+  unsigned char buf[CHECKER_CACHE_MAX_OUTPUT + 1];
+  FILE *f = NULL;
 
-  if (!ti || ti->cmd.u <= 0) return NULL;
-
-  for (i = 0; i < ti->cmd.u; i++) {
-    cmd_args_len += 16;
-    if (ti->cmd.v[i]) {
-      cmd_args_len += strlen(ti->cmd.v[i]) + 16;
+  if ((f = fopen(check_out_path, "r"))) {
+    if (check_out_start > 0 && fseek(f, check_out_start, SEEK_SET) < 0) {
+      fclose(f);
+      return;
     }
-  }
-  if (cmd_args_len > 0) {
-    s = args = (unsigned char *) xmalloc(cmd_args_len + 1);
-    for (i = 0; i < ti->cmd.u; i++) {
-      if (ti->cmd.v[i]) {
-        s += sprintf(s, "[%3d]: >%s<\n", i + 1, ti->cmd.v[i]);
-      } else {
-        s += sprintf(s, "[%3d]: NULL\n", i + 1);
-      }
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (size > CHECKER_CACHE_MAX_OUTPUT) return;
+    if (size > 0) {
+      cres.output = buf;
+      cres.output_size = size;
     }
   }
-  return args;
+  cres.status = status;
+  cres.score = cur_info->score;
+  cres.checker_token = cur_info->checker_token;
+  checker_cache_store(key, &cres);
 }
 
 static int
@@ -2634,7 +3423,8 @@ invoke_checker(
         int output_only,
         const unsigned char *src_path,
         int exec_user_serial,
-        uint64_t test_random_value)
+        uint64_t test_random_value,
+        int builtin_checkers)
 {
   tpTask tsk = NULL;
   int status = RUN_CHECK_FAILED;
@@ -2643,6 +3433,11 @@ invoke_checker(
   int env_u = 0;
   char **env_v = 0;
   int user_score_mode = 0;
+  int builtin_kind = BUILTIN_CHECKER_NONE;
+  int exitcode = 0;
+  int use_cache = 0;
+  unsigned char cache_key[32];
+  long long check_out_start = 0;
   const struct super_run_in_global_packet *srgp = srp->global;
   const struct super_run_in_problem_packet *srpp = srp->problem;
 
@@ -2651,6 +3446,16 @@ invoke_checker(
     env_v = ti->checker_env.v;
   }
 
+  // the built-in checkers produce messages only in the default locale
+  if (builtin_checkers > 0
+      && srpp->standard_checker && srpp->standard_checker[0]
+      && !(ti && ti->check_cmd && ti->check_cmd[0])
+      && srpp->use_corr > 0 && corr_src && corr_src[0]
+      && srpp->scoring_checker <= 0
+      && (!srgp->checker_locale || !srgp->checker_locale[0])) {
+    builtin_kind = builtin_checker_find(srpp->standard_checker);
+  }
+
   tsk = task_New();
   task_AddArg(tsk, check_cmd);
   task_SetPathAsArg0(tsk);
@@ -2715,6 +3520,8 @@ invoke_checker(
   default:
     abort();
   }
+  // the source is neither passed to the checker nor a part of its cache key
+  if (srpp->checker_ignores_source > 0) src_path = NULL;
   setup_environment(tsk, srpp->checker_env, env_u, env_v, 1);
   setup_ejudge_environment(tsk,
                            srp,
@@ -2729,6 +3536,54 @@ invoke_checker(
   }
   task_EnableAllSignals(tsk);
 
+  // a checker set for the test may not accept the exact answer
+  if (output_only <= 0 && srpp->checker_exact_match_ok > 0
+      && srpp->use_corr > 0 && srpp->scoring_checker <= 0
+      && !(ti && ti->check_cmd && ti->check_cmd[0])
+      && corr_src && corr_src[0]
+      && is_output_equal_to_answer(check_dir, output_path, corr_src)) {
+    info("output is equal to the answer, the checker is not run");
+    cur_info->checker_cached = TESTING_REPORT_CHECKER_EXACT_MATCH;
+    cur_info->score = test_max_score;
+    status = RUN_OK;
+    goto cleanup;
+  }
+
+  if (output_only <= 0 && srpp->enable_checker_cache > 0
+      && srpp->use_tgz <= 0 && srpp->enable_extended_info <= 0
+      && make_checker_cache_key(srp, check_cmd, test_src, output_path,
+                                corr_src, info_src, src_path, check_dir, env_u, env_v,
+                                test_max_score, test_random_value,
+                                cache_key) >= 0) {
+    struct checker_cache_result cres = {};
+    if (checker_cache_lookup(cache_key, &cres)) {
+      info("checker verdict is found in the cache");
+      if (cres.output_size > 0) {
+        append_cached_checker_output(check_out_path, cres.output, cres.output_size);
+      }
+      status = cres.status;
+      cur_info->score = cres.score;
+      cur_info->checker_token = cres.checker_token; cres.checker_token = NULL;
+      cur_info->checker_cached = TESTING_REPORT_CHECKER_CACHED;
+      checker_cache_free_result(&cres);
+      goto cleanup;
+    }
+    use_cache = 1;
+    check_out_start = generic_file_size(0, check_out_path, 0);
+    if (check_out_start < 0) check_out_start = 0;
+  }
+
+  if (builtin_kind != BUILTIN_CHECKER_NONE) {
+    struct checker_env ce = { srpp->checker_env, env_u, env_v };
+    if (!checker_env_getenv(&ce, "EJUDGE_LOCALE")) {
+      info("running built-in checker %s", srpp->standard_checker);
+      exitcode = run_builtin_checker(builtin_kind, check_dir, test_src,
+                                     output_path, corr_src, check_out_path,
+                                     &ce);
+      goto checker_completed;
+    }
+  }
+
   task_PrintArgs(tsk);
 
   if (task_Start(tsk) < 0) {
@@ -2757,7 +3612,9 @@ invoke_checker(
     goto cleanup;
   }
 
-  int exitcode = task_ExitCode(tsk);
+  exitcode = task_ExitCode(tsk);
+
+checker_completed:
   if (exitcode == 1) exitcode = RUN_WRONG_ANSWER_ERR;
   if (exitcode == 2) exitcode = RUN_PRESENTATION_ERR;
   if (exitcode == RUN_PRESENTATION_ERR && srpp->disable_pe > 0) {
@@ -2839,6 +3696,10 @@ invoke_checker(
   }
 
 cleanup:
+  if (use_cache && status != RUN_CHECK_FAILED) {
+    store_checker_verdict(cache_key, check_out_path, check_out_start,
+                          cur_info, status);
+  }
   task_Delete(tsk); tsk = NULL;
   return status;
 }
@@ -3289,6 +4150,12 @@ trim_long_lines(
   *p_out_size = out_z;
 }
 
+/*
+ * reads the file for the testing report: only max_file_length bytes
+ * from the beginning of the file and max_file_tail_length bytes from its
+ * end are read, the rest of the file is skipped, the size of the whole
+ * file is taken from fstat
+ */
 static void
 read_run_test_file(
         const struct super_run_in_global_packet *srgp,
@@ -3299,6 +4166,9 @@ read_run_test_file(
   int fd = -1;
   unsigned char *proc_data = NULL;
   long long proc_size = 0;
+  long long head_size = 0, tail_size = 0, total_size = 0;
+  unsigned char *tail_data = NULL;
+  long long tail_used = 0;
 
   memset(rtf, 0, sizeof(*rtf));
 
@@ -3330,39 +4200,58 @@ read_run_test_file(
     goto done;
   }
 
-  proc_size = stb.st_size;
-  if (stb.st_size > srgp->max_file_length) {
-    proc_size = srgp->max_file_length;
+  head_size = srgp->max_file_length;
+  if (head_size < 0) head_size = 0;
+  if (head_size > stb.st_size) head_size = stb.st_size;
+  if (stb.st_size > head_size && srgp->max_file_tail_length > 0) {
+    tail_size = srgp->max_file_tail_length;
+    if (tail_size > stb.st_size - head_size) tail_size = stb.st_size - head_size;
+    tail_data = xmalloc(tail_size);
   }
-  proc_data = xmalloc(proc_size + 1024);
+  proc_data = xmalloc(head_size + tail_size + 1024);
+  total_size = stb.st_size;
 
-  {
-    long long rem_size = proc_size;
-    unsigned char *p = proc_data;
-    while (rem_size > 0) {
-      ssize_t r = read(fd, p, rem_size);
-      if (r < 0) {
-        err("%s: read error from '%s': %s", __FUNCTION__, path, os_ErrorMsg());
-        goto done;
-      }
-      if (!r) {
-        err("%s: file truncated '%s'", __FUNCTION__, path);
-        proc_size -= rem_size;
-        break;
-      }
-      rem_size -= r;
-      p += r;
+  while (proc_size < head_size) {
+    ssize_t r = read(fd, proc_data + proc_size, head_size - proc_size);
+    if (r < 0) {
+      err("%s: read error from '%s': %s", __FUNCTION__, path, os_ErrorMsg());
+      goto done;
     }
-    proc_data[proc_size] = 0;
+    if (!r) break;
+    proc_size += r;
+  }
+  while (tail_used < tail_size) {
+    ssize_t r = pread(fd, tail_data + tail_used, tail_size - tail_used,
+                      total_size - tail_size + tail_used);
+    if (r < 0) {
+      err("%s: read error from '%s': %s", __FUNCTION__, path, os_ErrorMsg());
+      goto done;
+    }
+    if (!r) break;
+    tail_used += r;
   }
   close(fd); fd = -1;
+  if (proc_size < head_size || tail_used < tail_size) {
+    // the file is shorter than fstat reported
+    err("%s: file '%s' is truncated while reading", __FUNCTION__, path);
+    total_size = proc_size;
+    tail_used = 0;
+  }
+
+  if (tail_used > 0 && proc_size + tail_used == total_size) {
+    // the head and the tail cover the whole file
+    memcpy(proc_data + proc_size, tail_data, tail_used);
+    proc_size += tail_used;
+    tail_used = 0;
+  }
+  proc_data[proc_size] = 0;
 
   if (need_base64(proc_data, proc_size)) {
     // binary file
-    rtf->orig_size = stb.st_size;
+    rtf->orig_size = total_size;
     rtf->is_here = 1;
     rtf->is_binary = 1;
-    rtf->is_too_long = (stb.st_size > proc_size);
+    rtf->is_too_long = (total_size > proc_size);
     rtf->is_base64 = 1;
     rtf->data = xmalloc(proc_size * 4 / 3 + 64);
     int len = base64_encode(proc_data, proc_size, rtf->data);
@@ -3371,24 +4260,42 @@ read_run_test_file(
     goto done;
   }
 
-  if (proc_size != stb.st_size && utf8_mode) {
+  rtf->is_too_long = proc_size != total_size;
+  if (rtf->is_too_long && utf8_mode) {
     proc_size = utf8_trim_last_codepoint(proc_data, proc_size);
   }
+  if (tail_used > 0) {
+    // the head, the separator and the tail
+    static const char sep_str_utf8[] = "\n…\n";
+    static const char sep_str[] = "\n...\n";
+    const char *sep = utf8_mode?sep_str_utf8:sep_str;
+    long long sep_len = strlen(sep);
+    long long tail_start = 0;
+    if (utf8_mode) {
+      // skip the continuation bytes of the first codepoint
+      while (tail_start < tail_used && tail_start < 3
+             && tail_data[tail_start] >= 0x80 && tail_data[tail_start] <= 0xbf) {
+        ++tail_start;
+      }
+    }
+    memcpy(proc_data + proc_size, sep, sep_len);
+    memcpy(proc_data + proc_size + sep_len, tail_data + tail_start,
+           tail_used - tail_start);
+    proc_size += sep_len + tail_used - tail_start;
+    proc_data[proc_size] = 0;
+  }
 
   ssize_t max_len = get_max_line_length(proc_data, proc_size);
   if (max_len > srgp->max_line_length) {
     unsigned char *out_data = NULL;
     ssize_t out_size = 0;
-    rtf->is_too_long = proc_size != stb.st_size;
     trim_long_lines(proc_data, proc_size, utf8_mode, srgp->max_line_length,
                     &out_data, &out_size);
     xfree(proc_data); proc_data = out_data; out_data = NULL;
     proc_size = out_size; out_size = 0;
     rtf->is_too_wide = 1;
-  } else {
-    rtf->is_too_long = proc_size != stb.st_size;
   }
-  if (rtf->is_too_long) {
+  if (rtf->is_too_long && !tail_used) {
     if (utf8_mode) {
       static const char append_str[] = "\n…\n";
       proc_data = xrealloc(proc_data, proc_size + 64);
@@ -3406,12 +4313,13 @@ read_run_test_file(
     // FIXME: set is_fixed depending on the number of utf8 fixes
   }
   rtf->data = proc_data; proc_data = NULL;
-  rtf->orig_size = stb.st_size;
+  rtf->orig_size = total_size;
   rtf->stored_size = proc_size;
   rtf->is_here = 1;
 
 done:;
   xfree(proc_data);
+  xfree(tail_data);
   if (fd >= 0) close(fd);
 }
 
@@ -3450,7 +4358,8 @@ run_one_test(
         const unsigned char *test_dir,
         const unsigned char *corr_dir,
         const unsigned char *info_dir,
-        const unsigned char *tgz_dir)
+        const unsigned char *tgz_dir,
+        struct test_manifest *manifest)
 {
   const struct section_global_data *global = state->global;
 
@@ -3562,7 +4471,8 @@ run_one_test(
     snprintf(corr_src, sizeof(corr_src), "%s/%s", corr_dir, corr_base);
   }
   if (srpp->use_corr > 0 && corr_src[0]) {
-    mirror_file(agent, corr_src, sizeof(corr_src), mirror_dir);
+    mirror_test_file(agent, corr_src, sizeof(corr_src), mirror_dir,
+                     manifest, cur_test, TEST_MANIFEST_CORR);
   }
   info_base[0] = 0;
   info_src[0] = 0;
@@ -3653,32 +4563,35 @@ run_one_test(
 
   /* Load test information file */
   if (srpp->use_info > 0) {
-    struct testinfo_subst_handler_super_run sr;
-    memset(&sr, 0, sizeof(sr));
-    sr.b.substitute = testinfo_subst_handler_substitute;
-    sr.srp = srp;
-    sr.eff_f = open_memstream(&sr.eff_s, &sr.eff_z);
-    if ((errcode = testinfo_parse(info_src, &tstinfo, &sr.b)) < 0) {
-      fclose(sr.eff_f); xfree(sr.eff_s);
-      err("Cannot parse test info file '%s': %s", info_src, testinfo_strerror(-errcode));
-      append_msg_to_log(check_out_path, "failed to parse testinfo file '%s': %s\n",
-                        info_src, testinfo_strerror(-errcode));
-      goto check_failed;
-    }
-    fclose(sr.eff_f);
-    eff_inf_text = sr.eff_s;
-
-    // if 'enable_subst' is enabled, save the effective .inf file into the working directory
-    // and further use it instead of the original file
-    if (tstinfo.enable_subst > 0) {
-      snprintf(info_src, sizeof(info_src), "%s/eff_%s", global->run_work_dir, info_base);
-      if (generic_write_file(sr.eff_s, sr.eff_z, 0, NULL, info_src, NULL) < 0) {
-        append_msg_to_log(check_out_path, "failed to save effective testinfo file '%s': %s\n",
+    // the manifest keeps the parsed test info files without substitutions
+    if (!manifest || test_manifest_get_testinfo(manifest, cur_test, &tstinfo) < 0) {
+      struct testinfo_subst_handler_super_run sr;
+      memset(&sr, 0, sizeof(sr));
+      sr.b.substitute = testinfo_subst_handler_substitute;
+      sr.srp = srp;
+      sr.eff_f = open_memstream(&sr.eff_s, &sr.eff_z);
+      if ((errcode = testinfo_parse(info_src, &tstinfo, &sr.b)) < 0) {
+        fclose(sr.eff_f); xfree(sr.eff_s);
+        err("Cannot parse test info file '%s': %s", info_src, testinfo_strerror(-errcode));
+        append_msg_to_log(check_out_path, "failed to parse testinfo file '%s': %s\n",
                           info_src, testinfo_strerror(-errcode));
         goto check_failed;
       }
+      fclose(sr.eff_f);
+      eff_inf_text = sr.eff_s;
+
+      // if 'enable_subst' is enabled, save the effective .inf file into the working directory
+      // and further use it instead of the original file
+      if (tstinfo.enable_subst > 0) {
+        snprintf(info_src, sizeof(info_src), "%s/eff_%s", global->run_work_dir, info_base);
+        if (generic_write_file(sr.eff_s, sr.eff_z, 0, NULL, info_src, NULL) < 0) {
+          append_msg_to_log(check_out_path, "failed to save effective testinfo file '%s': %s\n",
+                            info_src, testinfo_strerror(-errcode));
+          goto check_failed;
+        }
+      }
+      xfree(eff_inf_text); eff_inf_text = NULL;
     }
-    xfree(eff_inf_text); eff_inf_text = NULL;
 
     if (srgp->lang_short_name && srgp->lang_short_name[0] && tstinfo.ok_language.u > 0) {
       int i;
@@ -3913,7 +4826,8 @@ run_one_test(
     }
   } else {
     /* copy the test */
-    mirror_file(agent, test_src, sizeof(test_src), mirror_dir);
+    mirror_test_file(agent, test_src, sizeof(test_src), mirror_dir,
+                     manifest, cur_test, TEST_MANIFEST_TEST);
     if (generic_copy_file(0, NULL, test_src, "", copy_flag, check_dir, srpp->input_file, "") < 0) {
       append_msg_to_log(check_out_path, "failed to copy test file %s -> %s/%s",
                         test_src, check_dir, srpp->input_file);
@@ -4250,6 +5164,18 @@ run_one_test(
     if (tst->secure_exec_type_val == SEXEC_TYPE_JAVA) {
       task_PutEnv(tsk, "EJUDGE_JAVA_POLICY=fileio.policy");
     }
+    if (srgp->enable_perf_counters > 0 || srgp->perf_instructions_per_ms > 0) {
+      task_EnablePerfCounters(tsk);
+    }
+    if (srgp->perf_instructions_per_ms > 0) {
+      long long normalized_limit_ms = time_limit_value_ms;
+      if (tstinfo.time_limit_ms > 0) normalized_limit_ms = tstinfo.time_limit_ms;
+      if (normalized_limit_ms > 0) {
+        task_SetMaxInstructions(tsk, normalized_limit_ms * srgp->perf_instructions_per_ms);
+        // the CPU time limit is kept only as a safety net
+        task_SetMaxTimeMillis(tsk, normalized_limit_ms * 2);
+      }
+    }
   } else if (tst && srgp->suid_run > 0) {
     task_SetSuidHelperDir(tsk, EJUDGE_SERVER_BIN_PATH);
     task_EnableSuidExec(tsk);
@@ -4458,6 +5384,14 @@ run_one_test(
   cur_info->max_memory_used = task_GetMemoryUsed(tsk);
   if (cur_info->max_memory_used > 0) *p_has_max_memory_used = 1;
   cur_info->program_stats_str = get_process_stats_str(tsk);
+  if (tst && srgp->enable_container > 0 && srgp->perf_instructions_per_ms > 0) {
+    // report the same instruction-normalized time the limit was enforced on
+    struct ej_process_stats stats;
+    process_stats_init(&stats);
+    if (task_GetProcessStats(tsk, &stats) >= 0 && stats.perf_instructions > 0) {
+      cur_info->times = stats.perf_instructions / srgp->perf_instructions_per_ms;
+    }
+  }
   cur_info->max_rss = task_GetMaxRSS(tsk);
   if (cur_info->max_rss > 0) *p_has_max_rss = 1;
 
@@ -4571,6 +5505,22 @@ run_one_test(
     goto cleanup;
   }
 
+  // a program, which failed after filling up the size-limited tmpfs,
+  // is handled as if max_file_size were exceeded
+  if (state->run_tmpfs_size > 0
+      && (task_Status(tsk) == TSK_SIGNALED || task_ExitCode(tsk) != 0)
+      && is_tmpfs_quota_exceeded(check_dir, global->run_check_dir, state->run_tmpfs_size)) {
+    append_msg_to_log(check_out_path, "output size limit exceeded (tmpfs quota is %lld bytes)",
+                      state->run_tmpfs_size);
+    cur_info->code = 256; /* FIXME: magic */
+#ifdef SIGXFSZ
+    cur_info->termsig = SIGXFSZ;
+#endif
+    status = RUN_RUN_TIME_ERR;
+    if (tsk_int) goto read_checker_output;
+    goto cleanup;
+  }
+
   if (tst && tst->enable_memory_limit_error > 0 && srgp->enable_memory_limit_error > 0
       && srgp->secure_run > 0 && task_IsMemoryLimit(tsk)) {
     status = RUN_MEM_LIMIT_ERR;
@@ -4720,7 +5670,8 @@ run_checker:;
                           check_dir, &tstinfo, test_score_count, test_score_val,
                           0, src_path,
                           state->exec_user_serial,
-                          test_random_value);
+                          test_random_value,
+                          state->run_builtin_checkers);
 
   // read the checker output
 read_checker_output:;
@@ -4810,33 +5761,121 @@ init_testinfo_vector(struct run_test_info_vector *tv)
   tv->size = 1;
 }
 
+static void
+free_testinfo(struct run_test_info *ti)
+{
+  xfree(ti->args);
+  xfree(ti->comment);
+  xfree(ti->team_comment);
+  xfree(ti->exit_comment);
+  xfree(ti->program_stats_str);
+  xfree(ti->interactor_stats_str);
+  xfree(ti->checker_stats_str);
+  xfree(ti->checker_token);
+  xfree(ti->time_samples);
+  xfree(ti->input.data);
+  xfree(ti->output.data);
+  xfree(ti->correct.data);
+  xfree(ti->error.data);
+  xfree(ti->chk_out.data);
+  xfree(ti->test_checker.data);
+  memset(ti, 0, sizeof(*ti));
+}
+
 static void
 free_testinfo_vector(struct run_test_info_vector *tv)
 {
   if (tv == NULL || tv->size <= 0 || tv->data == NULL) return;
 
   for (int i = 0; i < tv->size; ++i) {
-    struct run_test_info *ti = &tv->data[i];
-    xfree(ti->args);
-    xfree(ti->comment);
-    xfree(ti->team_comment);
-    xfree(ti->exit_comment);
-    xfree(ti->program_stats_str);
-    xfree(ti->interactor_stats_str);
-    xfree(ti->checker_stats_str);
-    xfree(ti->checker_token);
-    xfree(ti->input.data);
-    xfree(ti->output.data);
-    xfree(ti->correct.data);
-    xfree(ti->error.data);
-    xfree(ti->chk_out.data);
-    xfree(ti->test_checker.data);
-  }
-  memset(tv->data, 0, sizeof(tv->data[0]) * tv->size);
+    free_testinfo(&tv->data[i]);
+  }
   xfree(tv->data);
   memset(tv, 0, sizeof(*tv));
 }
 
+/*
+ * A test is measured again, if its CPU time is within the margin
+ * below the time limit, or if it has failed with the CPU time limit.
+ */
+static int
+is_time_borderline(
+        const struct super_run_in_problem_packet *srpp,
+        int status,
+        long times,
+        long time_limit_ms)
+{
+  if (srpp->tl_remeasure_count <= 1 || time_limit_ms <= 0) return 0;
+  if (status == RUN_TIME_LIMIT_ERR) return 1;
+  if (status != RUN_OK) return 0;
+
+  int margin = srpp->tl_remeasure_margin;
+  if (margin <= 0) margin = 5;
+  if (margin > 100) margin = 100;
+  return times * 100 >= time_limit_ms * (100 - margin);
+}
+
+static long
+sample_time_key(const struct run_test_info *ti)
+{
+  // time limit samples are slower than any other
+  if (ti->status == RUN_TIME_LIMIT_ERR) return LONG_MAX;
+  return ti->times;
+}
+
+/*
+ * selects the sample with the minimal or the median time and
+ * keeps the text of all the measurements in it, the other samples are freed
+ */
+static int
+select_time_sample(
+        struct run_test_info *samples,
+        int count,
+        int median_mode,
+        struct run_test_info *out)
+{
+  int order[count];
+  for (int i = 0; i < count; ++i) {
+    order[i] = i;
+  }
+  for (int i = 1; i < count; ++i) {
+    int v = order[i], j = i;
+    for (; j > 0 && sample_time_key(&samples[order[j - 1]]) > sample_time_key(&samples[v]); --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = v;
+  }
+  int sel = order[0];
+  if (median_mode) sel = order[(count - 1) / 2];
+
+  char *text = NULL;
+  size_t size = 0;
+  FILE *f = open_memstream(&text, &size);
+  for (int i = 0; i < count; ++i) {
+    if (samples[i].status == RUN_TIME_LIMIT_ERR) {
+      fprintf(f, "TL ");
+    } else {
+      fprintf(f, "%ld ", samples[i].times);
+    }
+  }
+  fprintf(f, "-> %s ", median_mode?"median":"min");
+  if (samples[sel].status == RUN_TIME_LIMIT_ERR) {
+    fprintf(f, "TL");
+  } else {
+    fprintf(f, "%ld", samples[sel].times);
+  }
+  fclose(f); f = NULL;
+
+  *out = samples[sel];
+  memset(&samples[sel], 0, sizeof(samples[sel]));
+  xfree(out->time_samples);
+  out->time_samples = text;
+  for (int i = 0; i < count; ++i) {
+    if (i != sel) free_testinfo(&samples[i]);
+  }
+  return out->status;
+}
+
 static int
 invoke_prepare_cmd(
         const unsigned char *prepare_cmd,
@@ -5078,7 +6117,7 @@ check_output_only(
                           corr_src, NULL, NULL,
                           global->run_work_dir, score_out_path, check_out_path,
                           global->run_work_dir, NULL, 0, NULL, 1, NULL,
-                          exec_user_serial, 0);
+                          exec_user_serial, 0, 0);
 
   cur_info->status = status;
   cur_info->max_score = srpp->full_score;
@@ -5266,6 +6305,187 @@ append_skipped_test(
   cur_info->max_score = test_max_score;
 }
 
+/*
+ * Per-problem test failure statistics. Stored as a text file
+ * <run_stats_dir>/<contest_id>/<short_name>[-<variant>].txt
+ * with the test count in the first line followed by
+ * "<test> <runs> <fails>" lines. The statistics are reset
+ * when the number of tests changes.
+ */
+struct test_fail_stat
+{
+  int runs;
+  int fails;
+};
+
+/* counters are halved when reaching this value, so the statistics
+   follow the recent submissions */
+#define TEST_STATS_DECAY_RUNS 10000
+
+static int
+make_test_stats_path(
+        const serve_state_t state,
+        const struct super_run_in_packet *srp,
+        unsigned char *buf,
+        size_t size,
+        int create_dir)
+{
+  const struct super_run_in_global_packet *srgp = srp->global;
+  const struct super_run_in_problem_packet *srpp = srp->problem;
+
+  if (!state->run_stats_dir || !state->run_stats_dir[0]) return -1;
+  if (!srpp->short_name || !srpp->short_name[0]) return -1;
+  if (strchr(srpp->short_name, '/')) return -1;
+
+  unsigned char dir[PATH_MAX];
+  snprintf(dir, sizeof(dir), "%s/%06d", state->run_stats_dir, srgp->contest_id);
+  if (create_dir && os_MakeDirPath(dir, 0755) < 0) {
+    err("failed to create directory '%s'", dir);
+    return -1;
+  }
+  if (srgp->variant > 0) {
+    snprintf(buf, size, "%s/%s-%d.txt", dir, srpp->short_name, srgp->variant);
+  } else {
+    snprintf(buf, size, "%s/%s.txt", dir, srpp->short_name);
+  }
+  return 0;
+}
+
+static void
+parse_test_stats(FILE *f, int test_count, struct test_fail_stat *stats)
+{
+  int stored_count = 0;
+  int num, runs, fails;
+
+  if (fscanf(f, "%d", &stored_count) != 1 || stored_count != test_count)
+    return;
+  while (fscanf(f, "%d%d%d", &num, &runs, &fails) == 3) {
+    if (num <= 0 || num > test_count || runs < 0 || fails < 0 || fails > runs)
+      continue;
+    stats[num].runs = runs;
+    stats[num].fails = fails;
+  }
+}
+
+/* returns the array of test_count + 1 entries, or NULL if no statistics */
+static struct test_fail_stat *
+load_test_stats(
+        const serve_state_t state,
+        const struct super_run_in_packet *srp,
+        int test_count)
+{
+  unsigned char path[PATH_MAX];
+  struct test_fail_stat *stats = NULL;
+  FILE *f = NULL;
+
+  if (test_count <= 0) return NULL;
+  if (make_test_stats_path(state, srp, path, sizeof(path), 0) < 0) return NULL;
+  if (!(f = fopen(path, "r"))) return NULL;
+#ifndef __MINGW32__
+  flock(fileno(f), LOCK_SH);
+#endif
+  XCALLOC(stats, test_count + 1);
+  parse_test_stats(f, test_count, stats);
+  fclose(f);
+  return stats;
+}
+
+static void
+update_test_stats(
+        const serve_state_t state,
+        const struct super_run_in_packet *srp,
+        const struct run_test_info_vector *tests,
+        int test_count)
+{
+  unsigned char path[PATH_MAX];
+  struct test_fail_stat *stats = NULL;
+  FILE *f = NULL;
+  int fd = -1;
+
+  if (test_count <= 0) return;
+  if (make_test_stats_path(state, srp, path, sizeof(path), 1) < 0) return;
+  if ((fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) < 0) {
+    err("update_test_stats: open '%s' failed: %s", path, os_ErrorMsg());
+    return;
+  }
+#ifndef __MINGW32__
+  if (flock(fd, LOCK_EX) < 0) {
+    err("update_test_stats: flock '%s' failed: %s", path, os_ErrorMsg());
+    close(fd);
+    return;
+  }
+#endif
+  if (!(f = fdopen(fd, "r+"))) {
+    err("update_test_stats: fdopen failed: %s", os_ErrorMsg());
+    close(fd);
+    return;
+  }
+  XCALLOC(stats, test_count + 1);
+  parse_test_stats(f, test_count, stats);
+
+  for (int i = 1; i < tests->size && i <= test_count; ++i) {
+    int status = tests->data[i].status;
+    if (status == RUN_SKIPPED || status == RUN_CHECK_FAILED) continue;
+    if (++stats[i].runs > TEST_STATS_DECAY_RUNS) {
+      stats[i].runs /= 2;
+      stats[i].fails /= 2;
+    }
+    if (status != RUN_OK) ++stats[i].fails;
+  }
+
+  rewind(f);
+  if (ftruncate(fileno(f), 0) < 0) {
+    err("update_test_stats: ftruncate '%s' failed: %s", path, os_ErrorMsg());
+    goto cleanup;
+  }
+  fprintf(f, "%d\n", test_count);
+  for (int i = 1; i <= test_count; ++i) {
+    if (stats[i].runs > 0) {
+      fprintf(f, "%d %d %d\n", i, stats[i].runs, stats[i].fails);
+    }
+  }
+  if (fflush(f) < 0 || ferror(f)) {
+    err("update_test_stats: write '%s' failed", path);
+  }
+
+cleanup:
+  fclose(f);
+  xfree(stats);
+}
+
+static const struct test_fail_stat *sort_test_stats;
+
+static int
+probe_sort_func(const void *p1, const void *p2)
+{
+  int t1 = *(const int *) p1;
+  int t2 = *(const int *) p2;
+  int f1 = sort_test_stats[t1].fails;
+  int f2 = sort_test_stats[t2].fails;
+  if (f1 != f2) return f2 - f1;
+  return t1 - t2;
+}
+
+/* selects at most max_count tests with the highest failure count */
+static int
+select_probe_tests(
+        const struct test_fail_stat *stats,
+        int test_count,
+        int max_count,
+        int *probe_order)
+{
+  int count = 0;
+
+  for (int i = 1; i <= test_count; ++i) {
+    if (stats[i].fails > 0) probe_order[count++] = i;
+  }
+  sort_test_stats = stats;
+  qsort(probe_order, count, sizeof(probe_order[0]), probe_sort_func);
+  sort_test_stats = NULL;
+  if (count > max_count) count = max_count;
+  return count;
+}
+
 void
 run_tests(
         const struct ejudge_cfg *config,
@@ -5367,7 +6587,20 @@ run_tests(
   const unsigned char *info_dir = srpp->info_dir;
   const unsigned char *tgz_dir = srpp->tgz_dir;
   unsigned char b_test_dir[PATH_MAX];
-
+  struct test_manifest *manifest = NULL;
+
+  // probe phase: the tests which fail most often are run first
+  int collect_test_stats = 0;
+  struct test_fail_stat *test_stats = NULL;
+  struct run_test_info_vector probe_tests;
+  int *probe_order = NULL;
+  int *probe_status = NULL;
+  int probe_count = 0;
+  int probe_pos = 0;
+  long long run_cpu_ms = 0;     // CPU time of all the program runs so far
+  struct run_test_info_vector *cur_tests = &tests;
+
+  memset(&probe_tests, 0, sizeof(probe_tests));
   valuer_cmt_file[0] = 0;
   valuer_jcmt_file[0] = 0;
 
@@ -5407,7 +6640,11 @@ run_tests(
   report_path[0] = 0;
   pathmake(report_path, global->run_work_dir, "/", "report", NULL);
   full_report_path[0] = 0;
-  if (srgp->enable_full_archive > 0) {
+  if (srgp->enable_full_archive > 0 && srgp->full_archive_threads > 0) {
+    // the indexed archive, the tests do not wait for the compression
+    pathmake(full_report_path, global->run_work_dir, "/", "full_output", NULL);
+    far = full_archive_open_write_indexed(full_report_path, srgp->full_archive_threads);
+  } else if (srgp->enable_full_archive > 0) {
 #if defined CONF_HAS_LIBZIP
     pathmake(full_report_path, global->run_work_dir, "/", "full_output", ".zip", NULL);
 #else
@@ -5546,12 +6783,29 @@ run_tests(
                         b_test_dir, strerror(errno));
       goto check_failed;
     }
-    r = invoke_test_generator_cmd(srp, test_generator_cmd,
-                                  b_test_dir, src_path, messages_path,
-                                  state->exec_user_serial);
-    if (r != 0) {
-      append_msg_to_log(messages_path, "test generator failed");
-      goto check_failed;
+    unsigned char gen_key[32];
+    // without the source the tests are shared by all the runs of the problem
+    const unsigned char *gen_src_path = src_path;
+    if (srpp->test_generator_ignores_source > 0) gen_src_path = NULL;
+    // the generator output must not depend on the user
+    int gen_cacheable = state->run_gen_cache_size > 0
+      && srpp->enable_extended_info <= 0
+      && make_test_generator_key(srp, test_generator_cmd, gen_src_path, gen_key) >= 0;
+    if (gen_cacheable
+        && test_gen_cache_lookup(state->run_gen_cache_dir, gen_key, b_test_dir) > 0) {
+      info("generated tests for problem %s are found in the cache", srpp->short_name);
+    } else {
+      r = invoke_test_generator_cmd(srp, test_generator_cmd,
+                                    b_test_dir, gen_src_path, messages_path,
+                                    state->exec_user_serial);
+      if (r != 0) {
+        append_msg_to_log(messages_path, "test generator failed");
+        goto check_failed;
+      }
+      if (gen_cacheable) {
+        test_gen_cache_store(state->run_gen_cache_dir, gen_key, b_test_dir,
+                             state->run_gen_cache_size);
+      }
     }
     test_dir = b_test_dir;
     corr_dir = b_test_dir;
@@ -5559,6 +6813,24 @@ run_tests(
     tgz_dir = b_test_dir;
   }
 
+  // the manifest is used only for the tests available locally
+  if (!user_input_mode && !agent && test_dir == srpp->test_dir) {
+    manifest = test_manifest_get(state->run_manifest_dir,
+                                 test_dir, srpp->test_pat,
+                                 corr_dir, (srpp->use_corr > 0)?srpp->corr_pat:NULL,
+                                 info_dir, (srpp->use_info > 0)?srpp->info_pat:NULL);
+    if (manifest && srpp->test_count <= 0 && manifest->test_count > 0) {
+      srpp->test_count = manifest->test_count;
+    }
+  }
+
+  if (agent) {
+    // transfer the tests of the problem in bulk before running them
+    agent_mirror_prefetch(agent, mirror_dir, srpp,
+                          (!user_input_mode && test_dir == srpp->test_dir)?test_dir:NULL,
+                          corr_dir);
+  }
+
   if (!srpp->type_val && tst && tst->prepare_cmd && tst->prepare_cmd[0]) {
     if (invoke_prepare_cmd(tst->prepare_cmd, global->run_work_dir, exe_name,
                            messages_path, src_path,
@@ -5605,8 +6877,53 @@ run_tests(
   }
 #endif
 
+  /*
+   * Probe order: the tests which failed most often in the past are
+   * run first. Since the testing stops on the first failed test
+   * only for these scoring systems, the probes may give the verdict
+   * early. All tests preceding the failed probe are still run to report
+   * the canonical failed test, each test is run at most once: the result
+   * of a probe is taken as is when the normal order reaches the test.
+   * If an earlier test fails, the probe results past it are dropped,
+   * their output stays in the full archive, but the report does not
+   * refer to it.
+   */
+  if (srpp->probe_test_count > 0 && srpp->test_count > 0
+      && !user_input_mode && !valuer_tsk && srgp->accepting_mode <= 0
+      && (srgp->scoring_system_val == SCORE_ACM
+          || srgp->scoring_system_val == SCORE_MOSCOW
+          || (srgp->scoring_system_val == SCORE_KIROV
+              && srpp->stop_on_first_fail > 0))) {
+    collect_test_stats = 1;
+    if ((test_stats = load_test_stats(state, srp, srpp->test_count))) {
+      XCALLOC(probe_order, srpp->test_count);
+      probe_count = select_probe_tests(test_stats, srpp->test_count,
+                                       srpp->probe_test_count, probe_order);
+    }
+    if (probe_count > 0) {
+      probe_tests.reserved = srpp->test_count + 1;
+      XCALLOC(probe_tests.data, probe_tests.reserved);
+      XCALLOC(probe_status, srpp->test_count + 1);
+      for (int i = 0; i <= srpp->test_count; ++i) {
+        probe_status[i] = -1;
+      }
+    }
+  }
+
   while (1) {
-    ++cur_test;
+    if (probe_pos < probe_count) {
+      cur_test = probe_order[probe_pos++];
+      cur_tests = &probe_tests;
+      probe_tests.size = cur_test;
+    } else {
+      if (probe_pos > 0) {
+        // probe phase is over, continue in the normal order
+        probe_pos = probe_count = 0;
+        cur_test = 0;
+        cur_tests = &tests;
+      }
+      ++cur_test;
+    }
     if (srgp->scoring_system_val == SCORE_OLYMPIAD
         && srgp->accepting_mode
         && cur_test > srpp->tests_to_accept) break;
@@ -5616,13 +6933,28 @@ run_tests(
     if (tl_retry_count <= 0) tl_retry_count = 1;
 
     if (listener && listener->ops && listener->ops->before_test) {
-      listener->ops->before_test(listener, cur_test);
+      listener->ops->before_test(listener, cur_test, run_cpu_ms);
+    }
+
+    int probe_reused = 0;
+    if (probe_status && cur_tests == &tests && cur_test <= srpp->test_count
+        && probe_status[cur_test] >= 0) {
+      if (tests.size >= tests.reserved) {
+        tests.reserved *= 2;
+        if (!tests.reserved) tests.reserved = 32;
+        tests.data = (typeof(tests.data)) xrealloc(tests.data, tests.reserved * sizeof(tests.data[0]));
+      }
+      tests.data[cur_test] = probe_tests.data[cur_test];
+      memset(&probe_tests.data[cur_test], 0, sizeof(probe_tests.data[0]));
+      ++tests.size;
+      status = probe_status[cur_test];
+      probe_reused = 1;
     }
 
-    while (1) {
+    while (!probe_reused) {
       status = run_one_test(config, state, srp, tst,
                             agent,
-                            cur_test, &tests,
+                            cur_test, cur_tests,
                             far, exe_name, report_path, check_cmd,
                             interactor_cmd, start_env,
                             open_tests_count, open_tests_val,
@@ -5640,12 +6972,89 @@ run_tests(
                             test_dir,
                             corr_dir,
                             info_dir,
-                            tgz_dir);
+                            tgz_dir,
+                            manifest);
+      if (cur_tests->data[cur_test].times > 0)
+        run_cpu_ms += cur_tests->data[cur_test].times;
       if (status != RUN_TIME_LIMIT_ERR && status != RUN_WALL_TIME_LIMIT_ERR)
         break;
       if (++tl_retry >= tl_retry_count) break;
       info("test failed due to TL, do it again");
-      --tests.size;
+      --cur_tests->size;
+    }
+
+    /*
+     * The time close to the time limit is measured several times,
+     * and the verdict is taken by the minimal or the median time.
+     * The TL retries above already confirmed the time limit, if enabled.
+     */
+    if (!probe_reused && !user_input_mode
+        && !(status == RUN_TIME_LIMIT_ERR && tl_retry_count > 1)
+        && is_time_borderline(srpp, status, cur_tests->data[cur_test].times,
+                              report_time_limit_ms)) {
+      int sample_count = srpp->tl_remeasure_count;
+      struct run_test_info *samples = NULL;
+      int cur_sample = 0;
+
+      XCALLOC(samples, sample_count);
+      samples[cur_sample++] = cur_tests->data[cur_test];
+      samples[0].status = status;
+      while (cur_sample < sample_count) {
+        info("test %d: time %ld ms is close to the time limit, measuring again",
+             cur_test, cur_tests->data[cur_test].times);
+        --cur_tests->size;
+        status = run_one_test(config, state, srp, tst,
+                              agent,
+                              cur_test, cur_tests,
+                              far, exe_name, report_path, check_cmd,
+                              interactor_cmd, start_env,
+                              open_tests_count, open_tests_val,
+                              test_score_count, test_score_val,
+                              expected_free_space,
+                              &has_real_time, &has_max_memory_used,
+                              &has_max_rss,
+                              &report_time_limit_ms, &report_real_time_limit_ms,
+                              utf8_mode,
+                              mirror_dir, remaps,
+                              user_input_mode,
+                              inp_data,
+                              inp_size,
+                              src_path,
+                              test_dir,
+                              corr_dir,
+                              info_dir,
+                              tgz_dir,
+                              manifest);
+        if (cur_tests->data[cur_test].times > 0)
+          run_cpu_ms += cur_tests->data[cur_test].times;
+        samples[cur_sample] = cur_tests->data[cur_test];
+        samples[cur_sample++].status = status;
+        if (status != RUN_OK && status != RUN_TIME_LIMIT_ERR) break;
+        // the time limit is confirmed
+        if (cur_sample == 2 && samples[0].status == RUN_TIME_LIMIT_ERR
+            && status == RUN_TIME_LIMIT_ERR) break;
+      }
+      if (status != RUN_OK && status != RUN_TIME_LIMIT_ERR) {
+        // not a timing issue, the last run is reported as is
+        for (int i = 0; i < cur_sample - 1; ++i) {
+          free_testinfo(&samples[i]);
+        }
+      } else {
+        status = select_time_sample(samples, cur_sample,
+                                    srpp->tl_remeasure_median > 0,
+                                    &cur_tests->data[cur_test]);
+      }
+      xfree(samples);
+    }
+
+    if (cur_tests == &probe_tests) {
+      if (status < 0) {
+        probe_count = probe_pos;
+      } else {
+        probe_status[cur_test] = status;
+        if (status > 0) probe_count = probe_pos;
+      }
+      continue;
     }
 
     if (status < 0) {
@@ -5664,7 +7073,11 @@ run_tests(
       if (srgp->scoring_system_val == SCORE_KIROV && srpp->stop_on_first_fail > 0) {
         while (1) {
           ++cur_test;
-          if (!does_test_exist(config, state, srp, srpp->test_dir, cur_test)) break;
+          if (srpp->test_count > 0) {
+            if (cur_test > srpp->test_count) break;
+          } else if (!does_test_exist(config, state, srp, srpp->test_dir, cur_test)) {
+            break;
+          }
           append_skipped_test(srpp, cur_test, &tests,
                               open_tests_count, open_tests_val,
                               test_score_count, test_score_val);
@@ -5768,6 +7181,10 @@ run_tests(
     close(vefds[0]); vefds[0] = -1;
   }
 
+  if (collect_test_stats) {
+    update_test_stats(state, srp, &tests, srpp->test_count);
+  }
+
   /* TESTING COMPLETED */
   get_current_time(&reply_pkt->ts6, &reply_pkt->ts6_us);
 
@@ -6000,11 +7417,19 @@ done:;
   reply_pkt->user_score = user_score;
   reply_pkt->user_tests_passed = user_tests_passed;
 
+  if (far && full_archive_close_write(far) < 0) {
+    // the incomplete archive is removed and not sent
+    err("the archive of the run output is not available");
+    full_report_path[0] = 0;
+  }
+  far = NULL;
+
   generate_xml_report(srp, reply_pkt, report_path,
                       tests.size, tests.data, utf8_mode,
                       srgp->variant, total_score,
                       srpp->full_score, srpp->full_user_score,
                       srpp->use_corr, srpp->use_info,
+                      srgp->enable_full_archive > 0 && full_report_path[0],
                       report_time_limit_ms, report_real_time_limit_ms,
                       has_real_time, has_max_memory_used,
                       has_max_rss,
@@ -6026,8 +7451,12 @@ done:;
     task_Delete(valuer_tsk);
   }
 
-  if (far) full_archive_close(far);
   free_testinfo_vector(&tests);
+  probe_tests.size = probe_tests.reserved;
+  free_testinfo_vector(&probe_tests);
+  xfree(probe_order);
+  xfree(probe_status);
+  xfree(test_stats);
   xfree(open_tests_val);
   xfree(test_score_val);
   prepare_free_testsets(test_sets_count, test_sets_val);
@@ -1412,7 +1412,10 @@ cleanup:
   reply_pkt->ts7 = reply_pkt->ts6;
   reply_pkt->ts7_us = reply_pkt->ts6_us;
 
-  if (srgp->bson_available && testing_report_bson_available()) {
+  if (srgp->bson_available && srgp->enable_flatbuf_report > 0) {
+    if (testing_report_to_file_flatbuf(report_path, report_xml) < 0) {
+    }
+  } else if (srgp->bson_available && testing_report_bson_available()) {
     if (testing_report_to_file_bson(report_path, report_xml) < 0) {
     }
   } else {
@@ -57,6 +57,7 @@
 #include "ejudge/notify_plugin.h"
 #include "ejudge/cJSON.h"
 #include "ejudge/json_serializers.h"
+#include "ejudge/exe_store.h"
 
 #include "ejudge/xalloc.h"
 #include "ejudge/logger.h"
@@ -1809,6 +1810,7 @@ serve_compile_request(
     cp.preserve_numbers = 1;
   }
   cp.enable_remote_cache = (global->enable_remote_cache > 0);
+  cp.accept_exe_sha256 = 1;
 
   memset(&rx, 0, sizeof(rx));
   rx.accepting_mode = accepting_mode;
@@ -2077,6 +2079,8 @@ serve_run_request(
   unsigned char pkt_base[64];
   unsigned char exe_out_name[256];
   unsigned char exe_in_name[256];
+  unsigned char exe_in_path[PATH_MAX];
+  unsigned char exe_out_path[PATH_MAX];
   struct teamdb_export te;
   struct userlist_user_info *ui = 0;
 
@@ -2262,8 +2266,14 @@ serve_run_request(
     } else {
       snprintf(exe_in_name, sizeof(exe_in_name), "%06d%s", run_id, exe_sfx);
     }
-    if (generic_copy_file(REMOVE, compile_report_dir, exe_in_name, "",
-                          0, run_exe_dir,exe_out_name, "") < 0) {
+    snprintf(exe_in_path, sizeof(exe_in_path), "%s/%s", compile_report_dir, exe_in_name);
+    snprintf(exe_out_path, sizeof(exe_out_path), "%s/%s", run_exe_dir, exe_out_name);
+    if (comp_pkt && comp_pkt->has_exe_sha256 && exe_store_dir()
+        && exe_store_get(exe_store_dir(), comp_pkt->exe_sha256, exe_out_path) >= 0) {
+      // the executable is linked from the store, no copying
+      unlink(exe_in_path);
+    } else if (generic_copy_file(REMOVE, compile_report_dir, exe_in_name, "",
+                                 0, run_exe_dir,exe_out_name, "") < 0) {
       fprintf(errf, "copying failed");
       goto fail;
     }
@@ -2316,6 +2326,10 @@ serve_run_request(
   srgp->notify_flag = notify_flag;
   srgp->advanced_layout = global->advanced_layout;
   srgp->enable_full_archive = global->enable_full_archive;
+  srgp->enable_flatbuf_report = global->enable_flatbuf_report;
+  srgp->enable_perf_counters = global->enable_perf_counters;
+  srgp->perf_instructions_per_ms = global->perf_instructions_per_ms;
+  srgp->full_archive_threads = global->full_archive_threads;
   srgp->secure_run = secure_run;
   srgp->suid_run = suid_run;
   srgp->enable_container = prob->enable_container;
@@ -2365,6 +2379,7 @@ serve_run_request(
   }
   srgp->max_file_length = global->max_file_length;
   srgp->max_line_length = global->max_line_length;
+  srgp->max_file_tail_length = global->max_file_tail_length;
   srgp->max_cmd_length = global->max_cmd_length;
   if (time_limit_adj_millis > 0) {
     srgp->lang_time_limit_adj_ms = time_limit_adj_millis;
@@ -2417,7 +2432,7 @@ serve_run_request(
   srgp->zip_mode = zip_mode;
   srgp->contest_server_id = xstrdup(config->contest_server_id);
   if (submit_id > 0) {
-    srgp->bson_available = testing_report_bson_available();
+    srgp->bson_available = testing_report_bson_available() || global->enable_flatbuf_report > 0;
   } else {
     srgp->bson_available = (store_flags == STORE_FLAGS_UUID_BSON);
   }
@@ -2428,6 +2443,9 @@ serve_run_request(
   if (comp_pkt) {
     srgp->prepended_size = comp_pkt->prepended_size;
     srgp->cached_on_remote = comp_pkt->cached_on_remote;
+    if (comp_pkt->has_exe_sha256) {
+      srgp->exe_sha256 = xstrdup(unparse_sha256(comp_pkt->exe_sha256));
+    }
   }
   if (lang && lang->clean_up_cmd) {
     srgp->clean_up_cmd = xstrdup(lang->clean_up_cmd);
@@ -2726,6 +2744,14 @@ serve_run_request(
   srpp->max_file_size = prob->max_file_size;
   srpp->max_open_file_count = prob->max_open_file_count;
   srpp->max_process_count = prob->max_process_count;
+  srpp->probe_test_count = prob->probe_test_count;
+  srpp->tl_remeasure_count = prob->tl_remeasure_count;
+  srpp->tl_remeasure_margin = prob->tl_remeasure_margin;
+  srpp->tl_remeasure_median = prob->tl_remeasure_median;
+  srpp->enable_checker_cache = prob->enable_checker_cache;
+  srpp->checker_exact_match_ok = prob->checker_exact_match_ok;
+  srpp->test_generator_ignores_source = prob->test_generator_ignores_source;
+  srpp->checker_ignores_source = prob->checker_ignores_source;
   srpp->enable_process_group = prob->enable_process_group;
   srpp->enable_kill_all = prob->enable_kill_all;
   srgp->testlib_mode = prob->enable_testlib_mode;
@@ -3366,6 +3392,20 @@ serve_notify_run_update(
   free(jrstr);
 }
 
+/* the binary report: FlatBuffers, if enabled, or BSON */
+static int
+report_to_mem_binary(
+        const struct section_global_data *global,
+        char **pstr,
+        size_t *psize,
+        testing_report_xml_t tr)
+{
+  if (global->enable_flatbuf_report > 0) {
+    return testing_report_to_mem_flatbuf(pstr, psize, tr);
+  }
+  return testing_report_to_mem_bson(pstr, psize, tr);
+}
+
 static void
 read_compile_packet_input(
         struct contest_extra *extra,
@@ -3473,8 +3513,8 @@ read_compile_packet_input(
     txt_text = NULL; txt_size = 0;
     utf8_fix_string(tr->compiler_output, NULL);
     tr->compile_error = 1;
-    if (testing_report_bson_available()) {
-      testing_report_to_mem_bson(&txt_text, &txt_size, tr);
+    if (testing_report_bson_available() || cs->global->enable_flatbuf_report > 0) {
+      report_to_mem_binary(cs->global, &txt_text, &txt_size, tr);
       mime_type = MIME_TYPE_BSON;
     } else {
       testing_report_to_str(&txt_text, &txt_size, 1, tr);
@@ -3517,8 +3557,8 @@ read_compile_packet_input(
     txt_text = NULL; txt_size = 0;
     utf8_fix_string(tr->compiler_output, NULL);
     tr->compile_error = 1;
-    if (testing_report_bson_available()) {
-      testing_report_to_mem_bson(&txt_text, &txt_size, tr);
+    if (testing_report_bson_available() || cs->global->enable_flatbuf_report > 0) {
+      report_to_mem_binary(cs->global, &txt_text, &txt_size, tr);
       mime_type = MIME_TYPE_BSON;
     } else {
       testing_report_to_str(&txt_text, &txt_size, 1, tr);
@@ -3773,7 +3813,7 @@ serve_read_compile_packet(
 
     if (re.store_flags == STORE_FLAGS_UUID_BSON) {
       xfree(txt_text); txt_text = NULL; txt_size = 0;
-      testing_report_to_mem_bson(&txt_text, &txt_size, testing_report);
+      report_to_mem_binary(global, &txt_text, &txt_size, testing_report);
       rep_flags = uuid_archive_make_write_path(state, rep_path, sizeof(rep_path),
                                                &re.run_uuid, txt_size, DFLT_R_UUID_BSON_REPORT, -1);
     } else {
@@ -3871,7 +3911,7 @@ serve_read_compile_packet(
 
     if (re.store_flags == STORE_FLAGS_UUID_BSON) {
       xfree(txt_text); txt_text = NULL; txt_size = 0;
-      testing_report_to_mem_bson(&txt_text, &txt_size, testing_report);
+      report_to_mem_binary(global, &txt_text, &txt_size, testing_report);
       rep_flags = uuid_archive_make_write_path(state, rep_path, sizeof(rep_path),
                                                &re.run_uuid, txt_size, DFLT_R_UUID_BSON_REPORT, -1);
     } else {
@@ -4163,7 +4203,7 @@ prepare_run_request:
     testing_report->compile_error = 1;
     memcpy(&testing_report->uuid, &re.run_uuid, sizeof(testing_report->uuid));
     xfree(txt_text); txt_text = NULL; txt_size = 0;
-    testing_report_to_mem_bson(&txt_text, &txt_size, testing_report);
+    report_to_mem_binary(global, &txt_text, &txt_size, testing_report);
     rep_flags = uuid_archive_prepare_write_path(state, rep_path, sizeof(rep_path),
                                                 &re.run_uuid, txt_size, DFLT_R_UUID_BSON_REPORT, -1, 0);
   } else {
@@ -4452,8 +4492,8 @@ read_run_packet_input(
       tr->compiler_output = xstrdup(cp_tr->compiler_output);
     }
     free(rep_data); rep_data = NULL; rep_size = 0;
-    if (testing_report_bson_available()) {
-      testing_report_to_mem_bson(&rep_data, &rep_size, tr);
+    if (testing_report_bson_available() || cs->global->enable_flatbuf_report > 0) {
+      report_to_mem_binary(cs->global, &rep_data, &rep_size, tr);
       mime_type = MIME_TYPE_BSON;
     } else {
       testing_report_to_str(&rep_data, &rep_size, 1, tr);
@@ -4751,7 +4791,7 @@ serve_read_run_packet(
         if (new_tr && !new_tr->compiler_output) {
           new_tr->compiler_output = compiler_output; compiler_output = NULL;
           xfree(new_rep_text); new_rep_text = NULL; new_rep_len = 0;
-          testing_report_to_mem_bson(&new_rep_text, &new_rep_len, new_tr);
+          report_to_mem_binary(global, &new_rep_text, &new_rep_len, new_tr);
         }
         testing_report_free(new_tr); new_tr = NULL;
         xfree(compiler_output); compiler_output = NULL;
@@ -5089,7 +5129,7 @@ serve_judge_built_in_problem(
       testing_report_xml_t tr = testing_report_parse_xml(start_ptr);
       if (tr) {
         free(xml_buf); xml_buf = NULL; xml_len = 0;
-        testing_report_to_mem_bson(&xml_buf, &xml_len, tr);
+        report_to_mem_binary(global, &xml_buf, &xml_len, tr);
         testing_report_free(tr);
         rep_flags = uuid_archive_prepare_write_path(state, rep_path, sizeof(rep_path),
                                                     &re->run_uuid, xml_len, DFLT_R_UUID_BSON_REPORT, -1, 0);
@@ -5141,7 +5181,7 @@ serve_report_check_failed(
   tr->errors = xstrdup(error_text);
 
   if (re.store_flags == STORE_FLAGS_UUID_BSON) {
-    testing_report_to_mem_bson(&tr_t, &tr_z, tr);
+    report_to_mem_binary(global, &tr_t, &tr_z, tr);
     tr = testing_report_free(tr);
     flags = uuid_archive_prepare_write_path(state, tr_p, sizeof(tr_p),
                                             &re.run_uuid, tr_z, DFLT_R_UUID_BSON_REPORT, -1, 0);
@@ -259,6 +259,9 @@ serve_state_destroy(
   xfree(state->testers);
 
   xfree(state->user_results);
+  xfree(state->run_stats_dir);
+  xfree(state->run_manifest_dir);
+  xfree(state->run_gen_cache_dir);
 
   if (state->compiler_options) {
     for (i = 1; i <= state->max_lang; ++i) {
@@ -0,0 +1,501 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/spool_queue.h"
+#include "ejudge/dyntrie.h"
+#include "ejudge/random.h"
+#include "ejudge/errlog.h"
+#include "ejudge/osdeps.h"
+#include "ejudge/xalloc.h"
+#include "ejudge/fileutl.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+enum { PRIO_COUNT = 32 };
+
+struct spool_queue_heap
+{
+    unsigned char **names;
+    int a, u;
+};
+
+struct spool_queue
+{
+    unsigned char *dir_path;
+    int dfd;
+    int ifd;
+    int wd;
+    int quit_flag;
+    int rescan_flag;
+
+    struct spool_queue_heap heaps[PRIO_COUNT];
+    // names, which are in the heaps
+    struct dyntrie_node *present;
+    // ignored names, which are still in the directory
+    struct dyntrie_node *ignored;
+};
+
+/* the same priorities as in scan_dir */
+static int
+get_prio(const unsigned char *name)
+{
+    int prio;
+    if (name[0] >= '0' && name[0] <= '9') {
+        prio = -16 + (name[0] - '0');
+    } else if (name[0] >= 'A' && name[0] <= 'V') {
+        prio = -6 + (name[0] - 'A');
+    } else {
+        prio = 0;
+    }
+    if (prio < -16) prio = -16;
+    if (prio > 15) prio = 15;
+    return prio + 16;
+}
+
+static void
+heap_push(struct spool_queue_heap *h, unsigned char *name)
+{
+    if (h->u == h->a) {
+        if (!(h->a *= 2)) h->a = 32;
+        XREALLOC(h->names, h->a);
+    }
+    int i = h->u++;
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (strcmp(h->names[p], name) <= 0) break;
+        h->names[i] = h->names[p];
+        i = p;
+    }
+    h->names[i] = name;
+}
+
+static unsigned char *
+heap_pop(struct spool_queue_heap *h)
+{
+    unsigned char *res = h->names[0];
+    unsigned char *last = h->names[--h->u];
+    int i = 0;
+    while (1) {
+        int c = i * 2 + 1;
+        if (c >= h->u) break;
+        if (c + 1 < h->u && strcmp(h->names[c + 1], h->names[c]) < 0) ++c;
+        if (strcmp(last, h->names[c]) <= 0) break;
+        h->names[i] = h->names[c];
+        i = c;
+    }
+    if (h->u > 0) h->names[i] = last;
+    return res;
+}
+
+static void
+add_name(struct spool_queue *sq, const unsigned char *name)
+{
+    if (!strcmp(name, ".") || !strcmp(name, "..")) return;
+    if (!strcmp(name, "QUIT")) {
+        sq->quit_flag = 1;
+        return;
+    }
+    if (dyntrie_get(&sq->present, name)) return;
+    unsigned char *s = xstrdup(name);
+    dyntrie_insert(&sq->present, s, s, 0, NULL);
+    heap_push(&sq->heaps[get_prio(s)], s);
+}
+
+static void
+clear_heaps(struct spool_queue *sq)
+{
+    for (int i = 0; i < PRIO_COUNT; ++i) {
+        struct spool_queue_heap *h = &sq->heaps[i];
+        for (int j = 0; j < h->u; ++j) {
+            xfree(h->names[j]);
+        }
+        h->u = 0;
+    }
+    dyntrie_free(&sq->present, NULL, NULL);
+}
+
+static int
+rescan(struct spool_queue *sq)
+{
+    DIR *d = NULL;
+    struct dirent *de;
+    struct dyntrie_node *new_ignored = NULL;
+
+    if (sq->wd < 0) {
+        // the directory may have been replaced
+        if (sq->dfd >= 0) close(sq->dfd);
+        if ((sq->dfd = open(sq->dir_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC, 0)) < 0) {
+            err("spool_queue: open '%s' failed: %s", sq->dir_path, os_ErrorMsg());
+            return -1;
+        }
+        sq->wd = inotify_add_watch(sq->ifd, sq->dir_path,
+                                   IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM);
+        if (sq->wd < 0) {
+            err("spool_queue: inotify_add_watch '%s' failed: %s",
+                sq->dir_path, os_ErrorMsg());
+            return -1;
+        }
+    }
+
+    clear_heaps(sq);
+    sq->quit_flag = 0;
+    if (!(d = opendir(sq->dir_path))) {
+        err("spool_queue: opendir '%s' failed: %s", sq->dir_path, os_ErrorMsg());
+        return -1;
+    }
+    while ((de = readdir(d))) {
+        if (dyntrie_get(&sq->ignored, de->d_name)) {
+            dyntrie_insert(&new_ignored, de->d_name, (void*) 1, 1, NULL);
+            continue;
+        }
+        add_name(sq, de->d_name);
+    }
+    closedir(d);
+
+    // forget the ignored packets, which are gone
+    dyntrie_free(&sq->ignored, NULL, NULL);
+    sq->ignored = new_ignored;
+    sq->rescan_flag = 0;
+    return 0;
+}
+
+struct spool_queue *
+spool_queue_create(const unsigned char *spool_dir)
+{
+    struct spool_queue *sq = NULL;
+    unsigned char path[PATH_MAX];
+
+    if (snprintf(path, sizeof(path), "%s/dir", spool_dir) >= sizeof(path)) {
+        err("spool_queue: path is too long");
+        return NULL;
+    }
+
+    XCALLOC(sq, 1);
+    sq->dir_path = xstrdup(path);
+    sq->dfd = -1;
+    sq->ifd = -1;
+    sq->wd = -1;
+    if ((sq->ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0) {
+        err("spool_queue: inotify_init1 failed: %s", os_ErrorMsg());
+        goto fail;
+    }
+    if (rescan(sq) < 0) goto fail;
+    return sq;
+
+fail:;
+    spool_queue_free(sq);
+    return NULL;
+}
+
+void
+spool_queue_free(struct spool_queue *sq)
+{
+    if (!sq) return;
+
+    clear_heaps(sq);
+    for (int i = 0; i < PRIO_COUNT; ++i) {
+        xfree(sq->heaps[i].names);
+    }
+    dyntrie_free(&sq->ignored, NULL, NULL);
+    if (sq->ifd >= 0) close(sq->ifd);
+    if (sq->dfd >= 0) close(sq->dfd);
+    xfree(sq->dir_path);
+    xfree(sq);
+}
+
+int
+spool_queue_fd(const struct spool_queue *sq)
+{
+    return sq->ifd;
+}
+
+int
+spool_queue_update(struct spool_queue *sq)
+{
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (1) {
+        ssize_t r = read(sq->ifd, buf, sizeof(buf));
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0 && errno == EAGAIN) break;
+        if (r < 0) {
+            err("spool_queue: read failed: %s", os_ErrorMsg());
+            return -1;
+        }
+        if (!r) break;
+
+        const char *p = buf;
+        const char *bend = buf + r;
+        while (p < bend) {
+            const struct inotify_event *ev = (const struct inotify_event *) p;
+            p += sizeof(*ev) + ev->len;
+            if ((ev->mask & IN_Q_OVERFLOW)) {
+                sq->rescan_flag = 1;
+            } else if ((ev->mask & IN_IGNORED)) {
+                // the directory was removed or replaced
+                sq->wd = -1;
+                sq->rescan_flag = 1;
+            } else if (ev->wd != sq->wd || !ev->len) {
+                // nothing
+            } else if ((ev->mask & (IN_CREATE | IN_MOVED_TO))) {
+                if (!dyntrie_get(&sq->ignored, ev->name)) {
+                    add_name(sq, ev->name);
+                }
+            } else if ((ev->mask & (IN_DELETE | IN_MOVED_FROM)) && sq->ignored) {
+                dyntrie_remove(&sq->ignored, ev->name, NULL);
+            }
+        }
+    }
+
+    if (sq->rescan_flag) {
+        return rescan(sq);
+    }
+    return 0;
+}
+
+/* the first packet of the priority, which is still in the directory */
+static const unsigned char *
+get_top(struct spool_queue *sq, int prio)
+{
+    struct spool_queue_heap *h = &sq->heaps[prio];
+    struct stat stb;
+
+    while (h->u > 0) {
+        unsigned char *name = h->names[0];
+        if (!dyntrie_get(&sq->ignored, name)
+            && fstatat(sq->dfd, name, &stb, AT_SYMLINK_NOFOLLOW) >= 0) {
+            return name;
+        }
+        heap_pop(h);
+        dyntrie_remove(&sq->present, name, NULL);
+        xfree(name);
+    }
+    return NULL;
+}
+
+int
+spool_queue_get(
+        struct spool_queue *sq,
+        char *found_item,
+        size_t fi_size,
+        int random_mode)
+{
+    const unsigned char *items[PRIO_COUNT];
+    int low_prio = PRIO_COUNT, high_prio = -1;
+    struct stat stb;
+
+    if (spool_queue_update(sq) < 0) {
+        return -EIO;
+    }
+
+    if (sq->quit_flag) {
+        if (!dyntrie_get(&sq->ignored, "QUIT")
+            && fstatat(sq->dfd, "QUIT", &stb, AT_SYMLINK_NOFOLLOW) >= 0) {
+            snprintf(found_item, fi_size, "%s", "QUIT");
+            info("spool_queue: found QUIT packet");
+            return 1;
+        }
+        sq->quit_flag = 0;
+    }
+
+    for (int prio = 0; prio < PRIO_COUNT; ++prio) {
+        items[prio] = get_top(sq, prio);
+        if (items[prio]) {
+            if (prio < low_prio) low_prio = prio;
+            high_prio = prio;
+            if (!random_mode) break;
+        }
+    }
+    if (high_prio < 0) return 0;
+
+    if (random_mode && low_prio != high_prio) {
+        int range = high_prio - low_prio + 1;
+        unsigned long long mask = (1ULL << range) - 1;
+        unsigned long long value = 0;
+
+        random_init();
+
+        if (range < 16) {
+            value = random_u16() & mask;
+        } else if (range == 16) {
+            value = random_u16();
+        } else if (range < 32) {
+            value = random_u32() & mask;
+        } else if (range == 32) {
+            value = random_u32();
+        } else {
+            value = random_u64() & mask;
+        }
+        for (int i = high_prio; i > low_prio; --i) {
+            if (items[i]) {
+                if (!value) {
+                    low_prio = i;
+                    break;
+                }
+                --value;
+            }
+            value >>= 1;
+        }
+    }
+
+    snprintf(found_item, fi_size, "%s", items[low_prio]);
+    info("spool_queue: found '%s' (priority %d)", found_item, low_prio - 16);
+    return 1;
+}
+
+void
+spool_queue_add_ignored(struct spool_queue *sq, const unsigned char *name)
+{
+    if (!name || !*name) return;
+    dyntrie_insert(&sq->ignored, name, (void*) 1, 1, NULL);
+}
+
+/* returns the packets of a claim directory to the spool */
+static void
+recover_claim_dir(const unsigned char *spool_dir, const unsigned char *claim_dir)
+{
+    DIR *d;
+    struct dirent *dd;
+
+    if (!(d = opendir(claim_dir))) return;
+    while ((dd = readdir(d))) {
+        if (!strcmp(dd->d_name, ".") || !strcmp(dd->d_name, "..")) continue;
+        info("spool_queue: returning claimed packet '%s' from '%s'", dd->d_name, claim_dir);
+        // a concurrent recovery might move it first
+        if (spool_claim_return(spool_dir, claim_dir, dd->d_name) < 0 && errno != ENOENT) {
+            err("spool_queue: failed to return '%s/%s': %s", claim_dir, dd->d_name, os_ErrorMsg());
+        }
+    }
+    closedir(d);
+    rmdir(claim_dir);
+}
+
+int
+spool_claim_init(
+        const unsigned char *spool_dir,
+        unsigned char *claim_dir,
+        size_t claim_dir_size)
+{
+    unsigned char base_dir[PATH_MAX];
+    unsigned char path[PATH_MAX];
+    const unsigned char *node = os_NodeName();
+    size_t node_len = strlen(node);
+    DIR *d;
+    struct dirent *dd;
+
+    if (snprintf(base_dir, sizeof(base_dir), "%s/claim", spool_dir) >= sizeof(base_dir)) return -1;
+    if (mkdir(base_dir, 0700) < 0 && errno != EEXIST) {
+        err("spool_queue: mkdir '%s' failed: %s", base_dir, os_ErrorMsg());
+        return -1;
+    }
+
+    // the spool directory may be shared by several hosts
+    if ((d = opendir(base_dir))) {
+        while ((dd = readdir(d))) {
+            if (strncmp(dd->d_name, node, node_len) || dd->d_name[node_len] != '.') continue;
+            char *eptr = NULL;
+            errno = 0;
+            long pid = strtol(dd->d_name + node_len + 1, &eptr, 10);
+            if (errno || *eptr || pid <= 0 || pid > INT_MAX) continue;
+            // the same pid is left by a previous process
+            if (pid != getpid() && (kill(pid, 0) >= 0 || errno != ESRCH)) continue;
+            snprintf(path, sizeof(path), "%s/%s", base_dir, dd->d_name);
+            recover_claim_dir(spool_dir, path);
+        }
+        closedir(d);
+    }
+
+    if (snprintf(claim_dir, claim_dir_size, "%s/%s.%d", base_dir, node, (int) getpid()) >= claim_dir_size) {
+        return -1;
+    }
+    if (mkdir(claim_dir, 0700) < 0) {
+        err("spool_queue: mkdir '%s' failed: %s", claim_dir, os_ErrorMsg());
+        return -1;
+    }
+    return 0;
+}
+
+void
+spool_claim_fini(const unsigned char *claim_dir)
+{
+    if (!claim_dir || !*claim_dir) return;
+    if (rmdir(claim_dir) < 0) {
+        err("spool_queue: rmdir '%s' failed: %s", claim_dir, os_ErrorMsg());
+    }
+}
+
+int
+spool_claim_packet(
+        const unsigned char *spool_dir,
+        const unsigned char *claim_dir,
+        const unsigned char *name,
+        char **p_data,
+        size_t *p_size)
+{
+    unsigned char spool_path[PATH_MAX];
+    unsigned char claim_path[PATH_MAX];
+
+    if (snprintf(spool_path, sizeof(spool_path), "%s/dir/%s", spool_dir, name) >= sizeof(spool_path)) return -1;
+    if (snprintf(claim_path, sizeof(claim_path), "%s/%s", claim_dir, name) >= sizeof(claim_path)) return -1;
+    if (rename(spool_path, claim_path) < 0) {
+        if (errno == ENOENT) return 0;
+        err("spool_queue: rename '%s' failed: %s", spool_path, os_ErrorMsg());
+        return -1;
+    }
+    int r = generic_read_file(p_data, 0, p_size, 0, claim_dir, name, "");
+    if (r < 0) {
+        // the packet cannot be handled, so it is not returned
+        unlink(claim_path);
+        return r;
+    }
+    return 1;
+}
+
+void
+spool_claim_remove(
+        const unsigned char *claim_dir,
+        const unsigned char *name)
+{
+    unsigned char path[PATH_MAX];
+
+    if (snprintf(path, sizeof(path), "%s/%s", claim_dir, name) >= sizeof(path)) return;
+    if (unlink(path) < 0 && errno != ENOENT) {
+        err("spool_queue: unlink '%s' failed: %s", path, os_ErrorMsg());
+    }
+}
+
+int
+spool_claim_return(
+        const unsigned char *spool_dir,
+        const unsigned char *claim_dir,
+        const unsigned char *name)
+{
+    unsigned char spool_path[PATH_MAX];
+    unsigned char claim_path[PATH_MAX];
+
+    if (snprintf(spool_path, sizeof(spool_path), "%s/dir/%s", spool_dir, name) >= sizeof(spool_path)) return -1;
+    if (snprintf(claim_path, sizeof(claim_path), "%s/%s", claim_dir, name) >= sizeof(claim_path)) return -1;
+    return rename(claim_path, spool_path);
+}
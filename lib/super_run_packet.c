@@ -40,8 +40,13 @@ super_run_in_global_packet_init(struct generic_section_config *gp)
   p->is_virtual = -1;
   p->max_file_length = -1;
   p->max_line_length = -1;
+  p->max_file_tail_length = -1;
   p->max_cmd_length = -1;
   p->enable_full_archive = -1;
+  p->enable_flatbuf_report = -1;
+  p->enable_perf_counters = -1;
+  p->perf_instructions_per_ms = -1;
+  p->full_archive_threads = -1;
   p->run_id = -1;
   p->accepting_mode = -1;
   p->separate_user_score = -1;
@@ -73,8 +78,13 @@ super_run_in_global_packet_set_default(struct generic_section_config *gp)
   if (p->is_virtual < 0) p->is_virtual = 0;
   if (p->max_file_length < 0) p->max_file_length = 0;
   if (p->max_line_length < 0) p->max_line_length = 0;
+  if (p->max_file_tail_length < 0) p->max_file_tail_length = 0;
   if (p->max_cmd_length < 0) p->max_cmd_length = 0;
   if (p->enable_full_archive < 0) p->enable_full_archive = 0;
+  if (p->enable_flatbuf_report < 0) p->enable_flatbuf_report = 0;
+  if (p->enable_perf_counters < 0) p->enable_perf_counters = 0;
+  if (p->perf_instructions_per_ms < 0) p->perf_instructions_per_ms = 0;
+  if (p->full_archive_threads < 0) p->full_archive_threads = 0;
   if (p->run_id < 0) p->run_id = 0;
   if (p->accepting_mode < 0) p->accepting_mode = 0;
   if (p->separate_user_score < 0) p->separate_user_score = 0;
@@ -160,6 +170,14 @@ super_run_in_problem_packet_init(struct generic_section_config *gp)
   p->enable_control_socket = -1;
   p->test_count = -1;
   p->disable_vm_size_limit = -1;
+  p->probe_test_count = -1;
+  p->tl_remeasure_count = -1;
+  p->tl_remeasure_margin = -1;
+  p->tl_remeasure_median = -1;
+  p->enable_checker_cache = -1;
+  p->checker_exact_match_ok = -1;
+  p->test_generator_ignores_source = -1;
+  p->checker_ignores_source = -1;
 
   p->type_val = -1;
 }
@@ -205,6 +223,14 @@ super_run_in_problem_packet_set_default(struct generic_section_config *gp)
   if (p->disable_stderr < 0) p->disable_stderr = 0;
   if (p->max_open_file_count < 0) p->max_open_file_count = 0;
   if (p->max_process_count < 0) p->max_process_count = 0;
+  if (p->probe_test_count < 0) p->probe_test_count = 0;
+  if (p->tl_remeasure_count < 0) p->tl_remeasure_count = 0;
+  if (p->tl_remeasure_margin < 0) p->tl_remeasure_margin = 0;
+  if (p->tl_remeasure_median < 0) p->tl_remeasure_median = 0;
+  if (p->enable_checker_cache < 0) p->enable_checker_cache = 0;
+  if (p->checker_exact_match_ok < 0) p->checker_exact_match_ok = 0;
+  if (p->test_generator_ignores_source < 0) p->test_generator_ignores_source = 0;
+  if (p->checker_ignores_source < 0) p->checker_ignores_source = 0;
 
   if (p->type_val < 0) {
     p->type_val = problem_parse_type(p->type);
@@ -0,0 +1,272 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/config.h"
+#include "ejudge/super_run_progress.h"
+#include "ejudge/ej_uuid.h"
+#include "ejudge/errlog.h"
+#include "ejudge/osdeps.h"
+#include "ejudge/xalloc.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define PROGRESS_FILE_NAME "progress"
+#define PROGRESS_MAGIC     0x50527345U  /* "EsRP" */
+#define PROGRESS_VERSION   1
+#define READ_ATTEMPTS      64
+
+struct progress_slot
+{
+    unsigned seq;               // odd while the slot is being updated
+    int owner;                  // the owner pid, 0 if free
+    struct super_run_progress_info info;
+} __attribute__((aligned(64)));
+
+struct progress_table
+{
+    unsigned magic;
+    unsigned version;
+    unsigned slot_size;
+    unsigned slot_count;
+    unsigned char pad[48];
+    struct progress_slot slots[SUPER_RUN_PROGRESS_SLOTS];
+};
+
+struct super_run_progress
+{
+    struct progress_table *table;
+    int slot;                   // owned slot, -1 if none
+    int pid;
+};
+
+struct super_run_progress *
+super_run_progress_open(
+        const unsigned char *heartbeat_dir,
+        int writer_flag)
+{
+    unsigned char path[PATH_MAX];
+    struct stat stb;
+    struct super_run_progress *srp = NULL;
+    void *ptr = MAP_FAILED;
+    int fd = -1;
+
+    if (!heartbeat_dir || !*heartbeat_dir) return NULL;
+    /*
+     * the heartbeat directory may be shared by the invokers of several
+     * hosts, but the slot owners are checked by pid, and the mapping
+     * is coherent only within a host, so each host has its own table
+     */
+    if (snprintf(path, sizeof(path), "%s/%s.%s", heartbeat_dir, PROGRESS_FILE_NAME,
+                 os_NodeName()) >= sizeof(path)) {
+        return NULL;
+    }
+
+    if (writer_flag) {
+        fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+        if (fd < 0) {
+            err("super_run_progress: cannot open '%s': %s", path, os_ErrorMsg());
+            goto fail;
+        }
+    } else {
+        // the table does not exist until some ej-super-run creates it
+        if ((fd = open(path, O_RDONLY | O_CLOEXEC, 0)) < 0) goto fail;
+    }
+    if (fstat(fd, &stb) < 0) {
+        err("super_run_progress: fstat failed: %s", os_ErrorMsg());
+        goto fail;
+    }
+    if (!S_ISREG(stb.st_mode)) {
+        err("super_run_progress: '%s' is not a regular file", path);
+        goto fail;
+    }
+    if (stb.st_size != sizeof(struct progress_table)) {
+        if (!writer_flag) goto fail;
+        if (stb.st_size != 0) {
+            err("super_run_progress: '%s' has invalid size", path);
+            goto fail;
+        }
+        // several instances may race here, but they set the same size
+        if (ftruncate(fd, sizeof(struct progress_table)) < 0) {
+            err("super_run_progress: ftruncate failed: %s", os_ErrorMsg());
+            goto fail;
+        }
+    }
+
+    ptr = mmap(NULL, sizeof(struct progress_table),
+               writer_flag?(PROT_READ | PROT_WRITE):PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        err("super_run_progress: mmap failed: %s", os_ErrorMsg());
+        goto fail;
+    }
+    close(fd); fd = -1;
+
+    struct progress_table *table = ptr;
+    if (writer_flag && !__atomic_load_n(&table->magic, __ATOMIC_ACQUIRE)) {
+        table->version = PROGRESS_VERSION;
+        table->slot_size = sizeof(struct progress_slot);
+        table->slot_count = SUPER_RUN_PROGRESS_SLOTS;
+        __atomic_store_n(&table->magic, PROGRESS_MAGIC, __ATOMIC_RELEASE);
+    }
+    if (__atomic_load_n(&table->magic, __ATOMIC_ACQUIRE) != PROGRESS_MAGIC
+        || table->version != PROGRESS_VERSION
+        || table->slot_size != sizeof(struct progress_slot)
+        || table->slot_count != SUPER_RUN_PROGRESS_SLOTS) {
+        if (writer_flag) err("super_run_progress: '%s' is invalid", path);
+        goto fail;
+    }
+
+    XCALLOC(srp, 1);
+    srp->table = table;
+    srp->slot = -1;
+    srp->pid = getpid();
+    return srp;
+
+fail:;
+    if (ptr != MAP_FAILED) munmap(ptr, sizeof(struct progress_table));
+    if (fd >= 0) close(fd);
+    return NULL;
+}
+
+void
+super_run_progress_close(struct super_run_progress *srp)
+{
+    if (!srp) return;
+    super_run_progress_release(srp);
+    munmap(srp->table, sizeof(struct progress_table));
+    xfree(srp);
+}
+
+static int
+is_dead(int pid)
+{
+    return pid > 0 && kill(pid, 0) < 0 && errno == ESRCH;
+}
+
+int
+super_run_progress_acquire(
+        struct super_run_progress *srp,
+        const unsigned char *file_name)
+{
+    if (!srp) return -1;
+    if (srp->slot >= 0) return srp->slot;
+
+    for (int i = 0; i < SUPER_RUN_PROGRESS_SLOTS; ++i) {
+        struct progress_slot *s = &srp->table->slots[i];
+        int owner = __atomic_load_n(&s->owner, __ATOMIC_ACQUIRE);
+        if (owner == srp->pid) {
+            // left by the previous process with the same pid
+        } else if (owner && !is_dead(owner)) {
+            continue;
+        }
+        if (!__atomic_compare_exchange_n(&s->owner, &owner, srp->pid, 0,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        srp->slot = i;
+
+        struct super_run_progress_info info = {};
+        info.pid = srp->pid;
+        if (file_name) snprintf(info.file_name, sizeof(info.file_name), "%s", file_name);
+        super_run_progress_update(srp, &info);
+        return i;
+    }
+
+    err("super_run_progress: no free slots");
+    return -1;
+}
+
+void
+super_run_progress_release(struct super_run_progress *srp)
+{
+    if (!srp || srp->slot < 0) return;
+    struct progress_slot *s = &srp->table->slots[srp->slot];
+    __atomic_store_n(&s->owner, 0, __ATOMIC_RELEASE);
+    srp->slot = -1;
+}
+
+void
+super_run_progress_update(
+        struct super_run_progress *srp,
+        const struct super_run_progress_info *info)
+{
+    if (!srp || srp->slot < 0) return;
+    struct progress_slot *s = &srp->table->slots[srp->slot];
+
+    // the only writer of the slot, so plain increments are enough
+    unsigned seq = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+    // the previous owner might have died in the middle of the update
+    if ((seq & 1)) ++seq;
+    __atomic_store_n(&s->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&s->info, info, sizeof(s->info));
+    s->info.pid = srp->pid;
+    __atomic_store_n(&s->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+int
+super_run_progress_read(
+        const struct super_run_progress *srp,
+        int index,
+        struct super_run_progress_info *info)
+{
+    if (!srp || index < 0 || index >= SUPER_RUN_PROGRESS_SLOTS) return 0;
+    const struct progress_slot *s = &srp->table->slots[index];
+
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+        int owner = __atomic_load_n(&s->owner, __ATOMIC_ACQUIRE);
+        if (!owner || is_dead(owner)) return 0;
+        unsigned seq1 = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        if ((seq1 & 1)) continue;
+        memcpy(info, &s->info, sizeof(*info));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        unsigned seq2 = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+        if (seq1 == seq2) {
+            info->file_name[sizeof(info->file_name) - 1] = 0;
+            return 1;
+        }
+    }
+    // the writer is too busy, or it died in the middle of the update
+    return 0;
+}
+
+int
+super_run_progress_find(
+        const struct super_run_progress *srp,
+        const ej_uuid_t *run_uuid,
+        int contest_id,
+        int run_id,
+        struct super_run_progress_info *info)
+{
+    int has_uuid = run_uuid && ej_uuid_is_nonempty(*run_uuid);
+
+    if (!srp) return 0;
+    for (int i = 0; i < SUPER_RUN_PROGRESS_SLOTS; ++i) {
+        if (!super_run_progress_read(srp, i, info)) continue;
+        if (info->contest_id != contest_id || info->run_id != run_id) continue;
+        if (has_uuid && ej_uuid_is_nonempty(info->run_uuid)
+            && memcmp(&info->run_uuid, run_uuid, sizeof(*run_uuid)) != 0) continue;
+        return 1;
+    }
+    return 0;
+}
@@ -17,6 +17,7 @@
 #include "ejudge/config.h"
 #include "ejudge/ej_limits.h"
 #include "ejudge/super_run_status.h"
+#include "ejudge/super_run_progress.h"
 #include "ejudge/agent_client.h"
 
 #include "ejudge/xalloc.h"
@@ -260,6 +261,63 @@ super_run_status_read(
     return 0;
 }
 
+/*
+ * the status files are saved once in several seconds, so the fresher
+ * data from the live progress table of the local invokers is merged in
+ */
+static void
+super_run_status_apply_progress(
+        const unsigned char *heartbeat_dir,
+        struct super_run_status_vector *v,
+        int first)
+{
+    if (first >= v->u) return;
+    struct super_run_progress *srp = super_run_progress_open(heartbeat_dir, 0);
+    if (!srp) return;
+
+    for (int i = 0; i < SUPER_RUN_PROGRESS_SLOTS; ++i) {
+        struct super_run_progress_info info;
+        if (!super_run_progress_read(srp, i, &info)) continue;
+        if (!info.file_name[0] || info.update_ms <= 0) continue;
+        struct super_run_status_vector_item *vi = NULL;
+        for (int j = first; j < v->u; ++j) {
+            if (v->v[j]->file && !strcmp(v->v[j]->file, info.file_name)) {
+                vi = v->v[j];
+                break;
+            }
+        }
+        if (!vi || vi->status.super_run_pid != info.pid) continue;
+        struct super_run_status *srs = &vi->status;
+        if (info.update_ms < srs->timestamp) continue;
+
+        if (info.status == SRS_TESTING) {
+            if (srs->status != SRS_TESTING || srs->contest_id != info.contest_id
+                || srs->run_id != info.run_id) {
+                // the strings in the status file are for another run
+                srs->pkt_name_idx = 0;
+                srs->user_idx = 0;
+                srs->prob_idx = 0;
+                srs->lang_idx = 0;
+                srs->queue_ts = 0;
+            }
+            srs->contest_id = info.contest_id;
+            srs->run_id = info.run_id;
+            srs->test_num = info.test_num;
+            srs->test_count = info.test_count;
+            srs->testing_start_ts = info.start_ms;
+            srs->last_run_ts = info.update_ms;
+            vi->has_progress = 1;
+            vi->cpu_ms = info.cpu_ms;
+        } else if (info.status == SRS_WAITING) {
+            srs->last_run_ts = info.start_ms;
+        }
+        if (info.status > SRS_UNKNOWN) srs->status = info.status;
+        srs->timestamp = info.update_ms;
+    }
+
+    super_run_progress_close(srp);
+}
+
 void
 super_run_status_scan(
         const unsigned char *queue,
@@ -268,6 +326,7 @@ super_run_status_scan(
 {
     if (!heartbeat_dir) return;
 
+    int first = v->u;
     unsigned char dpath[PATH_MAX];
     snprintf(dpath, sizeof(dpath), "%s/dir", heartbeat_dir);
 
@@ -291,6 +350,8 @@ super_run_status_scan(
         super_run_status_vector_add(v, &srs, queue, dd->d_name);
     }
     closedir(d);
+
+    super_run_status_apply_progress(heartbeat_dir, v, first);
 }
 
 /*
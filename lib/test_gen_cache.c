@@ -0,0 +1,394 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/test_gen_cache.h"
+#include "ejudge/sha256.h"
+#include "ejudge/misctext.h"
+#include "ejudge/fileutl.h"
+#include "ejudge/xalloc.h"
+#include "ejudge/errlog.h"
+#include "ejudge/osdeps.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/file.h>
+
+/*
+ * The cache layout:
+ * <cache_dir>/<key in hex>/<generated files> - the complete entries,
+ * <cache_dir>/<key in hex>/.manifest - the file count and the total size,
+ * <cache_dir>/.tmp.<pid> - the entry being stored,
+ * <cache_dir>/.del.<pid>.<n> - the entries being removed,
+ * <cache_dir>/.lock - held shared while an entry is copied out,
+ * and exclusive while the entries to remove are selected.
+ * An entry is renamed into place when all its files are written, and
+ * renamed away before it is removed, the mtime of the entry directory
+ * is the last use time.
+ */
+#define KEY_VERSION "ejudge-test-gen-cache 2"
+#define MANIFEST_NAME ".manifest"
+#define LOCK_NAME ".lock"
+// the leftovers of the dead processes are removed after this time
+#define STALE_TIMEOUT 3600
+
+int
+test_gen_cache_make_key(
+        const unsigned char *generator_path,
+        char **argv,
+        char **envp,
+        unsigned char key[32])
+{
+    SHA256_CTX ctx;
+    unsigned char buf[65536];
+    struct stat stb;
+    int fd = -1;
+
+    if ((fd = open(generator_path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0)) < 0) {
+        return -1;
+    }
+    if (fstat(fd, &stb) < 0 || !S_ISREG(stb.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    sha256_init(&ctx);
+    sha256_update(&ctx, (const unsigned char *) KEY_VERSION, sizeof(KEY_VERSION));
+    while (1) {
+        ssize_t r = read(fd, buf, sizeof(buf));
+        if (r < 0) {
+            err("test_gen_cache: read error on '%s': %s", generator_path, os_ErrorMsg());
+            close(fd);
+            return -1;
+        }
+        if (!r) break;
+        sha256_update(&ctx, buf, r);
+    }
+    close(fd);
+
+    // the strings are separated by \0, the lists by \1
+    sha256_update(&ctx, (const unsigned char *) "\1", 1);
+    for (int i = 0; argv && argv[i]; ++i) {
+        sha256_update(&ctx, (const unsigned char *) argv[i], strlen(argv[i]) + 1);
+    }
+    sha256_update(&ctx, (const unsigned char *) "\1", 1);
+    for (int i = 0; envp && envp[i]; ++i) {
+        sha256_update(&ctx, (const unsigned char *) envp[i], strlen(envp[i]) + 1);
+    }
+    sha256_final(&ctx, key);
+    return 0;
+}
+
+static int
+make_entry_path(
+        unsigned char *buf,
+        size_t size,
+        const unsigned char *cache_dir,
+        const unsigned char key[32])
+{
+    if (snprintf(buf, size, "%s/%s", cache_dir, unparse_sha256(key)) >= size) {
+        return -1;
+    }
+    return 0;
+}
+
+static int
+lock_cache(const unsigned char *cache_dir, int operation)
+{
+    unsigned char path[PATH_MAX];
+    int fd;
+
+    if (snprintf(path, sizeof(path), "%s/%s", cache_dir, LOCK_NAME) >= sizeof(path)) return -1;
+    if ((fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | O_NOCTTY, 0600)) < 0) return -1;
+    if (flock(fd, operation) < 0) {
+        err("test_gen_cache: flock '%s' failed: %s", path, os_ErrorMsg());
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int
+write_manifest(const unsigned char *dir, int count, long long size)
+{
+    unsigned char path[PATH_MAX];
+    FILE *f;
+
+    if (snprintf(path, sizeof(path), "%s/%s", dir, MANIFEST_NAME) >= sizeof(path)) return -1;
+    if (!(f = fopen(path, "w"))) return -1;
+    fprintf(f, "%d %lld\n", count, size);
+    if (ferror(f)) {
+        fclose(f);
+        return -1;
+    }
+    if (fclose(f) < 0) return -1;
+    return 0;
+}
+
+static int
+read_manifest(const unsigned char *dir, int *p_count, long long *p_size)
+{
+    unsigned char path[PATH_MAX];
+    FILE *f;
+    int r;
+
+    if (snprintf(path, sizeof(path), "%s/%s", dir, MANIFEST_NAME) >= sizeof(path)) return -1;
+    if (!(f = fopen(path, "r"))) return -1;
+    r = fscanf(f, "%d%lld", p_count, p_size);
+    fclose(f);
+    if (r != 2 || *p_count < 0 || *p_size < 0) return -1;
+    return 0;
+}
+
+/*
+ * copies the regular files from 'src_dir' to 'dst_dir',
+ * returns the total size or -1 on error or if 'src_dir' has subdirectories,
+ * the manifest is not copied from the cache and is not accepted into it
+ */
+static long long
+copy_files(
+        const unsigned char *src_dir,
+        const unsigned char *dst_dir,
+        int from_cache,
+        int *p_count)
+{
+    DIR *d = NULL;
+    struct dirent *dd;
+    struct stat stb;
+    unsigned char src_path[PATH_MAX];
+    unsigned char dst_path[PATH_MAX];
+    long long total = 0;
+    int count = 0;
+
+    if (!(d = opendir(src_dir))) return -1;
+    while ((dd = readdir(d))) {
+        if (!strcmp(dd->d_name, ".") || !strcmp(dd->d_name, "..")) continue;
+        if (!strcmp(dd->d_name, MANIFEST_NAME)) {
+            if (from_cache) continue;
+            goto fail;
+        }
+        if (snprintf(src_path, sizeof(src_path), "%s/%s", src_dir, dd->d_name) >= sizeof(src_path)) goto fail;
+        if (snprintf(dst_path, sizeof(dst_path), "%s/%s", dst_dir, dd->d_name) >= sizeof(dst_path)) goto fail;
+        if (lstat(src_path, &stb) < 0 || !S_ISREG(stb.st_mode)) goto fail;
+        if (fast_copy_file(src_path, dst_path) < 0) goto fail;
+        total += stb.st_size;
+        ++count;
+    }
+    closedir(d);
+    *p_count = count;
+    return total;
+
+fail:;
+    closedir(d);
+    return -1;
+}
+
+static long long
+get_entry_size(const unsigned char *entry_dir)
+{
+    DIR *d = NULL;
+    struct dirent *dd;
+    struct stat stb;
+    unsigned char path[PATH_MAX];
+    long long total = 0;
+
+    if (!(d = opendir(entry_dir))) return 0;
+    while ((dd = readdir(d))) {
+        if (!strcmp(dd->d_name, ".") || !strcmp(dd->d_name, "..")) continue;
+        snprintf(path, sizeof(path), "%s/%s", entry_dir, dd->d_name);
+        if (lstat(path, &stb) >= 0 && S_ISREG(stb.st_mode)) total += stb.st_size;
+    }
+    closedir(d);
+    return total;
+}
+
+int
+test_gen_cache_lookup(
+        const unsigned char *cache_dir,
+        const unsigned char key[32],
+        const unsigned char *dst_dir)
+{
+    unsigned char entry_dir[PATH_MAX];
+    struct stat stb;
+    int count = 0, expected_count = 0;
+    long long size, expected_size = 0;
+    int lock_fd;
+
+    if (!cache_dir || !*cache_dir) return 0;
+    if (make_entry_path(entry_dir, sizeof(entry_dir), cache_dir, key) < 0) return 0;
+    if (stat(entry_dir, &stb) < 0 || !S_ISDIR(stb.st_mode)) return 0;
+
+    // the entry cannot be removed while the shared lock is held
+    if ((lock_fd = lock_cache(cache_dir, LOCK_SH)) < 0) return 0;
+    if (read_manifest(entry_dir, &expected_count, &expected_size) < 0) {
+        // the entry has been removed since stat
+        close(lock_fd);
+        return 0;
+    }
+    size = copy_files(entry_dir, dst_dir, 1, &count);
+    if (size < 0 || count != expected_count || size != expected_size) {
+        err("test_gen_cache: failed to copy '%s'", entry_dir);
+        close(lock_fd);
+        remove_directory_recursively(dst_dir, 1);
+        return 0;
+    }
+    utimes(entry_dir, NULL);
+    close(lock_fd);
+    return 1;
+}
+
+struct cache_entry
+{
+    unsigned char *name;
+    long long size;
+    time_t mtime;
+};
+
+static int
+entry_sort_func(const void *p1, const void *p2)
+{
+    const struct cache_entry *e1 = p1;
+    const struct cache_entry *e2 = p2;
+    if (e1->mtime < e2->mtime) return -1;
+    if (e1->mtime > e2->mtime) return 1;
+    return 0;
+}
+
+static void
+trim_cache(const unsigned char *cache_dir, long long max_size)
+{
+    DIR *d = NULL;
+    struct dirent *dd;
+    struct stat stb;
+    unsigned char path[PATH_MAX];
+    unsigned char del_path[PATH_MAX];
+    struct cache_entry *entries = NULL;
+    size_t entry_a = 0, entry_u = 0;
+    long long total = 0;
+    time_t current_time = time(NULL);
+    int del_count = 0;
+    int lock_fd;
+
+    if ((lock_fd = lock_cache(cache_dir, LOCK_EX)) < 0) return;
+    if (!(d = opendir(cache_dir))) {
+        close(lock_fd);
+        return;
+    }
+    while ((dd = readdir(d))) {
+        if (dd->d_name[0] == '.') {
+            if (strncmp(dd->d_name, ".tmp.", 5) && strncmp(dd->d_name, ".del.", 5)) continue;
+            snprintf(path, sizeof(path), "%s/%s", cache_dir, dd->d_name);
+            if (lstat(path, &stb) >= 0 && S_ISDIR(stb.st_mode)
+                && stb.st_ctime + STALE_TIMEOUT < current_time) {
+                remove_directory_recursively(path, 0);
+            }
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, dd->d_name);
+        if (lstat(path, &stb) < 0 || !S_ISDIR(stb.st_mode)) continue;
+        if (entry_u == entry_a) {
+            if (!(entry_a *= 2)) entry_a = 32;
+            XREALLOC(entries, entry_a);
+        }
+        struct cache_entry *e = &entries[entry_u++];
+        e->name = xstrdup(dd->d_name);
+        e->size = get_entry_size(path);
+        e->mtime = stb.st_mtime;
+        total += e->size;
+    }
+    closedir(d);
+
+    if (total > max_size) {
+        qsort(entries, entry_u, sizeof(entries[0]), entry_sort_func);
+        for (size_t i = 0; i < entry_u && total > max_size; ++i) {
+            snprintf(path, sizeof(path), "%s/%s", cache_dir, entries[i].name);
+            snprintf(del_path, sizeof(del_path), "%s/.del.%d.%d", cache_dir, (int) getpid(), del_count);
+            if (rename(path, del_path) >= 0) {
+                total -= entries[i].size;
+                ++del_count;
+            }
+        }
+    }
+    // the renamed entries are invisible to the lookups, so they are
+    // removed without the lock
+    close(lock_fd);
+
+    for (int i = 0; i < del_count; ++i) {
+        snprintf(del_path, sizeof(del_path), "%s/.del.%d.%d", cache_dir, (int) getpid(), i);
+        remove_directory_recursively(del_path, 0);
+    }
+
+    for (size_t i = 0; i < entry_u; ++i) {
+        xfree(entries[i].name);
+    }
+    xfree(entries);
+}
+
+int
+test_gen_cache_store(
+        const unsigned char *cache_dir,
+        const unsigned char key[32],
+        const unsigned char *src_dir,
+        long long max_size)
+{
+    unsigned char entry_dir[PATH_MAX];
+    unsigned char tmp_dir[PATH_MAX];
+    struct stat stb;
+
+    if (!cache_dir || !*cache_dir || max_size <= 0) return 0;
+    if (make_entry_path(entry_dir, sizeof(entry_dir), cache_dir, key) < 0) return -1;
+    if (snprintf(tmp_dir, sizeof(tmp_dir), "%s/.tmp.%d", cache_dir, (int) getpid()) >= sizeof(tmp_dir)) {
+        return -1;
+    }
+    if (os_MakeDirPath(cache_dir, 0700) < 0) {
+        err("test_gen_cache: cannot create '%s'", cache_dir);
+        return -1;
+    }
+    if (lstat(tmp_dir, &stb) >= 0) {
+        // left by a dead process with the same pid
+        remove_directory_recursively(tmp_dir, 0);
+    }
+    if (mkdir(tmp_dir, 0700) < 0) {
+        err("test_gen_cache: mkdir '%s' failed: %s", tmp_dir, os_ErrorMsg());
+        return -1;
+    }
+
+    int count = 0;
+    long long size = copy_files(src_dir, tmp_dir, 0, &count);
+    if (size < 0 || size > max_size || write_manifest(tmp_dir, count, size) < 0) {
+        remove_directory_recursively(tmp_dir, 0);
+        return 0;
+    }
+    if (rename(tmp_dir, entry_dir) < 0) {
+        // the same entry might be stored concurrently
+        if (errno != EEXIST && errno != ENOTEMPTY) {
+            err("test_gen_cache: rename '%s' failed: %s", tmp_dir, os_ErrorMsg());
+        }
+        remove_directory_recursively(tmp_dir, 0);
+        return 0;
+    }
+
+    trim_cache(cache_dir, max_size);
+    return 1;
+}
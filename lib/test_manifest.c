@@ -0,0 +1,579 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/test_manifest.h"
+#include "ejudge/dyntrie.h"
+#include "ejudge/sha256.h"
+#include "ejudge/misctext.h"
+#include "ejudge/fileutl.h"
+#include "ejudge/xalloc.h"
+#include "ejudge/errlog.h"
+#include "ejudge/osdeps.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+/*
+ * The manifest file format:
+ * ejudge-test-manifest 3
+ * <test_dir mtime sec> <nsec> <corr_dir mtime sec> <nsec> <info_dir mtime sec> <nsec>
+ * <test count>
+ * then for each test:
+ * <num> (<size> <mtime_us> <sha256 or ->){3}
+ * for the test, answer and test info files
+ */
+#define MANIFEST_HEADER "ejudge-test-manifest 3"
+
+/* the number of manifests kept in memory */
+enum { MAX_MANIFESTS = 64 };
+
+static struct dyntrie_node *manifests = NULL;
+// the manifests in the order of use, the most recently used first
+static struct test_manifest *first_manifest = NULL;
+static struct test_manifest *last_manifest = NULL;
+static int manifest_count = 0;
+
+static long long
+timespec_to_us(const struct timespec *ts)
+{
+    return ts->tv_sec * 1000000LL + ts->tv_nsec / 1000;
+}
+
+static int
+make_file_path(
+        unsigned char *buf,
+        size_t size,
+        const unsigned char *dir,
+        const unsigned char *pat,
+        int num)
+{
+    unsigned char name[PATH_MAX];
+
+    if (!dir || !*dir || !pat || !*pat) return -1;
+    if (snprintf(name, sizeof(name), pat, num) >= sizeof(name)) return -1;
+    if (snprintf(buf, size, "%s/%s", dir, name) >= size) return -1;
+    return 0;
+}
+
+static int
+hash_file(const unsigned char *path, struct test_manifest_file *tf)
+{
+    int fd = -1;
+    struct stat stb;
+    SHA256_CTX ctx;
+    unsigned char buf[65536];
+    long long size = 0;
+
+    memset(tf, 0, sizeof(*tf));
+    tf->size = -1;
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK, 0)) < 0) {
+        return -1;
+    }
+    if (fstat(fd, &stb) < 0 || !S_ISREG(stb.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    sha256_init(&ctx);
+    while (1) {
+        ssize_t r = read(fd, buf, sizeof(buf));
+        if (r < 0) {
+            err("hash_file: read error on '%s': %s", path, os_ErrorMsg());
+            close(fd);
+            return -1;
+        }
+        if (!r) break;
+        sha256_update(&ctx, buf, r);
+        size += r;
+    }
+    close(fd);
+    sha256_final(&ctx, tf->sha256);
+    tf->size = size;
+    tf->mtime_us = timespec_to_us(&stb.st_mtim);
+    return 0;
+}
+
+/*
+ * fills the file entry, the SHA-256 is taken from the previous entry,
+ * if the size and the modification time are the same
+ */
+static int
+stat_file(
+        const unsigned char *path,
+        struct test_manifest_file *tf,
+        const struct test_manifest_file *prev)
+{
+    struct stat stb;
+
+    memset(tf, 0, sizeof(*tf));
+    tf->size = -1;
+    if (stat(path, &stb) < 0 || !S_ISREG(stb.st_mode)) return -1;
+    long long mtime_us = timespec_to_us(&stb.st_mtim);
+    if (prev && prev->size == stb.st_size && prev->mtime_us == mtime_us) {
+        tf->size = stb.st_size;
+        tf->mtime_us = mtime_us;
+        memcpy(tf->sha256, prev->sha256, sizeof(tf->sha256));
+        return 0;
+    }
+    return hash_file(path, tf);
+}
+
+static void
+free_test_array(struct test_manifest_test *tests, int test_count)
+{
+    if (!tests) return;
+    for (int i = 1; i <= test_count; ++i) {
+        if (tests[i].tinfo_state > 0) {
+            testinfo_free(&tests[i].tinfo);
+        }
+    }
+    free(tests);
+}
+
+static void
+free_tests(struct test_manifest *tm)
+{
+    free_test_array(tm->tests, tm->test_count);
+    tm->tests = NULL;
+    tm->test_count = -1;
+}
+
+/* prev_tests are the entries of the previous scan, may be NULL */
+static void
+scan_tests(
+        struct test_manifest *tm,
+        const struct test_manifest_test *prev_tests,
+        int prev_count)
+{
+    int reserved = 32;
+    int num;
+    unsigned char path[PATH_MAX];
+
+    XCALLOC(tm->tests, reserved);
+    for (num = 1; ; ++num) {
+        if (num >= reserved) {
+            reserved *= 2;
+            XREALLOC(tm->tests, reserved);
+        }
+        struct test_manifest_test *t = &tm->tests[num];
+        const struct test_manifest_test *pt = NULL;
+        if (prev_tests && num <= prev_count) pt = &prev_tests[num];
+        memset(t, 0, sizeof(*t));
+        if (make_file_path(path, sizeof(path), tm->test_dir, tm->test_pat, num) < 0
+            || stat_file(path, &t->test, pt?&pt->test:NULL) < 0) {
+            break;
+        }
+        t->corr.size = -1;
+        if (make_file_path(path, sizeof(path), tm->corr_dir, tm->corr_pat, num) >= 0) {
+            stat_file(path, &t->corr, pt?&pt->corr:NULL);
+        }
+        t->info.size = -1;
+        if (make_file_path(path, sizeof(path), tm->info_dir, tm->info_pat, num) >= 0) {
+            stat_file(path, &t->info, pt?&pt->info:NULL);
+        }
+    }
+    tm->test_count = num - 1;
+}
+
+static int
+make_manifest_path(
+        unsigned char *buf,
+        size_t size,
+        const unsigned char *cache_dir,
+        const unsigned char *key)
+{
+    SHA256_CTX ctx;
+    unsigned char digest[32];
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, key, strlen(key));
+    sha256_final(&ctx, digest);
+    if (snprintf(buf, size, "%s/%s.txt", cache_dir, unparse_sha256(digest)) >= size) {
+        return -1;
+    }
+    return 0;
+}
+
+static void
+write_file_entry(FILE *f, const struct test_manifest_file *tf)
+{
+    if (tf->size < 0) {
+        fprintf(f, " -1 0 -");
+    } else {
+        fprintf(f, " %lld %lld %s", tf->size, tf->mtime_us, unparse_sha256(tf->sha256));
+    }
+}
+
+static void
+save_manifest(const unsigned char *cache_dir, const struct test_manifest *tm)
+{
+    unsigned char path[PATH_MAX];
+    unsigned char tmp_path[PATH_MAX];
+    FILE *f = NULL;
+
+    if (os_MakeDirPath(cache_dir, 0755) < 0) {
+        err("save_manifest: cannot create '%s'", cache_dir);
+        return;
+    }
+    if (make_manifest_path(path, sizeof(path), cache_dir, tm->key) < 0) return;
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, getpid()) >= sizeof(tmp_path)) {
+        return;
+    }
+    if (!(f = fopen(tmp_path, "w"))) {
+        err("save_manifest: cannot open '%s': %s", tmp_path, os_ErrorMsg());
+        return;
+    }
+    fprintf(f, "%s\n", MANIFEST_HEADER);
+    fprintf(f, "%lld %ld %lld %ld %lld %ld\n",
+            (long long) tm->test_dir_mtime.tv_sec, (long) tm->test_dir_mtime.tv_nsec,
+            (long long) tm->corr_dir_mtime.tv_sec, (long) tm->corr_dir_mtime.tv_nsec,
+            (long long) tm->info_dir_mtime.tv_sec, (long) tm->info_dir_mtime.tv_nsec);
+    fprintf(f, "%d\n", tm->test_count);
+    for (int i = 1; i <= tm->test_count; ++i) {
+        fprintf(f, "%d", i);
+        write_file_entry(f, &tm->tests[i].test);
+        write_file_entry(f, &tm->tests[i].corr);
+        write_file_entry(f, &tm->tests[i].info);
+        fprintf(f, "\n");
+    }
+    if (ferror(f) | fclose(f)) {
+        err("save_manifest: write error to '%s'", tmp_path);
+        unlink(tmp_path);
+        return;
+    }
+    if (rename(tmp_path, path) < 0) {
+        err("save_manifest: rename '%s' failed: %s", tmp_path, os_ErrorMsg());
+        unlink(tmp_path);
+    }
+}
+
+static int
+parse_sha256(const char *str, unsigned char *digest)
+{
+    if (strlen(str) != 64) return -1;
+    for (int i = 0; i < 32; ++i) {
+        unsigned int x;
+        if (sscanf(str + i * 2, "%2x", &x) != 1) return -1;
+        digest[i] = x;
+    }
+    return 0;
+}
+
+static int
+read_file_entry(FILE *f, struct test_manifest_file *tf)
+{
+    char sha_buf[80];
+
+    memset(tf, 0, sizeof(*tf));
+    if (fscanf(f, "%lld%lld%70s", &tf->size, &tf->mtime_us, sha_buf) != 3) return -1;
+    if (tf->size < 0) {
+        tf->size = -1;
+        return 0;
+    }
+    return parse_sha256(sha_buf, tf->sha256);
+}
+
+/*
+ * loads the manifest, *p_fresh is set, if it matches the current
+ * directory times, otherwise the entries are only good to reuse
+ * the SHA-256 of the unchanged files
+ */
+static int
+load_manifest(
+        const unsigned char *cache_dir,
+        struct test_manifest *tm,
+        int *p_fresh)
+{
+    unsigned char path[PATH_MAX];
+    char header[64];
+    FILE *f = NULL;
+    long long s1, s2, s3;
+    long n1, n2, n3;
+    int test_count = 0;
+    int fresh;
+
+    *p_fresh = 0;
+    if (make_manifest_path(path, sizeof(path), cache_dir, tm->key) < 0) return -1;
+    if (!(f = fopen(path, "r"))) return -1;
+    if (!fgets(header, sizeof(header), f)
+        || strcmp(header, MANIFEST_HEADER "\n") != 0) {
+        goto fail;
+    }
+    if (fscanf(f, "%lld%ld%lld%ld%lld%ld", &s1, &n1, &s2, &n2, &s3, &n3) != 6) {
+        goto fail;
+    }
+    fresh = (s1 == tm->test_dir_mtime.tv_sec && n1 == tm->test_dir_mtime.tv_nsec
+             && s2 == tm->corr_dir_mtime.tv_sec && n2 == tm->corr_dir_mtime.tv_nsec
+             && s3 == tm->info_dir_mtime.tv_sec && n3 == tm->info_dir_mtime.tv_nsec);
+    if (fscanf(f, "%d", &test_count) != 1 || test_count < 0 || test_count > 1000000) {
+        goto fail;
+    }
+    XCALLOC(tm->tests, test_count + 1);
+    tm->test_count = test_count;
+    for (int i = 1; i <= test_count; ++i) {
+        int num = 0;
+        if (fscanf(f, "%d", &num) != 1 || num != i
+            || read_file_entry(f, &tm->tests[i].test) < 0
+            || read_file_entry(f, &tm->tests[i].corr) < 0
+            || read_file_entry(f, &tm->tests[i].info) < 0) {
+            free_tests(tm);
+            goto fail;
+        }
+    }
+    fclose(f);
+    *p_fresh = fresh;
+    return 0;
+
+fail:
+    fclose(f);
+    return -1;
+}
+
+static int
+get_dir_mtime(const unsigned char *dir, struct timespec *ts)
+{
+    struct stat stb;
+
+    memset(ts, 0, sizeof(*ts));
+    if (!dir || !*dir) return 0;
+    if (stat(dir, &stb) < 0) return -1;
+    if (!S_ISDIR(stb.st_mode)) return -1;
+    *ts = stb.st_mtim;
+    return 0;
+}
+
+static int
+same_time(const struct timespec *t1, const struct timespec *t2)
+{
+    return t1->tv_sec == t2->tv_sec && t1->tv_nsec == t2->tv_nsec;
+}
+
+static void
+unlink_manifest(struct test_manifest *tm)
+{
+    if (tm->prev) tm->prev->next = tm->next;
+    else first_manifest = tm->next;
+    if (tm->next) tm->next->prev = tm->prev;
+    else last_manifest = tm->prev;
+    tm->prev = tm->next = NULL;
+}
+
+static void
+link_manifest_first(struct test_manifest *tm)
+{
+    tm->prev = NULL;
+    tm->next = first_manifest;
+    if (first_manifest) first_manifest->prev = tm;
+    else last_manifest = tm;
+    first_manifest = tm;
+}
+
+static void
+free_manifest(struct test_manifest *tm)
+{
+    free_tests(tm);
+    xfree(tm->key);
+    xfree(tm->test_dir);
+    xfree(tm->test_pat);
+    xfree(tm->corr_dir);
+    xfree(tm->corr_pat);
+    xfree(tm->info_dir);
+    xfree(tm->info_pat);
+    xfree(tm);
+}
+
+/* drops the least recently used manifests */
+static void
+evict_manifests(void)
+{
+    while (manifest_count > MAX_MANIFESTS && last_manifest) {
+        struct test_manifest *tm = last_manifest;
+        unlink_manifest(tm);
+        dyntrie_remove(&manifests, tm->key, NULL);
+        --manifest_count;
+        free_manifest(tm);
+    }
+}
+
+struct test_manifest *
+test_manifest_get(
+        const unsigned char *cache_dir,
+        const unsigned char *test_dir,
+        const unsigned char *test_pat,
+        const unsigned char *corr_dir,
+        const unsigned char *corr_pat,
+        const unsigned char *info_dir,
+        const unsigned char *info_pat)
+{
+    struct timespec test_mtime, corr_mtime, info_mtime;
+    char *key = NULL;
+    size_t key_z = 0;
+    FILE *key_f = NULL;
+    struct test_manifest *tm = NULL;
+    struct test_manifest_test *prev_tests = NULL;
+    int prev_count = 0;
+    int fresh = 0;
+
+    if (!test_dir || !*test_dir || !test_pat || !*test_pat) return NULL;
+    if (!corr_pat || !*corr_pat) corr_dir = NULL;
+    if (!info_pat || !*info_pat) info_dir = NULL;
+
+    if (get_dir_mtime(test_dir, &test_mtime) < 0
+        || get_dir_mtime(corr_dir, &corr_mtime) < 0
+        || get_dir_mtime(info_dir, &info_mtime) < 0) {
+        return NULL;
+    }
+
+    key_f = open_memstream(&key, &key_z);
+    fprintf(key_f, "%s\n%s\n%s\n%s\n%s\n%s",
+            test_dir, test_pat,
+            corr_dir?corr_dir:(const unsigned char*) "", corr_dir?corr_pat:(const unsigned char*) "",
+            info_dir?info_dir:(const unsigned char*) "", info_dir?info_pat:(const unsigned char*) "");
+    fclose(key_f); key_f = NULL;
+
+    if ((tm = dyntrie_get(&manifests, key))) {
+        free(key);
+        unlink_manifest(tm);
+        link_manifest_first(tm);
+        if (same_time(&tm->test_dir_mtime, &test_mtime)
+            && same_time(&tm->corr_dir_mtime, &corr_mtime)
+            && same_time(&tm->info_dir_mtime, &info_mtime)) {
+            return tm;
+        }
+        prev_tests = tm->tests; prev_count = tm->test_count;
+        tm->tests = NULL; tm->test_count = -1;
+    } else {
+        XCALLOC(tm, 1);
+        tm->key = key; key = NULL;
+        tm->test_dir = xstrdup(test_dir);
+        tm->test_pat = xstrdup(test_pat);
+        if (corr_dir) {
+            tm->corr_dir = xstrdup(corr_dir);
+            tm->corr_pat = xstrdup(corr_pat);
+        }
+        if (info_dir) {
+            tm->info_dir = xstrdup(info_dir);
+            tm->info_pat = xstrdup(info_pat);
+        }
+        tm->test_count = -1;
+        dyntrie_insert(&manifests, tm->key, tm, 0, NULL);
+        link_manifest_first(tm);
+        ++manifest_count;
+        evict_manifests();
+    }
+
+    tm->test_dir_mtime = test_mtime;
+    tm->corr_dir_mtime = corr_mtime;
+    tm->info_dir_mtime = info_mtime;
+    if (cache_dir && *cache_dir && load_manifest(cache_dir, tm, &fresh) >= 0
+        && !fresh) {
+        // the stored hashes of the unchanged files are still good
+        if (!prev_tests) {
+            prev_tests = tm->tests; prev_count = tm->test_count;
+            tm->tests = NULL; tm->test_count = -1;
+        } else {
+            free_tests(tm);
+        }
+    }
+    if (!fresh) {
+        info("building test manifest for '%s'", test_dir);
+        scan_tests(tm, prev_tests, prev_count);
+        if (cache_dir && *cache_dir) {
+            save_manifest(cache_dir, tm);
+        }
+    }
+    free_test_array(prev_tests, prev_count);
+    return tm;
+}
+
+int
+test_manifest_get_testinfo(
+        struct test_manifest *tm,
+        int test_num,
+        testinfo_t *pt)
+{
+    unsigned char path[PATH_MAX];
+    struct stat stb;
+
+    if (!tm || test_num <= 0 || test_num > tm->test_count) return -1;
+    struct test_manifest_test *t = &tm->tests[test_num];
+    if (t->info.size < 0) return -1;
+    if (make_file_path(path, sizeof(path), tm->info_dir, tm->info_pat, test_num) < 0) {
+        return -1;
+    }
+    // the file may be edited in place without changing the directory
+    if (stat(path, &stb) < 0) return -1;
+    long long mtime_us = timespec_to_us(&stb.st_mtim);
+    if (t->tinfo_state == 0 || t->tinfo_mtime_us != mtime_us
+        || t->tinfo_size != stb.st_size) {
+        if (t->tinfo_state > 0) {
+            testinfo_free(&t->tinfo);
+        }
+        t->tinfo_state = -1;
+        t->tinfo_mtime_us = mtime_us;
+        t->tinfo_size = stb.st_size;
+        if (testinfo_parse(path, &t->tinfo, NULL) >= 0) {
+            t->tinfo_state = 1;
+        }
+    }
+    if (t->tinfo_state <= 0) return -1;
+    // substitutions depend on the run, so such files are parsed each time
+    if (t->tinfo.enable_subst > 0) return -1;
+    testinfo_copy(pt, &t->tinfo);
+    return 0;
+}
+
+int
+test_manifest_check_file(
+        struct test_manifest *tm,
+        int test_num,
+        int kind,
+        const unsigned char *path)
+{
+    struct test_manifest_file *tf = NULL;
+    struct stat stb;
+
+    if (!tm || test_num <= 0 || test_num > tm->test_count) return -1;
+    struct test_manifest_test *t = &tm->tests[test_num];
+    switch (kind) {
+    case TEST_MANIFEST_TEST: tf = &t->test; break;
+    case TEST_MANIFEST_CORR: tf = &t->corr; break;
+    case TEST_MANIFEST_INFO: tf = &t->info; break;
+    default:
+        return -1;
+    }
+    if (tf->size < 0) return -1;
+    if (stat(path, &stb) < 0 || !S_ISREG(stb.st_mode)) return 0;
+    if (stb.st_size != tf->size) return 0;
+    long long mtime_us = timespec_to_us(&stb.st_mtim);
+    if (tf->checked_state == 0 || tf->checked_size != stb.st_size
+        || tf->checked_mtime_us != mtime_us) {
+        struct test_manifest_file cf;
+        tf->checked_size = stb.st_size;
+        tf->checked_mtime_us = mtime_us;
+        tf->checked_state = -1;
+        if (hash_file(path, &cf) >= 0 && cf.size == tf->size
+            && !memcmp(cf.sha256, tf->sha256, sizeof(cf.sha256))) {
+            tf->checked_state = 1;
+        }
+    }
+    return tf->checked_state > 0;
+}
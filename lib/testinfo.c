@@ -815,6 +815,51 @@ testinfo_free(testinfo_t *pt)
   memset(pt, 0, sizeof(*pt));
 }
 
+static char *
+copy_str(const char *s)
+{
+  char *r;
+
+  if (!s) return NULL;
+  if (!(r = malloc(strlen(s) + 1))) return NULL;
+  strcpy(r, s);
+  return r;
+}
+
+/* deep copy of the parsed test info */
+void
+testinfo_copy(testinfo_t *dst, const testinfo_t *src)
+{
+  int i;
+
+  static const int array_tags[] =
+  {
+    Tag_params, Tag_environ, Tag_checker_env, Tag_interactor_env,
+    Tag_init_env, Tag_compiler_env, Tag_style_checker_env, Tag_ok_language, 0
+  };
+  static const int string_tags[] =
+  {
+    Tag_comment, Tag_team_comment, Tag_source_stub, Tag_working_dir,
+    Tag_program_name, Tag_check_cmd, 0
+  };
+
+  memcpy(dst, src, sizeof(*dst));
+  for (int ti = 0; array_tags[ti]; ++ti) {
+    const struct testinfo_array *sa = XPDEREF(struct testinfo_array, src, tag_offsets[array_tags[ti]]);
+    struct testinfo_array *da = XPDEREF(struct testinfo_array, dst, tag_offsets[array_tags[ti]]);
+    da->v = NULL;
+    if (!sa->v) continue;
+    da->v = calloc(sa->u + 1, sizeof(da->v[0]));
+    for (i = 0; i < sa->u; ++i) {
+      da->v[i] = copy_str(sa->v[i]);
+    }
+  }
+  for (int ti = 0; string_tags[ti]; ++ti) {
+    char **ds = XPDEREF(char *, dst, tag_offsets[string_tags[ti]]);
+    *ds = copy_str(*ds);
+  }
+}
+
 static const unsigned char * const error_codes[] =
 {
   [TINF_E_OK] = "OK - no error",
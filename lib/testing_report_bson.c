@@ -193,6 +193,10 @@ parse_test(int index, bson_iter_t *bi, testing_report_xml_t r)
             if (ej_bson_parse_int_new(bi, key, &p->visibility, 1, 0, 0, 0) < 0)
                 goto cleanup;
             break;
+        case Tag_checker_cached:
+            if (ej_bson_parse_int_new(bi, key, &p->checker_cached, 1, 0, 0, 0) < 0)
+                goto cleanup;
+            break;
         case Tag_comment:
             if (ej_bson_parse_string_new(bi, key, &p->comment) < 0)
                 goto cleanup;
@@ -260,6 +264,10 @@ parse_test(int index, bson_iter_t *bi, testing_report_xml_t r)
             if (ej_bson_parse_string_new(bi, key, &p->interactor_stats_str) < 0)
                 goto cleanup;
             break;
+        case Tag_time_samples:
+            if (ej_bson_parse_string_new(bi, key, &p->time_samples) < 0)
+                goto cleanup;
+            break;
         case Tag_checker_stats_str:
             if (ej_bson_parse_string_new(bi, key, &p->checker_stats_str) < 0)
                 goto cleanup;
@@ -741,6 +749,9 @@ testing_report_parse_bson_data(
     bson_iter_t iter;
     testing_report_xml_t r = NULL;
 
+    if (testing_report_is_flatbuf(data, size)) {
+        return testing_report_parse_flatbuf_data(data, size, 0);
+    }
     if (bson_init_static(&sb, data, size) && bson_iter_init(&iter, &sb)) {
         XCALLOC(r, 1);
         if (parse_testing_report_bson(&iter, r) >= 0) {
@@ -1056,6 +1067,9 @@ do_unparse(
             if (t->visibility > 0) {
                 bson_append_int32(b_testp, tag_table[Tag_visibility], -1, t->visibility);
             }
+            if (t->checker_cached > 0) {
+                bson_append_int32(b_testp, tag_table[Tag_checker_cached], -1, t->checker_cached);
+            }
             if (t->has_user > 0) {
                 bson_append_bool(b_testp, tag_table[Tag_has_user], -1, 1);
                 if (t->user_status >= 0) {
@@ -1080,6 +1094,9 @@ do_unparse(
             if (t->checker_stats_str && t->checker_stats_str[0]) {
                 bson_append_utf8(b_testp, tag_table[Tag_checker_stats_str], -1, t->checker_stats_str, -1);
             }
+            if (t->time_samples && t->time_samples[0]) {
+                bson_append_utf8(b_testp, tag_table[Tag_time_samples], -1, t->time_samples, -1);
+            }
             unparse_file_content(b_testp, tag_table[Tag_input], &t->input);
             unparse_file_content(b_testp, tag_table[Tag_output], &t->output);
             unparse_file_content(b_testp, tag_table[Tag_correct], &t->correct);
@@ -1224,6 +1241,9 @@ testing_report_parse_bson_data(
         const unsigned char *data,
         unsigned int size)
 {
+    if (testing_report_is_flatbuf(data, size)) {
+        return testing_report_parse_flatbuf_data(data, size, 0);
+    }
     return NULL;
 }
 
@@ -1231,7 +1251,7 @@ testing_report_xml_t
 testing_report_parse_bson_file(
         const unsigned char *path)
 {
-    return NULL;
+    return testing_report_parse_file(path, STORE_FLAGS_UUID_BSON, 0, 0);
 }
 
 int
@@ -0,0 +1,659 @@
+/* -*- mode: c; c-basic-offset: 4 -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "ejudge/config.h"
+#include "ejudge/testing_report_xml.h"
+#include "ejudge/runlog.h"
+#include "ejudge/fileutl.h"
+#include "ejudge/misctext.h"
+#include "ejudge/ej_uuid.h"
+#include "ejudge/xalloc.h"
+#include "ejudge/errlog.h"
+#include "ejudge/osdeps.h"
+
+/*
+ * the scalar helpers of flatbuffers_common_builder.h, generated by flatcc,
+ * are one-line if/else chains, gcc reports them in small files
+ */
+#if defined __GNUC__ && !defined __clang__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmisleading-indentation"
+#endif
+#include "ejudge/testing_report_fb_builder.h"
+#include "ejudge/testing_report_fb_verifier.h"
+#if defined __GNUC__ && !defined __clang__
+#pragma GCC diagnostic pop
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/*
+ * The report is a single FlatBuffers table. The tests are stored
+ * in the order of their numbers, so a single test is found by
+ * a binary search in the offset vector and decoded without touching
+ * the rest of the report.
+ */
+
+enum { DIGEST_SIZE = 32 };
+
+int
+testing_report_is_flatbuf(const unsigned char *data, size_t size)
+{
+    return data && size >= 8 && !memcmp(data + 4, ej_report_Report_file_identifier, 4);
+}
+
+static void
+build_string(
+        flatcc_builder_t *B,
+        int (*add)(flatcc_builder_t *, const char *),
+        const unsigned char *s)
+{
+    if (s) add(B, (const char *) s);
+}
+
+static void
+build_file_content(
+        flatcc_builder_t *B,
+        int (*start)(flatcc_builder_t *),
+        int (*end)(flatcc_builder_t *),
+        const struct testing_report_file_content *fc)
+{
+    if (fc->size < 0) return;
+
+    start(B);
+    ej_report_FileContent_size_add(B, fc->size);
+    ej_report_FileContent_orig_size_add(B, fc->orig_size);
+    ej_report_FileContent_is_too_big_add(B, fc->is_too_big);
+    ej_report_FileContent_is_base64_add(B, fc->is_base64);
+    ej_report_FileContent_is_bzip2_add(B, fc->is_bzip2);
+    if (fc->data) {
+        size_t len = fc->size;
+        if (fc->is_base64 > 0) len = strlen(fc->data);
+        ej_report_FileContent_data_create(B, fc->data, len);
+    }
+    end(B);
+}
+
+static void
+build_test(flatcc_builder_t *B, const struct testing_report_test *t)
+{
+    ej_report_Test_num_add(B, t->num);
+    ej_report_Test_status_add(B, t->status);
+    ej_report_Test_time_add(B, t->time);
+    ej_report_Test_real_time_add(B, t->real_time);
+    ej_report_Test_exit_code_add(B, t->exit_code);
+    ej_report_Test_term_signal_add(B, t->term_signal);
+    ej_report_Test_nominal_score_add(B, t->nominal_score);
+    ej_report_Test_score_add(B, t->score);
+    ej_report_Test_output_available_add(B, t->output_available);
+    ej_report_Test_stderr_available_add(B, t->stderr_available);
+    ej_report_Test_checker_output_available_add(B, t->checker_output_available);
+    ej_report_Test_args_too_long_add(B, t->args_too_long);
+    ej_report_Test_visibility_add(B, t->visibility);
+    ej_report_Test_max_memory_used_add(B, t->max_memory_used);
+    ej_report_Test_max_rss_add(B, t->max_rss);
+    ej_report_Test_has_user_add(B, t->has_user);
+    ej_report_Test_user_status_add(B, t->user_status);
+    ej_report_Test_user_score_add(B, t->user_score);
+    ej_report_Test_user_nominal_score_add(B, t->user_nominal_score);
+    ej_report_Test_checker_cached_add(B, t->checker_cached);
+
+    if (t->has_input_digest > 0) {
+        ej_report_Test_input_digest_create(B, t->input_digest, DIGEST_SIZE);
+    }
+    if (t->has_correct_digest > 0) {
+        ej_report_Test_correct_digest_create(B, t->correct_digest, DIGEST_SIZE);
+    }
+    if (t->has_info_digest > 0) {
+        ej_report_Test_info_digest_create(B, t->info_digest, DIGEST_SIZE);
+    }
+
+    build_string(B, ej_report_Test_comment_create_str, t->comment);
+    build_string(B, ej_report_Test_team_comment_create_str, t->team_comment);
+    build_string(B, ej_report_Test_checker_comment_create_str, t->checker_comment);
+    build_string(B, ej_report_Test_exit_comment_create_str, t->exit_comment);
+    build_string(B, ej_report_Test_checker_token_create_str, t->checker_token);
+    build_string(B, ej_report_Test_program_stats_str_create_str, t->program_stats_str);
+    build_string(B, ej_report_Test_interactor_stats_str_create_str, t->interactor_stats_str);
+    build_string(B, ej_report_Test_checker_stats_str_create_str, t->checker_stats_str);
+    build_string(B, ej_report_Test_args_create_str, t->args);
+    build_string(B, ej_report_Test_time_samples_create_str, t->time_samples);
+
+    build_file_content(B, ej_report_Test_input_start, ej_report_Test_input_end, &t->input);
+    build_file_content(B, ej_report_Test_output_start, ej_report_Test_output_end, &t->output);
+    build_file_content(B, ej_report_Test_correct_start, ej_report_Test_correct_end, &t->correct);
+    build_file_content(B, ej_report_Test_error_start, ej_report_Test_error_end, &t->error);
+    build_file_content(B, ej_report_Test_checker_start, ej_report_Test_checker_end, &t->checker);
+    build_file_content(B, ej_report_Test_test_checker_start, ej_report_Test_test_checker_end, &t->test_checker);
+}
+
+static void
+build_report(flatcc_builder_t *B, testing_report_xml_t r)
+{
+    ej_report_Report_start_as_root(B);
+
+    ej_report_Report_submit_id_add(B, r->submit_id);
+    ej_report_Report_contest_id_add(B, r->contest_id);
+    ej_report_Report_run_id_add(B, r->run_id);
+    ej_report_Report_judge_id_add(B, r->judge_id);
+    ej_report_Report_status_add(B, r->status);
+    ej_report_Report_scoring_system_add(B, r->scoring_system);
+    ej_report_Report_archive_available_add(B, r->archive_available);
+    ej_report_Report_correct_available_add(B, r->correct_available);
+    ej_report_Report_info_available_add(B, r->info_available);
+    ej_report_Report_real_time_available_add(B, r->real_time_available);
+    ej_report_Report_max_memory_used_available_add(B, r->max_memory_used_available);
+    ej_report_Report_max_rss_available_add(B, r->max_rss_available);
+    ej_report_Report_run_tests_add(B, r->run_tests);
+    ej_report_Report_variant_add(B, r->variant);
+    ej_report_Report_accepting_mode_add(B, r->accepting_mode);
+    ej_report_Report_failed_test_add(B, r->failed_test);
+    ej_report_Report_tests_passed_add(B, r->tests_passed);
+    ej_report_Report_score_add(B, r->score);
+    ej_report_Report_max_score_add(B, r->max_score);
+    ej_report_Report_time_limit_ms_add(B, r->time_limit_ms);
+    ej_report_Report_real_time_limit_ms_add(B, r->real_time_limit_ms);
+    ej_report_Report_marked_flag_add(B, r->marked_flag);
+    ej_report_Report_tests_mode_add(B, r->tests_mode);
+    ej_report_Report_separate_user_score_add(B, r->separate_user_score);
+    ej_report_Report_user_status_add(B, r->user_status);
+    ej_report_Report_user_tests_passed_add(B, r->user_tests_passed);
+    ej_report_Report_user_score_add(B, r->user_score);
+    ej_report_Report_user_max_score_add(B, r->user_max_score);
+    ej_report_Report_user_run_tests_add(B, r->user_run_tests);
+    ej_report_Report_compile_error_add(B, r->compile_error);
+    ej_report_Report_verdict_bits_add(B, r->verdict_bits);
+
+    build_string(B, ej_report_Report_comment_create_str, r->comment);
+    build_string(B, ej_report_Report_valuer_comment_create_str, r->valuer_comment);
+    build_string(B, ej_report_Report_valuer_judge_comment_create_str, r->valuer_judge_comment);
+    build_string(B, ej_report_Report_valuer_errors_create_str, r->valuer_errors);
+    build_string(B, ej_report_Report_host_create_str, r->host);
+    build_string(B, ej_report_Report_cpu_model_create_str, r->cpu_model);
+    build_string(B, ej_report_Report_cpu_mhz_create_str, r->cpu_mhz);
+    build_string(B, ej_report_Report_errors_create_str, r->errors);
+    build_string(B, ej_report_Report_compiler_output_create_str, r->compiler_output);
+
+    if (ej_uuid_is_nonempty(r->uuid)) {
+        ej_report_Report_uuid_create(B, ej_uuid_bytes(&r->uuid), sizeof(r->uuid));
+    }
+    if (ej_uuid_is_nonempty(r->judge_uuid)) {
+        ej_report_Report_judge_uuid_create(B, ej_uuid_bytes(&r->judge_uuid), sizeof(r->judge_uuid));
+    }
+
+    if (r->run_tests > 0 && r->tests) {
+        ej_report_Report_tests_start(B);
+        for (int i = 0; i < r->run_tests; ++i) {
+            struct testing_report_test *t = r->tests[i];
+            // the lookup relies on the tests being sorted by number
+            if (!t || t->num != i + 1) continue;
+            ej_report_Report_tests_push_start(B);
+            build_test(B, t);
+            ej_report_Report_tests_push_end(B);
+        }
+        ej_report_Report_tests_end(B);
+    }
+
+    if (r->tt_row_count > 0 && r->tt_column_count > 0) {
+        ej_report_Report_tt_row_count_add(B, r->tt_row_count);
+        ej_report_Report_tt_column_count_add(B, r->tt_column_count);
+        if (r->tt_rows) {
+            ej_report_Report_tt_rows_start(B);
+            for (int i = 0; i < r->tt_row_count; ++i) {
+                struct testing_report_row *ttr = r->tt_rows[i];
+                if (!ttr) continue;
+                ej_report_Report_tt_rows_push_start(B);
+                ej_report_Row_row_add(B, ttr->row);
+                build_string(B, ej_report_Row_name_create_str, ttr->name);
+                ej_report_Row_must_fail_add(B, ttr->must_fail);
+                ej_report_Row_status_add(B, ttr->status);
+                ej_report_Row_nominal_score_add(B, ttr->nominal_score);
+                ej_report_Row_score_add(B, ttr->score);
+                ej_report_Report_tt_rows_push_end(B);
+            }
+            ej_report_Report_tt_rows_end(B);
+        }
+        if (r->tt_cells) {
+            ej_report_Report_tt_cells_start(B);
+            for (int i = 0; i < r->tt_row_count; ++i) {
+                if (!r->tt_cells[i]) continue;
+                for (int j = 0; j < r->tt_column_count; ++j) {
+                    struct testing_report_cell *ttc = r->tt_cells[i][j];
+                    if (!ttc) continue;
+                    ej_report_Report_tt_cells_push_create(B, ttc->row, ttc->column,
+                                                          ttc->status, ttc->time,
+                                                          ttc->real_time);
+                }
+            }
+            ej_report_Report_tt_cells_end(B);
+        }
+    }
+
+    ej_report_Report_end_as_root(B);
+}
+
+int
+testing_report_to_mem_flatbuf(
+        char **pstr,
+        size_t *psize,
+        testing_report_xml_t r)
+{
+    flatcc_builder_t builder;
+    size_t size = 0;
+    void *buf;
+
+    flatcc_builder_init(&builder);
+    build_report(&builder, r);
+    buf = flatcc_builder_finalize_buffer(&builder, &size);
+    flatcc_builder_clear(&builder);
+    if (!buf) {
+        err("testing_report_to_mem_flatbuf: failed to build the report");
+        return -1;
+    }
+
+    *pstr = buf;
+    *psize = size;
+    return 0;
+}
+
+int
+testing_report_to_file_flatbuf(
+        const unsigned char *path,
+        testing_report_xml_t r)
+{
+    char *data = NULL;
+    size_t size = 0;
+    int retval = -1;
+    FILE *f = NULL;
+
+    if (testing_report_to_mem_flatbuf(&data, &size, r) < 0) goto done;
+    if (!(f = fopen(path, "w"))) {
+        err("testing_report_to_file_flatbuf: open %s failed: %s", path, os_ErrorMsg());
+        goto done;
+    }
+    if (fwrite(data, 1, size, f) != size) {
+        err("testing_report_to_file_flatbuf: write %s failed", path);
+        goto done;
+    }
+    if (fclose(f) < 0) {
+        f = NULL;
+        err("testing_report_to_file_flatbuf: close %s failed: %s", path, os_ErrorMsg());
+        goto done;
+    }
+    f = NULL;
+    retval = 0;
+
+done:
+    if (f) fclose(f);
+    free(data);
+    return retval;
+}
+
+static unsigned char *
+parse_string(flatbuffers_string_t s)
+{
+    if (!s) return NULL;
+    return xmemdup(s, flatbuffers_string_len(s));
+}
+
+static void
+parse_digest(flatbuffers_uint8_vec_t v, unsigned char *digest, int *p_has)
+{
+    if (!v || flatbuffers_uint8_vec_len(v) != DIGEST_SIZE) return;
+    memcpy(digest, v, DIGEST_SIZE);
+    *p_has = 1;
+}
+
+static void
+parse_file_content(
+        ej_report_FileContent_table_t ft,
+        struct testing_report_file_content *fc)
+{
+    if (!ft) return;
+
+    fc->size = ej_report_FileContent_size_get(ft);
+    fc->orig_size = ej_report_FileContent_orig_size_get(ft);
+    fc->is_too_big = ej_report_FileContent_is_too_big_get(ft);
+    fc->is_base64 = ej_report_FileContent_is_base64_get(ft);
+    fc->is_bzip2 = ej_report_FileContent_is_bzip2_get(ft);
+    flatbuffers_uint8_vec_t data = ej_report_FileContent_data_get(ft);
+    if (data) {
+        fc->data = xmemdup((const char *) data, flatbuffers_uint8_vec_len(data));
+    }
+}
+
+static struct testing_report_test *
+parse_test(ej_report_Test_table_t tt)
+{
+    struct testing_report_test *t = testing_report_test_alloc(ej_report_Test_num_get(tt),
+                                                              ej_report_Test_status_get(tt));
+
+    t->time = ej_report_Test_time_get(tt);
+    t->real_time = ej_report_Test_real_time_get(tt);
+    t->exit_code = ej_report_Test_exit_code_get(tt);
+    t->term_signal = ej_report_Test_term_signal_get(tt);
+    t->nominal_score = ej_report_Test_nominal_score_get(tt);
+    t->score = ej_report_Test_score_get(tt);
+    t->output_available = ej_report_Test_output_available_get(tt);
+    t->stderr_available = ej_report_Test_stderr_available_get(tt);
+    t->checker_output_available = ej_report_Test_checker_output_available_get(tt);
+    t->args_too_long = ej_report_Test_args_too_long_get(tt);
+    t->visibility = ej_report_Test_visibility_get(tt);
+    t->max_memory_used = ej_report_Test_max_memory_used_get(tt);
+    t->max_rss = ej_report_Test_max_rss_get(tt);
+    t->has_user = ej_report_Test_has_user_get(tt);
+    t->user_status = ej_report_Test_user_status_get(tt);
+    t->user_score = ej_report_Test_user_score_get(tt);
+    t->checker_cached = ej_report_Test_checker_cached_get(tt);
+    t->user_nominal_score = ej_report_Test_user_nominal_score_get(tt);
+
+    parse_digest(ej_report_Test_input_digest_get(tt), t->input_digest, &t->has_input_digest);
+    parse_digest(ej_report_Test_correct_digest_get(tt), t->correct_digest, &t->has_correct_digest);
+    parse_digest(ej_report_Test_info_digest_get(tt), t->info_digest, &t->has_info_digest);
+
+    t->comment = parse_string(ej_report_Test_comment_get(tt));
+    t->team_comment = parse_string(ej_report_Test_team_comment_get(tt));
+    t->checker_comment = parse_string(ej_report_Test_checker_comment_get(tt));
+    t->exit_comment = parse_string(ej_report_Test_exit_comment_get(tt));
+    t->checker_token = parse_string(ej_report_Test_checker_token_get(tt));
+    t->program_stats_str = parse_string(ej_report_Test_program_stats_str_get(tt));
+    t->interactor_stats_str = parse_string(ej_report_Test_interactor_stats_str_get(tt));
+    t->checker_stats_str = parse_string(ej_report_Test_checker_stats_str_get(tt));
+    t->args = parse_string(ej_report_Test_args_get(tt));
+    t->time_samples = parse_string(ej_report_Test_time_samples_get(tt));
+
+    parse_file_content(ej_report_Test_input_get(tt), &t->input);
+    parse_file_content(ej_report_Test_output_get(tt), &t->output);
+    parse_file_content(ej_report_Test_correct_get(tt), &t->correct);
+    parse_file_content(ej_report_Test_error_get(tt), &t->error);
+    parse_file_content(ej_report_Test_checker_get(tt), &t->checker);
+    parse_file_content(ej_report_Test_test_checker_get(tt), &t->test_checker);
+
+    return t;
+}
+
+/* the tests are sorted by number, usually tests[i] is the test i + 1 */
+static ej_report_Test_table_t
+find_test(ej_report_Test_vec_t tests, int num)
+{
+    size_t low = 0, high = ej_report_Test_vec_len(tests);
+
+    if (num <= 0) return NULL;
+    if ((size_t) num <= high) {
+        ej_report_Test_table_t tt = ej_report_Test_vec_at(tests, num - 1);
+        if (ej_report_Test_num_get(tt) == num) return tt;
+    }
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        ej_report_Test_table_t tt = ej_report_Test_vec_at(tests, mid);
+        int cur = ej_report_Test_num_get(tt);
+        if (cur == num) return tt;
+        if (cur < num) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+static int
+parse_tests(ej_report_Test_vec_t tests, testing_report_xml_t r, int test_num)
+{
+    if (!tests || r->run_tests <= 0) return 0;
+
+    if (test_num > 0) {
+        if (test_num > r->run_tests) return 0;
+        ej_report_Test_table_t tt = find_test(tests, test_num);
+        if (tt) r->tests[test_num - 1] = parse_test(tt);
+        return 0;
+    }
+
+    size_t count = ej_report_Test_vec_len(tests);
+    for (size_t i = 0; i < count; ++i) {
+        ej_report_Test_table_t tt = ej_report_Test_vec_at(tests, i);
+        int num = ej_report_Test_num_get(tt);
+        if (num <= 0 || num > r->run_tests || r->tests[num - 1]) {
+            err("testing_report_parse_flatbuf_data: invalid test number %d", num);
+            return -1;
+        }
+        r->tests[num - 1] = parse_test(tt);
+    }
+    return 0;
+}
+
+static int
+parse_tt(ej_report_Report_table_t rt, testing_report_xml_t r)
+{
+    r->tt_row_count = ej_report_Report_tt_row_count_get(rt);
+    r->tt_column_count = ej_report_Report_tt_column_count_get(rt);
+    if (r->tt_row_count <= 0 || r->tt_column_count <= 0) {
+        r->tt_row_count = 0;
+        r->tt_column_count = 0;
+        return 0;
+    }
+
+    // the rows and the cells, which are not stored, are initialized as in BSON
+    XCALLOC(r->tt_rows, r->tt_row_count);
+    XCALLOC(r->tt_cells, r->tt_row_count);
+    for (int i = 0; i < r->tt_row_count; ++i) {
+        struct testing_report_row *ttr = NULL;
+        XCALLOC(ttr, 1);
+        r->tt_rows[i] = ttr;
+        ttr->row = i;
+        ttr->status = RUN_CHECK_FAILED;
+        ttr->nominal_score = -1;
+        ttr->score = -1;
+        XCALLOC(r->tt_cells[i], r->tt_column_count);
+        for (int j = 0; j < r->tt_column_count; ++j) {
+            struct testing_report_cell *ttc = NULL;
+            XCALLOC(ttc, 1);
+            r->tt_cells[i][j] = ttc;
+            ttc->row = i;
+            ttc->column = j;
+            ttc->status = RUN_CHECK_FAILED;
+            ttc->time = -1;
+            ttc->real_time = -1;
+        }
+    }
+
+    ej_report_Row_vec_t rows = ej_report_Report_tt_rows_get(rt);
+    size_t row_count = ej_report_Row_vec_len(rows);
+    for (size_t i = 0; i < row_count; ++i) {
+        ej_report_Row_table_t rowt = ej_report_Row_vec_at(rows, i);
+        int row = ej_report_Row_row_get(rowt);
+        if (row < 0 || row >= r->tt_row_count) {
+            err("testing_report_parse_flatbuf_data: invalid row %d", row);
+            return -1;
+        }
+        struct testing_report_row *ttr = r->tt_rows[row];
+        xfree(ttr->name);
+        ttr->name = parse_string(ej_report_Row_name_get(rowt));
+        ttr->must_fail = ej_report_Row_must_fail_get(rowt);
+        ttr->status = ej_report_Row_status_get(rowt);
+        ttr->nominal_score = ej_report_Row_nominal_score_get(rowt);
+        ttr->score = ej_report_Row_score_get(rowt);
+    }
+
+    ej_report_Cell_vec_t cells = ej_report_Report_tt_cells_get(rt);
+    size_t cell_count = ej_report_Cell_vec_len(cells);
+    for (size_t i = 0; i < cell_count; ++i) {
+        ej_report_Cell_table_t cellt = ej_report_Cell_vec_at(cells, i);
+        int row = ej_report_Cell_row_get(cellt);
+        int column = ej_report_Cell_column_get(cellt);
+        if (row < 0 || row >= r->tt_row_count || column < 0 || column >= r->tt_column_count) {
+            err("testing_report_parse_flatbuf_data: invalid cell %d, %d", row, column);
+            return -1;
+        }
+        struct testing_report_cell *ttc = r->tt_cells[row][column];
+        ttc->status = ej_report_Cell_status_get(cellt);
+        ttc->time = ej_report_Cell_time_get(cellt);
+        ttc->real_time = ej_report_Cell_real_time_get(cellt);
+    }
+    return 0;
+}
+
+static void
+parse_uuid(flatbuffers_uint8_vec_t v, ej_uuid_t *uuid)
+{
+    if (v && flatbuffers_uint8_vec_len(v) == sizeof(*uuid)) {
+        memcpy(uuid, v, sizeof(*uuid));
+    }
+}
+
+testing_report_xml_t
+testing_report_parse_flatbuf_data(
+        const unsigned char *data,
+        size_t size,
+        int test_num)
+{
+    testing_report_xml_t r = NULL;
+    int ret;
+
+    if ((ret = ej_report_Report_verify_as_root(data, size))) {
+        err("testing_report_parse_flatbuf_data: invalid report: %s",
+            flatcc_verify_error_string(ret));
+        return NULL;
+    }
+    ej_report_Report_table_t rt = ej_report_Report_as_root(data);
+
+    XCALLOC(r, 1);
+    r->submit_id = ej_report_Report_submit_id_get(rt);
+    r->contest_id = ej_report_Report_contest_id_get(rt);
+    r->run_id = ej_report_Report_run_id_get(rt);
+    r->judge_id = ej_report_Report_judge_id_get(rt);
+    r->status = ej_report_Report_status_get(rt);
+    r->scoring_system = ej_report_Report_scoring_system_get(rt);
+    r->archive_available = ej_report_Report_archive_available_get(rt);
+    r->correct_available = ej_report_Report_correct_available_get(rt);
+    r->info_available = ej_report_Report_info_available_get(rt);
+    r->real_time_available = ej_report_Report_real_time_available_get(rt);
+    r->max_memory_used_available = ej_report_Report_max_memory_used_available_get(rt);
+    r->max_rss_available = ej_report_Report_max_rss_available_get(rt);
+    r->run_tests = ej_report_Report_run_tests_get(rt);
+    r->variant = ej_report_Report_variant_get(rt);
+    r->accepting_mode = ej_report_Report_accepting_mode_get(rt);
+    r->failed_test = ej_report_Report_failed_test_get(rt);
+    r->tests_passed = ej_report_Report_tests_passed_get(rt);
+    r->score = ej_report_Report_score_get(rt);
+    r->max_score = ej_report_Report_max_score_get(rt);
+    r->time_limit_ms = ej_report_Report_time_limit_ms_get(rt);
+    r->real_time_limit_ms = ej_report_Report_real_time_limit_ms_get(rt);
+    r->marked_flag = ej_report_Report_marked_flag_get(rt);
+    r->tests_mode = ej_report_Report_tests_mode_get(rt);
+    r->separate_user_score = ej_report_Report_separate_user_score_get(rt);
+    r->user_status = ej_report_Report_user_status_get(rt);
+    r->user_tests_passed = ej_report_Report_user_tests_passed_get(rt);
+    r->user_score = ej_report_Report_user_score_get(rt);
+    r->user_max_score = ej_report_Report_user_max_score_get(rt);
+    r->user_run_tests = ej_report_Report_user_run_tests_get(rt);
+    r->compile_error = ej_report_Report_compile_error_get(rt);
+    r->verdict_bits = ej_report_Report_verdict_bits_get(rt);
+
+    r->comment = parse_string(ej_report_Report_comment_get(rt));
+    r->valuer_comment = parse_string(ej_report_Report_valuer_comment_get(rt));
+    r->valuer_judge_comment = parse_string(ej_report_Report_valuer_judge_comment_get(rt));
+    r->valuer_errors = parse_string(ej_report_Report_valuer_errors_get(rt));
+    r->host = parse_string(ej_report_Report_host_get(rt));
+    r->cpu_model = parse_string(ej_report_Report_cpu_model_get(rt));
+    r->cpu_mhz = parse_string(ej_report_Report_cpu_mhz_get(rt));
+    r->errors = parse_string(ej_report_Report_errors_get(rt));
+    r->compiler_output = parse_string(ej_report_Report_compiler_output_get(rt));
+
+    parse_uuid(ej_report_Report_uuid_get(rt), &r->uuid);
+    parse_uuid(ej_report_Report_judge_uuid_get(rt), &r->judge_uuid);
+
+    if (r->run_tests > 0) {
+        XCALLOC(r->tests, r->run_tests);
+    }
+    if (parse_tests(ej_report_Report_tests_get(rt), r, test_num) < 0) goto fail;
+    if (r->tests_mode > 0 && parse_tt(rt, r) < 0) goto fail;
+
+    return r;
+
+fail:
+    testing_report_free(r);
+    return NULL;
+}
+
+static testing_report_xml_t
+parse_binary_file(const unsigned char *path, int test_num)
+{
+    int fd = -1;
+    struct stat stb;
+    unsigned char *memp = MAP_FAILED;
+    size_t memz = 0;
+    testing_report_xml_t r = NULL;
+
+    if ((fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC, 0)) < 0) {
+        err("testing_report_parse_file: open %s failed: %s", path, os_ErrorMsg());
+        goto done;
+    }
+    if (fstat(fd, &stb) < 0) {
+        err("testing_report_parse_file: fstat %s failed: %s", path, os_ErrorMsg());
+        goto done;
+    }
+    if (!S_ISREG(stb.st_mode) || stb.st_size <= 0 || (unsigned int) stb.st_size != stb.st_size) {
+        err("testing_report_parse_file: %s is invalid", path);
+        goto done;
+    }
+    memz = stb.st_size;
+    if ((memp = mmap(NULL, memz, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        err("testing_report_parse_file: mmap %s failed: %s", path, os_ErrorMsg());
+        goto done;
+    }
+    if (testing_report_is_flatbuf(memp, memz)) {
+        r = testing_report_parse_flatbuf_data(memp, memz, test_num);
+    } else {
+        r = testing_report_parse_bson_data(memp, memz);
+    }
+
+done:
+    if (memp != MAP_FAILED) munmap(memp, memz);
+    if (fd >= 0) close(fd);
+    return r;
+}
+
+testing_report_xml_t
+testing_report_parse_file(
+        const unsigned char *path,
+        int store_flags,
+        int read_flags,
+        int test_num)
+{
+    char *txt = NULL;
+    size_t len = 0;
+    const unsigned char *start_ptr = NULL;
+    testing_report_xml_t r = NULL;
+
+    if (store_flags == STORE_FLAGS_UUID_BSON) {
+        return parse_binary_file(path, test_num);
+    }
+
+    if (generic_read_file(&txt, 0, &len, read_flags, 0, path, 0) < 0) {
+        return NULL;
+    }
+    if (get_content_type(txt, &start_ptr) == CONTENT_TYPE_XML) {
+        r = testing_report_parse_xml(start_ptr);
+    }
+    xfree(txt);
+    return r;
+}
@@ -94,6 +94,7 @@ enum
   TR_T_INTERACTOR_STATS_STR,
   TR_T_CHECKER_STATS_STR,
   TR_T_TEST_CHECKER,
+  TR_T_TIME_SAMPLES,
 
   TR_T_LAST_TAG,
 };
@@ -164,6 +165,7 @@ enum
   TR_A_MAX_RSS,
   TR_A_SUBMIT_ID,
   TR_A_VERDICT_BITS,
+  TR_A_CHECKER_CACHED,
 
   TR_A_LAST_ATTR,
 };
@@ -197,6 +199,7 @@ static const char * const elem_map[] =
   [TR_T_INTERACTOR_STATS_STR] = "interactor-stats-str",
   [TR_T_CHECKER_STATS_STR] = "checker-stats-str",
   [TR_T_TEST_CHECKER] = "test-checker",
+  [TR_T_TIME_SAMPLES] = "time-samples",
 
   [TR_T_LAST_TAG] = 0,
 };
@@ -267,6 +270,7 @@ static const char * const attr_map[] =
   [TR_A_MAX_RSS] = "max-rss",
   [TR_A_SUBMIT_ID] = "submit-id",
   [TR_A_VERDICT_BITS] = "verdict-bits",
+  [TR_A_CHECKER_CACHED] = "checker-cached",
 
   [TR_A_LAST_ATTR] = 0,
 };
@@ -511,6 +515,14 @@ parse_test(struct xml_tree *t, testing_report_xml_t r)
       }
       p->visibility = x;
       break;
+    case TR_A_CHECKER_CACHED:
+      if (xml_attr_int(a, &x) < 0) goto failure;
+      if (x < 0 || x > TESTING_REPORT_CHECKER_EXACT_MATCH) {
+        xml_err_attr_invalid(a);
+        goto failure;
+      }
+      p->checker_cached = x;
+      break;
     case TR_A_COMMENT:
       p->comment = a->text;
       a->text = 0;
@@ -613,6 +625,9 @@ parse_test(struct xml_tree *t, testing_report_xml_t r)
     case TR_T_CHECKER_STATS_STR:
       if (xml_leaf_elem(t2, &q->checker_stats_str, 1, 1) < 0) goto failure;
       break;
+    case TR_T_TIME_SAMPLES:
+      if (xml_leaf_elem(t2, &q->time_samples, 1, 1) < 0) goto failure;
+      break;
     case TR_T_INPUT:
       if (parse_file(t2, &q->input) < 0) goto failure;
       break;
@@ -1359,6 +1374,7 @@ testing_report_test_free(struct testing_report_test *p)
   xfree(p->program_stats_str); p->program_stats_str = 0;
   xfree(p->interactor_stats_str); p->interactor_stats_str = 0;
   xfree(p->checker_stats_str); p->checker_stats_str = 0;
+  xfree(p->time_samples); p->time_samples = 0;
   xfree(p->input.data); p->input.data = 0;
   xfree(p->output.data); p->output.data = 0;
   xfree(p->correct.data); p->correct.data = 0;
@@ -1749,6 +1765,9 @@ testing_report_unparse_xml(
       if (t->visibility > 0) {
         fprintf(out, " %s=\"%s\"", attr_map[TR_A_VISIBILITY], test_visibility_unparse(t->visibility));
       }
+      if (t->checker_cached > 0) {
+        fprintf(out, " %s=\"%d\"", attr_map[TR_A_CHECKER_CACHED], t->checker_cached);
+      }
       if (t->has_user > 0) {
         unparse_bool_attr(out, TR_A_HAS_USER, t->has_user);
         if (t->user_status >= 0) {
@@ -1768,6 +1787,7 @@ testing_report_unparse_xml(
       unparse_string_elem(out, &ab, TR_T_PROGRAM_STATS_STR, t->program_stats_str);
       unparse_string_elem(out, &ab, TR_T_INTERACTOR_STATS_STR, t->interactor_stats_str);
       unparse_string_elem(out, &ab, TR_T_CHECKER_STATS_STR, t->checker_stats_str);
+      unparse_string_elem(out, &ab, TR_T_TIME_SAMPLES, t->time_samples);
 
       unparse_file_content(out, &ab, TR_T_INPUT, &t->input);
       unparse_file_content(out, &ab, TR_T_OUTPUT, &t->output);
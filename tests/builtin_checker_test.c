@@ -0,0 +1,192 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Runs the built-in checkers and the standard checkers from checkers/
+ * on the same inputs and compares the verdicts.
+ * usage: builtin_checker_test [CHECKERS-DIR]
+ */
+
+#include "ejudge/config.h"
+#include "ejudge/builtin_checker.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+struct test_case
+{
+  const char *checker;
+  const char *out;
+  const char *corr;
+  const char *env[4];
+  size_t out_size;              // the output may contain \0
+};
+
+static const struct test_case tests[] =
+{
+  { "cmp_file", "a b\nc\n", "a b\nc\n" },
+  { "cmp_file", "a b  \nc\n\n\n", "a b\nc\n" },
+  { "cmp_file", "\xEF\xBB\xBF" "a b\nc\n", "a b\nc\n" },
+  { "cmp_file", "a b\nd\n", "a b\nc\n" },
+  { "cmp_file", "a  b\nc\n", "a b\nc\n" },
+  { "cmp_file", "a b\n", "a b\nc\n" },
+  { "cmp_file", "A B\nc\n", "a b\nc\n" },
+  { "cmp_file", "A B\nc\n", "a b\nc\n", { "EJUDGE_NOCASE=1" } },
+  { "cmp_file", "a b\nc", "a b\nc\n", { "EJ_REQUIRE_NL=1" } },
+  { "cmp_file", "a\0b\n", "ab\n", {}, 4 },
+  { "cmp_file", "", "" },
+  { "cmp_file", "\n\n", "" },
+
+  { "cmp_int_seq", "1 2 3\n", "1 2 3\n" },
+  { "cmp_int_seq", "1\n2\n\n3", "1 2 3\n" },
+  { "cmp_int_seq", "1 2 4\n", "1 2 3\n" },
+  { "cmp_int_seq", "1 2\n", "1 2 3\n" },
+  { "cmp_int_seq", "1 2 3 4\n", "1 2 3\n" },
+  { "cmp_int_seq", "1 2 x\n", "1 2 3\n" },
+  { "cmp_int_seq", "1 2 99999999999\n", "1 2 3\n" },
+  { "cmp_int_seq", "1 2 3\n\001", "1 2 3\n" },
+  { "cmp_int_seq", "ff 10\n", "255 16\n", { "EJ_BASE=16" } },
+  { "cmp_int_seq", "1 2\n", "1 2\n", { "EJ_BASE=40" } },
+  { "cmp_int_seq", "1 2 3\n", "1 2 z\n" },
+
+  { "cmp_double_seq", "1.0 2.0\n", "1 2\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1.0000001 2.0\n", "1 2\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1.1 2.0\n", "1 2\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1000.0005\n", "1000\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1000.0005\n", "1000\n", { "EPS=1e-6", "ABSOLUTE=1" } },
+  { "cmp_double_seq", "nan inf\n", "nan inf\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1 2\n", "1 2 3\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1 2 3\n", "1 2\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1 2x\n", "1 2\n", { "EPS=1e-6" } },
+  { "cmp_double_seq", "1 2\n", "1 2\n" },
+  { "cmp_double_seq", "1 2\n", "1 2\n", { "EPS=2" } },
+
+  { "cmp_yesno", "yes\n", "yes\n" },
+  { "cmp_yesno", "YES\n", "yes\n" },
+  { "cmp_yesno", "YES\n", "yes\n", { "CASE_INSENSITIVE=1" } },
+  { "cmp_yesno", "no\n", "yes\n" },
+  { "cmp_yesno", "maybe\n", "yes\n" },
+  { "cmp_yesno", "yes\n", "maybe\n" },
+  { "cmp_yesno", "yes yes\n", "yes\n" },
+  { "cmp_yesno", "", "yes\n" },
+  { "cmp_yesno", "yes", "yes\n", { "EJ_REQUIRE_NL=1" } },
+};
+
+static const char *
+test_getenv(void *data, const char *name)
+{
+  const struct test_case *tc = (const struct test_case *) data;
+  size_t len = strlen(name);
+
+  for (int i = 0; i < 4 && tc->env[i]; ++i) {
+    if (!strncmp(tc->env[i], name, len) && tc->env[i][len] == '=')
+      return tc->env[i] + len + 1;
+  }
+  return NULL;
+}
+
+static int
+write_file(const char *path, const char *data, size_t size)
+{
+  FILE *f = fopen(path, "w");
+  if (!f) return -1;
+  fwrite(data, 1, size, f);
+  return fclose(f);
+}
+
+static int
+run_checker(
+        const char *checkers_dir,
+        const struct test_case *tc,
+        const char *in_path,
+        const char *out_path,
+        const char *corr_path)
+{
+  char path[PATH_MAX];
+  char *args[5];
+  char *envs[5];
+  int i, status;
+  pid_t pid;
+
+  snprintf(path, sizeof(path), "%s/%s", checkers_dir, tc->checker);
+  args[0] = path;
+  args[1] = (char *) in_path;
+  args[2] = (char *) out_path;
+  args[3] = (char *) corr_path;
+  args[4] = NULL;
+  for (i = 0; i < 4 && tc->env[i]; ++i) envs[i] = (char *) tc->env[i];
+  envs[i] = NULL;
+
+  if ((pid = fork()) < 0) return -1;
+  if (!pid) {
+    int fd = open("/dev/null", O_WRONLY);
+    dup2(fd, 2);
+    execve(path, args, envs);
+    _exit(127);
+  }
+  if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)) return -1;
+  return WEXITSTATUS(status);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const char *checkers_dir = "checkers";
+  char dir[] = "/tmp/ej-builtin-checker-XXXXXX";
+  char in_path[PATH_MAX], out_path[PATH_MAX], corr_path[PATH_MAX];
+  int failed = 0;
+
+  if (argc > 1) checkers_dir = argv[1];
+  if (!mkdtemp(dir)) {
+    fprintf(stderr, "cannot create temporary directory\n");
+    return 1;
+  }
+  snprintf(in_path, sizeof(in_path), "%s/input", dir);
+  snprintf(out_path, sizeof(out_path), "%s/output", dir);
+  snprintf(corr_path, sizeof(corr_path), "%s/correct", dir);
+  write_file(in_path, "", 0);
+
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+    const struct test_case *tc = &tests[i];
+    write_file(out_path, tc->out, tc->out_size?tc->out_size:strlen(tc->out));
+    write_file(corr_path, tc->corr, strlen(tc->corr));
+
+    FILE *log_f = fopen("/dev/null", "w");
+    int builtin_status = builtin_checker_run(builtin_checker_find(tc->checker),
+                                             in_path, out_path, corr_path,
+                                             log_f, test_getenv, (void *) tc);
+    fclose(log_f);
+    int checker_status = run_checker(checkers_dir, tc, in_path, out_path,
+                                     corr_path);
+    if (builtin_status != checker_status) {
+      fprintf(stderr, "%s: test %zu: built-in: %d, standard: %d\n",
+              tc->checker, i + 1, builtin_status, checker_status);
+      failed = 1;
+    }
+  }
+
+  unlink(in_path);
+  unlink(out_path);
+  unlink(corr_path);
+  rmdir(dir);
+  if (!failed) printf("builtin_checker_test: all tests passed\n");
+  return failed;
+}
@@ -0,0 +1,210 @@
+/* -*- mode: c -*- */
+
+/* Copyright (C) 2026 Alexander Chernov <cher@ejudge.ru> */
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Writes a testing report in the FlatBuffers format, reads it back
+ * through the verifier and the reader and compares the XML forms
+ * of both reports.
+ * usage: testing_report_flatbuf_test
+ */
+
+#include "ejudge/config.h"
+#include "ejudge/testing_report_xml.h"
+#include "ejudge/runlog.h"
+#include "ejudge/ej_uuid.h"
+#include "ejudge/xalloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum { TEST_COUNT = 3, ROW_COUNT = 2, COLUMN_COUNT = 2 };
+
+static void
+set_content(struct testing_report_file_content *fc, const char *data)
+{
+  fc->size = strlen(data);
+  fc->orig_size = fc->size;
+  fc->data = xstrdup(data);
+}
+
+static testing_report_xml_t
+make_report(void)
+{
+  ej_uuid_t judge_uuid = {};
+  testing_report_xml_t r;
+
+  for (int i = 0; i < (int) sizeof(judge_uuid); ++i) {
+    ((unsigned char *) &judge_uuid)[i] = i + 1;
+  }
+  r = testing_report_alloc(12, 345, 6, &judge_uuid);
+  r->submit_id = 1234567890123LL;
+  r->status = RUN_WRONG_ANSWER_ERR;
+  r->scoring_system = SCORE_KIROV;
+  r->archive_available = 1;
+  r->correct_available = 1;
+  r->real_time_available = 1;
+  r->max_memory_used_available = 1;
+  r->variant = 2;
+  r->failed_test = 2;
+  r->tests_passed = 2;
+  r->score = 20;
+  r->max_score = 30;
+  r->time_limit_ms = 1000;
+  r->real_time_limit_ms = 5000;
+  r->comment = xstrdup("comment");
+  r->valuer_comment = xstrdup("valuer comment");
+  r->host = xstrdup("host");
+  r->cpu_model = xstrdup("cpu");
+  r->cpu_mhz = xstrdup("3000");
+
+  r->run_tests = TEST_COUNT;
+  XCALLOC(r->tests, TEST_COUNT);
+  for (int i = 0; i < TEST_COUNT; ++i) {
+    struct testing_report_test *t;
+    t = testing_report_test_alloc(i + 1, i == 1?RUN_WRONG_ANSWER_ERR:RUN_OK);
+    r->tests[i] = t;
+    t->time = 10 * (i + 1);
+    t->real_time = 20 * (i + 1);
+    t->nominal_score = 10;
+    t->score = i == 1?0:10;
+    t->max_memory_used = 1048576LL * (i + 1);
+    t->visibility = 1;
+    t->has_input_digest = 1;
+    memset(t->input_digest, 'a' + i, sizeof(t->input_digest));
+    t->checker_comment = xstrdup(i == 1?"wrong answer":"ok");
+    t->args = xstrdup("--test");
+    set_content(&t->input, "1 2\n");
+    set_content(&t->output, i == 1?"4\n":"3\n");
+    set_content(&t->correct, "3\n");
+    set_content(&t->checker, i == 1?"expected 3, got 4\n":"");
+  }
+
+  r->tests_mode = 1;
+  r->tt_row_count = ROW_COUNT;
+  r->tt_column_count = COLUMN_COUNT;
+  XCALLOC(r->tt_rows, ROW_COUNT);
+  XCALLOC(r->tt_cells, ROW_COUNT);
+  for (int i = 0; i < ROW_COUNT; ++i) {
+    struct testing_report_row *ttr;
+    XCALLOC(ttr, 1);
+    r->tt_rows[i] = ttr;
+    ttr->row = i;
+    ttr->name = xstrdup(i?"row 1":"row 0");
+    ttr->must_fail = i;
+    ttr->status = RUN_OK;
+    ttr->nominal_score = 5;
+    ttr->score = 5;
+    XCALLOC(r->tt_cells[i], COLUMN_COUNT);
+    for (int j = 0; j < COLUMN_COUNT; ++j) {
+      struct testing_report_cell *ttc;
+      XCALLOC(ttc, 1);
+      r->tt_cells[i][j] = ttc;
+      ttc->row = i;
+      ttc->column = j;
+      ttc->status = RUN_OK;
+      ttc->time = i * 10 + j;
+      ttc->real_time = i * 20 + j;
+    }
+  }
+
+  return r;
+}
+
+static char *
+report_to_xml(testing_report_xml_t r)
+{
+  char *str = NULL;
+  size_t size = 0;
+
+  testing_report_to_str(&str, &size, 1, r);
+  return str;
+}
+
+int
+main(int argc, char *argv[])
+{
+  testing_report_xml_t r = make_report();
+  testing_report_xml_t r2 = NULL;
+  char *data = NULL;
+  size_t size = 0;
+  char *xml = NULL, *xml2 = NULL;
+  int failed = 0;
+
+  if (testing_report_to_mem_flatbuf(&data, &size, r) < 0) {
+    fprintf(stderr, "failed to build the report\n");
+    return 1;
+  }
+  if (!testing_report_is_flatbuf((const unsigned char *) data, size)) {
+    fprintf(stderr, "the report is not recognized\n");
+    failed = 1;
+  }
+
+  // the whole report
+  if (!(r2 = testing_report_parse_flatbuf_data((const unsigned char *) data, size, 0))) {
+    fprintf(stderr, "failed to read the report\n");
+    return 1;
+  }
+  xml = report_to_xml(r);
+  xml2 = report_to_xml(r2);
+  if (strcmp(xml, xml2) != 0) {
+    fprintf(stderr, "the reports differ:\n%s\n----\n%s\n", xml, xml2);
+    failed = 1;
+  }
+  if (r2->submit_id != r->submit_id
+      || memcmp(&r2->judge_uuid, &r->judge_uuid, sizeof(r->judge_uuid)) != 0) {
+    fprintf(stderr, "the report header differs\n");
+    failed = 1;
+  }
+  free(xml); xml = NULL;
+  free(xml2); xml2 = NULL;
+  testing_report_free(r2); r2 = NULL;
+
+  // one test only
+  if (!(r2 = testing_report_parse_flatbuf_data((const unsigned char *) data, size, 2))) {
+    fprintf(stderr, "failed to read the test 2\n");
+    return 1;
+  }
+  if (r2->run_tests != TEST_COUNT || r2->tests[0] || !r2->tests[1] || r2->tests[2]) {
+    fprintf(stderr, "unexpected tests for the test 2\n");
+    failed = 1;
+  } else {
+    struct testing_report_test *t = r->tests[1], *t2 = r2->tests[1];
+    if (t2->num != 2 || t2->status != t->status || t2->time != t->time
+        || t2->max_memory_used != t->max_memory_used
+        || !t2->has_input_digest
+        || memcmp(t2->input_digest, t->input_digest, sizeof(t->input_digest)) != 0
+        || !t2->checker_comment || strcmp(t2->checker_comment, t->checker_comment) != 0
+        || t2->output.size != t->output.size
+        || memcmp(t2->output.data, t->output.data, t->output.size) != 0) {
+      fprintf(stderr, "the test 2 differs\n");
+      failed = 1;
+    }
+  }
+  testing_report_free(r2); r2 = NULL;
+
+  // the verifier must reject a damaged buffer
+  if ((r2 = testing_report_parse_flatbuf_data((const unsigned char *) data, size / 2, 0))) {
+    fprintf(stderr, "a truncated report is accepted\n");
+    testing_report_free(r2); r2 = NULL;
+    failed = 1;
+  }
+
+  free(data);
+  testing_report_free(r);
+  if (!failed) printf("testing_report_flatbuf_test: all tests passed\n");
+  return failed;
+}
@@ -32,12 +32,26 @@
 #include <stdio.h>
 #include <sys/mman.h>
 #include <errno.h>
+#include <pthread.h>
 
 #if defined CONF_HAS_LIBZIP
 #include <zip.h>
 #endif
 
 static const unsigned char file_sig[8] = "Ej. Ar.";
+static const unsigned char index_sig[8] = "EjArIdx";
+
+#define MAX_WRITER_THREADS 64
+/* the number of files read ahead of the compression, per thread */
+#define MAX_PENDING_PER_THREAD 4
+
+static int full_archive_close_indexed(full_archive_t af);
+static int
+full_archive_append_file_indexed(
+        full_archive_t af,
+        const unsigned char *entry_name,
+        unsigned int flags,
+        const unsigned char *path);
 
 #if defined CONF_HAS_LIBZIP
 static full_archive_t full_archive_open_write_zip(const unsigned char *path);
@@ -121,6 +135,11 @@ full_archive_close(full_archive_t af)
   }
 #endif
 
+  if (af->writer) {
+    full_archive_close_indexed(af);
+    return 0;
+  }
+
   ASSERT(af->fd >= 0);
 
   if (af->mptr) {
@@ -158,6 +177,10 @@ full_archive_append_file(
   }
 #endif
 
+  if (af->writer) {
+    return full_archive_append_file_indexed(af, entry_name, flags, path);
+  }
+
   if (af->fd < 0) {
     err("full_archive_append_file: file descriptor is invalid");
     goto failure;
@@ -248,6 +271,360 @@ full_archive_append_file(
   return -1;
 }
 
+struct full_archive_job
+{
+  struct full_archive_job *next;
+  unsigned char *name;
+  unsigned int flags;
+  char *data;
+  size_t size;
+};
+
+struct full_archive_index_item
+{
+  rint64_t offset;
+  unsigned char *name;
+};
+
+struct full_archive_writer
+{
+  pthread_mutex_t m;
+  pthread_cond_t job_cond;      /* a job is queued or the writer stops */
+  pthread_cond_t done_cond;     /* a job is completed */
+
+  struct full_archive_job *first, *last;
+  int pending;                  /* queued or being compressed */
+  int stop;
+  int failed;
+
+  int thread_count;
+  pthread_t *threads;
+
+  struct full_archive_index_item *items;
+  int item_u, item_a;
+
+  unsigned char *path;          /* removed, if the archive is incomplete */
+};
+
+static int
+write_entry(
+        full_archive_t af,
+        struct full_archive_job *job)
+{
+  struct full_archive_writer *w = af->writer;
+  size_t entry_name_len = strlen(job->name);
+  size_t header_size;
+  uLong comp_size = 0;
+  size_t entry_size;
+  unsigned char *entry_buf = 0;
+  struct full_archive_entry_header *cur_head;
+  rint64_t offset;
+  const unsigned char *buf;
+  long wtot, wsz;
+
+  header_size = sizeof(struct full_archive_entry_header) + entry_name_len;
+  header_size = (header_size + 15) & ~15;
+
+  // the entry is compressed right after its header, so it is written at once
+  if (job->size > 0) comp_size = compressBound(job->size);
+  entry_buf = xcalloc(1, header_size + ((comp_size + 15) & ~15));
+  if (job->size > 0) {
+    if (compress2(entry_buf + header_size, &comp_size,
+                  (const Bytef *) job->data, job->size, 9) != Z_OK) {
+      err("full_archive_append_file: compressing of `%s' failed", job->name);
+      goto failure;
+    }
+  }
+  entry_size = header_size + ((comp_size + 15) & ~15);
+
+  cur_head = (struct full_archive_entry_header*) entry_buf;
+  cur_head->header_size = header_size;
+  cur_head->flags = job->flags;
+  strcpy(cur_head->name, job->name);
+  cur_head->raw_size = job->size;
+  cur_head->size = comp_size;
+
+  // reserve the space and register the entry
+  pthread_mutex_lock(&w->m);
+  offset = af->cur_size;
+  af->cur_size += entry_size;
+  if (w->item_u == w->item_a) {
+    if (!(w->item_a *= 2)) w->item_a = 32;
+    XREALLOC(w->items, w->item_a);
+  }
+  w->items[w->item_u].offset = offset;
+  w->items[w->item_u].name = job->name;
+  job->name = 0;
+  ++w->item_u;
+  pthread_mutex_unlock(&w->m);
+
+  wtot = entry_size, buf = entry_buf;
+  while (wtot > 0) {
+    if ((wsz = pwrite(af->fd, buf, wtot, offset)) <= 0) {
+      err("full_archive_append_file: write error: %s", os_ErrorMsg());
+      goto failure;
+    }
+    wtot -= wsz, buf += wsz, offset += wsz;
+  }
+
+  xfree(entry_buf);
+  return 0;
+
+ failure:
+  xfree(entry_buf);
+  return -1;
+}
+
+static void *
+writer_thread_func(void *arg)
+{
+  full_archive_t af = (full_archive_t) arg;
+  struct full_archive_writer *w = af->writer;
+  struct full_archive_job *job;
+  int r;
+
+  while (1) {
+    pthread_mutex_lock(&w->m);
+    while (!w->first && !w->stop) {
+      pthread_cond_wait(&w->job_cond, &w->m);
+    }
+    if (!w->first) {
+      pthread_mutex_unlock(&w->m);
+      break;
+    }
+    job = w->first;
+    if (!(w->first = job->next)) w->last = 0;
+    pthread_mutex_unlock(&w->m);
+
+    r = write_entry(af, job);
+
+    pthread_mutex_lock(&w->m);
+    if (r < 0) w->failed = 1;
+    --w->pending;
+    pthread_cond_broadcast(&w->done_cond);
+    pthread_mutex_unlock(&w->m);
+
+    xfree(job->name);
+    xfree(job->data);
+    xfree(job);
+  }
+
+  return 0;
+}
+
+full_archive_t
+full_archive_open_write_indexed(const unsigned char *path, int thread_count)
+{
+  full_archive_t af = 0;
+  struct full_archive_writer *w = 0;
+  int fd = -1;
+  struct full_archive_file_header header;
+  int i;
+
+  if (!path || !*path) {
+    err("full_archive_open_write_indexed: path == NULL");
+    goto failure;
+  }
+  if (thread_count <= 0) thread_count = 1;
+  if (thread_count > MAX_WRITER_THREADS) thread_count = MAX_WRITER_THREADS;
+
+  if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600)) < 0) {
+    err("full_archive_open_write_indexed: cannot open: %s", os_ErrorMsg());
+    goto failure;
+  }
+
+  memset(&header, 0, sizeof(header));
+  strcpy(header.sig, file_sig);
+  header.version = 2;
+  if (pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) {
+    err("full_archive_open_write_indexed: write error: %s", os_ErrorMsg());
+    goto failure;
+  }
+
+  XCALLOC(af, 1);
+  af->fd = fd;
+  af->cur_size = sizeof(header);
+
+  XCALLOC(w, 1);
+  pthread_mutex_init(&w->m, 0);
+  pthread_cond_init(&w->job_cond, 0);
+  pthread_cond_init(&w->done_cond, 0);
+  XCALLOC(w->threads, thread_count);
+  w->path = xstrdup(path);
+  af->writer = w;
+
+  for (i = 0; i < thread_count; ++i) {
+    if ((errno = pthread_create(&w->threads[i], 0, writer_thread_func, af))) {
+      err("full_archive_open_write_indexed: pthread_create failed: %s",
+          os_ErrorMsg());
+      break;
+    }
+  }
+  if (!(w->thread_count = i)) {
+    pthread_cond_destroy(&w->done_cond);
+    pthread_cond_destroy(&w->job_cond);
+    pthread_mutex_destroy(&w->m);
+    xfree(w->threads);
+    xfree(w->path);
+    xfree(w);
+    xfree(af);
+    af = 0;
+    goto failure;
+  }
+
+  return af;
+
+ failure:
+  if (fd >= 0) {
+    close(fd);
+    unlink(path);
+  }
+  return 0;
+}
+
+static int
+full_archive_append_file_indexed(
+        full_archive_t af,
+        const unsigned char *entry_name,
+        unsigned int flags,
+        const unsigned char *path)
+{
+  struct full_archive_writer *w = af->writer;
+  struct full_archive_job *job = 0;
+  char *file_buf = 0;
+  size_t file_size = 0;
+  int failed;
+
+  if (!entry_name) entry_name = "";
+  if (strlen(entry_name) > FULL_ARCHIVE_MAX_NAME_LEN) {
+    err("full_archive_append_file: entry name `%s' is too long", entry_name);
+    return -1;
+  }
+  if (generic_read_file(&file_buf, 0, &file_size, 0, 0, path, 0) < 0) {
+    err("full_archive_append_file: reading of `%s' failed", path);
+    return -1;
+  }
+
+  XCALLOC(job, 1);
+  job->name = xstrdup(entry_name);
+  job->flags = flags;
+  job->data = file_buf;
+  job->size = file_size;
+
+  pthread_mutex_lock(&w->m);
+  // do not let the read files pile up, if the compression is behind
+  while (w->pending >= w->thread_count * MAX_PENDING_PER_THREAD && !w->failed) {
+    pthread_cond_wait(&w->done_cond, &w->m);
+  }
+  if (w->last) {
+    w->last->next = job;
+  } else {
+    w->first = job;
+  }
+  w->last = job;
+  ++w->pending;
+  pthread_cond_signal(&w->job_cond);
+  failed = w->failed;
+  pthread_mutex_unlock(&w->m);
+
+  return -failed;
+}
+
+static int
+index_item_sort_func(const void *p1, const void *p2)
+{
+  const struct full_archive_index_item *i1 = p1;
+  const struct full_archive_index_item *i2 = p2;
+  return strcmp(i1->name, i2->name);
+}
+
+static int
+full_archive_close_indexed(full_archive_t af)
+{
+  struct full_archive_writer *w = af->writer;
+  struct full_archive_index_trailer trailer;
+  ruint64_t *offsets = 0;
+  size_t offsets_size;
+  const unsigned char *buf;
+  long wtot, wsz;
+  rint64_t offset;
+  int i;
+  int retval = -1;
+
+  pthread_mutex_lock(&w->m);
+  w->stop = 1;
+  pthread_cond_broadcast(&w->job_cond);
+  pthread_mutex_unlock(&w->m);
+  for (i = 0; i < w->thread_count; ++i) {
+    pthread_join(w->threads[i], 0);
+  }
+
+  if (w->failed) {
+    err("full_archive_close: the archive is incomplete");
+    goto cleanup;
+  }
+
+  qsort(w->items, w->item_u, sizeof(w->items[0]), index_item_sort_func);
+  offsets_size = w->item_u * sizeof(offsets[0]);
+  XCALLOC(offsets, w->item_u + 1);
+  for (i = 0; i < w->item_u; ++i) {
+    offsets[i] = w->items[i].offset;
+  }
+  offset = af->cur_size;
+  wtot = offsets_size, buf = (const unsigned char *) offsets;
+  while (wtot > 0) {
+    if ((wsz = pwrite(af->fd, buf, wtot, offset)) <= 0) {
+      err("full_archive_close: write error: %s", os_ErrorMsg());
+      goto cleanup;
+    }
+    wtot -= wsz, buf += wsz, offset += wsz;
+  }
+
+  memset(&trailer, 0, sizeof(trailer));
+  memcpy(trailer.sig, index_sig, sizeof(trailer.sig));
+  trailer.index_offset = af->cur_size;
+  trailer.count = w->item_u;
+  if (pwrite(af->fd, &trailer, sizeof(trailer), offset) != sizeof(trailer)) {
+    err("full_archive_close: write error: %s", os_ErrorMsg());
+    goto cleanup;
+  }
+  retval = 0;
+
+ cleanup:
+  for (i = 0; i < w->item_u; ++i) {
+    xfree(w->items[i].name);
+  }
+  xfree(w->items);
+  xfree(w->threads);
+  xfree(offsets);
+  pthread_cond_destroy(&w->done_cond);
+  pthread_cond_destroy(&w->job_cond);
+  pthread_mutex_destroy(&w->m);
+  if (close(af->fd) < 0) {
+    err("full_archive_close: close error: %s", os_ErrorMsg());
+    retval = -1;
+  }
+  if (retval < 0) {
+    // an archive without the index cannot be read
+    unlink(w->path);
+  }
+  xfree(w->path);
+  xfree(w);
+  xfree(af);
+  return retval;
+}
+
+int
+full_archive_close_write(full_archive_t af)
+{
+  if (!af) return 0;
+  if (af->writer) {
+    return full_archive_close_indexed(af);
+  }
+  full_archive_close(af);
+  return 0;
+}
+
 full_archive_t
 full_archive_open_read(const unsigned char *path)
 {
@@ -296,7 +673,7 @@ full_archive_open_read(const unsigned char *path)
     err("full_archive_open_read: file signature mismatch");
     goto failure;
   }
-  if (fhead->version != 1) {
+  if (fhead->version != 1 && fhead->version != 2) {
     err("full_archive_open_read: version mismatch");
     goto failure;
   }
@@ -305,6 +682,30 @@ full_archive_open_read(const unsigned char *path)
   af->fd = fd;
   af->mptr = mptr;
   af->msize = msize;
+  af->data_end = msize;
+
+  if (fhead->version == 2) {
+    const struct full_archive_index_trailer *trailer;
+    if (msize < sizeof(*fhead) + sizeof(*trailer)) {
+      err("full_archive_open_read: file is too small (size %zu)", msize);
+      goto failure;
+    }
+    trailer = (const struct full_archive_index_trailer *)
+      ((const unsigned char *) mptr + msize - sizeof(*trailer));
+    if (memcmp(trailer->sig, index_sig, sizeof(index_sig)) != 0) {
+      err("full_archive_open_read: index signature mismatch");
+      goto failure;
+    }
+    if (trailer->index_offset < sizeof(*fhead)
+        || (trailer->index_offset & 15)
+        || trailer->index_offset + (rint64_t) trailer->count * sizeof(af->index[0]) + sizeof(*trailer) != msize) {
+      err("full_archive_open_read: invalid index");
+      goto failure;
+    }
+    af->index = (const ruint64_t *) ((const unsigned char *) mptr + trailer->index_offset);
+    af->index_count = trailer->count;
+    af->data_end = trailer->index_offset;
+  }
   return af;
 
  failure:
@@ -314,6 +715,137 @@ full_archive_open_read(const unsigned char *path)
   return 0;
 }
 
+/* validates the entry header at 'cur_ptr', returns NULL on error */
+static const full_archive_entry_header_t *
+check_entry(
+        const unsigned char *cur_ptr,
+        const unsigned char *end_ptr,
+        int *p_errcode)
+{
+  const full_archive_entry_header_t *cur_head;
+  size_t name_len;
+
+  if (cur_ptr + sizeof(*cur_head) > end_ptr) {
+    *p_errcode = 3;
+    return 0;
+  }
+  cur_head = (const full_archive_entry_header_t *) cur_ptr;
+  if (cur_head->header_size < 0) {
+    *p_errcode = 4;
+    return 0;
+  }
+  if ((cur_head->header_size & 15)) {
+    *p_errcode = 5;
+    return 0;
+  }
+  if (cur_head->header_size < sizeof(*cur_head)) {
+    *p_errcode = 6;
+    return 0;
+  }
+  if (cur_head->header_size > (((sizeof(*cur_head) + FULL_ARCHIVE_MAX_NAME_LEN) + 15) & ~15)) {
+    *p_errcode = 7;
+    return 0;
+  }
+  name_len = strnlen(cur_head->name, cur_head->header_size - sizeof(*cur_head));
+  if (cur_head->name[name_len]) {
+    *p_errcode = 8;
+    return 0;
+  }
+  if (name_len > FULL_ARCHIVE_MAX_NAME_LEN) {
+    *p_errcode = 9;
+    return 0;
+  }
+  if (cur_head->size < 0) {
+    *p_errcode = 10;
+    return 0;
+  }
+  if (cur_ptr + cur_head->header_size + cur_head->size > end_ptr) {
+    *p_errcode = 11;
+    return 0;
+  }
+  return cur_head;
+}
+
+static int
+extract_entry(
+        const full_archive_entry_header_t *cur_head,
+        long *p_raw_size,
+        unsigned int *p_flags,
+        unsigned char **p_data,
+        int *p_errcode)
+{
+  const unsigned char *data_ptr;
+  uLongf raw_size;
+
+  *p_raw_size = cur_head->raw_size;
+  *p_flags = cur_head->flags;
+
+  if (cur_head->raw_size <= 0) {
+    *p_data = xmalloc(1);
+    **p_data = 0;
+    return 1;
+  }
+
+  data_ptr = (const unsigned char *) cur_head + cur_head->header_size;
+  raw_size = cur_head->raw_size;
+  *p_data = xmalloc(cur_head->raw_size + 1);
+  if (uncompress(*p_data, &raw_size, data_ptr, cur_head->size) != Z_OK) {
+    xfree(*p_data);
+    *p_data = 0;
+    *p_errcode = 13;
+    return -1;
+  }
+  *p_raw_size = raw_size;
+  (*p_data)[cur_head->raw_size] = 0;
+  return 1;
+}
+
+/* binary search in the index of the version 2 archive */
+static int
+find_file_indexed(
+        full_archive_t af,
+        const unsigned char *name,
+        long *p_raw_size,
+        unsigned int *p_flags,
+        unsigned char **p_data)
+{
+  const unsigned char *end_ptr = af->mptr + af->data_end;
+  const full_archive_entry_header_t *cur_head;
+  long low = 0, high = af->index_count, mid;
+  ruint64_t offset;
+  int errcode = 0, c;
+
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    offset = af->index[mid];
+    if (offset < sizeof(struct full_archive_file_header)
+        || offset >= af->data_end || (offset & 15)) {
+      errcode = 14;
+      goto failure;
+    }
+    if (!(cur_head = check_entry(af->mptr + offset, end_ptr, &errcode))) {
+      goto failure;
+    }
+    if (!(c = strcmp(name, cur_head->name))) {
+      if (extract_entry(cur_head, p_raw_size, p_flags, p_data, &errcode) < 0)
+        goto failure;
+      return 1;
+    }
+    if (c < 0) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+
+  /* entry not found */
+  return 0;
+
+ failure:
+  err("full_archive_find_file: error %d", errcode);
+  return -1;
+}
+
 int
 full_archive_find_file(
         full_archive_t af,
@@ -323,9 +855,8 @@ full_archive_find_file(
         unsigned char **p_data)
 {
   const unsigned char *cur_ptr;
-  const unsigned char *end_ptr = af->mptr + af->msize;
+  const unsigned char *end_ptr;
   const full_archive_entry_header_t *cur_head;
-  size_t name_len;
   int errcode = 0;
 
   ASSERT(af);
@@ -338,6 +869,11 @@ full_archive_find_file(
 
   ASSERT(af->mptr);
 
+  if (af->index) {
+    return find_file_indexed(af, name, p_raw_size, p_flags, p_data);
+  }
+
+  end_ptr = af->mptr + af->data_end;
   cur_ptr = af->mptr + sizeof(struct full_archive_file_header);
   while (1) {
     if (((unsigned long) cur_ptr & 15)) {
@@ -349,68 +885,17 @@ full_archive_find_file(
       errcode = 2;
       goto failure;
     }
-    if (cur_ptr + sizeof(*cur_head) > end_ptr) {
-      errcode = 3;
-      goto failure;
-    }
-    cur_head = (const full_archive_entry_header_t *) cur_ptr;
-    if (cur_head->header_size < 0) {
-      errcode = 4;
-      goto failure;
-    }
-    if ((cur_head->header_size & 15)) {
-      errcode = 5;
-      goto failure;
-    }
-    if (cur_head->header_size < sizeof(*cur_head)) {
-      errcode = 6;
-      goto failure;
-    }
-    if (cur_head->header_size > (((sizeof(*cur_head) + FULL_ARCHIVE_MAX_NAME_LEN) + 15) & ~15)) {
-      errcode = 7;
-      goto failure;
-    }
-    name_len = strnlen(cur_head->name, cur_head->header_size - sizeof(*cur_head));
-    if (cur_head->name[name_len]) {
-      errcode = 8;
-      goto failure;
-    }
-    if (name_len > FULL_ARCHIVE_MAX_NAME_LEN) {
-      errcode = 9;
-      goto failure;
-    }
-
-    cur_ptr += cur_head->header_size;
-    if (cur_head->size < 0) {
-      errcode = 10;
-      goto failure;
-    }
-    if (cur_ptr + cur_head->size > end_ptr) {
-      errcode = 11;
+    if (!(cur_head = check_entry(cur_ptr, end_ptr, &errcode))) {
       goto failure;
     }
 
     if (!strcmp(cur_head->name, name)) {
-      *p_raw_size = cur_head->raw_size;
-      *p_flags = cur_head->flags;
-
-      if (cur_head->raw_size <= 0) {
-        *p_data = xmalloc(1);
-        **p_data = 0;
-        return 1;
-      }
-
-      *p_data = xmalloc(cur_head->raw_size + 1);
-      if (uncompress(*p_data, p_raw_size, cur_ptr, cur_head->size) != Z_OK) {
-        xfree(*p_data);
-        errcode = 13;
+      if (extract_entry(cur_head, p_raw_size, p_flags, p_data, &errcode) < 0)
         goto failure;
-      }
-      (*p_data)[cur_head->raw_size] = 0;
       return 1;
     }
 
-    cur_ptr += cur_head->size;
+    cur_ptr += cur_head->header_size + cur_head->size;
     cur_ptr = (const unsigned char*)(((unsigned long) cur_ptr + 15) & ~15);
     if (cur_ptr > end_ptr) {
       errcode = 12;
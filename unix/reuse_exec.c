@@ -123,6 +123,8 @@ struct tTask
   int    ctl_socket_fd_1;       /* this side of the control socket */
   int    ctl_socket_fd_2;       /* other side of the control socket */
   int    user_serial;           /* executing user serial */
+  int    enable_perf_counters;  /* measure with perf counters in the container */
+  long long max_instructions;   /* max number of user-mode instructions */
   struct rusage usage;          /* process resource utilization */
   struct timeval start_time;    /* start real-time */
   struct timeval stop_time;     /* stop real-time */
@@ -153,6 +155,9 @@ struct tTask
   long long cgroup_ptime_us;
   long long cgroup_utime_us;
   long long cgroup_stime_us;
+  long long cgroup_memory_peak;
+  long long perf_task_clock_us;
+  long long perf_instructions;
 };
 
 #define PIDARR_SIZE 32
@@ -1375,6 +1380,25 @@ task_SetUserSerial(tTask *tsk, int serial)
   return 0;
 }
 
+int
+task_EnablePerfCounters(tTask *tsk)
+{
+  task_init_module();
+  ASSERT(tsk);
+  tsk->enable_perf_counters = 1;
+  return 0;
+}
+
+int
+task_SetMaxInstructions(tTask *tsk, long long count)
+{
+  task_init_module();
+  ASSERT(tsk);
+  if (count < 0) return -1;
+  tsk->max_instructions = count;
+  return 0;
+}
+
 int
 task_SetKillSignal(tTask *tsk, char const *signame)
 {
@@ -1737,6 +1761,12 @@ task_StartContainer(tTask *tsk)
   if (tsk->enable_security_violation_error) {
     fprintf(spec_f, "mE");
   }
+  if (tsk->enable_perf_counters) {
+    fprintf(spec_f, "mT");
+  }
+  if (tsk->max_instructions > 0) {
+    fprintf(spec_f, "lI%lld", tsk->max_instructions);
+  }
 
   if (tsk->max_stack_size > 0) {
     fprintf(spec_f, "ls%lld", (long long) tsk->max_stack_size);
@@ -2631,6 +2661,9 @@ task_WaitContainer(tTask *tsk)
   long long cgroup_ptime_us = 0;
   long long cgroup_utime_us = 0;
   long long cgroup_stime_us = 0;
+  long long cgroup_memory_peak = 0;
+  long long perf_task_clock_us = 0;
+  long long perf_instructions = 0;
 
   while (*resp_p) {
     if (*resp_p == 'a' || *resp_p == 'b' || *resp_p == 'i' || *resp_p == 'o') {
@@ -2669,7 +2702,7 @@ task_WaitContainer(tTask *tsk)
       resp_p = eptr;
     } else if (*resp_p == 'c') {
       ++resp_p;
-      if (*resp_p == 't' || *resp_p == 'u' || *resp_p == 's') {
+      if (*resp_p == 't' || *resp_p == 'u' || *resp_p == 's' || *resp_p == 'm') {
         errno = 0;
         char *eptr = NULL;
         long long v = strtoll(resp_p + 1, &eptr, 10);
@@ -2683,6 +2716,31 @@ task_WaitContainer(tTask *tsk)
         if (*resp_p == 't') cgroup_ptime_us = v;
         else if (*resp_p == 'u') cgroup_utime_us = v;
         else if (*resp_p == 's') cgroup_stime_us = v;
+        else if (*resp_p == 'm') cgroup_memory_peak = v;
+        resp_p = eptr;
+      } else {
+        write_log(LOG_REUSE, LOG_ERROR, "task_WaitContainer: invalid reply from container: %s\n", resp_buf);
+        xfree(tsk->last_error_msg); tsk->last_error_msg = NULL;
+        _ = asprintf(&tsk->last_error_msg, "invalid reply from container: %s", resp_buf);
+        tsk->was_check_failed = 1;
+        return NULL;
+      }
+    } else if (*resp_p == 'p') {
+      // perf counters
+      ++resp_p;
+      if (*resp_p == 't' || *resp_p == 'i') {
+        errno = 0;
+        char *eptr = NULL;
+        long long v = strtoll(resp_p + 1, &eptr, 10);
+        if (errno || eptr == resp_p + 1 || v < 0) {
+          write_log(LOG_REUSE, LOG_ERROR, "task_WaitContainer: invalid reply from container: %s\n", resp_buf);
+          xfree(tsk->last_error_msg); tsk->last_error_msg = NULL;
+          _ = asprintf(&tsk->last_error_msg, "invalid reply from container: %s", resp_buf);
+          tsk->was_check_failed = 1;
+          return NULL;
+        }
+        if (*resp_p == 't') perf_task_clock_us = v;
+        else if (*resp_p == 'i') perf_instructions = v;
         resp_p = eptr;
       } else {
         write_log(LOG_REUSE, LOG_ERROR, "task_WaitContainer: invalid reply from container: %s\n", resp_buf);
@@ -2768,6 +2826,9 @@ task_WaitContainer(tTask *tsk)
   tsk->cgroup_ptime_us = cgroup_ptime_us;
   tsk->cgroup_utime_us = cgroup_utime_us;
   tsk->cgroup_stime_us = cgroup_stime_us;
+  tsk->cgroup_memory_peak = cgroup_memory_peak;
+  tsk->perf_task_clock_us = perf_task_clock_us;
+  tsk->perf_instructions = perf_instructions;
 
   return tsk;
 }
@@ -3127,6 +3188,9 @@ task_GetProcessStats(tTask *tsk, struct ej_process_stats *pstats)
   pstats->cgroup_ptime_us = tsk->cgroup_ptime_us;
   pstats->cgroup_utime_us = tsk->cgroup_utime_us;
   pstats->cgroup_stime_us = tsk->cgroup_stime_us;
+  pstats->cgroup_memory_peak = tsk->cgroup_memory_peak;
+  pstats->perf_task_clock_us = tsk->perf_task_clock_us;
+  pstats->perf_instructions = tsk->perf_instructions;
 
   return 0;
 }